@@ -0,0 +1,182 @@
+//Include header file
+#include "DVSPlanner.h"
+#include "DVSSweep.h"
+#include "LM51772.h"
+
+// Time spent reconfiguring MFR_SPECIFIC_D2 (read plus write at 100 kHz)
+#define DVS_CONFIG_CHANGE_US            1000
+
+static const uint8_t slewSettings[4] = {DVS_SLEW_40mV_us, DVS_SLEW_20mV_us, DVS_SLEW_1mV_us, DVS_SLEW_0_5mV_us};
+
+static uint32_t dischargeCurrent_mA(uint8_t Strength){
+    switch (Strength & 0x0C) {
+        case DISCHG_STRENGTH_50mA:
+            return 50;
+        case DISCHG_STRENGTH_75mA:
+            return 75;
+        default:
+            return 25;
+    }
+}
+
+/******************************************
+* @brief: Fills the planner input from the device registers
+* @param I2CAddress: I2CAddress of the LM51772 device (uint8_t)
+* @param Input: planner input to be filled (DVS_PlannerInput *)
+* @note: Reads VOUT_TARGET1, MFR_SPECIFIC_D2, D3, D5 and IVP_VOLTAGE
+*        and decodes them with the inverse of the formulas used by the
+*        configuration functions. The target is set equal to the
+*        present VOUT, the board parameters take the DVS_BOARD_*
+*        defaults and the load current is set to 0 (worst case for a
+*        passive down ramp), adjust them before planning.
+*******************************************/
+void DVS_Planner_ReadConfig(uint8_t I2CAddress, DVS_PlannerInput *Input){
+    Input->VoutNowmV = (uint16_t)(getVOUT1_TARGET(I2CAddress)*VOUT_MV_PER_CODE);
+    Input->VoutTargetmV = Input->VoutNowmV;
+    // Slew rate, active down ramp and discharge from MFR_SPECIFIC_D2
+    uint8_t d2 = I2C_ReadRegByte(I2CAddress,MFR_SPECIFIC_D2);
+    Input->Slewrate = d2 & 0x30;
+    Input->ActiveDownRamp = (d2 & 0x40) ? 1 : 0;
+    Input->DischargeEnabled = (d2 & 0x02) ? 1 : 0;
+    Input->DischargeStrength = d2 & 0x0C;
+    // OVP2 threshold from MFR_SPECIFIC_D5
+    uint8_t vovp2 = I2C_ReadRegByte(I2CAddress,MFR_SPECIFIC_D5) & 0x3F;
+    Input->OVP2ThresholdmV = (vovp2 < 24) ? (uint16_t)(4000 + vovp2*500) : (uint16_t)(16000 + (vovp2 - 24)*1000);
+    // IVP threshold from IVP_VOLTAGE, only if IVP is enabled in MFR_SPECIFIC_D3
+    if (I2C_ReadRegByte(I2CAddress,MFR_SPECIFIC_D3) & 0x80) {
+        uint8_t ivp = I2C_ReadRegByte(I2CAddress,IVP_VOLTAGE);
+        Input->IVPThresholdmV = (ivp < 151) ? (uint16_t)(4750 + ivp*125) : (uint16_t)(24000 + (ivp - 151)*250);
+    }
+    else {
+        Input->IVPThresholdmV = 0;
+    }
+    Input->VinmV = DVS_BOARD_VIN_MV;
+    Input->SourceResistance_mOhm = DVS_BOARD_RSOURCE_MOHM;
+    Input->Cout_uF = DVS_BOARD_COUT_UF;
+    Input->Iload_mA = 0;
+    Input->Efficiency_pct = DVS_BOARD_EFFICIENCY_PCT;
+}
+
+// Evaluates one candidate setting, returns 1 if it respects the margins
+static int evaluate(const DVS_PlannerInput *Input, uint8_t Slewrate, uint8_t ActiveDownRamp, DVS_Plan *Plan){
+    uint32_t slew = DVS_SlewRate_uVus(Slewrate);
+    int rising = Input->VoutTargetmV > Input->VoutNowmV;
+    uint32_t delta = rising ? (uint32_t)(Input->VoutTargetmV - Input->VoutNowmV) : (uint32_t)(Input->VoutNowmV - Input->VoutTargetmV);
+    uint32_t rate = slew;
+    int ok = 1;
+    Plan->Slewrate = Slewrate;
+    Plan->ActiveDownRamp = ActiveDownRamp;
+    Plan->PeakmV = (Input->VoutTargetmV > Input->VoutNowmV) ? Input->VoutTargetmV : Input->VoutNowmV;
+    Plan->VinMinmV = Input->VinmV;
+    if (rising) {
+        // The output keeps ramping for the loop delay after the target
+        uint32_t peak = Input->VoutTargetmV + (slew*DVS_LOOP_DELAY_US)/1000;
+        Plan->PeakmV = (peak > 0xFFFF) ? 0xFFFF : (uint16_t)peak;
+        if (Input->OVP2ThresholdmV != 0 && peak + DVS_OVP2_MARGIN_MV > Input->OVP2ThresholdmV) {
+            ok = 0;
+        }
+        // Charging current of the output capacitance (uF * mV/us = mA)
+        uint64_t icharge = ((uint64_t)Input->Cout_uF*slew)/1000;
+        uint64_t pout_uW = (uint64_t)Input->VoutTargetmV*(Input->Iload_mA + icharge);
+        uint64_t iin_mA = (Input->VinmV != 0 && Input->Efficiency_pct != 0) ?
+                          (pout_uW*100)/((uint64_t)Input->VinmV*Input->Efficiency_pct) : 0;
+        uint64_t sag = (iin_mA*Input->SourceResistance_mOhm)/1000;
+        Plan->VinMinmV = (sag >= Input->VinmV) ? 0 : (uint16_t)(Input->VinmV - sag);
+        if (Input->IVPThresholdmV != 0 && (uint32_t)Plan->VinMinmV < (uint32_t)Input->IVPThresholdmV + DVS_IVP_MARGIN_MV) {
+            ok = 0;
+        }
+    }
+    else if (!ActiveDownRamp) {
+        // Without active down ramp the output only falls as fast as the
+        // load and the discharge path drain it (mA/uF = mV/us)
+        uint32_t sink = Input->Iload_mA + (Input->DischargeEnabled ? dischargeCurrent_mA(Input->DischargeStrength) : 0);
+        uint32_t passive = (Input->Cout_uF != 0) ? (sink*1000)/Input->Cout_uF : slew;
+        if (passive < rate) {
+            rate = passive;
+        }
+    }
+    if (delta > 0 && rate == 0) {
+        // Nothing discharges the output, it would never get there
+        Plan->Ramp_us = UINT32_MAX;
+        Plan->Wait_us = UINT32_MAX;
+        return 0;
+    }
+    Plan->Ramp_us = (rate != 0) ? (uint32_t)(((uint64_t)delta*1000 + rate - 1)/rate) : 0;
+    Plan->Wait_us = Plan->Ramp_us + DVS_LOOP_DELAY_US + DVS_SETTLE_US;
+    if (Slewrate != Input->Slewrate || ActiveDownRamp != Input->ActiveDownRamp) {
+        Plan->Wait_us += DVS_CONFIG_CHANGE_US;
+    }
+    return ok;
+}
+
+/******************************************
+* @brief: Computes the time optimal plan for a VOUT transition
+* @param Input: transition and configuration (const DVS_PlannerInput *)
+* @param Plan: resulting plan (DVS_Plan *)
+* @note: Evaluates every DVS_SLEW_* setting with active down ramp on
+*        and off, and keeps the candidate with the shortest Wait_us
+*        among the ones that respect the margins:
+*           - Rising: the peak (target plus the distance ramped during
+*             DVS_LOOP_DELAY_US) stays DVS_OVP2_MARGIN_MV below OVP2,
+*             and the input sag caused by charging Cout at the slew
+*             rate stays DVS_IVP_MARGIN_MV above the IVP threshold.
+*           - Falling: with active down ramp the output follows the
+*             slew rate, without it it falls at most as fast as the
+*             load plus the discharge current drain Cout.
+*        Changing MFR_SPECIFIC_D2 costs DVS_CONFIG_CHANGE_US, so the
+*        present configuration wins when it is as fast. If no candidate
+*        is feasible, the slowest rising setting is returned with
+*        Feasible = 0.
+*******************************************/
+void DVS_Planner_Plan(const DVS_PlannerInput *Input, DVS_Plan *Plan){
+    DVS_Plan candidate;
+    int found = 0;
+    int rising = Input->VoutTargetmV > Input->VoutNowmV;
+    for (int adr = 0; adr < 2; ++adr) {
+        // Active down ramp only matters when going down
+        uint8_t activeDownRamp = rising ? Input->ActiveDownRamp : (uint8_t)adr;
+        if (rising && adr == 1) {
+            break;
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (!evaluate(Input,slewSettings[i],activeDownRamp,&candidate)) {
+                continue;
+            }
+            if (!found || candidate.Wait_us < Plan->Wait_us) {
+                *Plan = candidate;
+                found = 1;
+            }
+        }
+    }
+    if (!found) {
+        evaluate(Input,DVS_SLEW_0_5mV_us,Input->ActiveDownRamp,Plan);
+        Plan->Feasible = 0;
+        return;
+    }
+    Plan->Feasible = 1;
+}
+
+/******************************************
+* @brief: Applies a transition plan to the device
+* @param I2CAddress: I2CAddress of the LM51772 device (uint8_t)
+* @param Input: input the plan was computed from (const DVS_PlannerInput *)
+* @param Plan: plan from DVS_Planner_Plan (const DVS_Plan *)
+* @note: MFR_SPECIFIC_D2 is only touched when the slew rate or active
+*        down ramp change, with a single masked write for both. Then
+*        the VOUT target is written. Returns the time in us until the
+*        next command is safe.
+*******************************************/
+uint32_t DVS_Planner_Apply(uint8_t I2CAddress, const DVS_PlannerInput *Input, const DVS_Plan *Plan){
+    if (Plan->Slewrate != Input->Slewrate || Plan->ActiveDownRamp != Input->ActiveDownRamp) {
+        // Masked write of bits 6:4 of MFR_SPECIFIC_D2
+        uint8_t Reg = MFR_SPECIFIC_D2;
+        uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0x8F;
+        regContent |= Plan->Slewrate;
+        if (Plan->ActiveDownRamp) {
+            regContent |= 0x40;
+        }
+        I2C_WriteRegByte(I2CAddress,Reg,regContent);
+    }
+    setVOUT1_TARGET(I2CAddress,Input->VoutTargetmV);
+    return Plan->Wait_us;
+}
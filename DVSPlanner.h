@@ -0,0 +1,60 @@
+#include <stdint.h>
+
+#ifndef DVS_PLANNER_H
+#define DVS_PLANNER_H
+
+// Slew rate aware planner for VOUT transitions of the LM51772. Given the
+// present and target VOUT, the DVS/discharge configuration and the OVP2
+// and IVP thresholds, it returns the fastest transition that keeps the
+// output below OVP2 and the input above IVP, and how long to wait before
+// the next command is safe. Transitions can then be scheduled back to
+// back instead of sleeping a fixed worst case time.
+
+//-------CHANGE TO MATCH THE BOARD---------//
+// Default board parameters used by DVS_Planner_ReadConfig()
+#define DVS_BOARD_COUT_UF               200     // Output capacitance in uF
+#define DVS_BOARD_VIN_MV                20000   // Nominal input voltage in mV
+#define DVS_BOARD_RSOURCE_MOHM          50      // Source + cable resistance in mOhms
+#define DVS_BOARD_EFFICIENCY_PCT        90      // Converter efficiency in %
+
+// Model parameters
+#define DVS_LOOP_DELAY_US               10      // Time the output keeps ramping after reaching the target
+#define DVS_OVP2_MARGIN_MV              500     // Margin kept below the OVP2 threshold
+#define DVS_IVP_MARGIN_MV               250     // Margin kept above the IVP threshold
+#define DVS_SETTLE_US                   50      // Settling time added after the ramp
+
+typedef struct{
+    uint16_t VoutNowmV;                 // Present VOUT in mV
+    uint16_t VoutTargetmV;              // Target VOUT in mV
+    uint8_t Slewrate;                   // Configured DVS_SLEW_* setting
+    uint8_t ActiveDownRamp;             // DVS_ActiveDownRamp enabled (1) or not (0)
+    uint8_t DischargeEnabled;           // Discharge_Enable state
+    uint8_t DischargeStrength;          // DISCHG_STRENGTH_* setting
+    uint16_t OVP2ThresholdmV;           // OVP_SecondaryThreshold in mV
+    uint16_t IVPThresholdmV;            // IVP_VoltageThreshold in mV, 0 if IVP is disabled
+    // Board/operating point
+    uint16_t VinmV;                     // Input voltage in mV
+    uint16_t SourceResistance_mOhm;     // Resistance in series with the input
+    uint16_t Cout_uF;                   // Output capacitance in uF
+    uint16_t Iload_mA;                  // Load current in mA
+    uint8_t Efficiency_pct;             // Converter efficiency in %
+} DVS_PlannerInput;
+
+typedef struct{
+    uint8_t Feasible;                   // 0 if no setting keeps OVP2/IVP margins
+    uint8_t Slewrate;                   // DVS_SLEW_* setting to use
+    uint8_t ActiveDownRamp;             // Enable (1) or disable (0) active down ramp
+    uint16_t PeakmV;                    // Expected VOUT peak during the transition
+    uint16_t VinMinmV;                  // Expected input voltage sag
+    uint32_t Ramp_us;                   // Expected ramp time
+    uint32_t Wait_us;                   // Time until the next command is safe
+} DVS_Plan;
+
+// Filling of the planner input from the device registers and board defaults
+void DVS_Planner_ReadConfig(uint8_t I2CAddress, DVS_PlannerInput *Input);
+// Computation of the time optimal transition plan
+void DVS_Planner_Plan(const DVS_PlannerInput *Input, DVS_Plan *Plan);
+// Applying a plan: DVS settings (only if they change) and VOUT target
+uint32_t DVS_Planner_Apply(uint8_t I2CAddress, const DVS_PlannerInput *Input, const DVS_Plan *Plan);
+
+#endif // DVS_PLANNER_H
@@ -0,0 +1,163 @@
+//Include header file
+#include "DVSSweep.h"
+#include "LM51772.h"
+#include "i2cTransport.h"
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+/******************************************
+* @brief: Returns the slew rate of a DVS_SLEW_* setting in uV/us
+* @param Slewrate: one of the DVS_SLEW_* definitions (uint8_t)
+*******************************************/
+uint32_t DVS_SlewRate_uVus(uint8_t Slewrate){
+    switch (Slewrate & 0x30) {
+        case DVS_SLEW_40mV_us:
+            return 40000;
+        case DVS_SLEW_20mV_us:
+            return 20000;
+        case DVS_SLEW_1mV_us:
+            return 1000;
+        default:
+            return 500;
+    }
+}
+
+/******************************************
+* @brief: Computes the register code schedule of a sweep
+* @param Schedule: schedule to be filled (DVS_SweepSchedule *)
+* @param Buffer: storage for the steps (DVS_SweepStep *)
+* @param MaxSteps: capacity of Buffer (uint32_t)
+* @param StartmV: first VOUT of the sweep in mV (uint16_t)
+* @param StopmV: last VOUT of the sweep in mV, can be below StartmV (uint16_t)
+* @param StepmV: step size in mV, 0 selects it automatically (uint16_t)
+* @param Slewrate: DVS_SLEW_* setting configured on the device (uint8_t)
+* @param Period_us: time between steps in us (uint32_t)
+* @note: With StepmV = 0 every step is one code (VOUT_MV_PER_CODE),
+*        the finest staircase the output can follow. The period is at
+*        least DVS_SWEEP_MIN_PERIOD_US and is stretched to the time the
+*        output needs to ramp one step at the configured slew rate, so
+*        it can finish ramping before the next step is written.
+*        Every step is encoded with VOUT1_TARGET_Encode, the last one is
+*        clamped to StopmV. Returns 0, or -1 if Buffer is too small.
+*******************************************/
+int DVS_Sweep_Plan(DVS_SweepSchedule *Schedule, DVS_SweepStep *Buffer, uint32_t MaxSteps,
+                   uint16_t StartmV, uint16_t StopmV, uint16_t StepmV, uint8_t Slewrate, uint32_t Period_us){
+    uint32_t slew = DVS_SlewRate_uVus(Slewrate);
+    uint32_t range = (StopmV > StartmV) ? (uint32_t)(StopmV - StartmV) : (uint32_t)(StartmV - StopmV);
+    if (Period_us < DVS_SWEEP_MIN_PERIOD_US) {
+        Period_us = DVS_SWEEP_MIN_PERIOD_US;
+    }
+    uint32_t step = StepmV;
+    if (step < VOUT_MV_PER_CODE) {
+        step = VOUT_MV_PER_CODE;
+    }
+    // Leave the output time to finish ramping each step
+    uint32_t rampUs = (uint32_t)(((uint64_t)step*1000 + slew - 1)/slew);
+    if (Period_us < rampUs) {
+        Period_us = rampUs;
+    }
+    if (step > range && range > 0) {
+        step = range;
+    }
+    uint32_t count = (range + step - 1)/step + 1;
+    if (range == 0) {
+        count = 1;
+    }
+    if (count > MaxSteps) {
+        return -1;
+    }
+    for (uint32_t k = 0; k < count; ++k) {
+        uint32_t delta = k*step;
+        if (delta > range) {
+            delta = range;
+        }
+        uint16_t vout = (StopmV >= StartmV) ? (uint16_t)(StartmV + delta) : (uint16_t)(StartmV - delta);
+        uint16_t code = VOUT1_TARGET_Encode(vout);
+        Buffer[k].VoutmV = vout;
+        Buffer[k].LSB = (uint8_t)(code & 0xFF);
+        Buffer[k].MSB = (uint8_t)((code >> 8) & 0x0F);
+    }
+    Schedule->Steps = Buffer;
+    Schedule->Count = count;
+    Schedule->StepmV = (uint16_t)step;
+    Schedule->Period_us = Period_us;
+    return 0;
+}
+
+static int64_t toNs(const struct timespec *Time){
+    return (int64_t)Time->tv_sec*1000000000ll + Time->tv_nsec;
+}
+
+/******************************************
+* @brief: Executes a precomputed sweep schedule
+* @param I2CAddress: I2CAddress of the LM51772 device (uint8_t)
+* @param Schedule: schedule from DVS_Sweep_Plan (const DVS_SweepSchedule *)
+* @param Report: jitter and transfer statistics (DVS_SweepReport *)
+* @param OnStep: callback after each step, can be NULL
+* @param Context: passed to OnStep (void *)
+* @note: Step k is released at start + k*Period_us using an absolute
+*        clock_nanosleep on CLOCK_MONOTONIC, so a late step does not
+*        delay the following ones. Each step writes the precomputed
+*        LSB and MSB codes, no division and no read-back on the way.
+*        The lateness of every release against its deadline is
+*        reported as the step jitter. The sweep stops at the first
+*        write that fails, Report->Status holds its error code.
+*        Returns I2C_OK or that error code.
+*******************************************/
+int DVS_Sweep_Run(uint8_t I2CAddress, const DVS_SweepSchedule *Schedule, DVS_SweepReport *Report,
+                  void (*OnStep)(uint32_t Index, const DVS_SweepStep *Step, void *Context), void *Context){
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC,&start);
+    int64_t startNs = toNs(&start);
+    double mean = 0.0;
+    double m2 = 0.0;
+    Report->Steps = 0;
+    Report->Transfers = 0;
+    Report->Status = I2C_OK;
+    Report->MinLate_ns = INT64_MAX;
+    Report->MaxLate_ns = INT64_MIN;
+    for (uint32_t k = 0; k < Schedule->Count; ++k) {
+        // Wait for the absolute deadline of the step
+        int64_t deadlineNs = startNs + (int64_t)k*Schedule->Period_us*1000;
+        struct timespec deadline;
+        deadline.tv_sec = (time_t)(deadlineNs/1000000000ll);
+        deadline.tv_nsec = (long)(deadlineNs%1000000000ll);
+        while (clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&deadline,0) == EINTR) {
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC,&now);
+        int64_t late = toNs(&now) - deadlineNs;
+        // Write the precomputed codes
+        const DVS_SweepStep *step = &Schedule->Steps[k];
+        int status = I2C_WriteReg(I2CAddress,VOUT_TARGET1_LSB,step->LSB);
+        Report->Transfers++;
+        if (status == I2C_OK) {
+            status = I2C_WriteReg(I2CAddress,VOUT_TARGET1_MSB,step->MSB);
+            Report->Transfers++;
+        }
+        if (status < 0) {
+            fprintf(stderr, "Sweep stopped at step %u of I2C device at address 0x%02X\nERROR CODE:%d\n", k, I2CAddress, status);
+            Report->Status = status;
+            break;
+        }
+        // Running lateness statistics (Welford)
+        Report->Steps++;
+        if (late < Report->MinLate_ns) {
+            Report->MinLate_ns = late;
+        }
+        if (late > Report->MaxLate_ns) {
+            Report->MaxLate_ns = late;
+        }
+        double delta = (double)late - mean;
+        mean += delta/Report->Steps;
+        m2 += delta*((double)late - mean);
+        if (OnStep != 0) {
+            OnStep(k,step,Context);
+        }
+    }
+    Report->MeanLate_ns = mean;
+    Report->StdLate_ns = (Report->Steps > 1) ? sqrt(m2/(Report->Steps - 1)) : 0.0;
+    return Report->Status;
+}
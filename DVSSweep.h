@@ -0,0 +1,48 @@
+#include <stdint.h>
+
+#ifndef DVS_SWEEP_H
+#define DVS_SWEEP_H
+
+// Timed DVS sweep engine for the LM51772. The whole VOUT_TARGET1 code
+// schedule is computed before the sweep starts, and every step is released
+// at an absolute deadline on the monotonic clock (start + k*period), so
+// the time spent on the bus or printing does not accumulate as drift the
+// way a usleep() after every step does.
+
+// Minimum step period, enough for the two register writes of a step on a
+// 100 kHz bus plus the pigpio call overhead
+#define DVS_SWEEP_MIN_PERIOD_US         1000
+
+typedef struct{
+    uint16_t VoutmV;                    // Nominal VOUT of the step in mV
+    uint8_t LSB;                        // VOUT_TARGET1_LSB code
+    uint8_t MSB;                        // VOUT_TARGET1_MSB code
+} DVS_SweepStep;
+
+typedef struct{
+    DVS_SweepStep *Steps;               // Precomputed steps
+    uint32_t Count;                     // Amount of steps
+    uint16_t StepmV;                    // Step size in mV
+    uint32_t Period_us;                 // Time between steps in us
+} DVS_SweepSchedule;
+
+typedef struct{
+    uint32_t Steps;                     // Steps written completely
+    uint32_t Transfers;                 // Register writes issued, incl. a failed one
+    int Status;                         // I2C_OK, or the error the sweep stopped at
+    int64_t MinLate_ns;                 // Earliest release relative to its deadline
+    int64_t MaxLate_ns;                 // Latest release relative to its deadline
+    double MeanLate_ns;                 // Mean release lateness
+    double StdLate_ns;                  // Standard deviation of the lateness (jitter)
+} DVS_SweepReport;
+
+// Slew rate in uV/us of a DVS_SLEW_* setting
+uint32_t DVS_SlewRate_uVus(uint8_t Slewrate);
+// Computation of a sweep schedule into a caller provided buffer
+int DVS_Sweep_Plan(DVS_SweepSchedule *Schedule, DVS_SweepStep *Buffer, uint32_t MaxSteps,
+                   uint16_t StartmV, uint16_t StopmV, uint16_t StepmV, uint8_t Slewrate, uint32_t Period_us);
+// Execution of a schedule, OnStep (can be NULL) is called after each step
+int DVS_Sweep_Run(uint8_t I2CAddress, const DVS_SweepSchedule *Schedule, DVS_SweepReport *Report,
+                  void (*OnStep)(uint32_t Index, const DVS_SweepStep *Step, void *Context), void *Context);
+
+#endif // DVS_SWEEP_H
@@ -0,0 +1,96 @@
+//Include header file
+#include "EEPROM24Cxx.h"
+#include "i2cTransport.h"
+#include <string.h>
+
+/******************************************
+* @brief: Writes a buffer to the EEPROM using page writes
+* @param I2CAddress: I2CAddress of the EEPROM (uint8_t)
+* @param MemAddress: first memory address to be written (uint16_t)
+* @param Data: bytes to be written (const uint8_t *)
+* @param Length: amount of bytes to be written (uint16_t)
+* @note: Splits the buffer at EEPROM_PAGE_SIZE boundaries, as a write
+*        crossing a page boundary would roll over to the start of the
+*        same page. Each chunk is sent in a single transaction with the
+*        two address bytes in front, so one write cycle is needed per
+*        page. The device is ACK polled once before each page, which
+*        waits out the write cycle of the previous one.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int EEPROM_Write(uint8_t I2CAddress, uint16_t MemAddress, const uint8_t *Data, uint16_t Length){
+    // Verify that the buffer fits in the device
+    if ((uint32_t)MemAddress + Length > EEPROM_SIZE) {
+        return I2C_ERR_BUS;
+    }
+    uint8_t buff[EEPROM_PAGE_SIZE + 2];
+    while (Length > 0) {
+        // Amount of bytes left until the end of the current page
+        uint16_t chunk = EEPROM_PAGE_SIZE - (MemAddress % EEPROM_PAGE_SIZE);
+        if (chunk > Length) {
+            chunk = Length;
+        }
+        // Wait until the previous write cycle has finished
+        if (pollForDevice(I2CAddress) != 0) {
+            return I2C_ERR_TIMEOUT;
+        }
+        // Address high byte, address low byte and page data
+        buff[0] = (uint8_t)(MemAddress >> 8);
+        buff[1] = (uint8_t)(MemAddress & 0xFF);
+        memcpy(&buff[2],Data,chunk);
+        int status = I2C_WriteBlock(I2CAddress,buff,chunk + 2);
+        if (status < 0) {
+            return status;
+        }
+        MemAddress += chunk;
+        Data += chunk;
+        Length -= chunk;
+    }
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Reads a buffer from the EEPROM with a sequential read
+* @param I2CAddress: I2CAddress of the EEPROM (uint8_t)
+* @param MemAddress: first memory address to be read (uint16_t)
+* @param Data: reception buffer (uint8_t *)
+* @param Length: amount of bytes to be read (uint16_t)
+* @note: Sets the address pointer and reads the whole buffer in one
+*        transaction, the device increments the address internally.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int EEPROM_Read(uint8_t I2CAddress, uint16_t MemAddress, uint8_t *Data, uint16_t Length){
+    // Verify that the buffer fits in the device
+    if ((uint32_t)MemAddress + Length > EEPROM_SIZE) {
+        return I2C_ERR_BUS;
+    }
+    // A pending write cycle would NACK the address
+    if (pollForDevice(I2CAddress) != 0) {
+        return I2C_ERR_TIMEOUT;
+    }
+    uint8_t addr[2];
+    addr[0] = (uint8_t)(MemAddress >> 8);
+    addr[1] = (uint8_t)(MemAddress & 0xFF);
+    return I2C_WriteReadBlock(I2CAddress,addr,2,Data,Length);
+}
+
+/******************************************
+* @brief: Writes a single byte to the EEPROM
+* @param I2CAddress: I2CAddress of the EEPROM (uint8_t)
+* @param MemAddress: memory address to be written (uint16_t)
+* @param ByteData: byte to be written (uint8_t)
+* @note: Same access the test programs do, one write cycle per byte.
+*        Prefer EEPROM_Write() for anything longer than one byte.
+*******************************************/
+int EEPROM_WriteByte(uint8_t I2CAddress, uint16_t MemAddress, uint8_t ByteData){
+    return EEPROM_Write(I2CAddress,MemAddress,&ByteData,1);
+}
+
+/******************************************
+* @brief: Waits until the EEPROM finishes its write cycle
+* @param I2CAddress: I2CAddress of the EEPROM (uint8_t)
+* @note: Useful before powering down, as EEPROM_Write() returns as
+*        soon as the last page has been sent.
+*******************************************/
+int EEPROM_WaitReady(uint8_t I2CAddress){
+    return (pollForDevice(I2CAddress) == 0) ? I2C_OK : I2C_ERR_TIMEOUT;
+}
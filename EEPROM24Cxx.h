@@ -0,0 +1,28 @@
+#include <stdint.h>
+
+#ifndef EEPROM24CXX_H
+#define EEPROM24CXX_H
+
+// Page write engine for the 24Cxx configuration EEPROM. Writes are split
+// at page boundaries so a whole page is programmed per write cycle, and
+// ACK polling is only done once per page instead of once per byte.
+// It uses the block transfer functions from i2cTransport.h.
+
+// I2C addressing definitions
+#define EEPROM_I2CADDR                  0x50
+
+//-------CHANGE TO MATCH THE EEPROM PART IN USE---------//
+// Default values correspond to a 24C32 (4 kB, 32 byte pages)
+#define EEPROM_SIZE                     4096    // Size in bytes
+#define EEPROM_PAGE_SIZE                32      // Page size in bytes
+#define EEPROM_WRITE_CYCLE              5000    // Max write cycle time in us
+
+// Writing/reading of an arbitrary buffer
+int EEPROM_Write(uint8_t I2CAddress, uint16_t MemAddress, const uint8_t *Data, uint16_t Length);
+int EEPROM_Read(uint8_t I2CAddress, uint16_t MemAddress, uint8_t *Data, uint16_t Length);
+// Single byte write, one write cycle per byte
+int EEPROM_WriteByte(uint8_t I2CAddress, uint16_t MemAddress, uint8_t ByteData);
+// Waits for the last write cycle to finish
+int EEPROM_WaitReady(uint8_t I2CAddress);
+
+#endif // EEPROM24CXX_H
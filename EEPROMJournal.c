@@ -0,0 +1,219 @@
+//Include header file
+#include "EEPROMJournal.h"
+#include "i2cTransport.h"
+#include <string.h>
+
+// CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF)
+static uint16_t crc16(const uint8_t *Data, uint16_t Length){
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < Length; ++i) {
+        crc ^= (uint16_t)Data[i] << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t getSequence(const uint8_t *Record){
+    return (uint32_t)Record[0] | ((uint32_t)Record[1] << 8) |
+           ((uint32_t)Record[2] << 16) | ((uint32_t)Record[3] << 24);
+}
+
+static uint16_t slotAddress(const EEPROM_Journal *Journal, uint16_t Slot){
+    return Journal->BaseAddress + Slot*JOURNAL_SLOT_SIZE;
+}
+
+// Reads only the sequence number of a slot
+static int readSequence(EEPROM_Journal *Journal, uint16_t Slot, uint32_t *Sequence){
+    uint8_t header[4];
+    Journal->Reads++;
+    int status = EEPROM_Read(Journal->I2CAddress,slotAddress(Journal,Slot),header,4);
+    if (status < 0) {
+        return status;
+    }
+    *Sequence = getSequence(header);
+    return I2C_OK;
+}
+
+// Reads a whole slot, returns 1 if it holds a valid record, 0 if it is
+// erased or fails its CRC and a negative error code on bus errors
+static int readRecord(EEPROM_Journal *Journal, uint16_t Slot, uint8_t *Record){
+    Journal->Reads++;
+    int status = EEPROM_Read(Journal->I2CAddress,slotAddress(Journal,Slot),Record,JOURNAL_SLOT_SIZE);
+    if (status < 0) {
+        return status;
+    }
+    if (getSequence(Record) == JOURNAL_SEQ_ERASED) {
+        return 0;
+    }
+    uint16_t crc = (uint16_t)Record[JOURNAL_SLOT_SIZE - 2] | ((uint16_t)Record[JOURNAL_SLOT_SIZE - 1] << 8);
+    return crc16(Record,JOURNAL_SLOT_SIZE - 2) == crc;
+}
+
+/******************************************
+* @brief: Mounts the journal and locates the newest valid record
+* @param Journal: journal context to be filled (EEPROM_Journal *)
+* @param I2CAddress: I2CAddress of the EEPROM (uint8_t)
+* @param BaseAddress: first address of the region, page aligned (uint16_t)
+* @param Slots: number of slots (pages) in the region, at least 2 (uint16_t)
+* @note: Records are appended in slot order, so the sequence numbers
+*        from slot 0 up to the head are consecutive and every slot
+*        after the head belongs to the previous lap (or is erased).
+*        Slot 0 is read and validated, then the last slot whose
+*        sequence number equals seq0+slot is found by binary search
+*        reading only the 4 byte headers. The candidate is validated
+*        and if its CRC fails (torn write) the previous slot is used.
+*        When slot 0 itself is invalid the newest record can only be
+*        the last slot of the previous lap.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int Journal_Mount(EEPROM_Journal *Journal, uint8_t I2CAddress, uint16_t BaseAddress, uint16_t Slots){
+    // Verify that the region is page aligned and fits in the device
+    if ((BaseAddress % EEPROM_PAGE_SIZE) != 0 || Slots < 2 ||
+        (uint32_t)BaseAddress + (uint32_t)Slots*JOURNAL_SLOT_SIZE > EEPROM_SIZE) {
+        return I2C_ERR_BUS;
+    }
+    Journal->I2CAddress = I2CAddress;
+    Journal->BaseAddress = BaseAddress;
+    Journal->Slots = Slots;
+    Journal->Head = -1;
+    Journal->Sequence = 0;
+    Journal->Reads = 0;
+
+    uint8_t record[JOURNAL_SLOT_SIZE];
+    int valid = readRecord(Journal,0,record);
+    if (valid < 0) {
+        return valid;
+    }
+    if (!valid) {
+        // Either the journal is empty or the wrap-around write was torn
+        valid = readRecord(Journal,Slots - 1,record);
+        if (valid < 0) {
+            return valid;
+        }
+        if (valid) {
+            Journal->Head = Slots - 1;
+            Journal->Sequence = getSequence(record);
+        }
+        return I2C_OK;
+    }
+    uint32_t seq0 = getSequence(record);
+
+    // Binary search of the last slot continuing the sequence of slot 0
+    uint16_t low = 0;
+    uint16_t high = Slots - 1;
+    while (low < high) {
+        uint16_t mid = (uint16_t)((low + high + 1) / 2);
+        uint32_t seq;
+        int status = readSequence(Journal,mid,&seq);
+        if (status < 0) {
+            return status;
+        }
+        if (seq != JOURNAL_SEQ_ERASED && seq == seq0 + mid) {
+            low = mid;
+        }
+        else {
+            high = mid - 1;
+        }
+    }
+
+    // Validate the candidate, stepping back over a torn record
+    for (uint16_t slot = low; slot > 0; --slot) {
+        valid = readRecord(Journal,slot,record);
+        if (valid < 0) {
+            return valid;
+        }
+        if (valid && getSequence(record) == seq0 + slot) {
+            Journal->Head = slot;
+            Journal->Sequence = seq0 + slot;
+            return I2C_OK;
+        }
+    }
+    Journal->Head = 0;
+    Journal->Sequence = seq0;
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Appends a new record to the journal
+* @param Journal: mounted journal (EEPROM_Journal *)
+* @param Payload: data to be stored (const uint8_t *)
+* @param Length: size of the data, up to JOURNAL_PAYLOAD_SIZE (uint16_t)
+* @note: The record goes to the slot after the head with the next
+*        sequence number, unused payload bytes are set to 0xFF. The
+*        record is a single page so it costs one write cycle.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int Journal_Append(EEPROM_Journal *Journal, const uint8_t *Payload, uint16_t Length){
+    if (Length > JOURNAL_PAYLOAD_SIZE) {
+        return I2C_ERR_BUS;
+    }
+    uint16_t slot = (uint16_t)((Journal->Head + 1) % Journal->Slots);
+    uint32_t seq = (Journal->Head < 0) ? 0 : Journal->Sequence + 1;
+    if (seq == JOURNAL_SEQ_ERASED) {
+        // Would look like an erased slot
+        seq = 0;
+    }
+    // Build the record: sequence number, payload and CRC
+    uint8_t record[JOURNAL_SLOT_SIZE];
+    memset(record,0xFF,sizeof(record));
+    record[0] = (uint8_t)(seq & 0xFF);
+    record[1] = (uint8_t)((seq >> 8) & 0xFF);
+    record[2] = (uint8_t)((seq >> 16) & 0xFF);
+    record[3] = (uint8_t)((seq >> 24) & 0xFF);
+    memcpy(&record[4],Payload,Length);
+    uint16_t crc = crc16(record,JOURNAL_SLOT_SIZE - 2);
+    record[JOURNAL_SLOT_SIZE - 2] = (uint8_t)(crc & 0xFF);
+    record[JOURNAL_SLOT_SIZE - 1] = (uint8_t)(crc >> 8);
+
+    int status = EEPROM_Write(Journal->I2CAddress,slotAddress(Journal,slot),record,JOURNAL_SLOT_SIZE);
+    if (status < 0) {
+        return status;
+    }
+    Journal->Head = slot;
+    Journal->Sequence = seq;
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Reads the payload of the newest record
+* @param Journal: mounted journal (EEPROM_Journal *)
+* @param Payload: buffer of JOURNAL_PAYLOAD_SIZE bytes (uint8_t *)
+* @note: Returns I2C_OK, I2C_ERR_BUS if the journal is empty or the
+*        record is no longer valid, or a negative bus error code.
+*******************************************/
+int Journal_ReadLatest(EEPROM_Journal *Journal, uint8_t *Payload){
+    if (Journal->Head < 0) {
+        return I2C_ERR_BUS;
+    }
+    uint8_t record[JOURNAL_SLOT_SIZE];
+    int valid = readRecord(Journal,(uint16_t)Journal->Head,record);
+    if (valid < 0) {
+        return valid;
+    }
+    if (!valid) {
+        return I2C_ERR_BUS;
+    }
+    memcpy(Payload,&record[4],JOURNAL_PAYLOAD_SIZE);
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Erases every slot of the journal region
+* @param Journal: mounted journal (EEPROM_Journal *)
+* @note: Writes 0xFF to the whole region using page writes.
+*******************************************/
+int Journal_Format(EEPROM_Journal *Journal){
+    uint8_t erased[JOURNAL_SLOT_SIZE];
+    memset(erased,0xFF,sizeof(erased));
+    for (uint16_t slot = 0; slot < Journal->Slots; ++slot) {
+        int status = EEPROM_Write(Journal->I2CAddress,slotAddress(Journal,slot),erased,JOURNAL_SLOT_SIZE);
+        if (status < 0) {
+            return status;
+        }
+    }
+    Journal->Head = -1;
+    Journal->Sequence = 0;
+    return I2C_OK;
+}
@@ -0,0 +1,41 @@
+#include <stdint.h>
+#include "EEPROM24Cxx.h"
+
+#ifndef EEPROM_JOURNAL_H
+#define EEPROM_JOURNAL_H
+
+// Wear levelled profile storage on the 24Cxx EEPROM. Instead of rewriting
+// one fixed location, every save is appended to the next slot of a circular
+// log, so writes are spread over all the slots of the region.
+// Each slot is one EEPROM page and holds one record:
+//      [0..3]  sequence number (little endian, increments on every save)
+//      [4..n]  payload
+//      [n+1..n+2] CRC-16/CCITT of sequence number and payload
+// At startup Journal_Mount() finds the newest valid record with a binary
+// search over the sequence numbers, reading only log2(slots) headers.
+// A torn (half programmed) record fails its CRC and the previous record
+// is used instead, the next save then overwrites the torn slot.
+
+#define JOURNAL_SLOT_SIZE               EEPROM_PAGE_SIZE
+#define JOURNAL_PAYLOAD_SIZE            (JOURNAL_SLOT_SIZE - 6)
+#define JOURNAL_SEQ_ERASED              0xFFFFFFFF
+
+typedef struct{
+    uint8_t I2CAddress;                 // Address of the EEPROM
+    uint16_t BaseAddress;               // First address of the region (page aligned)
+    uint16_t Slots;                     // Number of slots in the region
+    int32_t Head;                       // Slot of the newest valid record, -1 if empty
+    uint32_t Sequence;                  // Sequence number of the newest record
+    uint32_t Reads;                     // EEPROM read transactions done by the journal
+} EEPROM_Journal;
+
+// Mounting of the journal, locating the newest valid record
+int Journal_Mount(EEPROM_Journal *Journal, uint8_t I2CAddress, uint16_t BaseAddress, uint16_t Slots);
+// Appending of a new record (Length <= JOURNAL_PAYLOAD_SIZE)
+int Journal_Append(EEPROM_Journal *Journal, const uint8_t *Payload, uint16_t Length);
+// Reading of the newest record payload
+int Journal_ReadLatest(EEPROM_Journal *Journal, uint8_t *Payload);
+// Erasing of the region (every slot set to 0xFF)
+int Journal_Format(EEPROM_Journal *Journal);
+
+#endif // EEPROM_JOURNAL_H
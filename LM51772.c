@@ -1,5 +1,6 @@
 //Include header file
 #include "LM51772.h"
+#include "i2cTrace.h"
 #include <stdio.h>
 
 /******************************************
@@ -9,6 +10,7 @@
 *        this clearing all faults stated on the STATUS_BYTE register.
 *******************************************/
 void ClearFaults(uint8_t I2CAddress){
+    TRACE_API();
     // Write 0x00 to the CLEAR_FAULTS register
     I2C_WriteRegByte(I2CAddress,CLEAR_FAULTS,0x00);
 }
@@ -27,12 +29,10 @@ void ClearFaults(uint8_t I2CAddress){
 *        1mOhm onwards with thsi function.
 *******************************************/
 void setILIM_THRESHOLD(uint8_t I2CAddress, uint16_t ILIMmAmps){
+    TRACE_API();
     // Ensure the input value is inside the 500 to 7000 mA range.
-    if (ILIMmAmps >= 500 && ILIMmAmps <= 7000){
-        // Convert from float to equivalent value
-        // ILIM_THRESHOLD = (ILIMmAmps*RSENSE)/500
-        uint8_t ilimValue;
-        ilimValue = (uint8_t)((ILIMmAmps*R_SENSE)/(500));
+    if (ILIMmAmps >= ILIM_MIN_MA && ILIMmAmps <= ILIM_MAX_MA){
+        uint8_t ilimValue = ILIM_THRESHOLD_Encode(ILIMmAmps);
         // Write the equivalent value to the ILIM_THRESHOLD register
         float ILIMAmps = ILIMmAmps/1000.0;
         printf("Now writing 0x%X in the ILIM_THRESHOLD register to get a %.2f A current limit\n",ilimValue,ILIMAmps);
@@ -40,6 +40,43 @@ void setILIM_THRESHOLD(uint8_t I2CAddress, uint16_t ILIMmAmps){
     }
 }
 
+/******************************************
+* @brief: Converts a current limit in mA to the ILIM_THRESHOLD code
+* @param ILIMmAmps: current limit in mA (uint16_t)
+* @note: ILIM_THRESHOLD = (ILIMmAmps*R_SENSE)/500 with the R_SENSE
+*        define on the LM51772.h file. Only meant for the ILIM_MIN_MA
+*        to ILIM_MAX_MA range setILIM_THRESHOLD accepts.
+*******************************************/
+uint8_t ILIM_THRESHOLD_Encode(uint16_t ILIMmAmps){
+    return (uint8_t)((ILIMmAmps*R_SENSE)/500);
+}
+
+/******************************************
+* @brief: Converts a VOUT in mV to the VOUT_TARGET1 register code
+* @param Vout: VOUT to be reached in mV (uint16_t)
+* @note: Uses the FB divider configuration selected with the
+*        FB_DIVIDER_CONFIG define on the LM51772.h file. Kept apart
+*        from setVOUT1_TARGET so schedules can be encoded up front.
+*******************************************/
+uint16_t VOUT1_TARGET_Encode(uint16_t Vout){
+    #if FB_DIVIDER_CONFIG == FB_INTERNAL20
+        // When the internal FB divider is set to 20 then:
+        // VoutTarget = Vout/20
+        uint16_t VoutTarget = Vout/20;
+    #elif FB_DIVIDER_CONFIG == FB_INTERNAL10
+        // When the internal FB divider is set to 20 then:
+        // VoutTarget = Vout/10
+        uint16_t VoutTarget = Vout/10;
+    #elif FB_DIVIDER_CONFIG == FB_EXTERNAL
+        // When the FB divider is set with external resistors
+        // VoutTarget = Vout*(Rbot/(Rbot+Rtop))
+        uint16_t VoutTarget = Vout*(Rbot/(Rbot+Rtop));
+    #else
+        #error "FB_DIVIDER_CONFIG not defined"
+    #endif
+    return VoutTarget;
+}
+
 /******************************************
 * @brief: Sets the VOUT1_TARGET MSB and LSB registers
 * @param I2CAddress: I2CAddress of the LM51772 device (uint8_t)
@@ -61,21 +98,8 @@ void setILIM_THRESHOLD(uint8_t I2CAddress, uint16_t ILIMmAmps){
 *        the LM51772.h file as Rbot and Rtop respectively.
 *******************************************/
 void setVOUT1_TARGET(uint8_t I2CAddress, uint16_t Vout){
-    #if FB_DIVIDER_CONFIG == FB_INTERNAL20
-        // When the internal FB divider is set to 20 then:
-        // VoutTarget = Vout/20
-        uint16_t VoutTarget = Vout/20;
-    #elif FB_DIVIDER_CONFIG == FB_INTERNAL10
-        // When the internal FB divider is set to 20 then:
-        // VoutTarget = Vout/10
-        uint16_t VoutTarget = Vout/10;
-    #elif FB_DIVIDER_CONFIG == FB_EXTERNAL
-        // When the FB divider is set with external resistors
-        // VoutTarget = Vout*(Rbot/(Rbot+Rtop))
-        uint16_t VoutTarget = Vout*(Rbot/(Rbot+Rtop));
-    #else
-        #error "FB_DIVIDER_CONFIG not defined"
-    #endif
+    TRACE_API();
+    uint16_t VoutTarget = VOUT1_TARGET_Encode(Vout);
     // Separate VoutTarget on two separate bytes
     uint8_t VoutTargetMSB,VoutTargetLSB;
     VoutTargetLSB = (uint8_t)(VoutTarget & 0xFF);
@@ -94,6 +118,7 @@ void setVOUT1_TARGET(uint8_t I2CAddress, uint16_t Vout){
 *        divider configuration gives the output voltage target.
 *******************************************/
 uint16_t getVOUT1_TARGET(uint8_t I2CAddress){
+    TRACE_API();
     // Read LSB register
     uint8_t VoutTargetLSB;
     VoutTargetLSB = I2C_ReadRegByte(I2CAddress,VOUT_TARGET1_LSB);
@@ -117,6 +142,7 @@ uint16_t getVOUT1_TARGET(uint8_t I2CAddress){
 *        path.
 *******************************************/
 void ForceDischargeEnable(uint8_t I2CAddress){
+    TRACE_API();
     // Read USB_PD_CONTROL_0 register current value
     uint8_t Reg = USB_PD_CONTROL_0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -132,6 +158,7 @@ void ForceDischargeEnable(uint8_t I2CAddress){
 *        path.
 *******************************************/
 void ForceDischargeDisable(uint8_t I2CAddress){
+    TRACE_API();
     // Read USB_PD_CONTROL_0 register current value
     uint8_t Reg = USB_PD_CONTROL_0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -147,6 +174,7 @@ void ForceDischargeDisable(uint8_t I2CAddress){
 *        enabling switching in the power stage.
 *******************************************/
 void EnablePowerStage(uint8_t I2CAddress){
+    TRACE_API();
     // Read USB_PD_CONTROL_0 register current value
     uint8_t Reg = USB_PD_CONTROL_0;
     int8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -167,6 +195,7 @@ void EnablePowerStage(uint8_t I2CAddress){
 *        disabling switching in the power stage.
 *******************************************/
 void DisablePowerStage(uint8_t I2CAddress){
+    TRACE_API();
     // Read USB_PD_CONTROL_0 register current value
     uint8_t Reg = USB_PD_CONTROL_0;
     int8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -187,6 +216,7 @@ void DisablePowerStage(uint8_t I2CAddress){
 *        on the bit number 6.
 *******************************************/
 uint8_t get_USBPD_STATUS(uint8_t I2CAddress){
+    TRACE_API();
     // Prepare the read opearation
     uint8_t USBPDSTATUS;
     // Read the contents of the USB_PD_STATUS_0 byte
@@ -211,11 +241,12 @@ uint8_t get_USBPD_STATUS(uint8_t I2CAddress){
 *           - OTHER (bit 0): any other fault not mentioned above
 *******************************************/
 uint8_t get_STATUS_BYTE(uint8_t I2CAddress){
+    TRACE_API();
     // Prepare the read opearation
     uint8_t STATUS;
-    // Read the contents of the USB_PD_STATUS_0 byte
-    STATUS = (I2CAddress,STATUS_BYTE);
-    // Return the contents of the USB_PD_STATUS_0 byte
+    // Read the contents of the STATUS_BYTE register
+    STATUS = I2C_ReadRegByte(I2CAddress,STATUS_BYTE);
+    // Return the contents of the STATUS_BYTE register
     return STATUS;
 }
 
@@ -237,6 +268,7 @@ uint8_t get_STATUS_BYTE(uint8_t I2CAddress){
 *           - FLT_BUSY       
 *******************************************/
 void ClearFaultFlag(uint8_t I2CAddress,uint8_t FaultFlag){
+    TRACE_API();
     // Read STATUS_BYTE register current value
     uint8_t Reg = STATUS_BYTE;
     // Clear the desired fault flag/flags
@@ -251,6 +283,7 @@ void ClearFaultFlag(uint8_t I2CAddress,uint8_t FaultFlag){
 *        sleep mode.
 *******************************************/
 void uSleep_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -266,6 +299,7 @@ void uSleep_Enable(uint8_t I2CAddress){
 *        sleep mode.
 *******************************************/
 void uSleep_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -281,6 +315,7 @@ void uSleep_Disable(uint8_t I2CAddress){
 *        spread spectrum switching feature.
 *******************************************/
 void DRSS_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -296,6 +331,7 @@ void DRSS_Enable(uint8_t I2CAddress){
 *        spread spectrum switching feature.
 *******************************************/
 void DRSS_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -311,6 +347,7 @@ void DRSS_Disable(uint8_t I2CAddress){
 *        in hiccup short circuit mode.
 *******************************************/
 void HiccupProtection_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -326,6 +363,7 @@ void HiccupProtection_Enable(uint8_t I2CAddress){
 *        in cycle-by-cycle current limiting mode.
 *******************************************/
 void HiccupProtection_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -341,6 +379,7 @@ void HiccupProtection_Disable(uint8_t I2CAddress){
 *        circuit to work as a current limiter.
 *******************************************/
 void CurrentLimiter_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -356,6 +395,7 @@ void CurrentLimiter_Enable(uint8_t I2CAddress){
 *        circuit to work as a current monitor.
 *******************************************/
 void CurrentLimiter_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -371,6 +411,7 @@ void CurrentLimiter_Disable(uint8_t I2CAddress){
 *        LDO for VCC1 supply.
 *******************************************/
 void Vcc1LDO_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -386,6 +427,7 @@ void Vcc1LDO_Enable(uint8_t I2CAddress){
 *        LDO for VCC1 supply.
 *******************************************/
 void Vcc1LDO_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -401,6 +443,7 @@ void Vcc1LDO_Disable(uint8_t I2CAddress){
 *        limiting functionality.
 *******************************************/
 void NegativeCurrentLimiting_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -416,6 +459,7 @@ void NegativeCurrentLimiting_Enable(uint8_t I2CAddress){
 *        limiting functionality. Here ILIM clamps positive.
 **************D*****************************/
 void NegativeCurrentLimiting_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D0 current value
     uint8_t Reg = MFR_SPECIFIC_D0;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -431,6 +475,7 @@ void NegativeCurrentLimiting_Disable(uint8_t I2CAddress){
 *        switching in PSM mode.
 *******************************************/
 void PSM_2PhaseBB_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -446,6 +491,7 @@ void PSM_2PhaseBB_Enable(uint8_t I2CAddress){
 *        switching in PSM mode.
 *******************************************/
 void PSM_2PhaseBB_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -461,6 +507,7 @@ void PSM_2PhaseBB_Disable(uint8_t I2CAddress){
 *        switching in fPWM mode.
 *******************************************/
 void FPWM_2PhaseBB_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -476,6 +523,7 @@ void FPWM_2PhaseBB_Enable(uint8_t I2CAddress){
 *        switching in fPWM mode.
 *******************************************/
 void FPWM_2PhaseBB_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -492,6 +540,7 @@ void FPWM_2PhaseBB_Disable(uint8_t I2CAddress){
 *        overriding VSMART selection.
 *******************************************/
 void ForceBias_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -508,6 +557,7 @@ void ForceBias_Enable(uint8_t I2CAddress){
 *        taking VSMART selection instead.
 *******************************************/
 void ForceBias_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -523,6 +573,7 @@ void ForceBias_Disable(uint8_t I2CAddress){
 *        on DTRK mode without waiting for DTRK PWM signal.
 *******************************************/
 void DTRK_DirectStartup_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -538,6 +589,7 @@ void DTRK_DirectStartup_Enable(uint8_t I2CAddress){
 *        on DTRK and waiting for the DTRK PWM signal on startup.
 *******************************************/
 void DTRK_DirectStartup_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -553,6 +605,7 @@ void DTRK_DirectStartup_Disable(uint8_t I2CAddress){
 *        work as an interrupt pin.
 *******************************************/
 void nFLT_as_INT_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -568,6 +621,7 @@ void nFLT_as_INT_Enable(uint8_t I2CAddress){
 *        act as an indicator of faults.
 *******************************************/
 void nFLT_as_INT_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -584,10 +638,11 @@ void nFLT_as_INT_Disable(uint8_t I2CAddress){
 *        to one of four different values:
 *           - THW_THRESHOLD_140degC
 *           - THW_THRESHOLD_125degC
-*           - THW_THRESHOLD_140degC
-*           - THW_THRESHOLD_140degC
+*           - THW_THRESHOLD_110degC
+*           - THW_THRESHOLD_95degC
 *******************************************/
 void ThermalWarning_ThresholdConfigure(uint8_t I2CAddress,uint8_t Threshold){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = (I2C_ReadRegByte(I2CAddress,Reg)&0x9F);
@@ -602,6 +657,7 @@ void ThermalWarning_ThresholdConfigure(uint8_t I2CAddress,uint8_t Threshold){
 *        MFR_SPECIFIC_D1 register, hence enabling Thermal Warning.
 *******************************************/
 void ThermalWarning_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -616,6 +672,7 @@ void ThermalWarning_Enable(uint8_t I2CAddress){
 *        MFR_SPECIFIC_D1 register, hence disabling Thermal Warning.
 *******************************************/
 void ThermalWarning_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D1 current value
     uint8_t Reg = MFR_SPECIFIC_D1;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -631,6 +688,7 @@ void ThermalWarning_Disable(uint8_t I2CAddress){
 *        discharge is reached.
 *******************************************/
 void Discharge_VTH_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -646,6 +704,7 @@ void Discharge_VTH_Enable(uint8_t I2CAddress){
 *        discharge is reached.
 *******************************************/
 void Discharge_VTH_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -661,6 +720,7 @@ void Discharge_VTH_Disable(uint8_t I2CAddress){
 *        CONV_EN.
 *******************************************/
 void Discharge_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -676,6 +736,7 @@ void Discharge_Enable(uint8_t I2CAddress){
 *        CONV_EN.
 *******************************************/
 void Discharge_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -695,6 +756,7 @@ void Discharge_Disable(uint8_t I2CAddress){
 *           - DISCHG_STRENGTH_75mA
 *******************************************/
 void Dishcarge_StrengthConfigure(uint8_t I2CAddress,uint8_t Strength){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xF3;
@@ -715,6 +777,7 @@ void Dishcarge_StrengthConfigure(uint8_t I2CAddress,uint8_t Strength){
 *           - DVS_SLEW_0_5mV_us
 *******************************************/
 void DVS_SlewrateConfigure(uint8_t I2CAddress, uint8_t Slewrate){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xCF;
@@ -730,6 +793,7 @@ void DVS_SlewrateConfigure(uint8_t I2CAddress, uint8_t Slewrate){
 *        on DVS using the discharge.
 *******************************************/
 void DVS_ActiveDownRamp_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -745,6 +809,7 @@ void DVS_ActiveDownRamp_Enable(uint8_t I2CAddress){
 *        on DVS.
 *******************************************/
 void DVS_ActiveDownRamp_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D2 current value
     uint8_t Reg = MFR_SPECIFIC_D2;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -763,6 +828,7 @@ void DVS_ActiveDownRamp_Disable(uint8_t I2CAddress){
 *        won't be modified.
 *******************************************/
 void VDET_FallingThresholdConfigure(uint8_t I2CAddress,uint16_t Threshold){
+    TRACE_API();
     // Verify if the threshold is between 2700 and 8900
     if((Threshold>=2700)&&(Threshold<=8900)){
         // Read MFR_SPECIFIC_D3 current value
@@ -785,6 +851,7 @@ void VDET_FallingThresholdConfigure(uint8_t I2CAddress,uint16_t Threshold){
 *   	 UVLO comparator.
 *******************************************/
 void VDET_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D3 current value
     uint8_t Reg = MFR_SPECIFIC_D3;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -800,6 +867,7 @@ void VDET_Enable(uint8_t I2CAddress){
 *   	 UVLO comparator.
 *******************************************/
 void VDET_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D3 current value
     uint8_t Reg = MFR_SPECIFIC_D3;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -817,6 +885,7 @@ void VDET_Disable(uint8_t I2CAddress){
 *        first activate IVP through the IVP_Enable() function.
 *******************************************/
 void IVP_InputVoltageRegulation_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D3 current value
     uint8_t Reg = MFR_SPECIFIC_D3;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -832,6 +901,7 @@ void IVP_InputVoltageRegulation_Enable(uint8_t I2CAddress){
 *        Regulation when IVP is enabled.
 *******************************************/
 void IVP_InputVoltageRegulation_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D3 current value
     uint8_t Reg = MFR_SPECIFIC_D3;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -847,6 +917,7 @@ void IVP_InputVoltageRegulation_Disable(uint8_t I2CAddress){
 *        Protection.
 *******************************************/
 void IVP_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D3 current value
     uint8_t Reg = MFR_SPECIFIC_D3;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -862,6 +933,7 @@ void IVP_Enable(uint8_t I2CAddress){
 *        Protection.
 *******************************************/
 void IVP_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D3 current value
     uint8_t Reg = MFR_SPECIFIC_D3;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -880,6 +952,7 @@ void IVP_Disable(uint8_t I2CAddress){
 *        won't be modified.
 *******************************************/
 void VDET_RisingThresholdConfigure(uint8_t I2CAddress,uint16_t Threshold){
+    TRACE_API();
     // Verify if the threshold is between 2800 and 9000
     if((Threshold>=2800)&&(Threshold<=9000)){
         uint8_t Reg = MFR_SPECIFIC_D4;
@@ -903,6 +976,7 @@ void VDET_RisingThresholdConfigure(uint8_t I2CAddress,uint16_t Threshold){
 *        won't be modified.
 *******************************************/
 void OVP_SecondaryThreshold_Configure(uint8_t I2CAddress,uint16_t Threshold){
+    TRACE_API();
     // Verify if the threshold is between 4000 and 55000
     if((Threshold>=4000)&&(Threshold<=55000)){
         uint8_t Reg = MFR_SPECIFIC_D5;
@@ -941,6 +1015,7 @@ void OVP_SecondaryThreshold_Configure(uint8_t I2CAddress,uint16_t Threshold){
 *           - BB_MINTIME_SCALE_1_5x 
 *******************************************/
 void BB_MinTimeScale_Select(uint8_t I2CAddress,uint8_t Scale){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D6;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xFC;
     // Masked write of the scale value selected to MFR_SPECIFIC_D6
@@ -960,6 +1035,7 @@ void BB_MinTimeScale_Select(uint8_t I2CAddress,uint8_t Scale){
 *           - GDRV_MINDEADTIME_60ns
 *******************************************/
 void GDRV_MinDeadTime_Select(uint8_t I2CAddress,uint8_t DeadTime){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D6;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xF3;
     // Masked write of the scale value selected to MFR_SPECIFIC_D6
@@ -974,6 +1050,7 @@ void GDRV_MinDeadTime_Select(uint8_t I2CAddress,uint8_t DeadTime){
 *        dead-time scaling on the Gate Driver.
 *******************************************/
 void GDRV_DeadTimeScaling_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D6 current value
     uint8_t Reg = MFR_SPECIFIC_D6;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -989,6 +1066,7 @@ void GDRV_DeadTimeScaling_Enable(uint8_t I2CAddress){
 *        dead-time scaling on the Gate Driver.
 *******************************************/
 void GDRV_DeadTimeScaling_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D6 current value
     uint8_t Reg = MFR_SPECIFIC_D6;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1005,6 +1083,7 @@ void GDRV_DeadTimeScaling_Disable(uint8_t I2CAddress){
 *        the dead-time.
 *******************************************/
 void GDRV_ForceConstantDeadTime_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D6 current value
     uint8_t Reg = MFR_SPECIFIC_D6;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1021,6 +1100,7 @@ void GDRV_ForceConstantDeadTime_Enable(uint8_t I2CAddress){
 *        of the dead-time is enabled.
 *******************************************/
 void GDRV_ForceConstantDeadTime_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D6 current value
     uint8_t Reg = MFR_SPECIFIC_D6;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1041,6 +1121,7 @@ void GDRV_ForceConstantDeadTime_Disable(uint8_t I2CAddress){
 *           - OSC_SYNC_OUTPUT_FALLING
 *******************************************/
 void OSC_FreqSyncConfigure(uint8_t I2CAddress,uint8_t SyncFunction){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D6;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0x3F;
     // Masked write of the scale value selected to MFR_SPECIFIC_D6
@@ -1073,6 +1154,7 @@ void OSC_FreqSyncConfigure(uint8_t I2CAddress,uint8_t SyncFunction){
 *           - SLOPECOMP_CORRECTION_5_0  
 *******************************************/
 void SlopeComp_CorrectionFactor_Select(uint8_t I2CAddress,uint8_t CorrectionFactor){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D7;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xF0;
     // Masked write of the scale value selected to MFR_SPECIFIC_D7
@@ -1093,6 +1175,7 @@ void SlopeComp_CorrectionFactor_Select(uint8_t I2CAddress,uint8_t CorrectionFact
 *           - INDUC_DERATE_40     
 *******************************************/
 void SlopeComp_InductorDerating_Select(uint8_t I2CAddress,uint8_t InductorDerating){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D7;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xCF;
     // Masked write of the scale value selected to MFR_SPECIFIC_D7
@@ -1112,6 +1195,7 @@ void SlopeComp_InductorDerating_Select(uint8_t I2CAddress,uint8_t InductorDerati
 *           - DRV1_SUP_VCC2     
 *******************************************/
 void DRV1_Supply_Configure(uint8_t I2CAddress,uint8_t DRV1Config){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D8;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xFC;
     // Masked write of the scale value selected to MFR_SPECIFIC_D8
@@ -1131,6 +1215,7 @@ void DRV1_Supply_Configure(uint8_t I2CAddress,uint8_t DRV1Config){
 *           - DRV1_SEQ_FORCE_OFF        
 *******************************************/
 void DRV1_Sequence_Configure(uint8_t I2CAddress,uint8_t DRV1Sequence){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D8;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xF3;
     // Masked write of the scale value selected to MFR_SPECIFIC_D8
@@ -1151,6 +1236,7 @@ void DRV1_Sequence_Configure(uint8_t I2CAddress,uint8_t DRV1Sequence){
 *           - CDC_GAIN_2_000V
 *******************************************/
 void CDC_GainVoltage_Select(uint8_t I2CAddress,uint8_t GainVoltage){
+    TRACE_API();
     uint8_t Reg = MFR_SPECIFIC_D8;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg)&0xCF;
     // Masked write of the scale value selected to MFR_SPECIFIC_D8
@@ -1165,6 +1251,7 @@ void CDC_GainVoltage_Select(uint8_t I2CAddress,uint8_t GainVoltage){
 *        compensation (CDC) feature.
 *******************************************/
 void CDC_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D8 current value
     uint8_t Reg = MFR_SPECIFIC_D8;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1180,6 +1267,7 @@ void CDC_Enable(uint8_t I2CAddress){
 *        compensation (CDC) feature.
 *******************************************/
 void CDC_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D8 current value
     uint8_t Reg = MFR_SPECIFIC_D8;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1195,6 +1283,7 @@ void CDC_Disable(uint8_t I2CAddress){
 *        FB divider of ratio 20.
 *******************************************/
 void LM51772_FB_Divider_Sel20(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D8 current value
     uint8_t Reg = MFR_SPECIFIC_D8;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1210,6 +1299,7 @@ void LM51772_FB_Divider_Sel20(uint8_t I2CAddress){
 *        FB divider of ratio 10.
 *******************************************/
 void LM51772_FB_Divider_Sel10(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D8 current value
     uint8_t Reg = MFR_SPECIFIC_D8;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1229,6 +1319,7 @@ void LM51772_FB_Divider_Sel10(uint8_t I2CAddress){
 *        is done to avoid floating point operations.
 *******************************************/
 void PCM_LowerVoltageWindow_Configure(uint8_t I2CAddress,uint16_t LowerWindow){
+    TRACE_API();
     // Verify if the LowerWindow is between 0 and 775
     if((LowerWindow>=0)&&(LowerWindow<=775)){
         uint8_t Reg = MFR_SPECIFIC_D9;
@@ -1252,6 +1343,7 @@ void PCM_LowerVoltageWindow_Configure(uint8_t I2CAddress,uint16_t LowerWindow){
 *        Vout one wants to place the lower window of PCM on.
 *******************************************/
 void PCM_LowerVoltageWindow_ConfigureF(uint8_t I2CAddress,float LowerWindow){
+    TRACE_API();
     // Verify if the LowerWindow is between 0 and 77.5
     if((LowerWindow>=0)&&(LowerWindow<=77.5)){
         uint8_t Reg = MFR_SPECIFIC_D9;
@@ -1272,6 +1364,7 @@ void PCM_LowerVoltageWindow_ConfigureF(uint8_t I2CAddress,float LowerWindow){
 *        to be used as the current limit input over the ILIM DAC.
 *******************************************/
 void OCP_ISET_OverILIM_Enable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D9 current value
     uint8_t Reg = MFR_SPECIFIC_D9;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1287,6 +1380,7 @@ void OCP_ISET_OverILIM_Enable(uint8_t I2CAddress){
 *        to be used as the current limit input over the ILIM DAC.
 *******************************************/
 void OCP_ISET_OverILIM_Disable(uint8_t I2CAddress){
+    TRACE_API();
     // Read MFR_SPECIFIC_D9 current value
     uint8_t Reg = MFR_SPECIFIC_D9;
     uint8_t regContent = I2C_ReadRegByte(I2CAddress,Reg);
@@ -1300,30 +1394,40 @@ void OCP_ISET_OverILIM_Disable(uint8_t I2CAddress){
 * @param Threshold: threshold voltage for IVP given in mV (uint16_t)
 * @note: writes the IVP_VOLTAGE register, setting the threshold
 *   	 for IVP functionality. The value provided on the Threshold
-*        parameter must be between 4750 and 55000 mV otherwise the register
-*        won't be modified.
+*        parameter must be between 4750 and 50000 mV otherwise the register
+*        won't be modified (50000 mV is code 255, the top of the register).
+*        Codes 0-150 are 4750-23500 mV in 125 mV steps and codes 151-255
+*        are 24000-50000 mV in 250 mV steps, thresholds in between are
+*        rounded down (23501-23999 mV to code 150, 23500 mV).
 *******************************************/
 void IVP_VoltageThreshold_Configure(uint8_t I2CAddress,uint16_t Threshold){
-    // Verify if the threshold is between 4750 and 55000
-    if((Threshold>=4750)&&(Threshold<=55000)){
+    TRACE_API();
+    // Verify if the threshold is between 4750 and 50000
+    if((Threshold>=4750)&&(Threshold<=50000)){
         uint8_t Reg = IVP_VOLTAGE;
         uint8_t IVP;
-        if(Threshold<24000){
-            // Calculate the value to be written on the 5:0 bits
-            // When Threshold < 16000mV
-            // IVP_VOLTAGE=(Threshold-4750mV)/250mV
+        if(Threshold<=23500){
+            // Calculate the value to be written on the register
+            // When Threshold <= 23500mV
+            // IVP_VOLTAGE=(Threshold-4750mV)/125mV
             IVP = (uint8_t)((Threshold-4750)/125);
             // Write the IVP_VOLTAGE register
             I2C_WriteRegByte(I2CAddress,Reg,IVP);
         }
+        else if(Threshold<24000){
+            // No code between 23500mV (150) and 24000mV (151), round down
+            IVP = 150;
+            // Write the IVP_VOLTAGE register
+            I2C_WriteRegByte(I2CAddress,Reg,IVP);
+        }
         else{
-            // Calculate the value to be written on the 5:0 bits
-            // When Threshold > 24000mV
+            // Calculate the value to be written on the register
+            // When Threshold >= 24000mV
             // IVP_VOLTAGE=151+(Threshold-24000mV)/250mV
             IVP = (uint8_t)(151+(Threshold-24000)/250);
             // Write the IVP_VOLTAGE register
             I2C_WriteRegByte(I2CAddress,Reg,IVP);
         }
     }
-    // If threshold is not between 4750 and 55000, do nothing
+    // If threshold is not between 4750 and 50000, do nothing
 }
@@ -1,5 +1,7 @@
 #include <stdint.h>
-//To use this library, you need to provide the following external functions, which are the functions that the SC8815 library needs to use
+//To use this library, you need to provide the following external functions,
+//which are the functions that the LM51772 library needs to use
+//(i2cTransport.h supplies them on top of any bus backend)
 extern void I2C_WriteRegByte(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData);   //Write a byte to the device register via I2C
 extern uint8_t I2C_ReadRegByte(uint8_t SlaveAddress, uint8_t RegAddress);                   //Read a byte from the device register via I2C
 extern void SoftwareDelay(uint8_t ms);                                                      //Software delay in milliseconds
@@ -35,6 +37,9 @@ extern void SoftwareDelay(uint8_t ms);
 #define ILIM_THRESHOLD_HBOUND           0x8C // Values from 0x8C onwards set a 70mV threshold
 // Rsense value used in the application
 #define R_SENSE                         10 // Value in mOhms
+// Current limit range accepted by setILIM_THRESHOLD
+#define ILIM_MIN_MA                     500
+#define ILIM_MAX_MA                     7000
 
 // LM51772 - VOUT Aux definitions
 #define VOUT_MSB_RMASK                  0x07
@@ -50,6 +55,18 @@ extern void SoftwareDelay(uint8_t ms);
 #define Rbot                            1000 // Value in Ohms
 #define Rtop                            1000 // Value in Ohms
 #endif
+// Output voltage step of one VOUT_TARGET1 code, in mV
+#if FB_DIVIDER_CONFIG == FB_INTERNAL20
+#define VOUT_MV_PER_CODE                20
+#elif FB_DIVIDER_CONFIG == FB_INTERNAL10
+#define VOUT_MV_PER_CODE                10
+#else
+#define VOUT_MV_PER_CODE                ((Rbot+Rtop)/Rbot)
+#endif
+// Supported VOUT range in mV: 3.3 V to 48 V, at most what the 12 bit
+// VOUT_TARGET1 code reaches with the FB divider configuration
+#define VOUT_MIN_MV                     3300
+#define VOUT_MAX_MV                     ((0x0FFF*VOUT_MV_PER_CODE < 48000) ? 0x0FFF*VOUT_MV_PER_CODE : 48000)
 
 // LM51772 - STATUS_BYTE auxiliary definitions
 // Fault/Interrupt flags
@@ -144,10 +161,14 @@ void ClearFaults(uint8_t I2CAddress);
 
 // Functions for ILIM_THRESHOLD modifications
 void setILIM_THRESHOLD(uint8_t I2CAddress, uint16_t ILIMmAmps);
+// Conversion of a current limit in mA to the ILIM_THRESHOLD register code
+uint8_t ILIM_THRESHOLD_Encode(uint16_t ILIMmAmps);
 // Functions for VOUT_TARGET1 registers
 // Setting of the VOUT target
 void setVOUT1_TARGET(uint8_t I2CAddress, uint16_t Vout);
 uint16_t getVOUT1_TARGET(uint8_t I2CAddress);
+// Conversion of a VOUT in mV to the VOUT_TARGET1 register code
+uint16_t VOUT1_TARGET_Encode(uint16_t Vout);
 
 // Functions for the USB_PD_CONTROL_0 register
 // Functions for enabling/disabling discharge functionality
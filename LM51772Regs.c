@@ -0,0 +1,109 @@
+//Include header file
+#include "LM51772Regs.h"
+#include "LM51772.h"
+
+// Register map, sorted by address
+const LM51772_RegisterDesc LM51772_Registers[] = {
+    {CLEAR_FAULTS,      REG_CMD,                "CLEAR_FAULTS",     0},
+    {ILIM_THRESHOLD,    REG_RW,                 "ILIM_THRESHOLD",   0},
+    {VOUT_TARGET1_LSB,  REG_RW,                 "VOUT_TARGET1_LSB", 0},
+    {VOUT_TARGET1_MSB,  REG_RW,                 "VOUT_TARGET1_MSB", 0},
+    {USB_PD_STATUS_0,   REG_RO|REG_VOLATILE,    "USB_PD_STATUS_0",  0},
+    {STATUS_BYTE,       REG_W1C|REG_VOLATILE,   "STATUS_BYTE",      0},
+    {USB_PD_CONTROL_0,  REG_RW,                 "USB_PD_CONTROL_0", 0},
+    {MFR_SPECIFIC_D0,   REG_RW,                 "MFR_SPECIFIC_D0",  0},
+    {MFR_SPECIFIC_D1,   REG_RW,                 "MFR_SPECIFIC_D1",  0},
+    {MFR_SPECIFIC_D2,   REG_RW,                 "MFR_SPECIFIC_D2",  0},
+    {MFR_SPECIFIC_D3,   REG_RW,                 "MFR_SPECIFIC_D3",  0},
+    {MFR_SPECIFIC_D4,   REG_RW,                 "MFR_SPECIFIC_D4",  0},
+    {MFR_SPECIFIC_D5,   REG_RW,                 "MFR_SPECIFIC_D5",  0},
+    {MFR_SPECIFIC_D6,   REG_RW,                 "MFR_SPECIFIC_D6",  0},
+    {MFR_SPECIFIC_D7,   REG_RW,                 "MFR_SPECIFIC_D7",  0},
+    {MFR_SPECIFIC_D8,   REG_RW,                 "MFR_SPECIFIC_D8",  0},
+    {MFR_SPECIFIC_D9,   REG_RW,                 "MFR_SPECIFIC_D9",  0},
+    {IVP_VOLTAGE,       REG_RW,                 "IVP_VOLTAGE",      0},
+};
+const uint8_t LM51772_RegisterCount = sizeof(LM51772_Registers)/sizeof(LM51772_Registers[0]);
+
+// Bit fields of every register
+const LM51772_FieldDesc LM51772_Fields[] = {
+    {ILIM_THRESHOLD,    0xFF,   "ILIM_THRESHOLD"},
+    {VOUT_TARGET1_LSB,  0xFF,   "VOUT_TARGET1_LSB"},
+    {VOUT_TARGET1_MSB,  0x0F,   "VOUT_TARGET1_MSB"},
+    {USB_PD_STATUS_0,   0x40,   "CC"},
+    {STATUS_BYTE,       FLT_OTHER,          "OTHER"},
+    {STATUS_BYTE,       FLT_CML,            "CML"},
+    {STATUS_BYTE,       FLT_TEMPERATURE,    "TEMPERATURE"},
+    {STATUS_BYTE,       FLT_IVP,            "INPUT"},
+    {STATUS_BYTE,       FLT_OCP,            "IOUT"},
+    {STATUS_BYTE,       FLT_OVP,            "VOUT"},
+    {STATUS_BYTE,       FLT_OFF,            "OFF"},
+    {STATUS_BYTE,       FLT_BUSY,           "BUSY"},
+    {USB_PD_CONTROL_0,  0x01,   "CONV_EN"},
+    {USB_PD_CONTROL_0,  0x02,   "FORCE_DISCHG"},
+    {MFR_SPECIFIC_D0,   0x01,   "CONV_EN"},
+    {MFR_SPECIFIC_D0,   0x02,   "USLEEP_EN"},
+    {MFR_SPECIFIC_D0,   0x04,   "DRSS_EN"},
+    {MFR_SPECIFIC_D0,   0x08,   "HICCUP_EN"},
+    {MFR_SPECIFIC_D0,   0x10,   "IMON_LIMITER_EN"},
+    {MFR_SPECIFIC_D0,   0x20,   "EN_VCC1"},
+    {MFR_SPECIFIC_D0,   0x40,   "EN_NEG_CL_LIMIT"},
+    {MFR_SPECIFIC_D1,   0x01,   "EN_BB_2P_PSM"},
+    {MFR_SPECIFIC_D1,   0x02,   "EN_BB_2P_FPWM"},
+    {MFR_SPECIFIC_D1,   0x04,   "FORCE_BIASPIN"},
+    {MFR_SPECIFIC_D1,   0x08,   "EN_DTRK_STARTOVER"},
+    {MFR_SPECIFIC_D1,   0x10,   "EN_NINT"},
+    {MFR_SPECIFIC_D1,   0x60,   "THW_THRESHOLD"},
+    {MFR_SPECIFIC_D1,   0x80,   "EN_THER_WARN"},
+    {MFR_SPECIFIC_D2,   0x01,   "DISCHARGE_CONFIG0"},
+    {MFR_SPECIFIC_D2,   0x02,   "DISCHARGE_CONFIG1"},
+    {MFR_SPECIFIC_D2,   0x0C,   "DISCHG_STRENGTH"},
+    {MFR_SPECIFIC_D2,   0x30,   "DVS_SLEW_RAMP"},
+    {MFR_SPECIFIC_D2,   0x40,   "EN_ACTIVE_DVS"},
+    {MFR_SPECIFIC_D3,   0x1F,   "VDET_FALL"},
+    {MFR_SPECIFIC_D3,   0x20,   "VDET_EN"},
+    {MFR_SPECIFIC_D3,   0x40,   "SEL_IVR"},
+    {MFR_SPECIFIC_D3,   0x80,   "EN_IVP"},
+    {MFR_SPECIFIC_D4,   0x1F,   "VDET_RISE"},
+    {MFR_SPECIFIC_D5,   0x3F,   "V_OVP2"},
+    {MFR_SPECIFIC_D6,   0x03,   "BB_MINTIME_SCALE"},
+    {MFR_SPECIFIC_D6,   0x0C,   "GDRV_MIN_DEADTIME"},
+    {MFR_SPECIFIC_D6,   0x10,   "SEL_SCALE_DT"},
+    {MFR_SPECIFIC_D6,   0x20,   "EN_CONTS_TDEAD"},
+    {MFR_SPECIFIC_D6,   0xC0,   "OSC_SYNC"},
+    {MFR_SPECIFIC_D7,   0x0F,   "SLOPECOMP_CORRECTION"},
+    {MFR_SPECIFIC_D7,   0x30,   "INDUC_DERATE"},
+    {MFR_SPECIFIC_D8,   0x03,   "DRV1_SUPPLY"},
+    {MFR_SPECIFIC_D8,   0x0C,   "DRV1_SEQUENCE"},
+    {MFR_SPECIFIC_D8,   0x30,   "CDC_GAIN"},
+    {MFR_SPECIFIC_D8,   0x40,   "EN_CDC"},
+    {MFR_SPECIFIC_D8,   0x80,   "SEL_FB_DIV20"},
+    {MFR_SPECIFIC_D9,   0x1F,   "PCM_WINDOW_LOW"},
+    {MFR_SPECIFIC_D9,   0x20,   "SEL_ISET_PIN"},
+    {IVP_VOLTAGE,       0xFF,   "IVP_VOLTAGE"},
+};
+const uint8_t LM51772_FieldCount = sizeof(LM51772_Fields)/sizeof(LM51772_Fields[0]);
+
+const ChipMap LM51772_Map = {
+    "LM51772",
+    LM51772_Registers, sizeof(LM51772_Registers)/sizeof(LM51772_Registers[0]),
+    LM51772_Fields, sizeof(LM51772_Fields)/sizeof(LM51772_Fields[0]),
+};
+
+/******************************************
+* @brief: Looks up the descriptor of a register
+* @param Reg: register address (uint8_t)
+* @note: Returns NULL if the register is not in the map.
+*******************************************/
+const LM51772_RegisterDesc *LM51772_FindRegister(uint8_t Reg){
+    return Chip_FindRegister(&LM51772_Map,Reg);
+}
+
+/******************************************
+* @brief: Returns the name of a register
+* @param Reg: register address (uint8_t)
+*******************************************/
+const char *LM51772_RegisterName(uint8_t Reg){
+    const LM51772_RegisterDesc *desc = LM51772_FindRegister(Reg);
+    return (desc != 0) ? desc->Name : "UNKNOWN";
+}
@@ -0,0 +1,27 @@
+#include <stdint.h>
+#include "chipMap.h"
+
+#ifndef LM51772_REGS_H
+#define LM51772_REGS_H
+
+// Register and field descriptor tables of the LM51772. They describe the
+// register map as data (address, access type, name and bit fields) so
+// generic code (read-back verification, caches, test models) does not
+// need to know about every configuration function. The same tables are
+// available as a generic ChipMap (chipMap.h) for the register engine.
+
+typedef Chip_RegisterDesc LM51772_RegisterDesc;
+typedef Chip_FieldDesc LM51772_FieldDesc;
+
+extern const LM51772_RegisterDesc LM51772_Registers[];
+extern const uint8_t LM51772_RegisterCount;
+extern const LM51772_FieldDesc LM51772_Fields[];
+extern const uint8_t LM51772_FieldCount;
+extern const ChipMap LM51772_Map;
+
+// Looking up a register descriptor, NULL if the register is unknown
+const LM51772_RegisterDesc *LM51772_FindRegister(uint8_t Reg);
+// Name of a register, "UNKNOWN" if the register is unknown
+const char *LM51772_RegisterName(uint8_t Reg);
+
+#endif // LM51772_REGS_H
@@ -0,0 +1,191 @@
+//Include header file
+#include "LM51772Sync.h"
+#include "LM51772.h"
+#include <stdio.h>
+
+/******************************************
+* @brief: Initializes a group of paralleled LM51772
+* @param Group: group to be initialized (LM51772_SyncGroup *)
+* @param Addresses: I2C addresses of the members (const uint8_t *)
+* @param Count: amount of members, up to LM51772_SYNC_MAX_DEVICES (uint8_t)
+* @note: The targets are staged as code 0, stage every member before
+*        the first commit. Returns I2C_OK or LM51772_SYNC_ERR_ARG.
+*******************************************/
+int LM51772_Sync_Init(LM51772_SyncGroup *Group, const uint8_t *Addresses, uint8_t Count){
+    if (Count > LM51772_SYNC_MAX_DEVICES) {
+        fprintf(stderr, "A synchronized group takes up to %d devices, not %u\n", LM51772_SYNC_MAX_DEVICES, Count);
+        return LM51772_SYNC_ERR_ARG;
+    }
+    Group->Count = Count;
+    for (uint8_t i = 0; i < Count; ++i) {
+        Group->Addresses[i] = Addresses[i];
+        Group->Frames[i][0] = VOUT_TARGET1_LSB;
+        Group->Frames[i][1] = 0;
+        Group->Frames[i][2] = 0;
+    }
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Stages the VOUT of one member
+* @param Group: group of paralleled devices (LM51772_SyncGroup *)
+* @param Index: member in the order of LM51772_Sync_Init (uint8_t)
+* @param Vout: VOUT to be reached in mV (uint16_t)
+* @note: Encoded with VOUT1_TARGET_Encode, nothing goes to the bus
+*        until LM51772_Sync_Commit(). A VOUT out of the VOUT_MIN_MV to
+*        VOUT_MAX_MV range is rejected with LM51772_SYNC_ERR_ARG.
+*******************************************/
+int LM51772_Sync_Stage(LM51772_SyncGroup *Group, uint8_t Index, uint16_t Vout){
+    if (Index >= Group->Count || Vout < VOUT_MIN_MV || Vout > VOUT_MAX_MV) {
+        return LM51772_SYNC_ERR_ARG;
+    }
+    uint16_t code = VOUT1_TARGET_Encode(Vout);
+    // VOUT_TARGET1_MSB follows VOUT_TARGET1_LSB, the pointer auto-increments
+    Group->Frames[Index][1] = (uint8_t)(code & 0xFF);
+    Group->Frames[Index][2] = (uint8_t)(code >> 8);
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Writes the staged targets of every member
+* @param Group: group of paralleled devices (const LM51772_SyncGroup *)
+* @param Report: skew of the update, can be NULL (LM51772_SyncReport *)
+* @note: One message per member with both VOUT_TARGET1 registers, so
+*        no member ever runs on half a code, and all messages in one
+*        combined transaction. If the transport cannot combine them
+*        every member is a transaction of its own and the report says
+*        so (Combined = 0). A member that does not acknowledge aborts
+*        the update, the ones before it already have the new target.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int LM51772_Sync_Commit(const LM51772_SyncGroup *Group, LM51772_SyncReport *Report){
+    I2C_Message messages[LM51772_SYNC_MAX_DEVICES];
+    for (uint8_t i = 0; i < Group->Count; ++i) {
+        messages[i].SlaveAddress = Group->Addresses[i];
+        messages[i].Flags = 0;
+        messages[i].Length = 3;
+        messages[i].Data = (uint8_t *)Group->Frames[i];
+    }
+    int combined = I2C_HasTransfer();
+    int status = I2C_Transfer(messages,Group->Count);
+    if (status < 0) {
+        fprintf(stderr, "Synchronized VOUT update of %u devices failed\nERROR CODE:%d\n", Group->Count, status);
+    }
+    if (Report != 0) {
+        uint32_t perDevice = combined ? LM51772_SYNC_MESSAGE_BITS : LM51772_SYNC_MESSAGE_BITS + 1;
+        Report->Combined = (uint8_t)combined;
+        Report->SkewBits = (Group->Count > 1) ? perDevice*(uint32_t)(Group->Count - 1) : 0;
+    }
+    return status;
+}
+
+/******************************************
+* @brief: Sets the same VOUT on every member at once
+* @param Group: group of paralleled devices (LM51772_SyncGroup *)
+* @param Vout: VOUT to be reached in mV (uint16_t)
+* @param Report: skew of the update, can be NULL (LM51772_SyncReport *)
+* @note: See LM51772_Sync_Commit(). Nothing is written if the VOUT
+*        is out of range (LM51772_SYNC_ERR_ARG).
+*******************************************/
+int LM51772_Sync_SetVout(LM51772_SyncGroup *Group, uint16_t Vout, LM51772_SyncReport *Report){
+    for (uint8_t i = 0; i < Group->Count; ++i) {
+        int status = LM51772_Sync_Stage(Group,i,Vout);
+        if (status < 0) {
+            return status;
+        }
+    }
+    return LM51772_Sync_Commit(Group,Report);
+}
+
+/******************************************
+* @brief: Clears the faults of every member
+* @param Group: group of paralleled devices (const LM51772_SyncGroup *)
+* @note: CLEAR_FAULTS as one group command, see ClearFaults().
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int LM51772_Sync_ClearFaults(const LM51772_SyncGroup *Group){
+    I2C_GroupWrite writes[LM51772_SYNC_MAX_DEVICES];
+    for (uint8_t i = 0; i < Group->Count; ++i) {
+        writes[i].SlaveAddress = Group->Addresses[i];
+        writes[i].Command = CLEAR_FAULTS;
+        writes[i].Length = 1;
+        writes[i].Data[0] = 0x00;
+    }
+    int status = I2C_GroupCommand(writes,Group->Count);
+    if (status < 0) {
+        fprintf(stderr, "Group CLEAR_FAULTS of %u devices failed\nERROR CODE:%d\n", Group->Count, status);
+    }
+    return status;
+}
+
+// Reads one register of every member, write-read pairs of as many
+// members as fit in one combined transaction
+static int readAll(const LM51772_SyncGroup *Group, uint8_t Reg, uint8_t *Values){
+    I2C_Message messages[I2C_MAX_MESSAGES];
+    uint8_t reg = Reg;
+    for (uint8_t first = 0; first < Group->Count; first += I2C_MAX_MESSAGES/2) {
+        uint16_t count = 0;
+        for (uint8_t i = first; i < Group->Count && count < I2C_MAX_MESSAGES; ++i) {
+            messages[count++] = (I2C_Message){Group->Addresses[i], 0, 1, &reg};
+            messages[count++] = (I2C_Message){Group->Addresses[i], I2C_MSG_READ, 1, &Values[i]};
+        }
+        int status = I2C_Transfer(messages,count);
+        if (status < 0) {
+            fprintf(stderr, "Failed to read register 0x%02X of the group\nERROR CODE:%d\n", Reg, status);
+            return status;
+        }
+    }
+    return I2C_OK;
+}
+
+// Sets or clears CONV_EN (bit 0) of a register in every member, the new
+// values go out as one group command
+static int groupConvEn(const LM51772_SyncGroup *Group, uint8_t Reg, int Enable){
+    uint8_t values[LM51772_SYNC_MAX_DEVICES];
+    int status = readAll(Group,Reg,values);
+    if (status < 0) {
+        return status;
+    }
+    I2C_GroupWrite writes[LM51772_SYNC_MAX_DEVICES];
+    for (uint8_t i = 0; i < Group->Count; ++i) {
+        writes[i].SlaveAddress = Group->Addresses[i];
+        writes[i].Command = Reg;
+        writes[i].Length = 1;
+        writes[i].Data[0] = Enable ? (uint8_t)(values[i] | 0x01) : (uint8_t)(values[i] & 0xFE);
+    }
+    status = I2C_GroupCommand(writes,Group->Count);
+    if (status < 0) {
+        fprintf(stderr, "Group write of register 0x%02X of %u devices failed\nERROR CODE:%d\n", Reg, Group->Count, status);
+    }
+    return status;
+}
+
+/******************************************
+* @brief: Enables the power stage of every member
+* @param Group: group of paralleled devices (const LM51772_SyncGroup *)
+* @note: CONV_EN of USB_PD_CONTROL_0, then of MFR_SPECIFIC_D0, each
+*        as one group command (see EnablePowerStage()). Returns I2C_OK
+*        or a negative error code.
+*******************************************/
+int LM51772_Sync_EnablePowerStage(const LM51772_SyncGroup *Group){
+    int status = groupConvEn(Group,USB_PD_CONTROL_0,1);
+    if (status < 0) {
+        return status;
+    }
+    return groupConvEn(Group,MFR_SPECIFIC_D0,1);
+}
+
+/******************************************
+* @brief: Disables the power stage of every member
+* @param Group: group of paralleled devices (const LM51772_SyncGroup *)
+* @note: CONV_EN of USB_PD_CONTROL_0, then of MFR_SPECIFIC_D0, each
+*        as one group command (see DisablePowerStage()). Returns I2C_OK
+*        or a negative error code.
+*******************************************/
+int LM51772_Sync_DisablePowerStage(const LM51772_SyncGroup *Group){
+    int status = groupConvEn(Group,USB_PD_CONTROL_0,0);
+    if (status < 0) {
+        return status;
+    }
+    return groupConvEn(Group,MFR_SPECIFIC_D0,0);
+}
@@ -0,0 +1,54 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef LM51772_SYNC_H
+#define LM51772_SYNC_H
+
+// Synchronized VOUT change of paralleled LM51772 (same output, oscillators
+// synchronized with OSC_FreqSyncConfigure). Two setVOUT1_TARGET calls in a
+// row leave the converters on different targets for four transactions,
+// plus whatever the host does in between, and circulating current flows
+// meanwhile. Here the codes of every member are encoded (staged) before
+// the bus is touched, then each member gets both VOUT_TARGET1 registers in
+// one message and all messages go out back-to-back in one combined
+// transaction (I2C_Transfer): nothing else can get on the bus in between
+// and the skew is only the bus time of the messages.
+// Commands for the whole group (clearing faults, power stage on/off) are
+// PMBus group commands (I2C_GroupCommand): one transaction with a single
+// STOP, at which every member executes its command.
+
+// Status code besides the I2C_* codes of i2cTransport.h
+#define LM51772_SYNC_ERR_ARG            -8  // Too many members or VOUT out of range
+
+#define LM51772_SYNC_MAX_DEVICES        I2C_MAX_MESSAGES
+// Bus time of one member in a combined transaction: repeated start,
+// address, register pointer and both registers (9 SCL periods per byte)
+#define LM51772_SYNC_MESSAGE_BITS       (1 + 4*9)
+
+typedef struct{
+    uint8_t Count;                                      // Members
+    uint8_t Addresses[LM51772_SYNC_MAX_DEVICES];        // 7 bit addresses
+    uint8_t Frames[LM51772_SYNC_MAX_DEVICES][3];        // Staged VOUT_TARGET1_LSB write
+} LM51772_SyncGroup;
+
+typedef struct{
+    uint8_t Combined;                   // 1 if the writes were one transaction
+    uint32_t SkewBits;                  // SCL periods from the first to the last member
+                                        // taking its target, host time not included
+                                        // when not Combined
+} LM51772_SyncReport;
+
+// Initialization of a group, every member staged with code 0
+int LM51772_Sync_Init(LM51772_SyncGroup *Group, const uint8_t *Addresses, uint8_t Count);
+// Staging of the VOUT (mV) of one member, no bus access
+int LM51772_Sync_Stage(LM51772_SyncGroup *Group, uint8_t Index, uint16_t Vout);
+// Writing the staged targets of every member, Report can be NULL
+int LM51772_Sync_Commit(const LM51772_SyncGroup *Group, LM51772_SyncReport *Report);
+// Staging the same VOUT for every member and committing it
+int LM51772_Sync_SetVout(LM51772_SyncGroup *Group, uint16_t Vout, LM51772_SyncReport *Report);
+// Group commands
+int LM51772_Sync_ClearFaults(const LM51772_SyncGroup *Group);
+int LM51772_Sync_EnablePowerStage(const LM51772_SyncGroup *Group);
+int LM51772_Sync_DisablePowerStage(const LM51772_SyncGroup *Group);
+
+#endif // LM51772_SYNC_H
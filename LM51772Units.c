@@ -0,0 +1,92 @@
+//Include header file
+#include "LM51772Units.h"
+#include "LM51772Regs.h"
+#include "LM51772.h"
+
+/******************************************
+* @brief: Initializes an engine device for an LM51772
+* @param Device: device context (RegEngine_Device *)
+* @param I2CAddress: I2CAddress of the LM51772 device (uint8_t)
+*******************************************/
+void LM51772Units_Init(RegEngine_Device *Device, uint8_t I2CAddress){
+    RegEngine_Init(Device,&LM51772_Map,I2CAddress);
+}
+
+/******************************************
+* @brief: Sets the VOUT target
+* @param Device: LM51772 device (RegEngine_Device *)
+* @param Vout: VOUT to be reached in mV (uint16_t)
+* @note: Encoded with VOUT1_TARGET_Encode, so it follows the
+*        FB_DIVIDER_CONFIG of LM51772.h. A VOUT out of the VOUT_MIN_MV
+*        to VOUT_MAX_MV range is rejected with REG_ERR_FIELD and
+*        nothing is written.
+*******************************************/
+int LM51772Units_SetVout(RegEngine_Device *Device, uint16_t Vout){
+    if (Vout < VOUT_MIN_MV || Vout > VOUT_MAX_MV) {
+        return REG_ERR_FIELD;
+    }
+    uint16_t code = VOUT1_TARGET_Encode(Vout);
+    RegEngine_FieldValue values[2] = {
+        {RegEngine_Field(Device,VOUT_TARGET1_LSB,"VOUT_TARGET1_LSB"), (uint8_t)(code & 0xFF)},
+        {RegEngine_Field(Device,VOUT_TARGET1_MSB,"VOUT_TARGET1_MSB"), (uint8_t)(code >> 8)},
+    };
+    return RegEngine_WriteFields(Device,values,2);
+}
+
+/******************************************
+* @brief: Gets the VOUT_TARGET1 code
+* @param Device: LM51772 device (RegEngine_Device *)
+* @param Code: 12 bit code of both registers (uint16_t *)
+*******************************************/
+int LM51772Units_GetVoutCode(RegEngine_Device *Device, uint16_t *Code){
+    RegEngine_FieldValue values[2] = {
+        {RegEngine_Field(Device,VOUT_TARGET1_LSB,"VOUT_TARGET1_LSB"), 0},
+        {RegEngine_Field(Device,VOUT_TARGET1_MSB,"VOUT_TARGET1_MSB"), 0},
+    };
+    int status = RegEngine_ReadFields(Device,values,2);
+    *Code = (uint16_t)((values[1].Value << 8) | values[0].Value);
+    return status;
+}
+
+/******************************************
+* @brief: Sets the current limit
+* @param Device: LM51772 device (RegEngine_Device *)
+* @param ILIMmAmps: current limit in mA, 500 to 7000 (uint16_t)
+* @note: Encoded with ILIM_THRESHOLD_Encode, so it follows R_SENSE
+*        of LM51772.h. Values out of the ILIM_MIN_MA to ILIM_MAX_MA
+*        range of setILIM_THRESHOLD return REG_ERR_FIELD and write
+*        nothing.
+*******************************************/
+int LM51772Units_SetIlim(RegEngine_Device *Device, uint16_t ILIMmAmps){
+    if (ILIMmAmps < ILIM_MIN_MA || ILIMmAmps > ILIM_MAX_MA) {
+        return REG_ERR_FIELD;
+    }
+    uint8_t code = ILIM_THRESHOLD_Encode(ILIMmAmps);
+    return RegEngine_WriteField(Device,RegEngine_Field(Device,ILIM_THRESHOLD,"ILIM_THRESHOLD"),code);
+}
+
+static int setPowerStage(RegEngine_Device *Device, uint8_t On){
+    RegEngine_FieldValue values[2] = {
+        {RegEngine_Field(Device,USB_PD_CONTROL_0,"CONV_EN"), On},
+        {RegEngine_Field(Device,MFR_SPECIFIC_D0,"CONV_EN"), On},
+    };
+    return RegEngine_WriteFields(Device,values,2);
+}
+
+/******************************************
+* @brief: Enables the power stage
+* @param Device: LM51772 device (RegEngine_Device *)
+* @note: Sets CONV_EN in USB_PD_CONTROL_0 and MFR_SPECIFIC_D0, as
+*        EnablePowerStage does.
+*******************************************/
+int LM51772Units_EnablePowerStage(RegEngine_Device *Device){
+    return setPowerStage(Device,1);
+}
+
+/******************************************
+* @brief: Disables the power stage
+* @param Device: LM51772 device (RegEngine_Device *)
+*******************************************/
+int LM51772Units_DisablePowerStage(RegEngine_Device *Device){
+    return setPowerStage(Device,0);
+}
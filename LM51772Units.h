@@ -0,0 +1,24 @@
+#include <stdint.h>
+#include "regEngine.h"
+
+#ifndef LM51772_UNITS_H
+#define LM51772_UNITS_H
+
+// LM51772 on the register engine: unit conversions to field values of
+// LM51772_Map, the I/O is done by regEngine.c. The encoders and ranges
+// are the ones of LM51772.c (VOUT1_TARGET_Encode, ILIM_THRESHOLD_Encode),
+// which keeps the functions taking an I2C address for existing programs.
+
+// Initialization of an engine device for an LM51772
+void LM51772Units_Init(RegEngine_Device *Device, uint8_t I2CAddress);
+// VOUT target in mV, both VOUT_TARGET1 registers in one block write
+int LM51772Units_SetVout(RegEngine_Device *Device, uint16_t Vout);
+// Current VOUT_TARGET1 code
+int LM51772Units_GetVoutCode(RegEngine_Device *Device, uint16_t *Code);
+// Current limit in mA, ILIM_MIN_MA to ILIM_MAX_MA
+int LM51772Units_SetIlim(RegEngine_Device *Device, uint16_t ILIMmAmps);
+// CONV_EN of USB_PD_CONTROL_0 and MFR_SPECIFIC_D0
+int LM51772Units_EnablePowerStage(RegEngine_Device *Device);
+int LM51772Units_DisablePowerStage(RegEngine_Device *Device);
+
+#endif // LM51772_UNITS_H
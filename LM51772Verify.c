@@ -0,0 +1,180 @@
+//Include header file
+#include "LM51772Verify.h"
+#include "LM51772Regs.h"
+#include "i2cTransport.h"
+
+typedef struct{
+    uint8_t I2CAddress;
+    uint8_t Reg;
+    uint8_t Expected;
+} VerifyEntry;
+
+// Writes recorded during the current batch
+static VerifyEntry Entries[VERIFY_MAX_ENTRIES];
+static int EntryCount = 0;
+// Sampling schedule
+static uint32_t SampleEvery = 1;
+static uint32_t BatchCounter = 0;
+static int Recording = 0;
+static Verify_Stats Stats;
+
+// Bits of a register covered by a known field, reserved bits are ignored
+static uint8_t verifiedMask(uint8_t Reg){
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < LM51772_FieldCount; ++i) {
+        if (LM51772_Fields[i].Reg == Reg) {
+            mask |= LM51772_Fields[i].Mask;
+        }
+    }
+    return mask;
+}
+
+// Write observer installed while a sampled batch is open
+static void recordWrite(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData){
+    // Commands, read only and write-1-to-clear registers cannot be read back
+    const LM51772_RegisterDesc *desc = LM51772_FindRegister(RegAddress);
+    if (desc == 0 || !(desc->Flags & REG_RW)) {
+        return;
+    }
+    // The last value written to a register is the expected one
+    for (int i = 0; i < EntryCount; ++i) {
+        if (Entries[i].I2CAddress == SlaveAddress && Entries[i].Reg == RegAddress) {
+            Entries[i].Expected = ByteData;
+            return;
+        }
+    }
+    if (EntryCount >= VERIFY_MAX_ENTRIES) {
+        Stats.Dropped++;
+        return;
+    }
+    // Keep the entries sorted by device and register
+    int pos = EntryCount;
+    while (pos > 0 && (Entries[pos - 1].I2CAddress > SlaveAddress ||
+           (Entries[pos - 1].I2CAddress == SlaveAddress && Entries[pos - 1].Reg > RegAddress))) {
+        Entries[pos] = Entries[pos - 1];
+        pos--;
+    }
+    Entries[pos].I2CAddress = SlaveAddress;
+    Entries[pos].Reg = RegAddress;
+    Entries[pos].Expected = ByteData;
+    EntryCount++;
+}
+
+/******************************************
+* @brief: Sets the sampling schedule of the verification
+* @param EveryN: verify one batch out of EveryN (uint32_t)
+* @note: 1 verifies every batch, 0 disables the verification. The
+*        batches that are not sampled cost nothing, their writes are
+*        not even recorded.
+*******************************************/
+void Verify_SetSampling(uint32_t EveryN){
+    SampleEvery = EveryN;
+    BatchCounter = 0;
+}
+
+/******************************************
+* @brief: Starts a batch of writes to be verified
+* @note: Installs the write observer if the batch is sampled.
+*******************************************/
+void Verify_BeginBatch(void){
+    EntryCount = 0;
+    Recording = (SampleEvery != 0) && (BatchCounter % SampleEvery == 0);
+    BatchCounter++;
+    if (Recording) {
+        I2C_SetWriteHook(recordWrite);
+    }
+}
+
+/******************************************
+* @brief: Ends a batch and verifies the recorded writes
+* @param Mismatches: array receiving the mismatches, can be NULL (Verify_Mismatch *)
+* @param MaxMismatches: capacity of Mismatches (int)
+* @note: The recorded registers of each device are grouped in runs
+*        where consecutive registers are at most VERIFY_MAX_GAP apart,
+*        and every run is read back with a single block read. Only
+*        the bits covered by a known field are compared.
+*        Returns the number of mismatching registers (also those that
+*        did not fit in Mismatches) or a negative error code.
+*******************************************/
+int Verify_EndBatch(Verify_Mismatch *Mismatches, int MaxMismatches){
+    Stats.Batches++;
+    if (!Recording) {
+        return 0;
+    }
+    I2C_SetWriteHook(0);
+    Recording = 0;
+    Stats.BatchesVerified++;
+    int found = 0;
+    int first = 0;
+    while (first < EntryCount) {
+        // Extend the run while the next register is close enough
+        int last = first;
+        while (last + 1 < EntryCount &&
+               Entries[last + 1].I2CAddress == Entries[first].I2CAddress &&
+               Entries[last + 1].Reg - Entries[last].Reg <= VERIFY_MAX_GAP + 1 &&
+               Entries[last + 1].Reg - Entries[first].Reg < VERIFY_MAX_BLOCK) {
+            last++;
+        }
+        uint8_t block[VERIFY_MAX_BLOCK];
+        uint8_t start = Entries[first].Reg;
+        uint16_t length = (uint16_t)(Entries[last].Reg - start + 1);
+        int status = I2C_ReadRegBlock(Entries[first].I2CAddress,start,block,length);
+        Stats.BlockReads++;
+        if (status < 0) {
+            EntryCount = 0;
+            return status;
+        }
+        for (int i = first; i <= last; ++i) {
+            uint8_t actual = block[Entries[i].Reg - start];
+            uint8_t mask = verifiedMask(Entries[i].Reg);
+            Stats.Registers++;
+            if (((actual ^ Entries[i].Expected) & mask) != 0) {
+                if (Mismatches != 0 && found < MaxMismatches) {
+                    Mismatches[found].I2CAddress = Entries[i].I2CAddress;
+                    Mismatches[found].Reg = Entries[i].Reg;
+                    Mismatches[found].Expected = Entries[i].Expected;
+                    Mismatches[found].Actual = actual;
+                }
+                found++;
+            }
+        }
+        first = last + 1;
+    }
+    Stats.Mismatches += found;
+    EntryCount = 0;
+    return found;
+}
+
+/******************************************
+* @brief: Prints a mismatch with register and field names
+* @param Stream: output stream (FILE *)
+* @param Mismatch: mismatch to be printed (const Verify_Mismatch *)
+* @note: Prints the register line followed by one line per field
+*        whose value differs, field values are shifted to bit 0.
+*******************************************/
+void Verify_Report(FILE *Stream, const Verify_Mismatch *Mismatch){
+    fprintf(Stream, "Device 0x%02X %s (0x%02X): expected 0x%02X, read 0x%02X\n",
+            Mismatch->I2CAddress, LM51772_RegisterName(Mismatch->Reg), Mismatch->Reg,
+            Mismatch->Expected, Mismatch->Actual);
+    for (uint8_t i = 0; i < LM51772_FieldCount; ++i) {
+        const LM51772_FieldDesc *field = &LM51772_Fields[i];
+        if (field->Reg != Mismatch->Reg || ((Mismatch->Expected ^ Mismatch->Actual) & field->Mask) == 0) {
+            continue;
+        }
+        // Shift of the lowest bit of the field
+        int shift = 0;
+        while (((field->Mask >> shift) & 0x01) == 0) {
+            shift++;
+        }
+        fprintf(Stream, "    %s: expected 0x%X, read 0x%X\n", field->Name,
+                (Mismatch->Expected & field->Mask) >> shift, (Mismatch->Actual & field->Mask) >> shift);
+    }
+}
+
+/******************************************
+* @brief: Copies the verification statistics
+* @param StatsOut: destination (Verify_Stats *)
+*******************************************/
+void Verify_GetStats(Verify_Stats *StatsOut){
+    *StatsOut = Stats;
+}
@@ -0,0 +1,45 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef LM51772_VERIFY_H
+#define LM51772_VERIFY_H
+
+// Batched read-back verification. Instead of reading every register back
+// right after writing it, the expected values of a batch of writes are
+// recorded and checked at the end of the batch with block reads (one per
+// run of neighbouring registers of a device). Verification can also be
+// sampled, checking only one batch out of N.
+// It observes the writes done through I2C_WriteRegByte of i2cTransport.c.
+
+#define VERIFY_MAX_ENTRIES              64      // Registers recorded per batch
+#define VERIFY_MAX_GAP                  2       // Unwritten registers a block read may span
+#define VERIFY_MAX_BLOCK                32      // Maximum registers per block read
+
+typedef struct{
+    uint8_t I2CAddress;                 // Device address
+    uint8_t Reg;                        // Register address
+    uint8_t Expected;                   // Last value written during the batch
+    uint8_t Actual;                     // Value read back
+} Verify_Mismatch;
+
+typedef struct{
+    uint32_t Batches;                   // Batches ended
+    uint32_t BatchesVerified;           // Batches actually verified (sampling)
+    uint32_t Registers;                 // Registers verified
+    uint32_t BlockReads;                // Block reads issued
+    uint32_t Mismatches;                // Mismatching registers found
+    uint32_t Dropped;                   // Writes not recorded, batch full
+} Verify_Stats;
+
+// Verifying one batch out of EveryN (1 verifies all, 0 disables verification)
+void Verify_SetSampling(uint32_t EveryN);
+// Starting a batch, writes are recorded until Verify_EndBatch()
+void Verify_BeginBatch(void);
+// Ending a batch, returns the number of mismatches or a negative error code
+int Verify_EndBatch(Verify_Mismatch *Mismatches, int MaxMismatches);
+// Printing a mismatch with register and field names
+void Verify_Report(FILE *Stream, const Verify_Mismatch *Mismatch);
+// Reading of the statistics
+void Verify_GetStats(Verify_Stats *StatsOut);
+
+#endif // LM51772_VERIFY_H
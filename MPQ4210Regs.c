@@ -0,0 +1,36 @@
+//Include header file
+#include "MPQ4210Regs.h"
+
+// Register map, sorted by address
+static const Chip_RegisterDesc registers[] = {
+    {MPQREG_REF_LSB,    REG_RW,                 "REF_LSB",          0},
+    {MPQREG_REF_MSB,    REG_RW,                 "REF_MSB",          0},
+    {MPQREG_CONTROL1,   REG_RW,                 "CONTROL1",         MPQ_CONTROL1_GO_BIT},
+    {MPQREG_CONTROL2,   REG_RW,                 "CONTROL2",         0},
+    {MPQREG_ILIM,       REG_RW,                 "ILIM",             0},
+    {MPQREG_INT_STATUS, REG_W1C|REG_VOLATILE,   "INT_STATUS",       0},
+    {MPQREG_INT_MASK,   REG_RW,                 "INT_MASK",         0},
+};
+
+// Bit fields of every register
+static const Chip_FieldDesc fields[] = {
+    {MPQREG_REF_LSB,    0x07,   "VREF_L"},
+    {MPQREG_REF_MSB,    0xFF,   "VREF_H"},
+    {MPQREG_CONTROL1,   0x80,   "EN"},
+    {MPQREG_CONTROL1,   0x40,   "DISCHG_EN"},
+    {MPQREG_CONTROL1,   0x30,   "SR"},
+    {MPQREG_CONTROL1,   0x08,   "DITHER"},
+    {MPQREG_CONTROL1,   0x04,   "PNG_LATCH"},
+    {MPQREG_CONTROL1,   0x02,   "GO_BIT"},
+    {MPQREG_CONTROL2,   0xC0,   "FSW"},
+    {MPQREG_CONTROL2,   0x20,   "BB_FSW"},
+    {MPQREG_ILIM,       0x0F,   "ILIM"},
+    {MPQREG_INT_STATUS, 0xFF,   "INT_STATUS"},
+    {MPQREG_INT_MASK,   0xFF,   "INT_MASK"},
+};
+
+const ChipMap MPQ4210_Map = {
+    "MPQ4210",
+    registers, sizeof(registers)/sizeof(registers[0]),
+    fields, sizeof(fields)/sizeof(fields[0]),
+};
@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include "chipMap.h"
+
+#ifndef MPQ4210_REGS_H
+#define MPQ4210_REGS_H
+
+// Register map of the MPQ4210/MPQ4214 buck-boost controllers, as data for
+// the register engine (regEngine.h). The register names are the ones used
+// by test.c and test2.c. The reference voltage is an 11 bit code in mV,
+// split over REF_LSB (bits 2:0) and REF_MSB (bits 10:3); it is applied
+// when GO_BIT of CONTROL1 is set, which clears itself afterwards.
+
+// I2C addressing definitions
+#define MPQ4210_I2CADDR                 0x60
+
+// MPQ4210 register definitions
+#define MPQREG_REF_LSB                  0x00
+#define MPQREG_REF_MSB                  0x01
+#define MPQREG_CONTROL1                 0x02
+#define MPQREG_CONTROL2                 0x03
+#define MPQREG_ILIM                     0x04
+#define MPQREG_INT_STATUS               0x05
+#define MPQREG_INT_MASK                 0x06
+
+// CONTROL1 definitions
+#define MPQ_CONTROL1_EN                 0x80    // Power switching enabled
+#define MPQ_CONTROL1_DISCHG_EN          0x40    // Output discharge path
+#define MPQ_CONTROL1_DITHER             0x08    // Frequency spread spectrum
+#define MPQ_CONTROL1_PNG_LATCH          0x04    // Power not good latched
+#define MPQ_CONTROL1_GO_BIT             0x02    // Applies the reference, self clearing
+// VREF slew rate, bits 5:4 of CONTROL1
+#define MPQ4210_CONTROL1_SR_38mV_ms     0x00
+#define MPQ4210_CONTROL1_SR_50mV_ms     0x10
+#define MPQ4210_CONTROL1_SR_75mV_ms     0x20
+#define MPQ4210_CONTROL1_SR_150mV_ms    0x30
+#define MPQ4214_CONTROL1_SR_38mV_ms     0x00
+#define MPQ4214_CONTROL1_SR_50mV_ms     0x10
+#define MPQ4214_CONTROL1_SR_72mV_ms     0x20
+#define MPQ4214_CONTROL1_SR_150mV_ms    0x30
+
+// CONTROL2 definitions
+// Switching frequency, bits 7:6
+#define MPQ_CONTROL2_FSW_200khz         0x00
+#define MPQ_CONTROL2_FSW_300khz         0x40
+#define MPQ_CONTROL2_FSW_400khz         0x80
+#define MPQ_CONTROL2_FSW_600khz         0xC0
+// Buck-boost switching frequency, bit 5
+#define MPQ4210_CONTROL2_BBFSW_LOW      0x00
+#define MPQ4210_CONTROL2_BBFSW_HIGH     0x20
+
+#define MPQ_VREF_MAX_MV                 2047
+
+extern const ChipMap MPQ4210_Map;
+
+#endif // MPQ4210_REGS_H
@@ -0,0 +1,99 @@
+//Include header file
+#include "MPQ4210Units.h"
+#include "MPQ4210Regs.h"
+
+/******************************************
+* @brief: Initializes an engine device for an MPQ4210
+* @param Device: device context (RegEngine_Device *)
+* @param I2CAddress: 7 bit address of the device (uint8_t)
+*******************************************/
+void MPQ4210Units_Init(RegEngine_Device *Device, uint8_t I2CAddress){
+    RegEngine_Init(Device,&MPQ4210_Map,I2CAddress);
+}
+
+/******************************************
+* @brief: Sets the reference voltage
+* @param Device: MPQ4210 device (RegEngine_Device *)
+* @param VrefmV: reference in mV, 0 to MPQ_VREF_MAX_MV (uint16_t)
+* @note: REF_LSB, REF_MSB and the GO bit of CONTROL1 are neighbours,
+*        so the whole change is one block write once CONTROL1 is
+*        known. Values out of range return REG_ERR_FIELD.
+*******************************************/
+int MPQ4210Units_SetVref(RegEngine_Device *Device, uint16_t VrefmV){
+    if (VrefmV > MPQ_VREF_MAX_MV) {
+        return REG_ERR_FIELD;
+    }
+    RegEngine_FieldValue values[3] = {
+        {RegEngine_Field(Device,MPQREG_REF_LSB,"VREF_L"), (uint8_t)(VrefmV & 0x07)},
+        {RegEngine_Field(Device,MPQREG_REF_MSB,"VREF_H"), (uint8_t)(VrefmV >> 3)},
+        {RegEngine_Field(Device,MPQREG_CONTROL1,"GO_BIT"), 1},
+    };
+    return RegEngine_WriteFields(Device,values,3);
+}
+
+/******************************************
+* @brief: Gets the reference voltage
+* @param Device: MPQ4210 device (RegEngine_Device *)
+* @param VrefmV: reference in mV (uint16_t *)
+*******************************************/
+int MPQ4210Units_GetVref(RegEngine_Device *Device, uint16_t *VrefmV){
+    RegEngine_FieldValue values[2] = {
+        {RegEngine_Field(Device,MPQREG_REF_LSB,"VREF_L"), 0},
+        {RegEngine_Field(Device,MPQREG_REF_MSB,"VREF_H"), 0},
+    };
+    int status = RegEngine_ReadFields(Device,values,2);
+    *VrefmV = (uint16_t)((values[1].Value << 3) | values[0].Value);
+    return status;
+}
+
+/******************************************
+* @brief: Sets the output voltage
+* @param Device: MPQ4210 device (RegEngine_Device *)
+* @param VoutmV: output voltage in mV (uint32_t)
+* @param Rtop: top resistor of the feedback divider (uint32_t)
+* @param Rbot: bottom resistor of the feedback divider (uint32_t)
+* @note: VREF = VOUT*Rbot/(Rtop+Rbot), rounded to the nearest mV.
+*        Voltages needing a reference above MPQ_VREF_MAX_MV return
+*        REG_ERR_FIELD.
+*******************************************/
+int MPQ4210Units_SetVout(RegEngine_Device *Device, uint32_t VoutmV, uint32_t Rtop, uint32_t Rbot){
+    uint64_t vref = ((uint64_t)VoutmV*Rbot + (Rtop + Rbot)/2)/(Rtop + Rbot);
+    if (vref > MPQ_VREF_MAX_MV) {
+        return REG_ERR_FIELD;
+    }
+    return MPQ4210Units_SetVref(Device,(uint16_t)vref);
+}
+
+/******************************************
+* @brief: Enables power switching
+* @param Device: MPQ4210 device (RegEngine_Device *)
+*******************************************/
+int MPQ4210Units_Enable(RegEngine_Device *Device){
+    return RegEngine_WriteField(Device,RegEngine_Field(Device,MPQREG_CONTROL1,"EN"),1);
+}
+
+/******************************************
+* @brief: Disables power switching
+* @param Device: MPQ4210 device (RegEngine_Device *)
+*******************************************/
+int MPQ4210Units_Disable(RegEngine_Device *Device){
+    return RegEngine_WriteField(Device,RegEngine_Field(Device,MPQREG_CONTROL1,"EN"),0);
+}
+
+/******************************************
+* @brief: Sets the VREF slew rate
+* @param Device: MPQ4210 device (RegEngine_Device *)
+* @param SlewRate: MPQ4210_CONTROL1_SR_* or MPQ4214_CONTROL1_SR_* (uint8_t)
+*******************************************/
+int MPQ4210Units_SetSlewRate(RegEngine_Device *Device, uint8_t SlewRate){
+    return RegEngine_WriteField(Device,RegEngine_Field(Device,MPQREG_CONTROL1,"SR"),(uint8_t)(SlewRate >> 4));
+}
+
+/******************************************
+* @brief: Sets the switching frequency
+* @param Device: MPQ4210 device (RegEngine_Device *)
+* @param Frequency: MPQ_CONTROL2_FSW_* (uint8_t)
+*******************************************/
+int MPQ4210Units_SetSwitchingFrequency(RegEngine_Device *Device, uint8_t Frequency){
+    return RegEngine_WriteField(Device,RegEngine_Field(Device,MPQREG_CONTROL2,"FSW"),(uint8_t)(Frequency >> 6));
+}
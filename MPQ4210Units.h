@@ -0,0 +1,26 @@
+#include <stdint.h>
+#include "regEngine.h"
+
+#ifndef MPQ4210_UNITS_H
+#define MPQ4210_UNITS_H
+
+// MPQ4210/MPQ4214 on the register engine: unit conversions to field values
+// of MPQ4210_Map (MPQ4210Regs.h), the I/O is done by regEngine.c. Replaces
+// the register shims of test.c and test2.c.
+
+// Initialization of an engine device for an MPQ4210
+void MPQ4210Units_Init(RegEngine_Device *Device, uint8_t I2CAddress);
+// Reference voltage in mV (0 to MPQ_VREF_MAX_MV), applied with the GO bit
+int MPQ4210Units_SetVref(RegEngine_Device *Device, uint16_t VrefmV);
+int MPQ4210Units_GetVref(RegEngine_Device *Device, uint16_t *VrefmV);
+// Output voltage in mV through the feedback divider Rtop/Rbot
+int MPQ4210Units_SetVout(RegEngine_Device *Device, uint32_t VoutmV, uint32_t Rtop, uint32_t Rbot);
+// Power switching (EN of CONTROL1)
+int MPQ4210Units_Enable(RegEngine_Device *Device);
+int MPQ4210Units_Disable(RegEngine_Device *Device);
+// VREF slew rate, one of the MPQ42xx_CONTROL1_SR_* definitions
+int MPQ4210Units_SetSlewRate(RegEngine_Device *Device, uint8_t SlewRate);
+// Switching frequency, one of the MPQ_CONTROL2_FSW_* definitions
+int MPQ4210Units_SetSwitchingFrequency(RegEngine_Device *Device, uint8_t Frequency);
+
+#endif // MPQ4210_UNITS_H
@@ -0,0 +1,147 @@
+//Include header file
+#include "adaptivePoller.h"
+#include "LM51772.h"
+#include "i2cTransport.h"
+#include <string.h>
+
+/******************************************
+* @brief: Initializes a poller without devices
+* @param Poller: poller context (Poller *)
+* @param BudgetPollsPerSec: polls per second allowed for all the
+*                           devices together, 0 for no limit (uint32_t)
+* @param BurstPolls: polls that can be done back to back when the
+*                    budget was not used for a while (uint32_t)
+* @note: Every poll costs POLLER_TRANSFERS_PER_POLL register reads,
+*        so the bus load is bounded by BudgetPollsPerSec times that.
+*******************************************/
+void Poller_Init(Poller *Poller, uint32_t BudgetPollsPerSec, uint32_t BurstPolls){
+    memset(Poller,0,sizeof(*Poller));
+    Poller->BudgetPollsPerSec = BudgetPollsPerSec;
+    Poller->BurstPolls = (BurstPolls == 0) ? 1 : BurstPolls;
+    Poller->TokensMilli = (uint64_t)Poller->BurstPolls*1000;
+}
+
+/******************************************
+* @brief: Adds a device to the poller
+* @param Poller: poller context (Poller *)
+* @param I2CAddress: 7 bit address of the device (uint8_t)
+* @param MinIntervalUs: interval after a change, 0 for
+*                       POLLER_MIN_INTERVAL_US (uint32_t)
+* @param MaxIntervalUs: interval of a quiet device, 0 for
+*                       POLLER_MAX_INTERVAL_US (uint32_t)
+* @note: The device is polled on the next Poller_Run(). Returns the
+*        index of the device or -1 if the poller is full.
+*******************************************/
+int Poller_AddDevice(Poller *Poller, uint8_t I2CAddress, uint32_t MinIntervalUs, uint32_t MaxIntervalUs){
+    if (Poller->Count >= POLLER_MAX_DEVICES) {
+        return -1;
+    }
+    Poller_Device *device = &Poller->Devices[Poller->Count];
+    memset(device,0,sizeof(*device));
+    device->I2CAddress = I2CAddress;
+    device->MinIntervalUs = (MinIntervalUs == 0) ? POLLER_MIN_INTERVAL_US : MinIntervalUs;
+    device->MaxIntervalUs = (MaxIntervalUs == 0) ? POLLER_MAX_INTERVAL_US : MaxIntervalUs;
+    if (device->MaxIntervalUs < device->MinIntervalUs) {
+        device->MaxIntervalUs = device->MinIntervalUs;
+    }
+    device->IntervalUs = device->MinIntervalUs;
+    return Poller->Count++;
+}
+
+/******************************************
+* @brief: Installs the function called when a poll sees a change
+* @param Poller: poller context (Poller *)
+* @param Callback: change callback, NULL removes it (Poller_ChangeCallback)
+* @param Context: passed to the callback (void *)
+*******************************************/
+void Poller_SetCallback(Poller *Poller, Poller_ChangeCallback Callback, void *Context){
+    Poller->OnChange = Callback;
+    Poller->CallbackContext = Context;
+}
+
+// Polls one device and plans its next poll
+static void pollDevice(Poller *Poller, Poller_Device *Device, uint64_t NowUs){
+    uint8_t status, usbpd;
+    Device->Polls++;
+    if (I2C_ReadRegBlock(Device->I2CAddress,STATUS_BYTE,&status,1) < 0 ||
+        I2C_ReadRegBlock(Device->I2CAddress,USB_PD_STATUS_0,&usbpd,1) < 0) {
+        // Keep the interval, the device may be resetting
+        Device->Errors++;
+        Device->NextDueUs = NowUs + Device->IntervalUs;
+        return;
+    }
+    int changed = Device->Known &&
+                  (((status ^ Device->Status) & POLLER_STATUS_MASK) || ((usbpd ^ Device->UsbPdStatus) & POLLER_USBPD_MASK));
+    Device->Status = status;
+    Device->UsbPdStatus = usbpd;
+    Device->Known = 1;
+    if (changed) {
+        // Activity, look closely for a while
+        Device->Changes++;
+        Device->LastChangeUs = NowUs;
+        Device->IntervalUs = Device->MinIntervalUs;
+        if (Poller->OnChange != 0) {
+            Poller->OnChange(Poller->CallbackContext,Device->I2CAddress,status,usbpd,NowUs);
+        }
+    } else if (NowUs - Device->LastChangeUs >= POLLER_HOLD_US) {
+        // Quiet, back off towards the floor rate
+        uint64_t interval = (uint64_t)Device->IntervalUs*POLLER_GROWTH_NUM/POLLER_GROWTH_DEN;
+        Device->IntervalUs = (interval > Device->MaxIntervalUs) ? Device->MaxIntervalUs : (uint32_t)interval;
+    }
+    Device->NextDueUs = NowUs + Device->IntervalUs;
+}
+
+/******************************************
+* @brief: Polls the devices that are due
+* @param Poller: poller context (Poller *)
+* @param NowUs: current time in us (uint64_t)
+* @note: Devices are polled in order of due time while the budget
+*        allows. Devices that could not be polled stay due and are
+*        counted as deferred. Returns the time at which Poller_Run()
+*        should be called again: the next due time, or the time the
+*        budget allows the next poll if some device is still due.
+*******************************************/
+uint64_t Poller_Run(Poller *Poller, uint64_t NowUs){
+    // Refill of the bucket
+    if (Poller->BudgetPollsPerSec != 0 && NowUs > Poller->LastRefillUs) {
+        Poller->TokensMilli += (NowUs - Poller->LastRefillUs)*Poller->BudgetPollsPerSec/1000;
+        if (Poller->TokensMilli > (uint64_t)Poller->BurstPolls*1000) {
+            Poller->TokensMilli = (uint64_t)Poller->BurstPolls*1000;
+        }
+    }
+    Poller->LastRefillUs = NowUs;
+    for (;;) {
+        // Earliest due device
+        Poller_Device *next = 0;
+        for (int i = 0; i < Poller->Count; ++i) {
+            Poller_Device *device = &Poller->Devices[i];
+            if (device->NextDueUs <= NowUs && (next == 0 || device->NextDueUs < next->NextDueUs)) {
+                next = device;
+            }
+        }
+        if (next == 0) {
+            break;
+        }
+        if (Poller->BudgetPollsPerSec != 0) {
+            if (Poller->TokensMilli < 1000) {
+                // Out of budget, the due devices wait for the next token
+                for (int i = 0; i < Poller->Count; ++i) {
+                    if (Poller->Devices[i].NextDueUs <= NowUs) {
+                        Poller->Devices[i].Deferred++;
+                    }
+                }
+                uint64_t missing = 1000 - Poller->TokensMilli;
+                return NowUs + (missing*1000 + Poller->BudgetPollsPerSec - 1)/Poller->BudgetPollsPerSec;
+            }
+            Poller->TokensMilli -= 1000;
+        }
+        pollDevice(Poller,next,NowUs);
+    }
+    uint64_t due = UINT64_MAX;
+    for (int i = 0; i < Poller->Count; ++i) {
+        if (Poller->Devices[i].NextDueUs < due) {
+            due = Poller->Devices[i].NextDueUs;
+        }
+    }
+    return due;
+}
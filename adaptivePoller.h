@@ -0,0 +1,70 @@
+#include <stdint.h>
+
+#ifndef ADAPTIVE_POLLER_H
+#define ADAPTIVE_POLLER_H
+
+// Adaptive STATUS_BYTE / USB_PD_STATUS_0 poller. Every device has its own
+// poll interval: it drops to the minimum as soon as any FLT_* bit or the
+// CC bit changes, and grows back towards the maximum while the device
+// stays quiet for POLLER_HOLD_US. All the devices of a bus share a token
+// bucket that limits the polls per second, so a fault storm cannot take
+// the whole bus.
+// Time is passed by the caller in us, so the poller runs the same on a
+// real clock and on the virtual clock of the simulated bus.
+
+#define POLLER_MAX_DEVICES              16
+#define POLLER_STATUS_MASK              0xFF    // Every FLT_* bit of STATUS_BYTE
+#define POLLER_USBPD_MASK               0x40    // CC bit of USB_PD_STATUS_0
+#define POLLER_TRANSFERS_PER_POLL       2       // Register reads per poll
+
+// Default intervals, time the minimum interval is held after the last
+// change (covers the off time of a hiccup cycle) and growth of the
+// interval once quiet (x3/2 per poll)
+#define POLLER_MIN_INTERVAL_US          1000
+#define POLLER_MAX_INTERVAL_US          100000
+#define POLLER_HOLD_US                  50000
+#define POLLER_GROWTH_NUM               3
+#define POLLER_GROWTH_DEN               2
+
+// Called when a poll sees a change
+typedef void (*Poller_ChangeCallback)(void *Context, uint8_t I2CAddress, uint8_t Status, uint8_t UsbPdStatus, uint64_t NowUs);
+
+typedef struct{
+    uint8_t I2CAddress;                 // 7 bit address of the device
+    uint8_t Status;                     // Last STATUS_BYTE read
+    uint8_t UsbPdStatus;                // Last USB_PD_STATUS_0 read
+    uint8_t Known;                      // 0 until the first poll
+    uint32_t IntervalUs;                // Current poll interval
+    uint32_t MinIntervalUs;             // Interval right after a change
+    uint32_t MaxIntervalUs;             // Interval of a quiet device
+    uint64_t NextDueUs;                 // Time of the next poll
+    uint64_t LastChangeUs;              // Time of the last change seen
+    // Statistics
+    uint32_t Polls;                     // Polls done
+    uint32_t Changes;                   // Polls that saw a change
+    uint32_t Deferred;                  // Polls delayed by the budget
+    uint32_t Errors;                    // Polls that failed
+} Poller_Device;
+
+typedef struct{
+    Poller_Device Devices[POLLER_MAX_DEVICES];
+    int Count;                          // Devices added
+    uint32_t BudgetPollsPerSec;         // Refill rate of the bucket, 0 unlimited
+    uint32_t BurstPolls;                // Capacity of the bucket
+    uint64_t TokensMilli;               // Available polls x1000
+    uint64_t LastRefillUs;              // Time of the last refill
+    Poller_ChangeCallback OnChange;     // Can be NULL
+    void *CallbackContext;
+} Poller;
+
+// Initialization with a budget of polls per second shared by all devices
+void Poller_Init(Poller *Poller, uint32_t BudgetPollsPerSec, uint32_t BurstPolls);
+// Adding a device with its interval limits, returns its index or -1
+int Poller_AddDevice(Poller *Poller, uint8_t I2CAddress, uint32_t MinIntervalUs, uint32_t MaxIntervalUs);
+// Installing the change callback
+void Poller_SetCallback(Poller *Poller, Poller_ChangeCallback Callback, void *Context);
+// Polling every device due at NowUs within the budget, returns the time
+// of the next poll due
+uint64_t Poller_Run(Poller *Poller, uint64_t NowUs);
+
+#endif // ADAPTIVE_POLLER_H
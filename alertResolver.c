@@ -0,0 +1,65 @@
+//Include header file
+#include "alertResolver.h"
+#include "i2cTransport.h"
+#include "LM51772.h"
+#include <stdio.h>
+#include <string.h>
+
+/******************************************
+* @brief: Initializes an alert resolver
+* @param Resolver: resolver context (AlertResolver *)
+* @param Line: reads SMBALERT#, NULL to rely on the ARA alone (AlertResolver_Line)
+* @param LineContext: passed to Line (void *)
+* @param Service: called for every alerting device (AlertResolver_Service)
+* @param ServiceContext: passed to Service (void *)
+*******************************************/
+void AlertResolver_Init(AlertResolver *Resolver, AlertResolver_Line Line, void *LineContext,
+                        AlertResolver_Service Service, void *ServiceContext){
+    memset(Resolver,0,sizeof(*Resolver));
+    Resolver->Line = Line;
+    Resolver->LineContext = LineContext;
+    Resolver->Service = Service;
+    Resolver->ServiceContext = ServiceContext;
+}
+
+/******************************************
+* @brief: Services every device pulling SMBALERT#
+* @param Resolver: resolver context (AlertResolver *)
+* @note: To be called when the line is asserted (interrupt or poll of
+*        the line). Every round reads the ARA, reads the STATUS_BYTE
+*        of the device that answered and calls the service callback,
+*        until the line is released, nobody answers the ARA or
+*        ALERT_MAX_ROUNDS devices have been serviced. A line asserted
+*        without an ARA answer (a device without ARA support, or a
+*        stuck line) is counted as spurious. Returns the amount of
+*        devices serviced.
+*******************************************/
+int AlertResolver_Run(AlertResolver *Resolver){
+    int serviced = 0;
+    Resolver->Runs++;
+    for (int round = 0; round < ALERT_MAX_ROUNDS; ++round) {
+        if (Resolver->Line != 0 && !Resolver->Line(Resolver->LineContext)) {
+            break;
+        }
+        uint8_t response;
+        if (I2C_ReadBlock(SMBUS_ARA_ADDRESS,&response,1) < 0) {
+            // Nobody alerting, or nobody answering while the line is low
+            if (Resolver->Line != 0) {
+                Resolver->Spurious++;
+            }
+            break;
+        }
+        uint8_t address = response >> 1;
+        Resolver->Identified++;
+        uint8_t status;
+        int result = I2C_ReadRegBlock(address,STATUS_BYTE,&status,1);
+        if (result < 0) {
+            fprintf(stderr, "Failed to read STATUS_BYTE of I2C device at address 0x%02X\nERROR CODE:%d\n", address, result);
+            Resolver->Errors++;
+            continue;
+        }
+        Resolver->Service(Resolver->ServiceContext,address,status);
+        serviced++;
+    }
+    return serviced;
+}
@@ -0,0 +1,45 @@
+#include <stdint.h>
+
+#ifndef ALERT_RESOLVER_H
+#define ALERT_RESOLVER_H
+
+// SMBus alert resolver for many LM51772 sharing one nFLT/SMBALERT# line.
+// Instead of reading the STATUS_BYTE of every device when the line goes
+// low, the resolver reads one byte from the Alert Response Address: every
+// alerting device answers with its address, the lowest address wins the
+// arbitration and releases the line. Only that device is read and passed
+// to the service callback, and the resolver goes on until the line is
+// released (or, without a line callback, until nobody answers the ARA).
+// Identification costs one transfer whatever the amount of devices.
+
+#define SMBUS_ARA_ADDRESS               0x0C
+// Bound of the devices serviced by one AlertResolver_Run, so a device that
+// keeps alerting cannot hold the caller forever
+#define ALERT_MAX_ROUNDS                128
+
+// State of SMBALERT#: 1 while asserted (low)
+typedef int (*AlertResolver_Line)(void *Context);
+// Called for every device identified, with its STATUS_BYTE. It should
+// handle and clear the faults (e.g. ClearFaults) so the device stops
+// alerting.
+typedef void (*AlertResolver_Service)(void *Context, uint8_t I2CAddress, uint8_t Status);
+
+typedef struct{
+    AlertResolver_Line Line;            // Can be NULL
+    void *LineContext;
+    AlertResolver_Service Service;
+    void *ServiceContext;
+    // Statistics
+    uint32_t Runs;                      // Calls of AlertResolver_Run
+    uint32_t Identified;                // Devices answering the ARA
+    uint32_t Spurious;                  // Line asserted but no ARA answer
+    uint32_t Errors;                    // Failed STATUS_BYTE reads
+} AlertResolver;
+
+// Initialization, Line can be NULL
+void AlertResolver_Init(AlertResolver *Resolver, AlertResolver_Line Line, void *LineContext,
+                        AlertResolver_Service Service, void *ServiceContext);
+// Servicing every alerting device, returns how many were serviced
+int AlertResolver_Run(AlertResolver *Resolver);
+
+#endif // ALERT_RESOLVER_H
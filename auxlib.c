@@ -1,4 +1,4 @@
-#include "aux.h"
+#include "auxlib.h"
 #include <stdint.h>
 
 // Auxiliary functions helping development of firmware I2C libraries
@@ -0,0 +1,212 @@
+#include "LM51772.h"
+#include "adaptivePoller.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Fault detection latency against bus load of fixed rate polling and of
+// the adaptive poller, on simulated LM51772 with injected faults. Every
+// device gets bursts of hiccup cycles (an FLT_OCP pulse of PULSE_ON_US
+// every HICCUP_PERIOD_US) at random times, plus occasional CC changes.
+// A pulse no poll saw while it was present counts as missed.
+
+#define DEVICES                 4
+#define SIM_TIME_US             60000000ull     // 60 s of virtual time
+#define PULSE_ON_US             3000
+#define HICCUP_PERIOD_US        12000
+#define PULSES_PER_BURST        20
+#define MAX_EVENTS              4096
+#define MAX_PULSES              4096
+
+typedef struct{
+    uint64_t TimeUs;
+    uint8_t Set;                        // 1 sets the bits, 0 clears them
+    uint8_t Reg;                        // STATUS_BYTE or USB_PD_STATUS_0
+    uint8_t Bits;
+} FaultEvent;
+
+typedef struct{
+    FaultEvent Events[MAX_EVENTS];
+    int Count;
+    int Next;
+    // Pulse being tracked
+    int Active;
+    int Detected;
+    uint64_t StartUs;
+} DeviceFaults;
+
+static SimI2CBus bus;
+static SimLM51772 devices[DEVICES];
+static DeviceFaults faults[DEVICES];
+static uint64_t latencies[MAX_PULSES];
+static int latencyCount;
+static int pulses, missed;
+static uint32_t rng;
+
+static uint32_t xorshift(void){
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void addEvent(DeviceFaults *Faults, uint64_t TimeUs, uint8_t Set, uint8_t Reg, uint8_t Bits){
+    if (Faults->Count < MAX_EVENTS) {
+        FaultEvent *e = &Faults->Events[Faults->Count++];
+        e->TimeUs = TimeUs;
+        e->Set = Set;
+        e->Reg = Reg;
+        e->Bits = Bits;
+    }
+}
+
+// Same schedule for every strategy, it only depends on the seed
+static void planFaults(void){
+    rng = 12345;
+    for (int d = 0; d < DEVICES; ++d) {
+        DeviceFaults *f = &faults[d];
+        memset(f,0,sizeof(*f));
+        uint64_t t = 200000 + xorshift() % 2000000;
+        int cc = 0;
+        while (t < SIM_TIME_US - 1000000) {
+            if (xorshift() % 4 == 0) {
+                // Cable event: CC toggles
+                cc ^= 1;
+                addEvent(f,t,(uint8_t)cc,USB_PD_STATUS_0,0x40);
+            } else {
+                for (int p = 0; p < PULSES_PER_BURST; ++p) {
+                    uint64_t start = t + (uint64_t)p*HICCUP_PERIOD_US;
+                    addEvent(f,start,1,STATUS_BYTE,FLT_OCP);
+                    addEvent(f,start + PULSE_ON_US,0,STATUS_BYTE,FLT_OCP);
+                }
+            }
+            t += 500000 + xorshift() % 3000000;
+        }
+    }
+}
+
+static void onChange(void *Context, uint8_t I2CAddress, uint8_t Status, uint8_t UsbPdStatus, uint64_t NowUs){
+    (void)Context;
+    (void)UsbPdStatus;
+    // The change was seen when the bus finished the reads
+    NowUs = bus.NowNs/1000;
+    DeviceFaults *f = &faults[I2CAddress - 0x10];
+    if (f->Active && !f->Detected && (Status & FLT_OCP)) {
+        f->Detected = 1;
+        if (latencyCount < MAX_PULSES) {
+            latencies[latencyCount++] = NowUs - f->StartUs;
+        }
+    }
+}
+
+static void applyEvent(int Device, const FaultEvent *Event){
+    DeviceFaults *f = &faults[Device];
+    uint8_t *reg = &devices[Device].Regs[Event->Reg];
+    if (Event->Set) {
+        *reg |= Event->Bits;
+    } else {
+        *reg &= (uint8_t)~Event->Bits;
+    }
+    if (Event->Reg != STATUS_BYTE) {
+        return;
+    }
+    if (Event->Set) {
+        pulses++;
+        f->Active = 1;
+        f->Detected = 0;
+        f->StartUs = Event->TimeUs;
+    } else {
+        if (f->Active && !f->Detected) {
+            missed++;
+        }
+        f->Active = 0;
+    }
+}
+
+static int compare(const void *a, const void *b){
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void run(const char *Name, uint32_t MinUs, uint32_t MaxUs, uint32_t Budget){
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    for (int d = 0; d < DEVICES; ++d) {
+        SimLM51772_Init(&devices[d],(uint8_t)(0x10 + d));
+        devices[d].Regs[STATUS_BYTE] = 0;
+        SimBus_Attach(&bus,&devices[d]);
+    }
+    I2C_SetTransport(&transport);
+    planFaults();
+    latencyCount = pulses = missed = 0;
+
+    Poller poller;
+    Poller_Init(&poller,Budget,DEVICES);
+    for (int d = 0; d < DEVICES; ++d) {
+        Poller_AddDevice(&poller,(uint8_t)(0x10 + d),MinUs,MaxUs);
+    }
+    Poller_SetCallback(&poller,onChange,0);
+
+    // The bus clock is the time base: polls take their bus time and
+    // nothing else can use the bus meanwhile
+    uint64_t now = 0;
+    uint64_t nextPoll = 0;
+    uint64_t busyNs = 0;
+    while (now < SIM_TIME_US) {
+        // Next thing happening: a poll or a fault event
+        uint64_t next = nextPoll;
+        int device = -1;
+        for (int d = 0; d < DEVICES; ++d) {
+            DeviceFaults *f = &faults[d];
+            if (f->Next < f->Count && f->Events[f->Next].TimeUs <= next) {
+                next = f->Events[f->Next].TimeUs;
+                device = d;
+            }
+        }
+        now = next;
+        if (bus.NowNs < now*1000) {
+            bus.NowNs = now*1000; // Idle bus
+        }
+        if (device >= 0) {
+            applyEvent(device,&faults[device].Events[faults[device].Next++]);
+        } else {
+            uint64_t start = bus.NowNs;
+            nextPoll = Poller_Run(&poller,bus.NowNs/1000);
+            busyNs += bus.NowNs - start;
+        }
+    }
+
+    uint32_t polls = 0, deferred = 0;
+    for (int d = 0; d < DEVICES; ++d) {
+        polls += poller.Devices[d].Polls;
+        deferred += poller.Devices[d].Deferred;
+    }
+    qsort(latencies,latencyCount,sizeof(uint64_t),compare);
+    uint64_t sum = 0;
+    for (int i = 0; i < latencyCount; ++i) {
+        sum += latencies[i];
+    }
+    double load = 100.0*(double)busyNs/(double)bus.NowNs;
+    printf("%-26s %8u %6.2f %%  %7.2f  %7.2f  %7.2f   %4d/%4d  %6u\n", Name, polls, load,
+           latencyCount ? (double)sum/latencyCount/1000.0 : 0.0,
+           latencyCount ? latencies[latencyCount/2]/1000.0 : 0.0,
+           latencyCount ? latencies[latencyCount*99/100]/1000.0 : 0.0, missed, pulses, deferred);
+}
+
+int main(){
+    printf("%d devices, %.0f s, hiccup pulses of %d ms every %d ms\n\n", DEVICES,
+           SIM_TIME_US/1e6, PULSE_ON_US/1000, HICCUP_PERIOD_US/1000);
+    printf("%-26s %8s %8s  %7s  %7s  %7s   %9s  %6s\n", "Strategy", "polls", "bus load",
+           "mean ms", "p50 ms", "p99 ms", "missed", "defer");
+    run("fixed 1 ms",1000,1000,0);
+    run("fixed 10 ms",10000,10000,0);
+    run("fixed 50 ms",50000,50000,0);
+    run("adaptive 1-50 ms",1000,50000,0);
+    run("adaptive 1-50 ms, 400/s",1000,50000,400);
+    run("adaptive 1-50 ms, 200/s",1000,50000,200);
+    run("adaptive 1-100 ms",1000,100000,0);
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "LM51772.h"
+#include "alertResolver.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Fault-to-identification latency with many LM51772 on one shared
+// SMBALERT# line: scanning the STATUS_BYTE of every device when the line
+// goes low, against the ARA resolver. Faults are raised on 1 or 3 random
+// devices at once; the latency runs from the fault to the read that
+// identifies the device. The host needs HOST_GAP_NS between transactions.
+// The exit status is 1 if a fault is missed or the line stays asserted.
+
+#define MAX_DEVICES             64
+#define FIRST_ADDRESS           0x10
+#define HOST_GAP_NS             50000
+#define EVENTS                  200
+
+static SimI2CBus bus;
+static I2C_Transport transport;
+static SimLM51772 devices[MAX_DEVICES];
+static uint8_t pending[MAX_DEVICES];
+static uint64_t faultNs;
+static uint64_t latencySumNs, latencyMaxNs;
+static uint32_t identified;
+static uint32_t seed = 1;
+
+static uint32_t nextRandom(void){
+    seed = seed*1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static void identify(uint8_t I2CAddress){
+    int index = I2CAddress - FIRST_ADDRESS;
+    if (index < 0 || index >= MAX_DEVICES || !pending[index]) {
+        return;
+    }
+    uint64_t latency = bus.NowNs - faultNs;
+    latencySumNs += latency;
+    latencyMaxNs = (latency > latencyMaxNs) ? latency : latencyMaxNs;
+    identified++;
+    pending[index] = 0;
+    ClearFaults(I2CAddress);
+}
+
+static int alertLine(void *Context){
+    return SimBus_AlertLine((const SimI2CBus *)Context);
+}
+
+static void service(void *Context, uint8_t I2CAddress, uint8_t Status){
+    (void)Context;
+    if (Status & (FLT_OCP|FLT_OVP|FLT_TEMPERATURE)) {
+        identify(I2CAddress);
+    }
+}
+
+static void scan(int Count){
+    for (int i = 0; i < Count; ++i) {
+        uint8_t status;
+        if (I2C_ReadRegBlock((uint8_t)(FIRST_ADDRESS + i),STATUS_BYTE,&status,1) == I2C_OK &&
+            (status & (FLT_OCP|FLT_OVP|FLT_TEMPERATURE))) {
+            identify((uint8_t)(FIRST_ADDRESS + i));
+        }
+    }
+}
+
+// Runs EVENTS fault events, returns the faults missed
+static int run(int Count, int Simultaneous, int UseAra){
+    AlertResolver resolver;
+    AlertResolver_Init(&resolver,alertLine,&bus,service,0);
+    latencySumNs = 0;
+    latencyMaxNs = 0;
+    identified = 0;
+    SimBus_ResetStats(&bus);
+    int raised = 0;
+    for (int e = 0; e < EVENTS; ++e) {
+        faultNs = bus.NowNs;
+        for (int k = 0; k < Simultaneous; ++k) {
+            int index = (int)(nextRandom() % (uint32_t)Count);
+            if (!pending[index]) {
+                pending[index] = 1;
+                SimLM51772_RaiseFault(&devices[index],FLT_OCP);
+                raised++;
+            }
+        }
+        if (!SimBus_AlertLine(&bus)) {
+            continue;
+        }
+        if (UseAra) {
+            AlertResolver_Run(&resolver);
+        } else {
+            scan(Count);
+        }
+    }
+    int missed = raised - (int)identified;
+    missed += SimBus_AlertLine(&bus);
+    printf("%2d devices %d at once %-5s  transfers/event %6.1f  latency mean %8.2f ms max %8.2f ms\n", Count,
+           Simultaneous, UseAra ? "ARA" : "scan", (double)bus.Transfers/EVENTS,
+           identified ? latencySumNs/1e6/identified : 0.0, latencyMaxNs/1e6);
+    return missed;
+}
+
+int main(){
+    SimBus_Init(&bus,&transport);
+    bus.HostGapNs = HOST_GAP_NS;
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        SimLM51772_Init(&devices[i],(uint8_t)(FIRST_ADDRESS + i));
+        SimBus_Attach(&bus,&devices[i]);
+    }
+    I2C_SetTransport(&transport);
+
+    int missed = 0;
+    static const int counts[] = {4, 8, 16, 32, 64};
+    for (int simultaneous = 1; simultaneous <= 3; simultaneous += 2) {
+        for (unsigned c = 0; c < sizeof(counts)/sizeof(counts[0]); ++c) {
+            missed += run(counts[c],simultaneous,0);
+            missed += run(counts[c],simultaneous,1);
+        }
+    }
+    printf("%s\n", missed ? "FAULTS MISSED" : "Every fault identified");
+    return missed ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+#include "busLock.h"
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Cross-process bus lock against flock() on a lock file, the usual
+// alternative:
+//   - uncontended acquire/release pair,
+//   - PROCESSES processes taking the lock HOLDS times each around a short
+//     critical section (a stand-in for a transaction): throughput, worst
+//     wait, and the holds that went to a process that asked later than
+//     one still waiting (none for a FIFO lock, apart from a process
+//     preempted between reading the clock and asking),
+//   - a process dying while it holds the lock, and while it waits for it.
+// The exit status is 1 if two processes were ever inside together or a
+// dead process is not recovered from.
+
+#define PROCESSES               4
+#define HOLDS                   20000
+#define UNCONTENDED             5000000
+#define CRITICAL_SPINS          200
+
+typedef struct{
+    _Atomic uint32_t Ready;             // Processes started
+    _Atomic uint32_t Inside;            // Processes in the critical section
+    uint32_t Overlaps;                  // Times Inside was not 0 on entry
+    uint32_t Count;                     // Holds so far, plain: protected by the lock
+    uint64_t MaxWaitNs[PROCESSES];
+    uint64_t AskedNs[PROCESSES*HOLDS];  // When the process of every hold asked for it
+} Shared;
+
+static char lockName[64];
+static char fileName[64];
+static Shared *shared;
+
+static uint64_t nowNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Lock under test: the bus lock, or flock() when Fd >= 0
+typedef struct{
+    BusLock Lock;
+    int Fd;
+} Lock;
+
+static void lockOpen(Lock *Lock, int Flock){
+    Lock->Fd = -1;
+    if (Flock) {
+        Lock->Fd = open(fileName,O_CREAT | O_RDWR,0666);
+    } else if (BusLock_Open(&Lock->Lock,lockName) < 0) {
+        exit(1);
+    }
+}
+
+static void lockClose(Lock *Lock){
+    if (Lock->Fd >= 0) {
+        close(Lock->Fd);
+    } else {
+        BusLock_Close(&Lock->Lock);
+    }
+}
+
+static inline void lockTake(Lock *Lock){
+    if (Lock->Fd >= 0) {
+        flock(Lock->Fd,LOCK_EX);
+    } else {
+        BusLock_Acquire(&Lock->Lock);
+    }
+}
+
+static inline void lockGive(Lock *Lock){
+    if (Lock->Fd >= 0) {
+        flock(Lock->Fd,LOCK_UN);
+    } else {
+        BusLock_Release(&Lock->Lock);
+    }
+}
+
+static void uncontended(const char *Name, int Flock){
+    Lock lock;
+    lockOpen(&lock,Flock);
+    int pairs = Flock ? UNCONTENDED/20 : UNCONTENDED;
+    uint64_t start = nowNs();
+    for (int i = 0; i < pairs; ++i) {
+        lockTake(&lock);
+        lockGive(&lock);
+    }
+    printf("%-10s uncontended acquire+release %8.1f ns\n", Name, (double)(nowNs() - start)/pairs);
+    lockClose(&lock);
+}
+
+static void worker(int Index, int Flock){
+    Lock lock;
+    lockOpen(&lock,Flock);
+    // Every process starts asking at the same time
+    atomic_fetch_add(&shared->Ready,1);
+    while (atomic_load(&shared->Ready) < PROCESSES) {
+        sched_yield();
+    }
+    uint64_t maxWait = 0;
+    for (int i = 0; i < HOLDS; ++i) {
+        uint64_t start = nowNs();
+        lockTake(&lock);
+        uint64_t wait = nowNs() - start;
+        maxWait = (wait > maxWait) ? wait : maxWait;
+        if (atomic_fetch_add(&shared->Inside,1) != 0) {
+            shared->Overlaps++;
+        }
+        shared->AskedNs[shared->Count++] = start;
+        for (volatile int s = 0; s < CRITICAL_SPINS; ++s) {
+        }
+        atomic_fetch_sub(&shared->Inside,1);
+        lockGive(&lock);
+    }
+    shared->MaxWaitNs[Index] = maxWait;
+    lockClose(&lock);
+    _exit(0);
+}
+
+static int contended(const char *Name, int Flock){
+    memset(shared,0,sizeof(*shared));
+    uint64_t start = nowNs();
+    pid_t pids[PROCESSES];
+    for (int p = 0; p < PROCESSES; ++p) {
+        pids[p] = fork();
+        if (pids[p] == 0) {
+            worker(p,Flock);
+        }
+    }
+    for (int p = 0; p < PROCESSES; ++p) {
+        waitpid(pids[p],0,0);
+    }
+    uint64_t elapsed = nowNs() - start;
+    // A hold was overtaken if an earlier hold was asked for after it
+    uint64_t latest = 0;
+    uint32_t overtaken = 0;
+    for (uint32_t i = 0; i < shared->Count; ++i) {
+        overtaken += shared->AskedNs[i] < latest;
+        latest = (shared->AskedNs[i] > latest) ? shared->AskedNs[i] : latest;
+    }
+    uint64_t maxWait = 0;
+    for (int p = 0; p < PROCESSES; ++p) {
+        maxWait = (shared->MaxWaitNs[p] > maxWait) ? shared->MaxWaitNs[p] : maxWait;
+    }
+    printf("%-10s %d processes: %7.0f holds/s, worst wait %8.1f us, %5.2f%% overtaken, %u overlaps\n",
+           Name, PROCESSES, shared->Count/(elapsed/1e9), maxWait/1e3, 100.0*overtaken/shared->Count, shared->Overlaps);
+    return shared->Count != PROCESSES*HOLDS || shared->Overlaps != 0;
+}
+
+// A process that dies while it holds the lock (Wait 0) or while it waits
+// in line for it (Wait 1)
+static int deadProcess(int Wait){
+    BusLock lock;
+    BusLock_Open(&lock,lockName);
+    if (Wait) {
+        BusLock_Acquire(&lock);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        BusLock child;
+        BusLock_Open(&child,lockName);
+        BusLock_Acquire(&child);
+        _exit(0);
+    }
+    if (Wait) {
+        // Let the child take its ticket, then kill it in the queue
+        struct timespec pause = {0, 20000000L};
+        nanosleep(&pause,0);
+        kill(pid,SIGKILL);
+        waitpid(pid,0,0);
+        BusLock_Release(&lock);
+    } else {
+        waitpid(pid,0,0);
+    }
+    uint64_t start = nowNs();
+    int result = BusLock_Acquire(&lock);
+    uint64_t elapsed = nowNs() - start;
+    BusLock_Release(&lock);
+    printf("Process dying %-12s lock taken after %6.2f ms, %s\n", Wait ? "in line:" : "holding it:", elapsed/1e6,
+           (result == BUSLOCK_OWNER_DIED) ? "owner death reported" : "NOT REPORTED");
+    BusLock_Close(&lock);
+    return result != BUSLOCK_OWNER_DIED;
+}
+
+int main(){
+    snprintf(lockName,sizeof(lockName),"/lm51772-benchBusLock-%d",(int)getpid());
+    snprintf(fileName,sizeof(fileName),"/tmp/lm51772-benchBusLock-%d",(int)getpid());
+    shared = (Shared *)mmap(0,sizeof(Shared),PROT_READ | PROT_WRITE,MAP_SHARED | MAP_ANONYMOUS,-1,0);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    int errors = 0;
+    uncontended("bus lock",0);
+    uncontended("flock",1);
+    errors += contended("bus lock",0);
+    errors += contended("flock",1);
+    errors += deadProcess(0);
+    errors += deadProcess(1);
+    BusLock_Unlink(lockName);
+    unlink(fileName);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,206 @@
+#include "LM51772.h"
+#include "i2cCoalesce.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Bus reads of threads polling the same LM51772 registers: a dashboard
+// (STATUS_BYTE, USB_PD_STATUS_0, VOUT target), an alarm monitor
+// (STATUS_BYTE) and a logger (VOUT target, STATUS_BYTE), all on the same
+// PERIOD_US for both devices, and a control thread that sets the VOUT
+// target every CONTROL_PERIODS and reads it back. The simulated bus takes
+// the real time of every transfer at 400 kHz and serves one at a time.
+// Direct transport against read coalescing, without and with a
+// freshness window. The exit status is 1 if a reader gets a wrong status
+// or the control thread does not read back what it wrote.
+
+#define DEVICES                 2
+#define PERIODS                 100
+#define PERIOD_US               1000
+#define CONTROL_PERIODS         10
+#define BIT_TIME_NS             2500
+#define FRESH_NS                2000000
+
+static const uint8_t addresses[DEVICES] = {LM51772_I2CADDR1, LM51772_I2CADDR2};
+static const uint8_t usbPdStatus[DEVICES] = {0x11, 0x22};
+
+static SimI2CBus bus;
+static SimLM51772 devices[DEVICES];
+static I2C_Transport simTransport, serialTransport, coalesceTransport;
+static I2C_Coalesce coalesce;
+static pthread_mutex_t busLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t busReads;
+static struct timespec start;
+static int wrong;
+
+// Backend that serves one transfer at a time and takes its bus time
+static void busy(uint64_t Before){
+    uint64_t ns = bus.NowNs - Before;
+    struct timespec ts = {(time_t)(ns / 1000000000u), (long)(ns % 1000000000u)};
+    nanosleep(&ts,0);
+}
+
+static int serialWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    (void)Context;
+    pthread_mutex_lock(&busLock);
+    uint64_t before = bus.NowNs;
+    int status = simTransport.Write(simTransport.Context,SlaveAddress,Data,Length);
+    busy(before);
+    pthread_mutex_unlock(&busLock);
+    return status;
+}
+
+static int serialRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    (void)Context;
+    pthread_mutex_lock(&busLock);
+    uint64_t before = bus.NowNs;
+    int status = simTransport.Read(simTransport.Context,SlaveAddress,Data,Length);
+    busy(before);
+    pthread_mutex_unlock(&busLock);
+    return status;
+}
+
+static int serialWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    (void)Context;
+    pthread_mutex_lock(&busLock);
+    uint64_t before = bus.NowNs;
+    int status = simTransport.WriteRead(simTransport.Context,SlaveAddress,WData,WLength,RData,RLength);
+    busReads++;
+    busy(before);
+    pthread_mutex_unlock(&busLock);
+    return status;
+}
+
+static int serialQuick(void *Context, uint8_t SlaveAddress){
+    (void)Context;
+    pthread_mutex_lock(&busLock);
+    int status = simTransport.Quick(simTransport.Context,SlaveAddress);
+    pthread_mutex_unlock(&busLock);
+    return status;
+}
+
+static void serialDelay(void *Context, uint32_t Microseconds){
+    (void)Context;
+    struct timespec ts = {0, (long)Microseconds*1000};
+    nanosleep(&ts,0);
+}
+
+// Sleeps until the start of period N of the run
+static void waitPeriod(int N){
+    struct timespec next = start;
+    uint64_t ns = (uint64_t)next.tv_nsec + (uint64_t)N*PERIOD_US*1000u;
+    next.tv_sec += (time_t)(ns / 1000000000u);
+    next.tv_nsec = (long)(ns % 1000000000u);
+    clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&next,0);
+}
+
+static void checkStatus(int Device, uint8_t Status){
+    if (Status != devices[Device].Regs[STATUS_BYTE]) {
+        __atomic_fetch_add(&wrong,1,__ATOMIC_RELAXED);
+    }
+}
+
+static void *dashboard(void *Context){
+    (void)Context;
+    for (int n = 0; n < PERIODS; ++n) {
+        waitPeriod(n);
+        for (int d = 0; d < DEVICES; ++d) {
+            checkStatus(d,get_STATUS_BYTE(addresses[d]));
+            if (get_USBPD_STATUS(addresses[d]) != usbPdStatus[d]) {
+                __atomic_fetch_add(&wrong,1,__ATOMIC_RELAXED);
+            }
+            getVOUT1_TARGET(addresses[d]);
+        }
+    }
+    return 0;
+}
+
+static void *alarmMonitor(void *Context){
+    (void)Context;
+    for (int n = 0; n < PERIODS; ++n) {
+        waitPeriod(n);
+        for (int d = 0; d < DEVICES; ++d) {
+            checkStatus(d,get_STATUS_BYTE(addresses[d]));
+        }
+    }
+    return 0;
+}
+
+static void *logger(void *Context){
+    (void)Context;
+    for (int n = 0; n < PERIODS; ++n) {
+        waitPeriod(n);
+        for (int d = 0; d < DEVICES; ++d) {
+            getVOUT1_TARGET(addresses[d]);
+            checkStatus(d,get_STATUS_BYTE(addresses[d]));
+        }
+    }
+    return 0;
+}
+
+static void *control(void *Context){
+    (void)Context;
+    for (int n = 0; n < PERIODS; n += CONTROL_PERIODS) {
+        waitPeriod(n);
+        uint16_t vout = (uint16_t)(5000 + 100*n);
+        for (int d = 0; d < DEVICES; ++d) {
+            setVOUT1_TARGET(addresses[d],vout);
+            if (getVOUT1_TARGET(addresses[d]) != VOUT1_TARGET_Encode(vout)) {
+                __atomic_fetch_add(&wrong,1,__ATOMIC_RELAXED);
+            }
+        }
+    }
+    return 0;
+}
+
+// Register reads the threads ask for in a run
+#define READS_ASKED             (PERIODS*DEVICES*(4 + 1 + 3) + (PERIODS/CONTROL_PERIODS)*DEVICES*2)
+
+static void run(const char *Mode, const I2C_Transport *Transport){
+    I2C_SetTransport(Transport);
+    busReads = 0;
+    clock_gettime(CLOCK_MONOTONIC,&start);
+    void *(*threads[])(void *) = {dashboard, alarmMonitor, logger, control};
+    pthread_t ids[4];
+    for (int i = 0; i < 4; ++i) {
+        pthread_create(&ids[i],0,threads[i],0);
+    }
+    for (int i = 0; i < 4; ++i) {
+        pthread_join(ids[i],0);
+    }
+    printf("%-26s %5d reads asked, %5u on the bus (%4.1f%% saved)\n", Mode, READS_ASKED, busReads,
+           100.0*(READS_ASKED - (int)busReads)/READS_ASKED);
+}
+
+int main(){
+    SimBus_Init(&bus,&simTransport);
+    bus.BitTimeNs = BIT_TIME_NS;
+    for (int d = 0; d < DEVICES; ++d) {
+        SimLM51772_Init(&devices[d],addresses[d]);
+        devices[d].Regs[USB_PD_STATUS_0] = usbPdStatus[d];
+        SimBus_Attach(&bus,&devices[d]);
+    }
+    memset(&serialTransport,0,sizeof(serialTransport));
+    serialTransport.Write = serialWrite;
+    serialTransport.Read = serialRead;
+    serialTransport.WriteRead = serialWriteRead;
+    serialTransport.Quick = serialQuick;
+    serialTransport.Delay = serialDelay;
+
+    printf("%d devices, 4 threads, %d periods of %d us\n", DEVICES, PERIODS, PERIOD_US);
+    run("direct",&serialTransport);
+    I2C_Coalesce_Init(&coalesce,&serialTransport,0,&coalesceTransport);
+    run("coalesced",&coalesceTransport);
+    printf("%26s %5u joined a read in flight\n", "", coalesce.Joined);
+    I2C_Coalesce_Destroy(&coalesce);
+    I2C_Coalesce_Init(&coalesce,&serialTransport,FRESH_NS,&coalesceTransport);
+    run("coalesced, 2 ms window",&coalesceTransport);
+    printf("%26s %5u joined a read in flight, %u within the window\n", "", coalesce.Joined, coalesce.Fresh);
+    I2C_Coalesce_Destroy(&coalesce);
+    printf("Wrong values: %d\n", wrong);
+    return wrong ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+#include "LM51772.h"
+#include "DVSPlanner.h"
+#include "DVSSweep.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Plans a sequence of VOUT transitions on a simulated LM51772 and compares
+// the total wait with the fixed worst case wait a caller would otherwise
+// sleep (full range at the slowest slew rate).
+
+int main(){
+    SimI2CBus bus;
+    SimLM51772 device;
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    SimBus_Attach(&bus,&device);
+    I2C_SetTransport(&transport);
+
+    // Device configuration: 1 mV/us, no active down ramp, 50 mA discharge,
+    // OVP2 at 25 V, IVP at 12 V
+    setVOUT1_TARGET(LM51772_I2CADDR1,5000);
+    DVS_SlewrateConfigure(LM51772_I2CADDR1,DVS_SLEW_1mV_us);
+    Discharge_Enable(LM51772_I2CADDR1);
+    Dishcarge_StrengthConfigure(LM51772_I2CADDR1,DISCHG_STRENGTH_50mA);
+    OVP_SecondaryThreshold_Configure(LM51772_I2CADDR1,25000);
+    IVP_VoltageThreshold_Configure(LM51772_I2CADDR1,12000);
+    IVP_Enable(LM51772_I2CADDR1);
+
+    const uint16_t targets[] = {9000, 15000, 20000, 24000, 5000, 12000, 3300, 20000};
+    const uint32_t worstCase_us = ((48000 - 3300)*1000)/DVS_SlewRate_uVus(DVS_SLEW_0_5mV_us);
+    uint64_t planned_us = 0;
+    for (unsigned i = 0; i < sizeof(targets)/sizeof(targets[0]); ++i) {
+        DVS_PlannerInput input;
+        DVS_Plan plan;
+        DVS_Planner_ReadConfig(LM51772_I2CADDR1,&input);
+        input.Iload_mA = 500;
+        input.VoutTargetmV = targets[i];
+        DVS_Planner_Plan(&input,&plan);
+        uint32_t wait = DVS_Planner_Apply(LM51772_I2CADDR1,&input,&plan);
+        planned_us += wait;
+        printf("%5u -> %5u mV: slew %5u uV/us, down ramp %s, peak %5u mV, vin min %5u mV, wait %6u us%s\n",
+               input.VoutNowmV, input.VoutTargetmV, DVS_SlewRate_uVus(plan.Slewrate), plan.ActiveDownRamp ? "on " : "off",
+               plan.PeakmV, plan.VinMinmV, wait, plan.Feasible ? "" : " (NOT FEASIBLE)");
+        // Let the virtual bus time pass instead of sleeping the worst case
+        I2C_DelayUs(wait);
+    }
+    printf("Total planned wait: %.2f ms, fixed worst case wait: %.2f ms\n",
+           planned_us/1e3, (double)worstCase_us*(sizeof(targets)/sizeof(targets[0]))/1e3);
+    return 0;
+}
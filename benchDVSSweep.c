@@ -0,0 +1,99 @@
+#include "LM51772.h"
+#include "DVSSweep.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// Compares the sweepVoltagesEEPROM loop (set, read back, usleep) with the
+// timed sweep engine on a simulated LM51772. Pacing uses the real clock,
+// so the period is kept short to finish quickly. The exit status is 1 if
+// the engine reports other transfers than the bus saw, does not stop at a
+// device that does not acknowledge, or the automatic 3.3 V -> 48 V plan
+// is not one code per step at the slowest period the slew rate allows.
+
+#define PERIOD_US 2000
+#define START_MV 3300
+#define STOP_MV 12300
+#define STEP_MV 100
+#define MAX_STEPS 4096
+#define AUTO_START_MV 3300
+#define AUTO_STOP_MV 48000
+
+static DVS_SweepStep steps[MAX_STEPS];
+
+static int64_t nowNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (int64_t)ts.tv_sec*1000000000ll + ts.tv_nsec;
+}
+
+int main(){
+    SimI2CBus bus;
+    SimLM51772 device;
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    SimBus_Attach(&bus,&device);
+    I2C_SetTransport(&transport);
+
+    // Legacy loop: lateness of every step against the ideal schedule
+    uint32_t count = (STOP_MV - START_MV)/STEP_MV + 1;
+    int64_t start = nowNs();
+    int64_t maxLate = 0;
+    int64_t lastLate = 0;
+    for (uint32_t k = 0; k < count; ++k) {
+        int64_t late = nowNs() - (start + (int64_t)k*PERIOD_US*1000);
+        if (late > maxLate) {
+            maxLate = late;
+        }
+        lastLate = late;
+        setVOUT1_TARGET(LM51772_I2CADDR1,(uint16_t)(START_MV + k*STEP_MV));
+        getVOUT1_TARGET(LM51772_I2CADDR1);
+        usleep(PERIOD_US);
+    }
+    printf("usleep loop: %u steps, transfers/step %.2f, max lateness %.1f us, drift at last step %.1f us\n",
+           count, (double)bus.Transfers/count, maxLate/1e3, lastLate/1e3);
+
+    // Engine with the same step and period
+    DVS_SweepSchedule schedule;
+    DVS_SweepReport report;
+    int errors = 0;
+    SimBus_ResetStats(&bus);
+    DVS_Sweep_Plan(&schedule,steps,MAX_STEPS,START_MV,STOP_MV,STEP_MV,DVS_SLEW_1mV_us,PERIOD_US);
+    if (DVS_Sweep_Run(LM51772_I2CADDR1,&schedule,&report,0,0) != I2C_OK || report.Steps != schedule.Count ||
+        report.Transfers != bus.Transfers) {
+        errors++;
+    }
+    printf("engine:      %u steps, transfers/step %.2f, lateness min %.1f us max %.1f us mean %.1f us jitter %.1f us\n",
+           report.Steps, (double)report.Transfers/report.Steps, report.MinLate_ns/1e3, report.MaxLate_ns/1e3,
+           report.MeanLate_ns/1e3, report.StdLate_ns/1e3);
+
+    // A device that does not acknowledge stops the sweep at its first write
+    SimBus_ResetStats(&bus);
+    int status = DVS_Sweep_Run(LM51772_I2CADDR2,&schedule,&report,0,0);
+    if (status >= 0 || report.Status != status || report.Steps != 0 || report.Transfers != 1) {
+        errors++;
+    }
+    printf("no device:   stopped after %u steps and %u transfers, status %d\n", report.Steps, report.Transfers, report.Status);
+
+    // Automatic step selection for every slew rate setting: one code per
+    // step, every period long enough to ramp it
+    const uint8_t slews[] = {DVS_SLEW_40mV_us, DVS_SLEW_20mV_us, DVS_SLEW_1mV_us, DVS_SLEW_0_5mV_us};
+    uint32_t autoCount = (AUTO_STOP_MV - AUTO_START_MV + VOUT_MV_PER_CODE - 1)/VOUT_MV_PER_CODE + 1;
+    for (unsigned i = 0; i < 4; ++i) {
+        uint32_t slew = DVS_SlewRate_uVus(slews[i]);
+        uint32_t rampUs = (VOUT_MV_PER_CODE*1000 + slew - 1)/slew;
+        uint32_t period = (rampUs > DVS_SWEEP_MIN_PERIOD_US) ? rampUs : DVS_SWEEP_MIN_PERIOD_US;
+        if (DVS_Sweep_Plan(&schedule,steps,MAX_STEPS,AUTO_START_MV,AUTO_STOP_MV,0,slews[i],0) != 0 ||
+            schedule.StepmV != VOUT_MV_PER_CODE || schedule.Count != autoCount || schedule.Period_us != period ||
+            schedule.Steps[schedule.Count - 1].VoutmV != AUTO_STOP_MV) {
+            errors++;
+        }
+        printf("auto step at %5u uV/us: %5u mV every %u us, %u steps for 3.3 V -> 48 V\n",
+               slew, schedule.StepmV, schedule.Period_us, schedule.Count);
+    }
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+#include "LM51772.h"
+#include "lm51772dServer.h"
+#include "lm51772dClient.h"
+#include "regCache.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <pthread.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Latency of a VOUT change requested from the resident daemon against
+// starting one process per command, like the test programs do. Both run
+// on a simulated LM51772. On the real board the one-shot process also
+// pays gpioInitialise()/gpioTerminate(), which is not included here.
+// The exit status is 1 if a request fails, if the daemon switches the
+// power stage for a client that is not its ControlUid, or if it takes a
+// VOUT out of range.
+
+#define DAEMON_REQUESTS         20000
+#define EXEC_COMMANDS           200
+
+extern char **environ;
+
+static LM51772D_Server server;
+static volatile int serverRunning = 1;
+
+static uint64_t nowNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compare(const void *a, const void *b){
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *Name, uint64_t *Samples, int Count){
+    qsort(Samples,Count,sizeof(uint64_t),compare);
+    uint64_t sum = 0;
+    for (int i = 0; i < Count; ++i) {
+        sum += Samples[i];
+    }
+    printf("%-26s mean %9.1f us  p50 %9.1f us  p99 %9.1f us\n", Name, (double)sum/Count/1000.0,
+           Samples[Count/2]/1000.0, Samples[Count*99/100]/1000.0);
+}
+
+// Simulated board owned by whoever calls it
+static void setupBoard(SimI2CBus *Bus, SimLM51772 *Device, I2C_Transport *Transport){
+    SimBus_Init(Bus,Transport);
+    SimLM51772_Init(Device,LM51772_I2CADDR1);
+    SimBus_Attach(Bus,Device);
+}
+
+static void *serverThread(void *Arg){
+    (void)Arg;
+    while (serverRunning) {
+        Daemon_Poll(&server,10);
+    }
+    return 0;
+}
+
+// What a one-shot command program does: set up the bus, one change, exit
+static int oneShot(uint16_t VoutmV){
+    static SimI2CBus bus;
+    static SimLM51772 device;
+    I2C_Transport transport;
+    setupBoard(&bus,&device,&transport);
+    I2C_SetTransport(&transport);
+    setVOUT1_TARGET(LM51772_I2CADDR1,VoutmV);
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    if (argc == 3 && strcmp(argv[1],"--oneshot") == 0) {
+        return oneShot((uint16_t)atoi(argv[2]));
+    }
+
+    // Daemon on a simulated board, in its own thread
+    static SimI2CBus bus;
+    static SimLM51772 device;
+    static RegCache cache;
+    I2C_Transport simTransport, cacheTransport;
+    setupBoard(&bus,&device,&simTransport);
+    RegCache_Init(&cache,&simTransport,&cacheTransport);
+    I2C_SetTransport(&cacheTransport);
+    char dir[64], path[96];
+    snprintf(dir,sizeof(dir),"/tmp/lm51772d-bench-%d",(int)getpid());
+    snprintf(path,sizeof(path),"%s/lm51772d.sock",dir);
+    if (Daemon_Open(&server,path,&cache) < 0) {
+        return 1;
+    }
+    pthread_t thread;
+    pthread_create(&thread,0,serverThread,0);
+
+    LM51772D_Client client;
+    if (Client_Open(&client,path) < 0) {
+        fprintf(stderr, "Cannot connect to %s\n", path);
+        return 1;
+    }
+    static uint64_t samples[DAEMON_REQUESTS];
+    for (int i = 0; i < DAEMON_REQUESTS; ++i) {
+        uint64_t start = nowNs();
+        int status = Client_SetVout(&client,LM51772_I2CADDR1,(uint16_t)(5000 + (i % 100)*100));
+        samples[i] = nowNs() - start;
+        if (status != LM51772D_OK) {
+            fprintf(stderr, "Request %d failed with %d\n", i, status);
+            return 1;
+        }
+    }
+    report("daemon set VOUT",samples,DAEMON_REQUESTS);
+    for (int i = 0; i < DAEMON_REQUESTS; ++i) {
+        uint64_t start = nowNs();
+        uint16_t vout;
+        Client_GetVout(&client,LM51772_I2CADDR1,&vout);
+        samples[i] = nowNs() - start;
+    }
+    report("daemon get VOUT",samples,DAEMON_REQUESTS);
+    for (int i = 0; i < DAEMON_REQUESTS; ++i) {
+        uint64_t start = nowNs();
+        Client_Request(&client,LM51772D_OP_POWER_STAGE,LM51772_I2CADDR1,(uint16_t)(i & 1),0);
+        samples[i] = nowNs() - start;
+    }
+    report("daemon power stage",samples,DAEMON_REQUESTS);
+    printf("Register cache: %u hits, %u misses\n", cache.Hits, cache.Misses);
+
+    // The same client when it is not the user of the daemon
+    serverRunning = 0;
+    pthread_join(thread,0);
+    server.ControlUid = geteuid() + 1;
+    serverRunning = 1;
+    pthread_create(&thread,0,serverThread,0);
+    uint8_t before = device.Regs[USB_PD_CONTROL_0];
+    int denied = Client_PowerStage(&client,LM51772_I2CADDR1,(before & 0x01) == 0);
+    int allowed = Client_SetVout(&client,LM51772_I2CADDR1,5000);
+    int range = Client_SetVout(&client,LM51772_I2CADDR1,VOUT_MAX_MV + 1);
+    printf("Other user: power stage %d, set VOUT %d, VOUT out of range %d\n", denied, allowed, range);
+    Client_Close(&client);
+    serverRunning = 0;
+    pthread_join(thread,0);
+    Daemon_Close(&server);
+    rmdir(dir);
+    if (denied != LM51772D_ERR_PERM || allowed != LM51772D_OK || range != LM51772D_ERR_ARG || device.Regs[USB_PD_CONTROL_0] != before) {
+        return 1;
+    }
+
+    // One process per command
+    for (int i = 0; i < EXEC_COMMANDS; ++i) {
+        char vout[16];
+        snprintf(vout,sizeof(vout),"%d",5000 + (i % 100)*100);
+        char *args[] = {argv[0], "--oneshot", vout, 0};
+        pid_t pid;
+        uint64_t start = nowNs();
+        if (posix_spawn(&pid,argv[0],0,0,args,environ) != 0) {
+            perror("posix_spawn");
+            return 1;
+        }
+        int wstatus;
+        waitpid(pid,&wstatus,0);
+        samples[i] = nowNs() - start;
+    }
+    report("exec per command set VOUT",samples,EXEC_COMMANDS);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "EEPROMJournal.h"
+#include "simEEPROM.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Boot time lookup cost of the EEPROM journal as the log fills, and
+// recovery from torn writes, on a simulated 24Cxx.
+
+#define JOURNAL_BASE 0x0200
+#define JOURNAL_SLOTS 64
+
+static SimEEPROM sim;
+static I2C_Transport transport;
+
+// Saved operating point used as payload
+static void makePayload(uint32_t Index, uint8_t *Payload){
+    memset(Payload,0,JOURNAL_PAYLOAD_SIZE);
+    uint16_t vout = (uint16_t)(3300 + (Index % 400)*100);
+    Payload[0] = (uint8_t)(vout & 0xFF);
+    Payload[1] = (uint8_t)(vout >> 8);
+    Payload[2] = (uint8_t)Index;
+}
+
+// Appends records until Count records have been saved in total
+static void fill(EEPROM_Journal *Journal, uint32_t *Saved, uint32_t Count){
+    uint8_t payload[JOURNAL_PAYLOAD_SIZE];
+    while (*Saved < Count) {
+        makePayload(*Saved,payload);
+        Journal_Append(Journal,payload,JOURNAL_PAYLOAD_SIZE);
+        (*Saved)++;
+    }
+}
+
+// Mounts the journal and checks it found the expected record
+static int mountAndCheck(EEPROM_Journal *Journal, uint32_t ExpectedIndex, int ExpectEmpty){
+    SimEEPROM_ResetStats(&sim);
+    uint64_t start = sim.NowNs;
+    Journal_Mount(Journal,EEPROM_I2CADDR,JOURNAL_BASE,JOURNAL_SLOTS);
+    uint64_t busNs = sim.NowNs - start;
+    uint32_t transfers = sim.Transfers;
+    uint32_t bytes = sim.BytesOnWire;
+    int ok;
+    if (ExpectEmpty) {
+        ok = (Journal->Head < 0);
+    }
+    else {
+        uint8_t payload[JOURNAL_PAYLOAD_SIZE];
+        uint8_t expected[JOURNAL_PAYLOAD_SIZE];
+        makePayload(ExpectedIndex,expected);
+        ok = (Journal->Head == (int32_t)(ExpectedIndex % JOURNAL_SLOTS)) &&
+             (Journal_ReadLatest(Journal,payload) == I2C_OK) &&
+             (memcmp(payload,expected,JOURNAL_PAYLOAD_SIZE) == 0);
+    }
+    printf("head:%3d seq:%5u record reads:%3u transfers:%3u bytes:%5u bus time:%6.2f ms %s\n",
+           Journal->Head, Journal->Sequence, Journal->Reads, transfers, bytes, busNs/1e6, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+int main(){
+    EEPROM_Journal journal;
+    uint32_t saved = 0;
+    int failures = 0;
+    SimEEPROM_Init(&sim,EEPROM_I2CADDR,&transport);
+    I2C_SetTransport(&transport);
+
+    printf("Journal of %d slots of %d bytes, a linear scan reads %d slots\n", JOURNAL_SLOTS, JOURNAL_SLOT_SIZE, JOURNAL_SLOTS);
+    const uint32_t levels[] = {0, 1, 2, 16, 32, 63, 64, 65, 100, 128, 1000, 4097};
+    for (unsigned i = 0; i < sizeof(levels)/sizeof(levels[0]); ++i) {
+        Journal_Mount(&journal,EEPROM_I2CADDR,JOURNAL_BASE,JOURNAL_SLOTS);
+        fill(&journal,&saved,levels[i]);
+        printf("saved:%5u ", saved);
+        failures += !mountAndCheck(&journal,saved - 1,saved == 0);
+    }
+
+    printf("\nTorn writes\n");
+    const int32_t tears[] = {0, 2, 10, JOURNAL_SLOT_SIZE - 1};
+    for (unsigned i = 0; i < sizeof(tears)/sizeof(tears[0]); ++i) {
+        uint8_t payload[JOURNAL_PAYLOAD_SIZE];
+        Journal_Mount(&journal,EEPROM_I2CADDR,JOURNAL_BASE,JOURNAL_SLOTS);
+        // Tear the record that goes to slot 0 on wrap-around for the last case
+        if (i == sizeof(tears)/sizeof(tears[0]) - 1) {
+            fill(&journal,&saved,saved + (JOURNAL_SLOTS - journal.Head - 1));
+        }
+        makePayload(saved,payload);
+        SimEEPROM_TearNextWrite(&sim,tears[i]);
+        Journal_Append(&journal,payload,JOURNAL_PAYLOAD_SIZE);
+        printf("torn after %2d bytes -> ", tears[i]);
+        failures += !mountAndCheck(&journal,saved - 1,0);
+        // The next save overwrites the torn slot
+        fill(&journal,&saved,saved + 1);
+        printf("     next save     -> ");
+        failures += !mountAndCheck(&journal,saved - 1,0);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+#include "EEPROM24Cxx.h"
+#include "simEEPROM.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Benchmark of the EEPROM page write engine against the byte per byte
+// path used by the test programs, both run on a simulated 24Cxx.
+
+#define PROFILE_SIZE 64
+
+static uint64_t hostNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + ts.tv_nsec;
+}
+
+// Byte path: poll, then a 3 byte write (address high, address low, data)
+// for every byte, exactly as the I2C_WriteRegByte shims do
+static void writeByteByByte(uint16_t MemAddress, const uint8_t *Data, uint16_t Length){
+    for (uint16_t i = 0; i < Length; ++i) {
+        if (pollForDevice(EEPROM_I2CADDR) != 0) {
+            fprintf(stderr, "Device at address 0x%02X is not ready\n", EEPROM_I2CADDR);
+            return;
+        }
+        uint8_t buff[3];
+        buff[0] = (uint8_t)((MemAddress + i) >> 8);
+        buff[1] = (uint8_t)((MemAddress + i) & 0xFF);
+        buff[2] = Data[i];
+        I2C_WriteBlock(EEPROM_I2CADDR,buff,3);
+    }
+}
+
+static void report(const char *Name, SimEEPROM *Sim, uint64_t StartNs, uint64_t CpuNs, int Verified){
+    printf("%-10s cycles:%4u transfers:%5u nacks:%5u bytes:%6u bus time:%8.2f ms cpu:%8.1f us %s\n",
+           Name, Sim->WriteCycles, Sim->Transfers, Sim->Nacks, Sim->BytesOnWire,
+           (Sim->NowNs - StartNs)/1e6, CpuNs/1e3, Verified ? "OK" : "MISMATCH");
+}
+
+static void runCase(uint16_t MemAddress){
+    SimEEPROM sim;
+    I2C_Transport transport;
+    uint8_t profile[PROFILE_SIZE];
+    uint8_t readBack[PROFILE_SIZE];
+    for (int i = 0; i < PROFILE_SIZE; ++i) {
+        profile[i] = (uint8_t)(i*7 + 3);
+    }
+    printf("\n%d byte profile at address 0x%04X (page size %d)\n", PROFILE_SIZE, MemAddress, EEPROM_PAGE_SIZE);
+
+    // Byte per byte path
+    SimEEPROM_Init(&sim,EEPROM_I2CADDR,&transport);
+    I2C_SetTransport(&transport);
+    uint64_t start = sim.NowNs;
+    uint64_t cpu = hostNs();
+    writeByteByByte(MemAddress,profile,PROFILE_SIZE);
+    EEPROM_WaitReady(EEPROM_I2CADDR);
+    cpu = hostNs() - cpu;
+    int verified = (EEPROM_Read(EEPROM_I2CADDR,MemAddress,readBack,PROFILE_SIZE) == I2C_OK) &&
+                   (memcmp(profile,readBack,PROFILE_SIZE) == 0);
+    report("byte",&sim,start,cpu,verified);
+
+    // Page write path
+    SimEEPROM_Init(&sim,EEPROM_I2CADDR,&transport);
+    start = sim.NowNs;
+    cpu = hostNs();
+    EEPROM_Write(EEPROM_I2CADDR,MemAddress,profile,PROFILE_SIZE);
+    EEPROM_WaitReady(EEPROM_I2CADDR);
+    cpu = hostNs() - cpu;
+    verified = (EEPROM_Read(EEPROM_I2CADDR,MemAddress,readBack,PROFILE_SIZE) == I2C_OK) &&
+               (memcmp(profile,readBack,PROFILE_SIZE) == 0);
+    report("page",&sim,start,cpu,verified);
+
+    // Sequential block read against one read per byte
+    SimEEPROM_ResetStats(&sim);
+    start = sim.NowNs;
+    for (int i = 0; i < PROFILE_SIZE; ++i) {
+        EEPROM_Read(EEPROM_I2CADDR,MemAddress + i,&readBack[i],1);
+    }
+    printf("read byte  transfers:%5u bytes:%6u bus time:%8.2f ms\n", sim.Transfers, sim.BytesOnWire, (sim.NowNs - start)/1e6);
+    SimEEPROM_ResetStats(&sim);
+    start = sim.NowNs;
+    EEPROM_Read(EEPROM_I2CADDR,MemAddress,readBack,PROFILE_SIZE);
+    printf("read block transfers:%5u bytes:%6u bus time:%8.2f ms\n", sim.Transfers, sim.BytesOnWire, (sim.NowNs - start)/1e6);
+}
+
+int main(){
+    // Page aligned and unaligned profiles
+    runCase(0x0100);
+    runCase(0x0110);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "LM51772.h"
+#include "LM51772Sync.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Fleet-wide commands on the simulated bus, one call per device against
+// one PMBus group command for all of them: transactions, bus time and the
+// spread between the first and the last device executing the command.
+// The simulated devices execute group commands at the STOP and the host
+// needs HOST_GAP_NS between two transactions. The exit status is 1 if a
+// device is left with a fault flag or an enabled power stage.
+
+#define MAX_DEVICES             32
+#define FIRST_ADDRESS           0x40
+#define HOST_GAP_NS             50000
+#define FAULTS                  (FLT_OCP|FLT_OVP|FLT_TEMPERATURE)
+
+static SimI2CBus bus;
+static I2C_Transport transport;
+static SimLM51772 devices[MAX_DEVICES];
+static uint8_t addresses[MAX_DEVICES];
+
+static void prepare(int Count){
+    for (int i = 0; i < Count; ++i) {
+        devices[i].Regs[STATUS_BYTE] |= FAULTS;
+        devices[i].Regs[USB_PD_CONTROL_0] |= 0x01;
+        devices[i].Regs[MFR_SPECIFIC_D0] |= 0x01;
+    }
+}
+
+static uint64_t spreadNs(int Count){
+    uint64_t first = devices[0].LastWriteNs, last = first;
+    for (int i = 1; i < Count; ++i) {
+        uint64_t t = devices[i].LastWriteNs;
+        first = (t < first) ? t : first;
+        last = (t > last) ? t : last;
+    }
+    return last - first;
+}
+
+static int check(int Count, const char *What){
+    int errors = 0;
+    for (int i = 0; i < Count; ++i) {
+        if ((devices[i].Regs[STATUS_BYTE] & FAULTS) != 0 ||
+            (devices[i].Regs[USB_PD_CONTROL_0] & 0x01) != 0 || (devices[i].Regs[MFR_SPECIFIC_D0] & 0x01) != 0) {
+            printf("%s: device 0x%02X not cleared/disabled\n", What, addresses[i]);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static void report(const char *What, int Count){
+    printf("%-30s %2d devices %5u transactions %9.2f ms, spread %8.2f ms\n", What, Count, bus.Transfers,
+           bus.NowNs/1e6, spreadNs(Count)/1e6);
+    SimBus_ResetStats(&bus);
+    bus.NowNs = 0;
+}
+
+int main(){
+    SimBus_Init(&bus,&transport);
+    bus.HostGapNs = HOST_GAP_NS;
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        addresses[i] = (uint8_t)(FIRST_ADDRESS + i);
+        SimLM51772_Init(&devices[i],addresses[i]);
+        devices[i].GroupCommand = 1;
+        SimBus_Attach(&bus,&devices[i]);
+    }
+    I2C_SetTransport(&transport);
+
+    int errors = 0;
+    static const int counts[] = {2, 4, 8, 16, 32};
+    for (unsigned c = 0; c < sizeof(counts)/sizeof(counts[0]); ++c) {
+        int n = counts[c];
+        LM51772_SyncGroup group;
+        LM51772_Sync_Init(&group,addresses,(uint8_t)n);
+
+        prepare(n);
+        for (int i = 0; i < n; ++i) {
+            ClearFaults(addresses[i]);
+        }
+        report("ClearFaults per device",n);
+        for (int i = 0; i < n; ++i) {
+            DisablePowerStage(addresses[i]);
+        }
+        report("DisablePowerStage per device",n);
+        errors += check(n,"per device");
+
+        prepare(n);
+        LM51772_Sync_ClearFaults(&group);
+        report("ClearFaults group",n);
+        LM51772_Sync_DisablePowerStage(&group);
+        report("DisablePowerStage group",n);
+        errors += check(n,"group");
+        printf("\n");
+    }
+    printf("%s\n", errors ? "ERRORS" : "Every device cleared and disabled");
+    return errors ? 1 : 0;
+}
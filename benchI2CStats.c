@@ -0,0 +1,129 @@
+#include "LM51772.h"
+#include "LM51772Regs.h"
+#include "simLM51772.h"
+#include "i2cStats.h"
+#include "i2cTransport.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Transport accounting on a simulated LM51772 bring-up, and cost of the
+// recording itself, alone and from several threads at once.
+// i2cTransport.c has to be compiled with -DI2C_STATS for this program.
+// The exit status is 1 if register reads through a backend without
+// WriteRead and Transfer are not accounted as one write-read of their
+// register each.
+
+#define RECORDS         2000000
+#define THREADS         4
+
+static const char *OpNames[I2C_OP_COUNT] = {"write", "read", "write-read", "quick"};
+
+static void *recordLoop(void *Arg){
+    uint8_t addr = (uint8_t)(uintptr_t)Arg;
+    for (int i = 0; i < RECORDS; ++i) {
+        I2C_Stats_Record(I2C_OP_WRITE,addr,MFR_SPECIFIC_D0,I2C_OK,(uint64_t)(i & 0xFFF));
+    }
+    return 0;
+}
+
+int main(){
+    static SimI2CBus bus;
+    static SimLM51772 device;
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    SimBus_Attach(&bus,&device);
+    I2C_SetTransport(&transport);
+
+    // Bring-up with a missing device on the way
+    I2C_Stats_Reset();
+    ClearFaults(LM51772_I2CADDR1);
+    setVOUT1_TARGET(LM51772_I2CADDR1,12000);
+    HiccupProtection_Enable(LM51772_I2CADDR1);
+    ThermalWarning_ThresholdConfigure(LM51772_I2CADDR1,THW_THRESHOLD_110degC);
+    DVS_SlewrateConfigure(LM51772_I2CADDR1,DVS_SLEW_1mV_us);
+    IVP_VoltageThreshold_Configure(LM51772_I2CADDR1,12000);
+    EnablePowerStage(LM51772_I2CADDR1);
+    pollForDevice(LM51772_I2CADDR2);
+    getVOUT1_TARGET(LM51772_I2CADDR1);
+
+    static I2C_StatsSnapshot snap;
+    I2C_Stats_Snapshot(&snap);
+    printf("Device  reads  writes  nacks  errors  poll retries\n");
+    for (int i = 0; i < 128; ++i) {
+        const I2C_DeviceStats *d = &snap.Devices[i];
+        if (d->Reads + d->Writes + d->Nacks + d->Errors + d->PollRetries != 0) {
+            printf("0x%02X   %6llu  %6llu  %5llu  %6llu  %12llu\n", i,
+                   (unsigned long long)d->Reads, (unsigned long long)d->Writes, (unsigned long long)d->Nacks,
+                   (unsigned long long)d->Errors, (unsigned long long)d->PollRetries);
+        }
+    }
+    printf("\nRegister              reads  writes\n");
+    for (int i = 0; i < 256; ++i) {
+        if (snap.Registers[i].Reads + snap.Registers[i].Writes != 0) {
+            printf("%-20s  %5llu  %6llu\n", LM51772_RegisterName((uint8_t)i),
+                   (unsigned long long)snap.Registers[i].Reads, (unsigned long long)snap.Registers[i].Writes);
+        }
+    }
+    printf("\nOperation    count     p50 ns    p99 ns    max ns\n");
+    for (int op = 0; op < I2C_OP_COUNT; ++op) {
+        const I2C_Histogram *h = &snap.Latency[op];
+        printf("%-10s  %6llu  %9llu %9llu %9llu\n", OpNames[op], (unsigned long long)h->Count,
+               (unsigned long long)I2C_Stats_Percentile(h,50), (unsigned long long)I2C_Stats_Percentile(h,99),
+               (unsigned long long)h->MaxNs);
+    }
+
+    // Register reads through a backend issuing them as a write and a read
+    I2C_Transport split = transport;
+    split.WriteRead = 0;
+    split.Transfer = 0;
+    I2C_SetTransport(&split);
+    I2C_Stats_Reset();
+    uint8_t reg = MFR_SPECIFIC_D2;
+    uint8_t value = 0;
+    I2C_ReadRegByte(LM51772_I2CADDR1,VOUT_TARGET1_LSB);
+    I2C_Message messages[2] = {{LM51772_I2CADDR1, 0, 1, &reg}, {LM51772_I2CADDR1, I2C_MSG_READ, 1, &value}};
+    I2C_Transfer(messages,2);
+    I2C_SetTransport(&transport);
+    I2C_Stats_Snapshot(&snap);
+    int errors = 0;
+    if (snap.Latency[I2C_OP_WRITEREAD].Count != 2 || snap.Latency[I2C_OP_WRITE].Count != 0 ||
+        snap.Latency[I2C_OP_READ].Count != 0 || snap.Registers[VOUT_TARGET1_LSB].Reads != 1 ||
+        snap.Registers[MFR_SPECIFIC_D2].Reads != 1 || snap.Devices[LM51772_I2CADDR1].Reads != 2 ||
+        value != device.Regs[MFR_SPECIFIC_D2]) {
+        errors++;
+    }
+    printf("\nWithout WriteRead and Transfer: %llu write-reads, %llu writes, %llu reads\n",
+           (unsigned long long)snap.Latency[I2C_OP_WRITEREAD].Count, (unsigned long long)snap.Latency[I2C_OP_WRITE].Count,
+           (unsigned long long)snap.Latency[I2C_OP_READ].Count);
+
+    // Cost of the recording, one thread
+    I2C_Stats_Reset();
+    uint64_t start = I2C_Stats_Now();
+    recordLoop((void *)(uintptr_t)LM51772_I2CADDR1);
+    double single = (double)(I2C_Stats_Now() - start)/RECORDS;
+    // Cost of the time stamps taken around every transfer
+    start = I2C_Stats_Now();
+    volatile uint64_t sink = 0;
+    for (int i = 0; i < RECORDS; ++i) {
+        sink += I2C_Stats_Now();
+    }
+    double stamp = (double)(I2C_Stats_Now() - start)/RECORDS;
+    // Several threads recording on the same device
+    pthread_t threads[THREADS];
+    start = I2C_Stats_Now();
+    for (int t = 0; t < THREADS; ++t) {
+        pthread_create(&threads[t],0,recordLoop,(void *)(uintptr_t)LM51772_I2CADDR1);
+    }
+    for (int t = 0; t < THREADS; ++t) {
+        pthread_join(threads[t],0);
+    }
+    double shared = (double)(I2C_Stats_Now() - start)/RECORDS;
+    I2C_Stats_Snapshot(&snap);
+    printf("\nRecord: %.1f ns, time stamp: %.1f ns (x2 per transfer)\n", single, stamp);
+    printf("%d threads: %.1f ns per record round, %llu writes counted (expected %llu)\n", THREADS, shared,
+           (unsigned long long)snap.Devices[LM51772_I2CADDR1].Writes,
+           (unsigned long long)(RECORDS*(THREADS + 1ull)));
+    return errors ? 1 : 0;
+}
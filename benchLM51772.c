@@ -0,0 +1,347 @@
+#include "LM51772.h"
+#include "simLM51772.h"
+#include "i2cCounter.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// Microbenchmark of every public function of LM51772.h. Each function
+// runs against the counting mock (pure driver cost) and against the
+// counting transport wrapped around the simulated LM51772. Reports CPU
+// ns per call, bus transfers per call and bytes on the wire per call as
+// CSV (default) or JSON.
+//
+// Usage: benchLM51772 [--json] [--iterations N] [--baseline file.csv]
+// With --baseline the transfers and bytes per call are compared against
+// a previous CSV output, the program exits with 1 if any of them grew.
+
+#define DEFAULT_ITERATIONS      20000
+
+typedef struct{
+    const char *Name;                   // Function name
+    void (*Call)(uint8_t I2CAddress);   // Thunk calling it with typical arguments
+} BenchEntry;
+
+typedef struct{
+    const char *Name;
+    const char *Transport;
+    double NsPerCall;
+    double TransfersPerCall;
+    double BytesPerCall;
+} BenchResult;
+
+// Keeps the results of the getters alive
+static volatile uint32_t Sink;
+
+#define BENCH0(fn)          static void bench_##fn(uint8_t a){ fn(a); }
+#define BENCH1(fn, arg)     static void bench_##fn(uint8_t a){ fn(a,arg); }
+#define BENCHGET(fn)        static void bench_##fn(uint8_t a){ Sink += fn(a); }
+#define ENTRY(fn)           { #fn, bench_##fn }
+
+BENCH0(ClearFaults)
+BENCH1(setILIM_THRESHOLD, 5000)
+BENCH1(setVOUT1_TARGET, 12000)
+BENCHGET(getVOUT1_TARGET)
+static void bench_VOUT1_TARGET_Encode(uint8_t a){ (void)a; Sink += VOUT1_TARGET_Encode(12000); }
+BENCH0(ForceDischargeEnable)
+BENCH0(ForceDischargeDisable)
+BENCH0(EnablePowerStage)
+BENCH0(DisablePowerStage)
+BENCHGET(get_USBPD_STATUS)
+BENCHGET(get_STATUS_BYTE)
+BENCH1(ClearFaultFlag, FLT_OVP)
+BENCH0(uSleep_Enable)
+BENCH0(uSleep_Disable)
+BENCH0(DRSS_Enable)
+BENCH0(DRSS_Disable)
+BENCH0(HiccupProtection_Enable)
+BENCH0(HiccupProtection_Disable)
+BENCH0(CurrentLimiter_Enable)
+BENCH0(CurrentLimiter_Disable)
+BENCH0(Vcc1LDO_Enable)
+BENCH0(Vcc1LDO_Disable)
+BENCH0(NegativeCurrentLimiting_Enable)
+BENCH0(NegativeCurrentLimiting_Disable)
+BENCH0(PSM_2PhaseBB_Enable)
+BENCH0(PSM_2PhaseBB_Disable)
+BENCH0(FPWM_2PhaseBB_Enable)
+BENCH0(FPWM_2PhaseBB_Disable)
+BENCH0(ForceBias_Enable)
+BENCH0(ForceBias_Disable)
+BENCH0(DTRK_DirectStartup_Enable)
+BENCH0(DTRK_DirectStartup_Disable)
+BENCH0(nFLT_as_INT_Enable)
+BENCH0(nFLT_as_INT_Disable)
+BENCH1(ThermalWarning_ThresholdConfigure, THW_THRESHOLD_110degC)
+BENCH0(ThermalWarning_Enable)
+BENCH0(ThermalWarning_Disable)
+BENCH0(Discharge_VTH_Enable)
+BENCH0(Discharge_VTH_Disable)
+BENCH0(Discharge_Enable)
+BENCH0(Discharge_Disable)
+BENCH1(Dishcarge_StrengthConfigure, DISCHG_STRENGTH_50mA)
+BENCH1(DVS_SlewrateConfigure, DVS_SLEW_1mV_us)
+BENCH0(DVS_ActiveDownRamp_Enable)
+BENCH0(DVS_ActiveDownRamp_Disable)
+BENCH1(VDET_FallingThresholdConfigure, 4500)
+BENCH0(VDET_Enable)
+BENCH0(VDET_Disable)
+BENCH0(IVP_InputVoltageRegulation_Enable)
+BENCH0(IVP_InputVoltageRegulation_Disable)
+BENCH0(IVP_Enable)
+BENCH0(IVP_Disable)
+BENCH1(VDET_RisingThresholdConfigure, 5000)
+BENCH1(OVP_SecondaryThreshold_Configure, 20000)
+BENCH1(BB_MinTimeScale_Select, BB_MINTIME_SCALE_1x)
+BENCH1(GDRV_MinDeadTime_Select, GDRV_MINDEADTIME_20ns)
+BENCH0(GDRV_DeadTimeScaling_Enable)
+BENCH0(GDRV_DeadTimeScaling_Disable)
+BENCH0(GDRV_ForceConstantDeadTime_Enable)
+BENCH0(GDRV_ForceConstantDeadTime_Disable)
+BENCH1(OSC_FreqSyncConfigure, OSC_SYNC_INPUT_RISING)
+BENCH1(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_1_0)
+BENCH1(SlopeComp_InductorDerating_Select, INDUC_DERATE_20)
+BENCH1(DRV1_Supply_Configure, DRV1_SUP_VOUT)
+BENCH1(DRV1_Sequence_Configure, DRV1_SEQ_PULL_LOW_CONV_ON)
+BENCH1(CDC_GainVoltage_Select, CDC_GAIN_0_500V)
+BENCH0(CDC_Enable)
+BENCH0(CDC_Disable)
+BENCH0(LM51772_FB_Divider_Sel20)
+BENCH0(LM51772_FB_Divider_Sel10)
+BENCH1(PCM_LowerVoltageWindow_Configure, 500)
+BENCH1(PCM_LowerVoltageWindow_ConfigureF, 0.5f)
+BENCH0(OCP_ISET_OverILIM_Enable)
+BENCH0(OCP_ISET_OverILIM_Disable)
+BENCH1(IVP_VoltageThreshold_Configure, 12000)
+
+static const BenchEntry Entries[] = {
+    ENTRY(ClearFaults),
+    ENTRY(setILIM_THRESHOLD),
+    ENTRY(setVOUT1_TARGET),
+    ENTRY(getVOUT1_TARGET),
+    ENTRY(VOUT1_TARGET_Encode),
+    ENTRY(ForceDischargeEnable),
+    ENTRY(ForceDischargeDisable),
+    ENTRY(EnablePowerStage),
+    ENTRY(DisablePowerStage),
+    ENTRY(get_USBPD_STATUS),
+    ENTRY(get_STATUS_BYTE),
+    ENTRY(ClearFaultFlag),
+    ENTRY(uSleep_Enable),
+    ENTRY(uSleep_Disable),
+    ENTRY(DRSS_Enable),
+    ENTRY(DRSS_Disable),
+    ENTRY(HiccupProtection_Enable),
+    ENTRY(HiccupProtection_Disable),
+    ENTRY(CurrentLimiter_Enable),
+    ENTRY(CurrentLimiter_Disable),
+    ENTRY(Vcc1LDO_Enable),
+    ENTRY(Vcc1LDO_Disable),
+    ENTRY(NegativeCurrentLimiting_Enable),
+    ENTRY(NegativeCurrentLimiting_Disable),
+    ENTRY(PSM_2PhaseBB_Enable),
+    ENTRY(PSM_2PhaseBB_Disable),
+    ENTRY(FPWM_2PhaseBB_Enable),
+    ENTRY(FPWM_2PhaseBB_Disable),
+    ENTRY(ForceBias_Enable),
+    ENTRY(ForceBias_Disable),
+    ENTRY(DTRK_DirectStartup_Enable),
+    ENTRY(DTRK_DirectStartup_Disable),
+    ENTRY(nFLT_as_INT_Enable),
+    ENTRY(nFLT_as_INT_Disable),
+    ENTRY(ThermalWarning_ThresholdConfigure),
+    ENTRY(ThermalWarning_Enable),
+    ENTRY(ThermalWarning_Disable),
+    ENTRY(Discharge_VTH_Enable),
+    ENTRY(Discharge_VTH_Disable),
+    ENTRY(Discharge_Enable),
+    ENTRY(Discharge_Disable),
+    ENTRY(Dishcarge_StrengthConfigure),
+    ENTRY(DVS_SlewrateConfigure),
+    ENTRY(DVS_ActiveDownRamp_Enable),
+    ENTRY(DVS_ActiveDownRamp_Disable),
+    ENTRY(VDET_FallingThresholdConfigure),
+    ENTRY(VDET_Enable),
+    ENTRY(VDET_Disable),
+    ENTRY(IVP_InputVoltageRegulation_Enable),
+    ENTRY(IVP_InputVoltageRegulation_Disable),
+    ENTRY(IVP_Enable),
+    ENTRY(IVP_Disable),
+    ENTRY(VDET_RisingThresholdConfigure),
+    ENTRY(OVP_SecondaryThreshold_Configure),
+    ENTRY(BB_MinTimeScale_Select),
+    ENTRY(GDRV_MinDeadTime_Select),
+    ENTRY(GDRV_DeadTimeScaling_Enable),
+    ENTRY(GDRV_DeadTimeScaling_Disable),
+    ENTRY(GDRV_ForceConstantDeadTime_Enable),
+    ENTRY(GDRV_ForceConstantDeadTime_Disable),
+    ENTRY(OSC_FreqSyncConfigure),
+    ENTRY(SlopeComp_CorrectionFactor_Select),
+    ENTRY(SlopeComp_InductorDerating_Select),
+    ENTRY(DRV1_Supply_Configure),
+    ENTRY(DRV1_Sequence_Configure),
+    ENTRY(CDC_GainVoltage_Select),
+    ENTRY(CDC_Enable),
+    ENTRY(CDC_Disable),
+    ENTRY(LM51772_FB_Divider_Sel20),
+    ENTRY(LM51772_FB_Divider_Sel10),
+    ENTRY(PCM_LowerVoltageWindow_Configure),
+    ENTRY(PCM_LowerVoltageWindow_ConfigureF),
+    ENTRY(OCP_ISET_OverILIM_Enable),
+    ENTRY(OCP_ISET_OverILIM_Disable),
+    ENTRY(IVP_VoltageThreshold_Configure),
+};
+#define ENTRY_COUNT (sizeof(Entries)/sizeof(Entries[0]))
+
+static BenchResult Results[2*ENTRY_COUNT];
+static int ResultCount = 0;
+
+static uint64_t nowNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID,&ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Runs every entry against the counter, which is already selected
+static void runAll(const char *TransportName, I2C_Counter *Counter, int Iterations){
+    for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+        // Warm up, then measure
+        for (int j = 0; j < Iterations/10; ++j) {
+            Entries[i].Call(LM51772_I2CADDR1);
+        }
+        I2C_Counter_Reset(Counter);
+        uint64_t start = nowNs();
+        for (int j = 0; j < Iterations; ++j) {
+            Entries[i].Call(LM51772_I2CADDR1);
+        }
+        uint64_t elapsed = nowNs() - start;
+        BenchResult *r = &Results[ResultCount++];
+        r->Name = Entries[i].Name;
+        r->Transport = TransportName;
+        r->NsPerCall = (double)elapsed/Iterations;
+        r->TransfersPerCall = (double)Counter->Transfers/Iterations;
+        r->BytesPerCall = (double)Counter->BytesOnWire/Iterations;
+    }
+}
+
+static void writeCSV(FILE *Out){
+    fprintf(Out,"function,transport,ns_per_call,transfers_per_call,bytes_per_call\n");
+    for (int i = 0; i < ResultCount; ++i) {
+        fprintf(Out,"%s,%s,%.1f,%.2f,%.2f\n", Results[i].Name, Results[i].Transport,
+                Results[i].NsPerCall, Results[i].TransfersPerCall, Results[i].BytesPerCall);
+    }
+}
+
+static void writeJSON(FILE *Out){
+    fprintf(Out,"[\n");
+    for (int i = 0; i < ResultCount; ++i) {
+        fprintf(Out,"  {\"function\": \"%s\", \"transport\": \"%s\", \"ns_per_call\": %.1f, "
+                "\"transfers_per_call\": %.2f, \"bytes_per_call\": %.2f}%s\n",
+                Results[i].Name, Results[i].Transport, Results[i].NsPerCall,
+                Results[i].TransfersPerCall, Results[i].BytesPerCall, (i + 1 < ResultCount) ? "," : "");
+    }
+    fprintf(Out,"]\n");
+}
+
+// Compares the bus cost against a previous CSV output, returns the
+// number of functions whose transfers or bytes per call grew
+static int compareBaseline(const char *Path){
+    FILE *f = fopen(Path,"r");
+    if (f == 0) {
+        fprintf(stderr,"Cannot open baseline %s\n",Path);
+        return -1;
+    }
+    char line[256];
+    int regressions = 0;
+    while (fgets(line,sizeof(line),f) != 0) {
+        char name[96], transport[32];
+        double ns, transfers, bytes;
+        if (sscanf(line,"%95[^,],%31[^,],%lf,%lf,%lf",name,transport,&ns,&transfers,&bytes) != 5) {
+            continue; // Header or malformed line
+        }
+        for (int i = 0; i < ResultCount; ++i) {
+            if (strcmp(Results[i].Name,name) != 0 || strcmp(Results[i].Transport,transport) != 0) {
+                continue;
+            }
+            if (Results[i].TransfersPerCall > transfers + 0.005 || Results[i].BytesPerCall > bytes + 0.005) {
+                fprintf(stderr,"REGRESSION %s (%s): transfers %.2f -> %.2f, bytes %.2f -> %.2f\n",
+                        name, transport, transfers, Results[i].TransfersPerCall, bytes, Results[i].BytesPerCall);
+                regressions++;
+            }
+        }
+    }
+    fclose(f);
+    return regressions;
+}
+
+int main(int argc, char *argv[]){
+    int json = 0;
+    int iterations = DEFAULT_ITERATIONS;
+    const char *baseline = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i],"--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[i],"--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else {
+            fprintf(stderr,"Usage: %s [--json] [--iterations N] [--baseline file.csv]\n",argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        iterations = DEFAULT_ITERATIONS;
+    }
+
+    // Some functions of the library print, keep their output away from
+    // the results
+    fflush(stdout);
+    FILE *out = fdopen(dup(STDOUT_FILENO),"w");
+    int devnull = open("/dev/null",O_WRONLY);
+    if (out == 0 || devnull < 0) {
+        fprintf(stderr,"Cannot redirect the standard output\n");
+        return 1;
+    }
+    dup2(devnull,STDOUT_FILENO);
+    close(devnull);
+
+    // Counting mock, no device behind it
+    I2C_Counter counter;
+    I2C_Transport counting;
+    I2C_Counter_Init(&counter,0,&counting);
+    I2C_SetTransport(&counting);
+    runAll("mock",&counter,iterations);
+
+    // Counting transport around the simulated LM51772
+    static SimI2CBus bus;
+    static SimLM51772 device;
+    I2C_Transport simTransport;
+    SimBus_Init(&bus,&simTransport);
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    SimBus_Attach(&bus,&device);
+    I2C_Counter_Init(&counter,&simTransport,&counting);
+    I2C_SetTransport(&counting);
+    runAll("sim",&counter,iterations);
+
+    fflush(stdout);
+    if (json) {
+        writeJSON(out);
+    } else {
+        writeCSV(out);
+    }
+    fclose(out);
+
+    if (baseline != 0) {
+        int regressions = compareBaseline(baseline);
+        if (regressions != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include "LM51772.h"
+#include "i2cMux.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Mux select writes of a round-robin telemetry sweep over 32 LM51772
+// behind two TCA9548A (8 channels each, the two LM51772 addresses per
+// channel). The converters are numbered the way the rails are laid out,
+// so neighbours sit on different channels and muxes. Every device gets
+// STATUS_BYTE, USB_PD_STATUS_0 and VOUT_TARGET1_LSB read per sweep:
+//   - select per access: the channel written before every transaction,
+//   - cached: the control registers cached, sweep in converter order,
+//   - scheduled: cached and the sweep queued on the mux scheduler, which
+//     groups it per channel.
+// The host needs HOST_GAP_NS between transactions. The exit status is 1 if
+// a value read does not come from the addressed converter, two open
+// channels answered at once, or the scheduler does not give the caller
+// its own thread transport back.
+
+#define MUXES                   2
+#define DEVICES                 (MUXES*I2C_MUX_CHANNELS*2)
+#define MUX_ADDRESS             0x70
+#define HOST_GAP_NS             50000
+#define SWEEPS                  100
+
+typedef struct{
+    I2C_MuxChannel *Channel;
+    uint8_t Address;
+    uint8_t Status;                     // Values read by the last sweep
+    uint8_t PdStatus;
+    uint8_t Vout;
+} Converter;
+
+static SimI2CBus bus;
+static I2C_Transport transport;
+static SimTCA9548A muxes[MUXES];
+static SimI2CBus channelBus[MUXES][I2C_MUX_CHANNELS];
+static SimLM51772 devices[MUXES][I2C_MUX_CHANNELS][2];
+static I2C_MuxBus muxBus;
+static I2C_MuxChannel channels[MUXES][I2C_MUX_CHANNELS];
+static I2C_MuxSched scheduler;
+static Converter converters[DEVICES];
+static int invalidateEach;
+
+// Converter k: mux k%2, channel (k/2)%8, second address from k = 16 on
+static SimLM51772 *simDevice(int K){
+    return &devices[K % MUXES][(K / MUXES) % I2C_MUX_CHANNELS][K / (MUXES*I2C_MUX_CHANNELS)];
+}
+
+static void setup(void){
+    SimBus_Init(&bus,&transport);
+    bus.HostGapNs = HOST_GAP_NS;
+    I2C_MuxBus_Init(&muxBus,&transport);
+    for (int m = 0; m < MUXES; ++m) {
+        SimTCA9548A_Init(&muxes[m],(uint8_t)(MUX_ADDRESS + m));
+        SimBus_AttachMux(&bus,&muxes[m]);
+        I2C_MuxBus_AddMux(&muxBus,(uint8_t)(MUX_ADDRESS + m));
+        for (int c = 0; c < I2C_MUX_CHANNELS; ++c) {
+            SimBus_Init(&channelBus[m][c],0);
+            muxes[m].Channels[c] = &channelBus[m][c];
+            for (int d = 0; d < 2; ++d) {
+                SimLM51772_Init(&devices[m][c][d],(uint8_t)(LM51772_I2CADDR1 + d));
+                SimBus_Attach(&channelBus[m][c],&devices[m][c][d]);
+            }
+            I2C_MuxChannel_Init(&channels[m][c],&muxBus,(uint8_t)m,(uint8_t)c);
+        }
+    }
+    for (int k = 0; k < DEVICES; ++k) {
+        SimLM51772 *device = simDevice(k);
+        converters[k].Channel = &channels[k % MUXES][(k / MUXES) % I2C_MUX_CHANNELS];
+        converters[k].Address = device->I2CAddress;
+        // Values telling the converters apart
+        device->Regs[USB_PD_STATUS_0] = (uint8_t)k;
+        device->Regs[VOUT_TARGET1_LSB] = (uint8_t)(0x80 | k);
+        SimLM51772_RaiseFault(device,(uint8_t)((k & 0x3F) & ~FLT_OFF));
+    }
+}
+
+static void beforeAccess(void){
+    if (invalidateEach) {
+        I2C_MuxBus_Invalidate(&muxBus);
+    }
+}
+
+static int telemetry(void *Context, uint8_t I2CAddress){
+    Converter *converter = (Converter *)Context;
+    beforeAccess();
+    converter->Status = get_STATUS_BYTE(I2CAddress);
+    beforeAccess();
+    converter->PdStatus = get_USBPD_STATUS(I2CAddress);
+    beforeAccess();
+    converter->Vout = I2C_ReadRegByte(I2CAddress,VOUT_TARGET1_LSB);
+    return I2C_OK;
+}
+
+static void sweep(int Scheduled){
+    for (int k = 0; k < DEVICES; ++k) {
+        Converter *converter = &converters[k];
+        if (Scheduled) {
+            I2C_MuxSched_Add(&scheduler,converter->Channel,converter->Address,telemetry,converter);
+        } else {
+            I2C_SetTransport(&converter->Channel->Transport);
+            telemetry(converter,converter->Address);
+        }
+    }
+    if (Scheduled) {
+        I2C_MuxSched_Run(&scheduler);
+    }
+}
+
+// Counts the converters whose values come from another device
+static int check(void){
+    int wrong = 0;
+    for (int k = 0; k < DEVICES; ++k) {
+        const SimLM51772 *device = simDevice(k);
+        const Converter *converter = &converters[k];
+        if (converter->Status != device->Regs[STATUS_BYTE] || converter->PdStatus != device->Regs[USB_PD_STATUS_0] ||
+            converter->Vout != device->Regs[VOUT_TARGET1_LSB]) {
+            wrong++;
+        }
+    }
+    return wrong;
+}
+
+static int run(const char *Mode, int Invalidate, int Scheduled){
+    invalidateEach = Invalidate;
+    I2C_MuxBus_Invalidate(&muxBus);
+    SimBus_ResetStats(&bus);
+    bus.NowNs = 0;
+    muxBus.Selects = muxBus.Skipped = 0;
+    int wrong = 0;
+    for (int s = 0; s < SWEEPS; ++s) {
+        for (int k = 0; k < DEVICES; ++k) {
+            converters[k].Status = converters[k].PdStatus = converters[k].Vout = 0;
+        }
+        sweep(Scheduled);
+        wrong += check();
+    }
+    printf("%-20s %6.1f selects %6.1f transfers %6.2f ms per sweep, %u conflicts, %d wrong\n", Mode,
+           (double)muxBus.Selects/SWEEPS, (double)bus.Transfers/SWEEPS, bus.NowNs/1e6/SWEEPS, bus.Conflicts, wrong);
+    return wrong + (int)bus.Conflicts;
+}
+
+int main(){
+    setup();
+    I2C_MuxSched_Init(&scheduler);
+    printf("%d LM51772 behind %d TCA9548A, %d sweeps\n", DEVICES, MUXES, SWEEPS);
+    int errors = 0;
+    errors += run("select per access",1,0);
+    errors += run("cached",0,0);
+    // The scheduled sweep runs in a thread with a transport of its own
+    const I2C_Transport *own = &converters[0].Channel->Transport;
+    I2C_SetThreadTransport(own);
+    errors += run("cached, scheduled",0,1);
+    if (I2C_GetThreadTransport() != own) {
+        printf("Thread transport not restored after the scheduler runs\n");
+        errors++;
+    }
+    I2C_SetThreadTransport(0);
+    return errors ? 1 : 0;
+}
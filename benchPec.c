@@ -0,0 +1,146 @@
+#include "LM51772.h"
+#include "LM51772Verify.h"
+#include "i2cPec.h"
+#include "simFault.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Integrity of a bring-up configuration on a noisy line (random bit flips
+// in reads and writes on the simulated bus): no checking, batched
+// read-back verification redoing the configuration on a mismatch, and
+// PEC with retries. Reports the traffic and the registers left wrong, and
+// the cost of the CRC-8 per byte. The exit status is 1 if PEC leaves a
+// register wrong.
+
+#define RUNS                    200
+#define CORRUPT_PPM             20000   // 2% of the reads and of the writes
+#define REDO_LIMIT              3
+#define CRC_BYTES               (1u << 24)
+
+static SimI2CBus bus;
+static I2C_Transport simTransport, pecTransport;
+static SimLM51772 device;
+static SimFault fault;
+static I2C_Pec pec;
+static uint8_t expected[256];
+
+static void configure(void){
+    const uint8_t addr = LM51772_I2CADDR1;
+    setVOUT1_TARGET(addr,12000);
+    HiccupProtection_Enable(addr);
+    CurrentLimiter_Enable(addr);
+    ThermalWarning_ThresholdConfigure(addr,THW_THRESHOLD_110degC);
+    ThermalWarning_Enable(addr);
+    DVS_SlewrateConfigure(addr,DVS_SLEW_1mV_us);
+    Dishcarge_StrengthConfigure(addr,DISCHG_STRENGTH_50mA);
+    IVP_Enable(addr);
+    OVP_SecondaryThreshold_Configure(addr,20000);
+    GDRV_MinDeadTime_Select(addr,GDRV_MINDEADTIME_20ns);
+    SlopeComp_CorrectionFactor_Select(addr,SLOPECOMP_CORRECTION_1_0);
+    CDC_Enable(addr);
+    IVP_VoltageThreshold_Configure(addr,12000);
+}
+
+// Registers differing from the clean configuration, STATUS_BYTE aside
+static int wrongRegisters(void){
+    int wrong = 0;
+    for (int i = 0; i < 256; ++i) {
+        wrong += (i != STATUS_BYTE && device.Regs[i] != expected[i]);
+    }
+    return wrong;
+}
+
+static void reset(void){
+    uint8_t pecMode = device.Pec;
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    device.Pec = pecMode;
+}
+
+static int run(const char *Name, int Mode){
+    SimBus_ResetStats(&bus);
+    bus.NowNs = 0;
+    int wrongRuns = 0, wrongRegs = 0, redone = 0;
+    for (int r = 0; r < RUNS; ++r) {
+        reset();
+        if (Mode == 1) {
+            for (int attempt = 0; attempt <= REDO_LIMIT; ++attempt) {
+                Verify_BeginBatch();
+                configure();
+                if (Verify_EndBatch(0,0) == 0) {
+                    break;
+                }
+                redone++;
+            }
+        } else {
+            configure();
+        }
+        int wrong = wrongRegisters();
+        wrongRegs += wrong;
+        wrongRuns += (wrong != 0);
+    }
+    printf("%-22s transfers/run %6.1f  bytes/run %6.1f  bus %6.2f ms/run  runs left wrong %3d/%d (%d registers)",
+           Name, (double)bus.Transfers/RUNS, (double)bus.BytesOnWire/RUNS, bus.NowNs/1e6/RUNS, wrongRuns, RUNS, wrongRegs);
+    if (Mode == 1) {
+        printf("  redone %d", redone);
+    }
+    if (Mode == 2) {
+        printf("  PEC errors %u, NACKs %u, retries %u, failed %u", pec.PecErrors, pec.Nacks, pec.Retried, pec.Failed);
+    }
+    printf("\n");
+    return wrongRuns;
+}
+
+static void crcSpeed(void){
+    static uint8_t data[4096];
+    for (unsigned i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i*131 + 7);
+    }
+    struct timespec t0, t1;
+    uint8_t crc = 0;
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    for (unsigned done = 0; done < CRC_BYTES; done += sizeof(data)) {
+        crc = I2C_Pec_Crc8(crc,data,sizeof(data));
+    }
+    clock_gettime(CLOCK_MONOTONIC,&t1);
+    double ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+    printf("CRC-8: %.2f ns/byte (check 0x%02X)\n", ns/CRC_BYTES, crc);
+}
+
+int main(){
+    // SMBus example: "123456789" has the CRC-8 0xF4
+    if (I2C_Pec_Crc8(0,(const uint8_t *)"123456789",9) != 0xF4) {
+        printf("CRC-8 check value wrong\n");
+        return 1;
+    }
+    crcSpeed();
+
+    SimBus_Init(&bus,&simTransport);
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    SimBus_Attach(&bus,&device);
+    I2C_SetTransport(&simTransport);
+    configure();
+    memcpy(expected,device.Regs,sizeof(expected));
+
+    SimFault_Init(&fault,&bus,1);
+    SimFault_Random random;
+    memset(&random,0,sizeof(random));
+    random.CorruptPpm = CORRUPT_PPM;
+    random.WriteCorruptPpm = CORRUPT_PPM;
+    SimFault_SetRandom(&fault,&random);
+    Verify_SetSampling(1);
+
+    run("no checking",0);
+    run("read-back, redo",1);
+
+    I2C_Pec_Init(&pec,&simTransport,&pecTransport);
+    I2C_Pec_Enable(&pec,LM51772_I2CADDR1,1);
+    device.Pec = 1;
+    I2C_SetTransport(&pecTransport);
+    int wrong = run("PEC",2);
+    printf("Writes rejected by the device: %u\n", bus.PecErrors);
+    return wrong ? 1 : 0;
+}
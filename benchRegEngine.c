@@ -0,0 +1,233 @@
+#include "LM51772.h"
+#include "LM51772Regs.h"
+#include "LM51772Units.h"
+#include "MPQ4210Regs.h"
+#include "MPQ4210Units.h"
+#include "regEngine.h"
+#include "regScheduler.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Bus cost of configuring a mixed bus (two LM51772 and two MPQ4210) with
+// the per-call drivers (LM51772.c and the register shims of test2.c)
+// against the register engine with one shared scheduler. Both run on
+// their own simulated bus and the final register contents must match,
+// the exit status is 1 if they do not.
+
+#define LM_COUNT                2
+#define MPQ_COUNT               2
+
+static const uint8_t lmAddress[LM_COUNT] = {LM51772_I2CADDR1, LM51772_I2CADDR2};
+static const uint8_t mpqAddress[MPQ_COUNT] = {MPQ4210_I2CADDR, MPQ4210_I2CADDR + 1};
+
+typedef struct{
+    SimI2CBus Bus;
+    I2C_Transport Transport;
+    SimLM51772 Lm[LM_COUNT];
+    SimLM51772 Mpq[MPQ_COUNT];
+} Rig;
+
+static Rig legacy, engine;
+static RegEngine_Device lm[LM_COUNT], mpq[MPQ_COUNT];
+static RegScheduler scheduler;
+
+static void rigInit(Rig *Rig){
+    SimBus_Init(&Rig->Bus,&Rig->Transport);
+    for (int i = 0; i < LM_COUNT; ++i) {
+        SimLM51772_Init(&Rig->Lm[i],lmAddress[i]);
+        SimBus_Attach(&Rig->Bus,&Rig->Lm[i]);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        SimRegFile_Init(&Rig->Mpq[i],mpqAddress[i]);
+        SimBus_Attach(&Rig->Bus,&Rig->Mpq[i]);
+    }
+}
+
+// Register shims as test2.c writes them, one read-modify-write per call
+static void mpqUpdate(uint8_t Address, uint8_t Reg, uint8_t Mask, uint8_t Bits){
+    uint8_t value = I2C_ReadRegByte(Address,Reg);
+    I2C_WriteRegByte(Address,Reg,(uint8_t)((value & ~Mask) | Bits));
+}
+
+static void mpqSetVref(uint8_t Address, uint16_t VrefmV){
+    I2C_WriteRegByte(Address,MPQREG_REF_LSB,(uint8_t)(VrefmV & 0x07));
+    I2C_WriteRegByte(Address,MPQREG_REF_MSB,(uint8_t)(VrefmV >> 3));
+    mpqUpdate(Address,MPQREG_CONTROL1,MPQ_CONTROL1_GO_BIT,MPQ_CONTROL1_GO_BIT);
+}
+
+static void legacyProfile(uint16_t Vout, uint16_t Vref){
+    for (int i = 0; i < LM_COUNT; ++i) {
+        uint8_t addr = lmAddress[i];
+        setVOUT1_TARGET(addr,Vout);
+        HiccupProtection_Enable(addr);
+        CurrentLimiter_Enable(addr);
+        ThermalWarning_ThresholdConfigure(addr,THW_THRESHOLD_110degC);
+        ThermalWarning_Enable(addr);
+        DVS_SlewrateConfigure(addr,DVS_SLEW_1mV_us);
+        Dishcarge_StrengthConfigure(addr,DISCHG_STRENGTH_50mA);
+        IVP_Enable(addr);
+        GDRV_MinDeadTime_Select(addr,GDRV_MINDEADTIME_20ns);
+        CDC_Enable(addr);
+        EnablePowerStage(addr);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        uint8_t addr = mpqAddress[i];
+        mpqSetVref(addr,Vref);
+        mpqUpdate(addr,MPQREG_CONTROL1,0x30,MPQ4210_CONTROL1_SR_75mV_ms);
+        mpqUpdate(addr,MPQREG_CONTROL2,0xC0,MPQ_CONTROL2_FSW_400khz);
+        mpqUpdate(addr,MPQREG_CONTROL1,MPQ_CONTROL1_EN,MPQ_CONTROL1_EN);
+    }
+}
+
+static void legacyPoll(void){
+    for (int i = 0; i < LM_COUNT; ++i) {
+        get_STATUS_BYTE(lmAddress[i]);
+        get_USBPD_STATUS(lmAddress[i]);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        I2C_ReadRegByte(mpqAddress[i],MPQREG_INT_STATUS);
+    }
+}
+
+static void queue(RegEngine_Device *Device, uint8_t Reg, const char *Name, uint8_t Value){
+    RegSched_Write(&scheduler,Device,RegEngine_Field(Device,Reg,Name),Value);
+}
+
+static void engineProfile(uint16_t Vout, uint16_t Vref){
+    uint16_t code = VOUT1_TARGET_Encode(Vout);
+    for (int i = 0; i < LM_COUNT; ++i) {
+        RegEngine_Device *dev = &lm[i];
+        queue(dev,VOUT_TARGET1_LSB,"VOUT_TARGET1_LSB",(uint8_t)(code & 0xFF));
+        queue(dev,VOUT_TARGET1_MSB,"VOUT_TARGET1_MSB",(uint8_t)(code >> 8));
+        queue(dev,MFR_SPECIFIC_D0,"HICCUP_EN",1);
+        queue(dev,MFR_SPECIFIC_D0,"IMON_LIMITER_EN",1);
+        queue(dev,MFR_SPECIFIC_D1,"THW_THRESHOLD",THW_THRESHOLD_110degC >> 5);
+        queue(dev,MFR_SPECIFIC_D1,"EN_THER_WARN",1);
+        queue(dev,MFR_SPECIFIC_D2,"DVS_SLEW_RAMP",DVS_SLEW_1mV_us >> 4);
+        queue(dev,MFR_SPECIFIC_D2,"DISCHG_STRENGTH",DISCHG_STRENGTH_50mA >> 2);
+        queue(dev,MFR_SPECIFIC_D3,"EN_IVP",1);
+        queue(dev,MFR_SPECIFIC_D6,"GDRV_MIN_DEADTIME",GDRV_MINDEADTIME_20ns >> 2);
+        queue(dev,MFR_SPECIFIC_D8,"EN_CDC",1);
+        queue(dev,USB_PD_CONTROL_0,"CONV_EN",1);
+        queue(dev,MFR_SPECIFIC_D0,"CONV_EN",1);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        RegEngine_Device *dev = &mpq[i];
+        queue(dev,MPQREG_REF_LSB,"VREF_L",(uint8_t)(Vref & 0x07));
+        queue(dev,MPQREG_REF_MSB,"VREF_H",(uint8_t)(Vref >> 3));
+        queue(dev,MPQREG_CONTROL1,"GO_BIT",1);
+        queue(dev,MPQREG_CONTROL1,"SR",MPQ4210_CONTROL1_SR_75mV_ms >> 4);
+        queue(dev,MPQREG_CONTROL2,"FSW",MPQ_CONTROL2_FSW_400khz >> 6);
+        queue(dev,MPQREG_CONTROL1,"EN",1);
+    }
+    RegSched_Run(&scheduler);
+}
+
+static void enginePoll(void){
+    static uint8_t results[LM_COUNT*2 + MPQ_COUNT];
+    int n = 0;
+    for (int i = 0; i < LM_COUNT; ++i) {
+        RegSched_Read(&scheduler,&lm[i],RegEngine_Field(&lm[i],STATUS_BYTE,"OFF"),&results[n++]);
+        RegSched_Read(&scheduler,&lm[i],RegEngine_Field(&lm[i],USB_PD_STATUS_0,"CC"),&results[n++]);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        RegSched_Read(&scheduler,&mpq[i],RegEngine_Field(&mpq[i],MPQREG_INT_STATUS,"INT_STATUS"),&results[n++]);
+    }
+    RegSched_Run(&scheduler);
+}
+
+static void report(const char *Phase){
+    printf("%-28s per-call %4u transfers %7.2f ms   engine %4u transfers %7.2f ms\n", Phase,
+           legacy.Bus.Transfers, legacy.Bus.NowNs/1e6, engine.Bus.Transfers, engine.Bus.NowNs/1e6);
+    SimBus_ResetStats(&legacy.Bus);
+    SimBus_ResetStats(&engine.Bus);
+    legacy.Bus.NowNs = 0;
+    engine.Bus.NowNs = 0;
+}
+
+static void run(const char *Phase, uint16_t Vout, uint16_t Vref, int Poll){
+    I2C_SetTransport(&legacy.Transport);
+    legacyProfile(Vout,Vref);
+    if (Poll) {
+        legacyPoll();
+    }
+    I2C_SetTransport(&engine.Transport);
+    engineProfile(Vout,Vref);
+    if (Poll) {
+        enginePoll();
+    }
+    report(Phase);
+}
+
+// Registers of both buses must match, apart from bits the map says clear
+// themselves (the simulated MPQ4210 is a plain register file)
+static int compare(const ChipMap *Map, const SimLM51772 *A, const SimLM51772 *B){
+    int mismatches = 0;
+    for (uint8_t i = 0; i < Map->RegisterCount; ++i) {
+        const Chip_RegisterDesc *desc = &Map->Registers[i];
+        uint8_t mask = (uint8_t)~desc->PulseMask;
+        if (((A->Regs[desc->Reg] ^ B->Regs[desc->Reg]) & mask) != 0) {
+            printf("%s 0x%02X %s: per-call 0x%02X engine 0x%02X\n", Map->Name, A->I2CAddress, desc->Name,
+                   A->Regs[desc->Reg], B->Regs[desc->Reg]);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int main(){
+    rigInit(&legacy);
+    rigInit(&engine);
+    for (int i = 0; i < LM_COUNT; ++i) {
+        LM51772Units_Init(&lm[i],lmAddress[i]);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        MPQ4210Units_Init(&mpq[i],mpqAddress[i]);
+    }
+    RegSched_Init(&scheduler);
+
+    run("first configuration",12000,1100,0);
+    run("same configuration again",12000,1100,0);
+    run("new VOUT/VREF",15000,1250,0);
+    run("status poll after change",15000,1250,1);
+
+    // Thin unit layers on the same engine devices
+    I2C_SetTransport(&legacy.Transport);
+    for (int i = 0; i < LM_COUNT; ++i) {
+        setVOUT1_TARGET(lmAddress[i],9000);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        mpqSetVref(mpqAddress[i],2000);
+    }
+    I2C_SetTransport(&engine.Transport);
+    for (int i = 0; i < LM_COUNT; ++i) {
+        LM51772Units_SetVout(&lm[i],9000);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        MPQ4210Units_SetVout(&mpq[i],20000,90000,10000);
+    }
+    report("unit layers, VOUT change");
+
+    int mismatches = 0;
+    for (int i = 0; i < LM_COUNT; ++i) {
+        mismatches += compare(&LM51772_Map,&legacy.Lm[i],&engine.Lm[i]);
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        mismatches += compare(&MPQ4210_Map,&legacy.Mpq[i],&engine.Mpq[i]);
+    }
+    uint32_t skipped = 0, hits = 0;
+    for (int i = 0; i < LM_COUNT; ++i) {
+        skipped += lm[i].Skipped;
+        hits += lm[i].Hits;
+    }
+    for (int i = 0; i < MPQ_COUNT; ++i) {
+        skipped += mpq[i].Skipped;
+        hits += mpq[i].Hits;
+    }
+    printf("Engine: %u registers skipped as unchanged, %u reads from the shadow, %u scheduler runs\n", skipped, hits,
+           scheduler.Runs);
+    printf("Register contents %s\n", mismatches ? "DIFFER" : "match");
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+#include "LM51772.h"
+#include "regCache.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Steady-state telemetry on the simulated bus: every PERIOD_US a logger
+// takes a snapshot of every readable register of both devices. Every
+// CONTROL_PERIODS the VOUT target is set, every FAULT_PERIODS a fault is
+// raised and cleared, and every CC_PERIODS the CC bit toggles.
+// Register by register reads against snapshots with every register
+// live, with the default policies (configuration static, status live)
+// and with USB_PD_STATUS_0 on a TTL_MS TTL. The exit status is 1 if a
+// snapshot misses a write or a status change, or a TTL register is
+// older than its TTL, or the TTL slots are not handed out and given back.
+
+#define DEVICES                 2
+#define PERIODS                 1000
+#define PERIOD_US               10000
+#define CONTROL_PERIODS         100
+#define FAULT_PERIODS           50
+#define CC_PERIODS              37
+#define TTL_MS                  50
+
+static const uint8_t addresses[DEVICES] = {LM51772_I2CADDR1, LM51772_I2CADDR2};
+static const uint8_t regs[] = {ILIM_THRESHOLD, VOUT_TARGET1_LSB, VOUT_TARGET1_MSB, USB_PD_STATUS_0, STATUS_BYTE,
+                               USB_PD_CONTROL_0, MFR_SPECIFIC_D0, MFR_SPECIFIC_D1, MFR_SPECIFIC_D2, MFR_SPECIFIC_D3,
+                               MFR_SPECIFIC_D4, MFR_SPECIFIC_D5, MFR_SPECIFIC_D6, MFR_SPECIFIC_D7, MFR_SPECIFIC_D8,
+                               MFR_SPECIFIC_D9, IVP_VOLTAGE};
+#define REGS                    (int)sizeof(regs)
+
+static SimI2CBus bus;
+static SimLM51772 devices[DEVICES];
+static I2C_Transport simTransport, cacheTransport;
+static RegCache cache;
+
+// What the devices do between two snapshots
+static void control(int Period, uint64_t *CcChangeUs){
+    for (int d = 0; d < DEVICES; ++d) {
+        if (Period % CONTROL_PERIODS == 0) {
+            setVOUT1_TARGET(addresses[d],(uint16_t)(5000 + 10*Period));
+        }
+        if (Period % FAULT_PERIODS == 0) {
+            SimLM51772_RaiseFault(&devices[d],FLT_OCP);
+        } else if (Period % FAULT_PERIODS == 1) {
+            ClearFaultFlag(addresses[d],FLT_OCP);
+        }
+        if (Period % CC_PERIODS == 0) {
+            devices[d].Regs[USB_PD_STATUS_0] ^= 0x40;
+            CcChangeUs[d] = (uint64_t)Period*PERIOD_US;
+        }
+    }
+}
+
+// Snapshot values against the simulated registers, a TTL register may be
+// behind for its TTL after a change
+static int check(int Device, const uint8_t *Values, uint64_t NowUs, uint64_t CcChangeUs){
+    int errors = 0;
+    for (int i = 0; i < REGS; ++i) {
+        if (Values[i] == devices[Device].Regs[regs[i]]) {
+            continue;
+        }
+        uint32_t ttl = cache.TtlMs[regs[i]];
+        if (regs[i] == USB_PD_STATUS_0 && ttl != REGCACHE_LIVE && ttl != REGCACHE_STATIC &&
+            NowUs - CcChangeUs < (uint64_t)ttl*1000u) {
+            continue;
+        }
+        errors++;
+    }
+    return errors;
+}
+
+static int run(const char *Mode, int Snapshots, int AllLive, uint32_t UsbPdTtlMs){
+    for (int d = 0; d < DEVICES; ++d) {
+        SimLM51772_Init(&devices[d],addresses[d]);
+        SimBus_Attach(&bus,&devices[d]);
+    }
+    RegCache_Init(&cache,&simTransport,&cacheTransport);
+    for (int i = 0; i < REGS && AllLive; ++i) {
+        RegCache_SetPolicy(&cache,regs[i],REGCACHE_LIVE);
+    }
+    if (UsbPdTtlMs != REGCACHE_LIVE && RegCache_SetPolicy(&cache,USB_PD_STATUS_0,UsbPdTtlMs) != I2C_OK) {
+        printf("%s: no TTL slot for USB_PD_STATUS_0\n", Mode);
+        return 1;
+    }
+    I2C_SetTransport(Snapshots ? &cacheTransport : &simTransport);
+    uint64_t ccChangeUs[DEVICES] = {0};
+    uint32_t telemetry = 0;
+    int errors = 0;
+    for (int p = 0; p < PERIODS; ++p) {
+        uint64_t nowUs = (uint64_t)p*PERIOD_US;
+        control(p,ccChangeUs);
+        // Only the telemetry transfers are counted, not the control ones
+        uint32_t before = bus.Transfers;
+        for (int d = 0; d < DEVICES; ++d) {
+            uint8_t values[REGS];
+            if (Snapshots) {
+                if (RegCache_Snapshot(&cache,addresses[d],regs,REGS,nowUs,values) < 0) {
+                    errors++;
+                }
+            } else {
+                for (int i = 0; i < REGS; ++i) {
+                    values[i] = I2C_ReadRegByte(addresses[d],regs[i]);
+                }
+            }
+            errors += check(d,values,nowUs,ccChangeUs[d]);
+        }
+        telemetry += bus.Transfers - before;
+    }
+    printf("%-30s %6u transfers %6.2f per snapshot, %6u registers fresh, %d errors\n", Mode, telemetry,
+           (double)telemetry/(PERIODS*DEVICES), cache.Fresh, errors);
+    return errors;
+}
+
+// Every TTL register takes a slot until it gets another policy
+static int slots(void){
+    int errors = 0;
+    RegCache_Init(&cache,&simTransport,&cacheTransport);
+    for (int i = 0; i < REGCACHE_TTL_SLOTS; ++i) {
+        errors += RegCache_SetPolicy(&cache,MFR_SPECIFIC_D0 + i,TTL_MS) != I2C_OK;
+    }
+    errors += RegCache_SetPolicy(&cache,USB_PD_STATUS_0,TTL_MS) != REGCACHE_ERR_SLOTS;
+    errors += cache.TtlMs[USB_PD_STATUS_0] != REGCACHE_LIVE;
+    errors += RegCache_SetPolicy(&cache,MFR_SPECIFIC_D0,2*TTL_MS) != I2C_OK;
+    errors += RegCache_SetPolicy(&cache,MFR_SPECIFIC_D0,REGCACHE_LIVE) != I2C_OK;
+    errors += RegCache_SetPolicy(&cache,USB_PD_STATUS_0,TTL_MS) != I2C_OK;
+    printf("%d TTL slots, %d errors\n", REGCACHE_TTL_SLOTS, errors);
+    return errors;
+}
+
+int main(){
+    SimBus_Init(&bus,&simTransport);
+    printf("%d devices, %d registers every %d ms for %d periods\n", DEVICES, REGS, PERIOD_US/1000, PERIODS);
+    int errors = 0;
+    errors += run("register by register",0,0,REGCACHE_LIVE);
+    errors += run("snapshot, all live",1,1,REGCACHE_LIVE);
+    errors += run("snapshot, default policies",1,0,REGCACHE_LIVE);
+    errors += run("snapshot, USB PD status TTL",1,0,TTL_MS);
+    errors += slots();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+#include "LM51772.h"
+#include "statusBoard.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// Reader throughput of the status board with 1 to 16 concurrent readers,
+// while a publisher polls two simulated LM51772 as fast as it can. Every
+// reader maps the region read-only and checks each snapshot it gets for
+// consistency (the VOUT code and mV written together must match).
+
+#define RUN_MS                  200
+#define MAX_READERS             16
+#define BOARD_NAME              "/lm51772-status-bench"
+
+static atomic_int publishing = 1;
+static atomic_int reading = 0;
+static atomic_ulong published = 0;
+static const uint8_t addresses[2] = {LM51772_I2CADDR1, LM51772_I2CADDR2};
+
+typedef struct{
+    uint64_t Reads;
+    uint64_t Torn;
+    uint64_t Busy;
+} ReaderResult;
+
+static void *publisher(void *Arg){
+    StatusBoard *board = (StatusBoard *)Arg;
+    static SimI2CBus bus;
+    static SimLM51772 devices[2];
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    for (int i = 0; i < 2; ++i) {
+        SimLM51772_Init(&devices[i],addresses[i]);
+        SimBus_Attach(&bus,&devices[i]);
+    }
+    I2C_SetTransport(&transport);
+    uint16_t vout = 5000;
+    while (atomic_load(&publishing)) {
+        // The sweep keeps the published values changing
+        setVOUT1_TARGET(LM51772_I2CADDR1,vout);
+        vout = (vout >= 20000) ? 5000 : (uint16_t)(vout + 20);
+        StatusBoard_Poll(board,addresses,2);
+        atomic_fetch_add(&published,1);
+    }
+    return 0;
+}
+
+static void *reader(void *Arg){
+    ReaderResult *result = (ReaderResult *)Arg;
+    StatusBoard board;
+    if (StatusBoard_Open(&board,BOARD_NAME) < 0) {
+        return 0;
+    }
+    StatusBoard_Entry entry;
+    while (!atomic_load_explicit(&reading,memory_order_relaxed)) {
+    }
+    while (atomic_load_explicit(&reading,memory_order_relaxed)) {
+        for (int i = 0; i < 2; ++i) {
+            int status = StatusBoard_Read(&board,i,&entry);
+            if (status < 0) {
+                result->Busy++;
+                continue;
+            }
+            if (status == 0 && entry.VoutmV != entry.VoutCode*VOUT_MV_PER_CODE) {
+                result->Torn++;
+            }
+            result->Reads++;
+        }
+    }
+    StatusBoard_Close(&board);
+    return 0;
+}
+
+int main(){
+    StatusBoard board;
+    if (StatusBoard_Create(&board,BOARD_NAME) < 0) {
+        return 1;
+    }
+    pthread_t pub;
+    pthread_create(&pub,0,publisher,&board);
+    while (atomic_load(&published) == 0) {
+        usleep(1000);
+    }
+
+    printf("Readers  reads/s total  reads/s per reader  publishes/s  torn  busy\n");
+    for (int n = 1; n <= MAX_READERS; n *= 2) {
+        pthread_t threads[MAX_READERS];
+        ReaderResult results[MAX_READERS] = {{0, 0, 0}};
+        for (int i = 0; i < n; ++i) {
+            pthread_create(&threads[i],0,reader,&results[i]);
+        }
+        usleep(10000); // Readers mapped and waiting
+        unsigned long before = atomic_load(&published);
+        atomic_store(&reading,1);
+        usleep(RUN_MS*1000);
+        atomic_store(&reading,0);
+        unsigned long publishes = atomic_load(&published) - before;
+        uint64_t reads = 0, torn = 0, busy = 0;
+        for (int i = 0; i < n; ++i) {
+            pthread_join(threads[i],0);
+            reads += results[i].Reads;
+            torn += results[i].Torn;
+            busy += results[i].Busy;
+        }
+        double seconds = RUN_MS/1000.0;
+        printf("%7d  %13.3e  %18.3e  %11.3e  %4llu  %4llu\n", n, reads/seconds, reads/seconds/n,
+               publishes/seconds, (unsigned long long)torn, (unsigned long long)busy);
+    }
+
+    atomic_store(&publishing,0);
+    pthread_join(pub,0);
+    StatusBoard_Destroy(&board);
+    return 0;
+}
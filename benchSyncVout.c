@@ -0,0 +1,113 @@
+#include "LM51772.h"
+#include "LM51772Sync.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Skew between paralleled LM51772 taking a new VOUT target on the simulated
+// bus, for 2 to 8 devices: setVOUT1_TARGET per device, one staged block
+// write per device, and the synchronized group (one combined transaction).
+// The skew is the bus time from the first to the last device having its
+// new target. Host time between transactions (driver call, scheduling) is
+// modelled with HostGapNs. The exit status is 1 if a device ends on the
+// wrong code, the skew of the group differs from its report, or a VOUT
+// out of range is staged.
+
+#define MAX_DEVICES             8
+#define FIRST_ADDRESS           0x68
+#define VOUT_A                  12000
+#define VOUT_B                  15000
+
+static SimI2CBus bus;
+static I2C_Transport transport;
+static SimLM51772 devices[MAX_DEVICES];
+static uint8_t addresses[MAX_DEVICES];
+
+static uint64_t skewNs(int Count){
+    uint64_t first = devices[0].VoutUpdateNs, last = first;
+    for (int i = 1; i < Count; ++i) {
+        uint64_t t = devices[i].VoutUpdateNs;
+        first = (t < first) ? t : first;
+        last = (t > last) ? t : last;
+    }
+    return last - first;
+}
+
+static int checkCode(int Count, uint16_t Vout){
+    uint16_t code = VOUT1_TARGET_Encode(Vout);
+    int errors = 0;
+    for (int i = 0; i < Count; ++i) {
+        uint16_t value = (uint16_t)(devices[i].Regs[VOUT_TARGET1_LSB] | (devices[i].Regs[VOUT_TARGET1_MSB] << 8));
+        if (value != code) {
+            printf("device 0x%02X: code 0x%03X instead of 0x%03X\n", addresses[i], value, code);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+// Staged block write per device without the combined transaction
+static void blockPerDevice(const LM51772_SyncGroup *Group){
+    for (uint8_t i = 0; i < Group->Count; ++i) {
+        I2C_WriteBlock(Group->Addresses[i],Group->Frames[i],3);
+    }
+}
+
+int main(){
+    SimBus_Init(&bus,&transport);
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        addresses[i] = (uint8_t)(FIRST_ADDRESS + i);
+        SimLM51772_Init(&devices[i],addresses[i]);
+        SimBus_Attach(&bus,&devices[i]);
+    }
+    I2C_SetTransport(&transport);
+
+    static const uint32_t gaps[] = {0, 50000};
+    int errors = 0;
+    printf("Skew in us (100 kHz bus)\n");
+    for (unsigned g = 0; g < sizeof(gaps)/sizeof(gaps[0]); ++g) {
+        bus.HostGapNs = gaps[g];
+        printf("host gap %2u us  devices  setVOUT1_TARGET  block/device  synchronized (reported)\n", gaps[g]/1000);
+        for (int n = 2; n <= MAX_DEVICES; ++n) {
+            LM51772_SyncGroup group;
+            LM51772_SyncReport report;
+            LM51772_Sync_Init(&group,addresses,(uint8_t)n);
+
+            for (int i = 0; i < n; ++i) {
+                setVOUT1_TARGET(addresses[i],VOUT_A);
+            }
+            uint64_t perCall = skewNs(n);
+            errors += checkCode(n,VOUT_A);
+
+            for (int i = 0; i < n; ++i) {
+                LM51772_Sync_Stage(&group,(uint8_t)i,VOUT_B);
+            }
+            blockPerDevice(&group);
+            uint64_t block = skewNs(n);
+            errors += checkCode(n,VOUT_B);
+
+            LM51772_Sync_SetVout(&group,VOUT_A,&report);
+            uint64_t sync = skewNs(n);
+            errors += checkCode(n,VOUT_A);
+            uint64_t reported = (uint64_t)report.SkewBits*bus.BitTimeNs;
+            if (!report.Combined || sync != reported) {
+                printf("synchronized skew %llu ns, reported %llu ns\n", (unsigned long long)sync, (unsigned long long)reported);
+                errors++;
+            }
+            printf("                 %d       %8.0f       %8.0f      %8.0f (%.0f)\n", n,
+                   perCall/1e3, block/1e3, sync/1e3, reported/1e3);
+        }
+    }
+    // Targets out of range are rejected, not clamped
+    LM51772_SyncGroup group;
+    LM51772_Sync_Init(&group,addresses,1);
+    if (LM51772_Sync_Stage(&group,0,VOUT_MIN_MV - 1) != LM51772_SYNC_ERR_ARG ||
+        LM51772_Sync_Stage(&group,0,VOUT_MAX_MV + 1) != LM51772_SYNC_ERR_ARG ||
+        LM51772_Sync_Stage(&group,0,VOUT_MAX_MV) != I2C_OK) {
+        printf("VOUT range %u to %u mV not enforced\n", VOUT_MIN_MV, VOUT_MAX_MV);
+        errors++;
+    }
+    printf("%s\n", errors ? "ERRORS" : "All devices on target, skew as reported");
+    return errors ? 1 : 0;
+}
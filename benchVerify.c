@@ -0,0 +1,104 @@
+#include "LM51772.h"
+#include "LM51772Verify.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Bus cost of verifying a bring-up configuration by reading back every
+// write, against batched verification and sampled batched verification,
+// on a simulated LM51772.
+
+#define BATCHES 20
+
+static SimI2CBus bus;
+static SimLM51772 device;
+
+// Bring-up configuration, with ReadBack set every register is read back
+// right after the call that wrote it, like the test programs do
+static void configure(int ReadBack){
+    const uint8_t addr = LM51772_I2CADDR1;
+    #define STEP(call, reg) do { call; if (ReadBack) { I2C_ReadRegByte(addr,reg); } } while (0)
+    setVOUT1_TARGET(addr,12000);
+    if (ReadBack) {
+        getVOUT1_TARGET(addr);
+    }
+    STEP(HiccupProtection_Enable(addr), MFR_SPECIFIC_D0);
+    STEP(CurrentLimiter_Enable(addr), MFR_SPECIFIC_D0);
+    STEP(ThermalWarning_ThresholdConfigure(addr,THW_THRESHOLD_110degC), MFR_SPECIFIC_D1);
+    STEP(ThermalWarning_Enable(addr), MFR_SPECIFIC_D1);
+    STEP(DVS_SlewrateConfigure(addr,DVS_SLEW_1mV_us), MFR_SPECIFIC_D2);
+    STEP(Dishcarge_StrengthConfigure(addr,DISCHG_STRENGTH_50mA), MFR_SPECIFIC_D2);
+    STEP(IVP_Enable(addr), MFR_SPECIFIC_D3);
+    STEP(OVP_SecondaryThreshold_Configure(addr,20000), MFR_SPECIFIC_D5);
+    STEP(GDRV_MinDeadTime_Select(addr,GDRV_MINDEADTIME_20ns), MFR_SPECIFIC_D6);
+    STEP(SlopeComp_CorrectionFactor_Select(addr,SLOPECOMP_CORRECTION_1_0), MFR_SPECIFIC_D7);
+    STEP(CDC_Enable(addr), MFR_SPECIFIC_D8);
+    STEP(IVP_VoltageThreshold_Configure(addr,12000), IVP_VOLTAGE);
+    #undef STEP
+}
+
+static void report(const char *Name){
+    printf("%-22s transfers/batch %6.1f  bytes/batch %7.1f\n", Name,
+           (double)bus.Transfers/BATCHES, (double)bus.BytesOnWire/BATCHES);
+}
+
+int main(){
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    SimBus_Attach(&bus,&device);
+    I2C_SetTransport(&transport);
+
+    // Nothing verified
+    SimBus_ResetStats(&bus);
+    for (int i = 0; i < BATCHES; ++i) {
+        configure(0);
+    }
+    report("no verification");
+
+    // Read-back after every write
+    SimBus_ResetStats(&bus);
+    for (int i = 0; i < BATCHES; ++i) {
+        configure(1);
+    }
+    report("read-back per write");
+
+    // Batched verification
+    SimBus_ResetStats(&bus);
+    Verify_SetSampling(1);
+    for (int i = 0; i < BATCHES; ++i) {
+        Verify_BeginBatch();
+        configure(0);
+        Verify_EndBatch(0,0);
+    }
+    report("batched verify");
+
+    // Sampled batched verification
+    SimBus_ResetStats(&bus);
+    Verify_SetSampling(10);
+    for (int i = 0; i < BATCHES; ++i) {
+        Verify_BeginBatch();
+        configure(0);
+        Verify_EndBatch(0,0);
+    }
+    report("batched verify 1/10");
+
+    // A bit lost between the write and the end of the batch
+    Verify_Mismatch mismatches[4];
+    Verify_SetSampling(1);
+    Verify_BeginBatch();
+    configure(0);
+    device.Regs[MFR_SPECIFIC_D2] &= (uint8_t)~0x20;
+    int found = Verify_EndBatch(mismatches,4);
+    printf("\nInjected fault, %d mismatch(es):\n", found);
+    for (int i = 0; i < found && i < 4; ++i) {
+        Verify_Report(stdout,&mismatches[i]);
+    }
+
+    Verify_Stats stats;
+    Verify_GetStats(&stats);
+    printf("\nBatches %u, verified %u, registers %u, block reads %u, mismatches %u\n",
+           stats.Batches, stats.BatchesVerified, stats.Registers, stats.BlockReads, stats.Mismatches);
+    return found == 1 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include "LM51772.h"
+#include "regCache.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Synthetic tuning loop on the simulated bus: every TICK_US a tuner tries
+// CANDIDATES settings of slope compensation, gate driver dead time and
+// cable drop compensation gain per device and keeps the last one, and
+// every ENABLE_TICKS the power stage is switched off and on again to
+// measure the new setting. Register cache in write-through mode against
+// write-behind flushed at every tick and with a DEADLINE_US deadline.
+// The exit status is 1 if a device does not have the tuned settings when
+// its power stage is enabled, or at the end of the run.
+
+#define DEVICES                 2
+#define TICKS                   1000
+#define TICK_US                 100
+#define CANDIDATES              4
+#define ENABLE_TICKS            100
+#define DEADLINE_US             1000
+
+static const uint8_t addresses[DEVICES] = {LM51772_I2CADDR1, LM51772_I2CADDR2};
+static const uint8_t deadTimes[4] = {GDRV_MINDEADTIME_10ns, GDRV_MINDEADTIME_20ns, GDRV_MINDEADTIME_40ns, GDRV_MINDEADTIME_60ns};
+static const uint8_t cdcGains[4] = {CDC_GAIN_0_250V, CDC_GAIN_0_500V, CDC_GAIN_1_000V, CDC_GAIN_2_000V};
+
+static SimI2CBus bus;
+static SimLM51772 devices[DEVICES];
+static I2C_Transport simTransport, cacheTransport;
+static RegCache cache;
+// Register values the tuner last asked for
+static uint8_t expected[DEVICES][3];
+
+// Compares the tuning registers of the devices with the last settings
+static int check(void){
+    int errors = 0;
+    for (int d = 0; d < DEVICES; ++d) {
+        if ((devices[d].Regs[MFR_SPECIFIC_D6] & 0x0C) != expected[d][0] ||
+            (devices[d].Regs[MFR_SPECIFIC_D7] & 0x0F) != expected[d][1] ||
+            (devices[d].Regs[MFR_SPECIFIC_D8] & 0x30) != expected[d][2]) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static int run(const char *Mode, uint8_t WriteBehind, uint32_t DeadlineUs){
+    for (int d = 0; d < DEVICES; ++d) {
+        SimLM51772_Init(&devices[d],addresses[d]);
+        SimBus_Attach(&bus,&devices[d]);
+    }
+    RegCache_InvalidateAll(&cache);
+    RegCache_SetWriteBehind(&cache,WriteBehind,DeadlineUs);
+    cache.Deferred = 0;
+    cache.Flushes = 0;
+    SimBus_ResetStats(&bus);
+    bus.NowNs = 0;
+    int errors = 0;
+    uint32_t calls = 0;
+    for (int t = 0; t < TICKS; ++t) {
+        for (int d = 0; d < DEVICES; ++d) {
+            for (int c = 0; c < CANDIDATES; ++c) {
+                int k = t*CANDIDATES + c + d;
+                expected[d][0] = deadTimes[k % 4];
+                expected[d][1] = (uint8_t)(k % 16);
+                expected[d][2] = cdcGains[(k/4) % 4];
+                GDRV_MinDeadTime_Select(addresses[d],expected[d][0]);
+                SlopeComp_CorrectionFactor_Select(addresses[d],expected[d][1]);
+                CDC_GainVoltage_Select(addresses[d],expected[d][2]);
+                calls += 3;
+            }
+        }
+        if (t % ENABLE_TICKS == ENABLE_TICKS - 1) {
+            // Enabling is a barrier by itself, the explicit one covers
+            // the disable as well
+            for (int d = 0; d < DEVICES; ++d) {
+                LM51772_Barrier(addresses[d]);
+                DisablePowerStage(addresses[d]);
+                EnablePowerStage(addresses[d]);
+            }
+            errors += check();
+        }
+        RegCache_Poll(&cache,(uint64_t)t*TICK_US);
+    }
+    LM51772_Barrier(I2C_FLUSH_ALL);
+    errors += check();
+    printf("%-28s %6u calls %6u transfers %8.2f ms bus, %5u deferred %5u flushes, %d errors\n", Mode, calls,
+           bus.Transfers, bus.NowNs/1e6, cache.Deferred, cache.Flushes, errors);
+    return errors;
+}
+
+int main(){
+    SimBus_Init(&bus,&simTransport);
+    RegCache_Init(&cache,&simTransport,&cacheTransport);
+    I2C_SetTransport(&cacheTransport);
+    printf("%d devices, %d ticks of %d us, %d candidates per tick\n", DEVICES, TICKS, TICK_US, CANDIDATES);
+    int errors = 0;
+    uint32_t before;
+    errors += run("write-through",0,0);
+    before = bus.Transfers;
+    errors += run("write-behind, every tick",1,0);
+    printf("%28s %5.1f%% transfers saved\n", "", 100.0*(before - bus.Transfers)/before);
+    errors += run("write-behind, 1 ms deadline",1,DEADLINE_US);
+    printf("%28s %5.1f%% transfers saved\n", "", 100.0*(before - bus.Transfers)/before);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,324 @@
+//Include header file
+#include "busLock.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+// Checks of a ticket without a process (taken, the process died before
+// writing its pid) before it is skipped
+#define EMPTY_CHECKS                    100
+
+struct BusLock_Region{
+    _Atomic uint32_t Next;              // Ticket dispenser
+    _Atomic uint32_t Serving;           // Ticket holding the lock, futex word
+    _Atomic uint32_t Waiters;           // Processes sleeping on Serving
+    _Atomic uint32_t OwnerDied;         // A dead ticket was skipped, for the next owner
+    _Atomic uint32_t Pids[BUSLOCK_MAX_PROCESSES];   // Process per ticket, 0 if none
+} __attribute__((aligned(64)));
+
+static inline void cpuRelax(void){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+// Sleeps until Serving may have moved from Value, returns 1 after
+// BUSLOCK_CHECK_MS without a wake-up
+static int sleepOn(BusLock_Region *Region, uint32_t Value){
+#ifdef __linux__
+    struct timespec timeout = {0, BUSLOCK_CHECK_MS*1000000L};
+    long status = syscall(SYS_futex,&Region->Serving,FUTEX_WAIT,Value,&timeout,0,0);
+    return status < 0 && errno == ETIMEDOUT;
+#else
+    (void)Region;
+    (void)Value;
+    struct timespec pause = {0, 1000000L};
+    nanosleep(&pause,0);
+    return 1;
+#endif
+}
+
+static void wakeAll(BusLock_Region *Region){
+#ifdef __linux__
+    syscall(SYS_futex,&Region->Serving,FUTEX_WAKE,0x7FFFFFFF,0,0,0);
+#else
+    (void)Region;
+#endif
+}
+
+// Skips the Serving ticket if its process is gone. Empty counts the
+// checks that found no process for it.
+static void recoverIfDead(BusLock *Lock, uint32_t Serving, uint32_t *Empty){
+    BusLock_Region *region = Lock->Region;
+    uint32_t pid = atomic_load_explicit(&region->Pids[Serving % BUSLOCK_MAX_PROCESSES],memory_order_relaxed);
+    int dead;
+    if (pid == 0) {
+        dead = ++*Empty >= EMPTY_CHECKS;
+    } else {
+        *Empty = 0;
+        dead = kill((pid_t)pid,0) < 0 && errno == ESRCH;
+    }
+    if (!dead) {
+        return;
+    }
+    uint32_t expected = Serving;
+    if (atomic_compare_exchange_strong(&region->Serving,&expected,Serving + 1)) {
+        atomic_compare_exchange_strong(&region->Pids[Serving % BUSLOCK_MAX_PROCESSES],&pid,0);
+        atomic_store(&region->OwnerDied,1);
+        Lock->Recovered++;
+        fprintf(stderr, "Bus lock %s: process %u died holding or waiting for it\n", Lock->Name, pid);
+        wakeAll(region);
+    }
+    *Empty = 0;
+}
+
+// Waits until Ticket is served: spins a little, then sleeps on the futex
+// and checks the current owner is alive whenever a sleep times out
+static void waitTurn(BusLock *Lock, uint32_t Ticket){
+    BusLock_Region *region = Lock->Region;
+    for (int spin = 0; spin < BUSLOCK_SPINS; ++spin) {
+        if (atomic_load_explicit(&region->Serving,memory_order_acquire) == Ticket) {
+            return;
+        }
+        cpuRelax();
+    }
+    uint32_t empty = 0, last = Ticket;
+    for (;;) {
+        uint32_t serving = atomic_load_explicit(&region->Serving,memory_order_acquire);
+        if (serving == Ticket) {
+            return;
+        }
+        if (serving != last) {
+            empty = 0;
+            last = serving;
+        }
+        // Waiters is raised before the futex checks Serving, the owner
+        // moves Serving before it looks at Waiters: no lost wake-up
+        atomic_fetch_add(&region->Waiters,1);
+        int timedOut = sleepOn(region,serving);
+        atomic_fetch_sub(&region->Waiters,1);
+        if (timedOut && atomic_load(&region->Serving) == serving) {
+            recoverIfDead(Lock,serving,&empty);
+        }
+    }
+}
+
+/******************************************
+* @brief: Maps a bus lock, creating it if needed
+* @param Lock: lock handle (BusLock *)
+* @param Name: shared memory object name (const char *)
+* @note: Every process sharing the bus opens the same name. A handle
+*        copied by fork() belongs to the parent, the child opens its
+*        own. Returns 0 or -1.
+*******************************************/
+int BusLock_Open(BusLock *Lock, const char *Name){
+    memset(Lock,0,sizeof(*Lock));
+    snprintf(Lock->Name,sizeof(Lock->Name),"%s",Name);
+    int fd = shm_open(Name,O_CREAT | O_RDWR,0666);
+    if (fd < 0) {
+        perror(Name);
+        return -1;
+    }
+    // Shared by the tools of every user, whatever the umask
+    fchmod(fd,0666);
+    // All zeros is the unlocked state: creating it twice is harmless
+    if (ftruncate(fd,sizeof(BusLock_Region)) < 0) {
+        perror("ftruncate");
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(0,sizeof(BusLock_Region),PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    Lock->Region = (BusLock_Region *)map;
+    Lock->Pid = (uint32_t)getpid();
+    return 0;
+}
+
+/******************************************
+* @brief: Maps the lock of an I2C bus, creating it if needed
+* @param Lock: lock handle (BusLock *)
+* @param BusNumber: I2C bus number (unsigned)
+* @note: Name from BUSLOCK_NAME_FORMAT. Returns 0 or -1.
+*******************************************/
+int BusLock_OpenBus(BusLock *Lock, unsigned BusNumber){
+    char name[32];
+    snprintf(name,sizeof(name),BUSLOCK_NAME_FORMAT,BusNumber);
+    return BusLock_Open(Lock,name);
+}
+
+/******************************************
+* @brief: Unmaps a bus lock
+* @param Lock: lock handle, not held (BusLock *)
+*******************************************/
+void BusLock_Close(BusLock *Lock){
+    munmap(Lock->Region,sizeof(BusLock_Region));
+    Lock->Region = 0;
+}
+
+/******************************************
+* @brief: Removes the shared memory object of a lock
+* @param Name: shared memory object name (const char *)
+* @note: Processes that mapped it keep sharing the old one, so only
+*        for locks nobody uses any more.
+*******************************************/
+void BusLock_Unlink(const char *Name){
+    shm_unlink(Name);
+}
+
+/******************************************
+* @brief: Takes the bus lock
+* @param Lock: lock handle (BusLock *)
+* @note: Waiters are served in the order they asked (ticket order).
+*        Uncontended it costs an atomic add and two stores, without a
+*        system call. Taking it again through the same handle only
+*        nests. Returns BUSLOCK_OK, or BUSLOCK_OWNER_DIED when the
+*        ticket of a dead process was skipped before this one: the lock
+*        is held, but a transaction of the dead process may have been
+*        cut short.
+*******************************************/
+int BusLock_Acquire(BusLock *Lock){
+    if (Lock->Depth++ > 0) {
+        return BUSLOCK_OK;
+    }
+    BusLock_Region *region = Lock->Region;
+    uint32_t ticket = atomic_fetch_add_explicit(&region->Next,1,memory_order_relaxed);
+    atomic_store_explicit(&region->Pids[ticket % BUSLOCK_MAX_PROCESSES],Lock->Pid,memory_order_relaxed);
+    Lock->Ticket = ticket;
+    if (atomic_load_explicit(&region->Serving,memory_order_acquire) != ticket) {
+        Lock->Contended++;
+        waitTurn(Lock,ticket);
+    }
+    Lock->Acquired++;
+    if (atomic_load_explicit(&region->OwnerDied,memory_order_relaxed) != 0 &&
+        atomic_exchange(&region->OwnerDied,0) != 0) {
+        return BUSLOCK_OWNER_DIED;
+    }
+    return BUSLOCK_OK;
+}
+
+/******************************************
+* @brief: Releases the bus lock
+* @param Lock: lock handle (BusLock *)
+* @note: The outermost release hands the lock to the next ticket and
+*        only makes a system call if a waiter sleeps.
+*******************************************/
+void BusLock_Release(BusLock *Lock){
+    if (Lock->Depth == 0 || --Lock->Depth > 0) {
+        return;
+    }
+    BusLock_Region *region = Lock->Region;
+    atomic_store_explicit(&region->Pids[Lock->Ticket % BUSLOCK_MAX_PROCESSES],0,memory_order_relaxed);
+    atomic_store(&region->Serving,Lock->Ticket + 1);
+    if (atomic_load(&region->Waiters) != 0) {
+        wakeAll(region);
+    }
+}
+
+// Transport of the locked backend
+
+static int lockedWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    I2C_Locked *Locked = (I2C_Locked *)Context;
+    BusLock_Acquire(Locked->Lock);
+    int status = Locked->Inner->Write(Locked->Inner->Context,SlaveAddress,Data,Length);
+    BusLock_Release(Locked->Lock);
+    return status;
+}
+
+static int lockedRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    I2C_Locked *Locked = (I2C_Locked *)Context;
+    BusLock_Acquire(Locked->Lock);
+    int status = Locked->Inner->Read(Locked->Inner->Context,SlaveAddress,Data,Length);
+    BusLock_Release(Locked->Lock);
+    return status;
+}
+
+static int lockedWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    I2C_Locked *Locked = (I2C_Locked *)Context;
+    const I2C_Transport *inner = Locked->Inner;
+    BusLock_Acquire(Locked->Lock);
+    int status;
+    if (inner->WriteRead != 0) {
+        status = inner->WriteRead(inner->Context,SlaveAddress,WData,WLength,RData,RLength);
+    } else {
+        // Both halves under the same lock, nobody moves the pointer between them
+        status = inner->Write(inner->Context,SlaveAddress,WData,WLength);
+        if (status >= 0) {
+            status = inner->Read(inner->Context,SlaveAddress,RData,RLength);
+        }
+    }
+    BusLock_Release(Locked->Lock);
+    return status;
+}
+
+static int lockedTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    I2C_Locked *Locked = (I2C_Locked *)Context;
+    BusLock_Acquire(Locked->Lock);
+    int status = Locked->Inner->Transfer(Locked->Inner->Context,Messages,Count);
+    BusLock_Release(Locked->Lock);
+    return status;
+}
+
+static int lockedQuick(void *Context, uint8_t SlaveAddress){
+    I2C_Locked *Locked = (I2C_Locked *)Context;
+    BusLock_Acquire(Locked->Lock);
+    int status = Locked->Inner->Quick(Locked->Inner->Context,SlaveAddress);
+    BusLock_Release(Locked->Lock);
+    return status;
+}
+
+static void lockedDelay(void *Context, uint32_t Microseconds){
+    I2C_Locked *Locked = (I2C_Locked *)Context;
+    if (Locked->Inner->Delay != 0) {
+        Locked->Inner->Delay(Locked->Inner->Context,Microseconds);
+    }
+}
+
+static int lockedFlush(void *Context, uint8_t SlaveAddress){
+    I2C_Locked *Locked = (I2C_Locked *)Context;
+    BusLock_Acquire(Locked->Lock);
+    int status = Locked->Inner->Flush(Locked->Inner->Context,SlaveAddress);
+    BusLock_Release(Locked->Lock);
+    return status;
+}
+
+/******************************************
+* @brief: Initializes a transport taking the bus lock per transaction
+* @param Locked: locking transport context (I2C_Locked *)
+* @param Lock: opened lock of the bus (BusLock *)
+* @param Inner: bus backend (const I2C_Transport *)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*        A batch that must not be interleaved (read-modify-write,
+*        pointer write and plain read) is wrapped in BusLock_Acquire()/
+*        BusLock_Release() of the same handle, its transactions then
+*        only nest. Delays do not take the lock.
+*******************************************/
+void BusLock_InitTransport(I2C_Locked *Locked, BusLock *Lock, const I2C_Transport *Inner, I2C_Transport *Transport){
+    Locked->Inner = Inner;
+    Locked->Lock = Lock;
+    Transport->Write = lockedWrite;
+    Transport->Read = lockedRead;
+    Transport->WriteRead = lockedWriteRead;
+    Transport->Transfer = (Inner->Transfer != 0) ? lockedTransfer : 0;
+    Transport->Quick = lockedQuick;
+    Transport->Delay = lockedDelay;
+    Transport->Flush = (Inner->Flush != 0) ? lockedFlush : 0;
+    Transport->Context = Locked;
+}
@@ -0,0 +1,68 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef BUS_LOCK_H
+#define BUS_LOCK_H
+
+// Cross-process bus lock. Every program driving a bus (daemon, status
+// publisher, sweeps, manual test programs) takes it around each
+// transaction, or around a batch that must not be interleaved, so two
+// programs never mix their pointer writes and reads.
+// The lock is a ticket lock in POSIX shared memory: FIFO fair, and an
+// uncontended acquire/release is two atomic operations on the region,
+// without a system call. Waiters spin shortly and then sleep on a futex
+// (Linux; other systems poll). A waiter that sleeps for BUSLOCK_CHECK_MS
+// checks whether the process holding the current ticket is still alive;
+// the ticket of a dead process (owner or waiter) is skipped, and the next
+// owner gets BUSLOCK_OWNER_DIED, the bus may be in the middle of a
+// transaction. The region is all zeros when unlocked, so it needs no
+// initialization and any process can create it.
+// A BusLock handle belongs to one thread; taking it again through the
+// same handle only nests.
+
+#define BUSLOCK_NAME_FORMAT             "/lm51772-i2c-%u"   // Lock of a bus number
+#define BUSLOCK_MAX_PROCESSES           64  // Tickets outstanding at once
+#define BUSLOCK_CHECK_MS                10  // Sleep before checking the owner is alive
+#define BUSLOCK_SPINS                   200 // Spins before sleeping
+
+// Results of BusLock_Acquire
+#define BUSLOCK_OK                      0
+#define BUSLOCK_OWNER_DIED              1   // Acquired, a process died holding it
+
+typedef struct BusLock_Region BusLock_Region;
+
+typedef struct{
+    BusLock_Region *Region;             // Mapped region
+    char Name[64];                      // Shared memory object name
+    uint32_t Pid;                       // Process that opened it (open again after fork)
+    uint32_t Ticket;                    // Ticket held
+    uint32_t Depth;                     // Nesting of the acquires of this handle
+    // Statistics
+    uint32_t Acquired;                  // Acquires that took the lock
+    uint32_t Contended;                 // Acquires that had to wait
+    uint32_t Recovered;                 // Tickets of dead processes skipped by this handle
+} BusLock;
+
+// Transport taking the lock around every transaction of the backend
+typedef struct{
+    const I2C_Transport *Inner;         // Bus backend
+    BusLock *Lock;
+} I2C_Locked;
+
+// Mapping (and creating if needed) the lock
+int BusLock_Open(BusLock *Lock, const char *Name);
+// Mapping the lock of an I2C bus number (BUSLOCK_NAME_FORMAT)
+int BusLock_OpenBus(BusLock *Lock, unsigned BusNumber);
+// Unmapping, the lock must not be held
+void BusLock_Close(BusLock *Lock);
+// Removing the shared memory object (e.g. in tests)
+void BusLock_Unlink(const char *Name);
+// Taking the lock in FIFO order, BUSLOCK_OK or BUSLOCK_OWNER_DIED
+int BusLock_Acquire(BusLock *Lock);
+// Releasing it, the next waiter in line gets it
+void BusLock_Release(BusLock *Lock);
+
+// Initialization of the locking transport
+void BusLock_InitTransport(I2C_Locked *Locked, BusLock *Lock, const I2C_Transport *Inner, I2C_Transport *Transport);
+
+#endif // BUS_LOCK_H
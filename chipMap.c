@@ -0,0 +1,59 @@
+//Include header file
+#include "chipMap.h"
+#include <string.h>
+
+/******************************************
+* @brief: Looks up the descriptor of a register
+* @param Map: register map of the chip (const ChipMap *)
+* @param Reg: register address (uint8_t)
+* @note: Returns NULL if the register is not in the map.
+*******************************************/
+const Chip_RegisterDesc *Chip_FindRegister(const ChipMap *Map, uint8_t Reg){
+    for (uint8_t i = 0; i < Map->RegisterCount; ++i) {
+        if (Map->Registers[i].Reg == Reg) {
+            return &Map->Registers[i];
+        }
+    }
+    return 0;
+}
+
+/******************************************
+* @brief: Looks up a field of a register by name
+* @param Map: register map of the chip (const ChipMap *)
+* @param Reg: register address (uint8_t)
+* @param Name: field name (const char *)
+* @note: The register is needed because field names are not unique
+*        (CONV_EN is in USB_PD_CONTROL_0 and MFR_SPECIFIC_D0 of the
+*        LM51772). Returns NULL if there is no such field.
+*******************************************/
+const Chip_FieldDesc *Chip_FindField(const ChipMap *Map, uint8_t Reg, const char *Name){
+    for (uint8_t i = 0; i < Map->FieldCount; ++i) {
+        if (Map->Fields[i].Reg == Reg && strcmp(Map->Fields[i].Name,Name) == 0) {
+            return &Map->Fields[i];
+        }
+    }
+    return 0;
+}
+
+/******************************************
+* @brief: Returns the name of a register
+* @param Map: register map of the chip (const ChipMap *)
+* @param Reg: register address (uint8_t)
+*******************************************/
+const char *Chip_RegisterName(const ChipMap *Map, uint8_t Reg){
+    const Chip_RegisterDesc *desc = Chip_FindRegister(Map,Reg);
+    return (desc != 0) ? desc->Name : "UNKNOWN";
+}
+
+/******************************************
+* @brief: Tells if a register can be read without side effects
+* @param Map: register map of the chip (const ChipMap *)
+* @param Reg: register address (uint8_t)
+* @note: Registers in the map apart from the commands, whose reads
+*        are meaningless. Block reads may include them without being
+*        asked for.
+*******************************************/
+int Chip_Readable(const ChipMap *Map, uint8_t Reg){
+    const Chip_RegisterDesc *desc = Chip_FindRegister(Map,Reg);
+    return desc != 0 && !(desc->Flags & REG_CMD);
+}
@@ -0,0 +1,49 @@
+#include <stdint.h>
+
+#ifndef CHIP_MAP_H
+#define CHIP_MAP_H
+
+// Register maps as data. A chip is described by its registers (address,
+// access type, name) and their bit fields, so generic code (register
+// engine, caches, verification, test models) works for every chip without
+// knowing its configuration functions. LM51772Regs.c and MPQ4210Regs.c
+// hold the maps of the supported chips.
+
+// Register access flags
+#define REG_RW                          0x01    // Read/write configuration register
+#define REG_RO                          0x02    // Read only
+#define REG_W1C                         0x04    // Flags cleared by writing 1
+#define REG_CMD                         0x08    // Write only command, reads are meaningless
+#define REG_VOLATILE                    0x10    // Changes without being written
+
+typedef struct{
+    uint8_t Reg;                        // Register address
+    uint8_t Flags;                      // REG_* access flags
+    const char *Name;                   // Register name
+    uint8_t PulseMask;                  // Bits clearing themselves after a 1 is written (GO bits)
+} Chip_RegisterDesc;
+
+typedef struct{
+    uint8_t Reg;                        // Register address
+    uint8_t Mask;                       // Bits of the field inside the register
+    const char *Name;                   // Field name as in the datasheet
+} Chip_FieldDesc;
+
+typedef struct{
+    const char *Name;                   // Chip name
+    const Chip_RegisterDesc *Registers; // Sorted by address
+    uint8_t RegisterCount;
+    const Chip_FieldDesc *Fields;
+    uint8_t FieldCount;
+} ChipMap;
+
+// Looking up a register descriptor, NULL if the register is unknown
+const Chip_RegisterDesc *Chip_FindRegister(const ChipMap *Map, uint8_t Reg);
+// Looking up a field of a register by name, NULL if there is none
+const Chip_FieldDesc *Chip_FindField(const ChipMap *Map, uint8_t Reg, const char *Name);
+// Name of a register, "UNKNOWN" if the register is unknown
+const char *Chip_RegisterName(const ChipMap *Map, uint8_t Reg);
+// 1 if a block read may include the register: in the map and not a command
+int Chip_Readable(const ChipMap *Map, uint8_t Reg);
+
+#endif // CHIP_MAP_H
@@ -0,0 +1,13 @@
+# Cross build for the Raspberry Pi (32 bit Raspberry Pi OS). pigpio is
+# looked up in the sysroot given with -DCMAKE_SYSROOT=... if any.
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+set(LM51772_CROSS_PREFIX arm-linux-gnueabihf- CACHE STRING "Prefix of the cross tools")
+set(CMAKE_C_COMPILER ${LM51772_CROSS_PREFIX}gcc)
+set(CMAKE_C_FLAGS_INIT "-mcpu=cortex-a53 -mfpu=neon-fp-armv8 -mfloat-abi=hard")
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PACKAGE ONLY)
@@ -0,0 +1,14 @@
+# Bare metal build for a Cortex-M microcontroller. Only the portable part
+# of liblm51772 is built; the application provides the I2C_Transport.
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+set(LM51772_CROSS_PREFIX arm-none-eabi- CACHE STRING "Prefix of the cross tools")
+set(LM51772_MCU_FLAGS "-mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16" CACHE STRING "CPU flags")
+set(CMAKE_C_COMPILER ${LM51772_CROSS_PREFIX}gcc)
+set(CMAKE_C_FLAGS_INIT "${LM51772_MCU_FLAGS} -ffunction-sections -fdata-sections")
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
@@ -0,0 +1,239 @@
+//Include header file
+#include "i2cCoalesce.h"
+#include <string.h>
+#include <time.h>
+
+static uint64_t nowNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Drops the completed results of a device and keeps its reads in flight
+// from being joined. Called with the lock held.
+static void dropDevice(I2C_Coalesce *Coalesce, uint8_t SlaveAddress){
+    for (int i = 0; i < I2C_COALESCE_SLOTS; ++i) {
+        I2C_CoalesceSlot *slot = &Coalesce->Slots[i];
+        if (slot->Used && slot->SlaveAddress == SlaveAddress) {
+            if (slot->InFlight) {
+                slot->Stale = 1;
+            } else {
+                slot->Used = 0;
+            }
+        }
+    }
+}
+
+// Slot of the register, NULL if none
+static I2C_CoalesceSlot *findSlot(I2C_Coalesce *Coalesce, uint8_t SlaveAddress, uint8_t Reg){
+    for (int i = 0; i < I2C_COALESCE_SLOTS; ++i) {
+        I2C_CoalesceSlot *slot = &Coalesce->Slots[i];
+        if (slot->Used && slot->SlaveAddress == SlaveAddress && slot->Reg == Reg) {
+            return slot;
+        }
+    }
+    return 0;
+}
+
+// Slot for a new read: a free one, else the oldest completed one, nobody
+// waiting on either. NULL if every slot is busy.
+static I2C_CoalesceSlot *takeSlot(I2C_Coalesce *Coalesce){
+    I2C_CoalesceSlot *oldest = 0;
+    for (int i = 0; i < I2C_COALESCE_SLOTS; ++i) {
+        I2C_CoalesceSlot *slot = &Coalesce->Slots[i];
+        if (slot->Waiters > 0) {
+            continue;
+        }
+        if (!slot->Used) {
+            return slot;
+        }
+        if (!slot->InFlight && (oldest == 0 || slot->DoneNs < oldest->DoneNs)) {
+            oldest = slot;
+        }
+    }
+    return oldest;
+}
+
+static int innerWriteRead(const I2C_Transport *Inner, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    if (Inner->WriteRead != 0) {
+        return Inner->WriteRead(Inner->Context,SlaveAddress,WData,WLength,RData,RLength);
+    }
+    int status = Inner->Write(Inner->Context,SlaveAddress,WData,WLength);
+    return (status < 0) ? status : Inner->Read(Inner->Context,SlaveAddress,RData,RLength);
+}
+
+static int coalesceWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    I2C_Coalesce *Coalesce = (I2C_Coalesce *)Context;
+    int status = Coalesce->Inner->Write(Coalesce->Inner->Context,SlaveAddress,Data,Length);
+    // Reads that started before the write completed may miss it
+    I2C_Coalesce_Invalidate(Coalesce,SlaveAddress);
+    return status;
+}
+
+static int coalesceRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    I2C_Coalesce *Coalesce = (I2C_Coalesce *)Context;
+    // Continues at the register pointer, nothing to share
+    return Coalesce->Inner->Read(Coalesce->Inner->Context,SlaveAddress,Data,Length);
+}
+
+static int coalesceWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    I2C_Coalesce *Coalesce = (I2C_Coalesce *)Context;
+    SlaveAddress &= 0x7F;
+    if (WLength != 1 || RLength == 0 || RLength > I2C_COALESCE_MAX_BYTES) {
+        int status = innerWriteRead(Coalesce->Inner,SlaveAddress,WData,WLength,RData,RLength);
+        if (WLength > 1) {
+            I2C_Coalesce_Invalidate(Coalesce,SlaveAddress);
+        }
+        return status;
+    }
+    uint8_t reg = WData[0];
+    pthread_mutex_lock(&Coalesce->Lock);
+    Coalesce->Reads++;
+    I2C_CoalesceSlot *slot = findSlot(Coalesce,SlaveAddress,reg);
+    if (slot != 0 && !slot->Stale && slot->Length >= RLength) {
+        if (slot->InFlight) {
+            // Wait for the read on the bus and share its result
+            uint32_t generation = slot->Generation;
+            slot->Waiters++;
+            while (slot->Generation == generation) {
+                pthread_cond_wait(&Coalesce->Done,&Coalesce->Lock);
+            }
+            slot->Waiters--;
+            int status = slot->Status;
+            memcpy(RData,slot->Data,RLength);
+            Coalesce->Joined++;
+            pthread_mutex_unlock(&Coalesce->Lock);
+            return status;
+        }
+        if (Coalesce->FreshNs > 0 && nowNs() - slot->DoneNs <= Coalesce->FreshNs) {
+            memcpy(RData,slot->Data,RLength);
+            Coalesce->Fresh++;
+            pthread_mutex_unlock(&Coalesce->Lock);
+            return slot->Status;
+        }
+    }
+    // This thread reads for everyone asking until it completes. Without a
+    // free slot, or while a read of the register that must not be joined
+    // is still in flight, it reads on its own.
+    if (slot != 0 && (slot->InFlight || slot->Waiters > 0)) {
+        slot = 0;
+    } else if (slot == 0) {
+        slot = takeSlot(Coalesce);
+    }
+    Coalesce->BusReads++;
+    if (slot == 0) {
+        pthread_mutex_unlock(&Coalesce->Lock);
+        return innerWriteRead(Coalesce->Inner,SlaveAddress,WData,WLength,RData,RLength);
+    }
+    slot->Used = 1;
+    slot->InFlight = 1;
+    slot->Stale = 0;
+    slot->SlaveAddress = SlaveAddress;
+    slot->Reg = reg;
+    slot->Length = (uint8_t)RLength;
+    pthread_mutex_unlock(&Coalesce->Lock);
+
+    int status = innerWriteRead(Coalesce->Inner,SlaveAddress,WData,WLength,RData,RLength);
+
+    pthread_mutex_lock(&Coalesce->Lock);
+    memcpy(slot->Data,RData,RLength);
+    slot->Status = status;
+    slot->DoneNs = nowNs();
+    slot->InFlight = 0;
+    slot->Generation++;
+    // A stale result only goes to the threads already waiting for it
+    if (slot->Stale || status < 0) {
+        slot->Used = 0;
+    }
+    if (slot->Waiters > 0) {
+        pthread_cond_broadcast(&Coalesce->Done);
+    }
+    pthread_mutex_unlock(&Coalesce->Lock);
+    return status;
+}
+
+static int coalesceTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    I2C_Coalesce *Coalesce = (I2C_Coalesce *)Context;
+    int status = Coalesce->Inner->Transfer(Coalesce->Inner->Context,Messages,Count);
+    for (uint16_t i = 0; i < Count; ++i) {
+        if (!(Messages[i].Flags & I2C_MSG_READ)) {
+            I2C_Coalesce_Invalidate(Coalesce,Messages[i].SlaveAddress);
+        }
+    }
+    return status;
+}
+
+static int coalesceQuick(void *Context, uint8_t SlaveAddress){
+    I2C_Coalesce *Coalesce = (I2C_Coalesce *)Context;
+    return Coalesce->Inner->Quick(Coalesce->Inner->Context,SlaveAddress);
+}
+
+static void coalesceDelay(void *Context, uint32_t Microseconds){
+    I2C_Coalesce *Coalesce = (I2C_Coalesce *)Context;
+    if (Coalesce->Inner->Delay != 0) {
+        Coalesce->Inner->Delay(Coalesce->Inner->Context,Microseconds);
+    }
+}
+
+static int coalesceFlush(void *Context, uint8_t SlaveAddress){
+    I2C_Coalesce *Coalesce = (I2C_Coalesce *)Context;
+    int status = Coalesce->Inner->Flush(Coalesce->Inner->Context,SlaveAddress);
+    // The held back writes are on the bus now
+    if (SlaveAddress == I2C_FLUSH_ALL) {
+        for (uint8_t address = 0; address < 0x80; ++address) {
+            I2C_Coalesce_Invalidate(Coalesce,address);
+        }
+    } else {
+        I2C_Coalesce_Invalidate(Coalesce,SlaveAddress);
+    }
+    return status;
+}
+
+/******************************************
+* @brief: Initializes read coalescing
+* @param Coalesce: coalescing context (I2C_Coalesce *)
+* @param Inner: bus backend (const I2C_Transport *)
+* @param FreshNs: freshness window in ns, 0 to share reads in flight only (uint64_t)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport()
+*        and is meant to be shared by threads. A window only suits
+*        registers that may be read that much late (status polling);
+*        reads of a device always see the writes done to it.
+*******************************************/
+void I2C_Coalesce_Init(I2C_Coalesce *Coalesce, const I2C_Transport *Inner, uint64_t FreshNs, I2C_Transport *Transport){
+    memset(Coalesce,0,sizeof(*Coalesce));
+    Coalesce->Inner = Inner;
+    Coalesce->FreshNs = FreshNs;
+    pthread_mutex_init(&Coalesce->Lock,0);
+    pthread_cond_init(&Coalesce->Done,0);
+    Transport->Write = coalesceWrite;
+    Transport->Read = coalesceRead;
+    Transport->WriteRead = coalesceWriteRead;
+    Transport->Transfer = (Inner->Transfer != 0) ? coalesceTransfer : 0;
+    Transport->Quick = coalesceQuick;
+    Transport->Delay = coalesceDelay;
+    Transport->Flush = (Inner->Flush != 0) ? coalesceFlush : 0;
+    Transport->Context = Coalesce;
+}
+
+/******************************************
+* @brief: Forgets the results of a device
+* @param Coalesce: coalescing context (I2C_Coalesce *)
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @note: Reads of the device in flight are no longer joined, their
+*        results go to the threads already waiting only.
+*******************************************/
+void I2C_Coalesce_Invalidate(I2C_Coalesce *Coalesce, uint8_t SlaveAddress){
+    pthread_mutex_lock(&Coalesce->Lock);
+    dropDevice(Coalesce,SlaveAddress & 0x7F);
+    pthread_mutex_unlock(&Coalesce->Lock);
+}
+
+/******************************************
+* @brief: Releases the mutex and condition variable
+* @param Coalesce: coalescing context, no read in flight (I2C_Coalesce *)
+*******************************************/
+void I2C_Coalesce_Destroy(I2C_Coalesce *Coalesce){
+    pthread_mutex_destroy(&Coalesce->Lock);
+    pthread_cond_destroy(&Coalesce->Done);
+}
@@ -0,0 +1,59 @@
+#include <stdint.h>
+#include <pthread.h>
+#include "i2cTransport.h"
+
+#ifndef I2C_COALESCE_H
+#define I2C_COALESCE_H
+
+// Read coalescing, a transport placed between the driver and a bus backend
+// shared by several threads (dashboard, alarm monitor, logger, ...). A
+// register read (write of the register address, repeated start, read)
+// of a device and register already on the bus does not go out again: the
+// thread waits for the read in flight and gets its result. With a
+// freshness window, a result that completed at most FreshNs ago also
+// serves new readers without a transfer.
+// Any write to a device (and any combined transfer writing to it) drops
+// its completed results and keeps reads started before the write from
+// being joined, so a thread always reads back what it wrote. Plain reads
+// continuing at the register pointer (I2C_ReadBlock) are not coalesced.
+// The backend is called from the threads of the readers, several reads of
+// different registers may be in flight at once if the backend allows it.
+
+#define I2C_COALESCE_SLOTS              32  // Reads tracked at once
+#define I2C_COALESCE_MAX_BYTES          32  // Longest coalesced read
+
+typedef struct{
+    uint8_t Used;                       // Holds a read, in flight or done
+    uint8_t InFlight;                   // On the bus
+    uint8_t Stale;                      // A write came after it started, not to be joined
+    uint8_t SlaveAddress;
+    uint8_t Reg;
+    uint8_t Length;                     // Bytes read
+    int Status;                         // Result of the read
+    uint8_t Data[I2C_COALESCE_MAX_BYTES];
+    uint64_t DoneNs;                    // CLOCK_MONOTONIC time the read completed
+    uint32_t Generation;                // Completed reads of the slot
+    uint32_t Waiters;                   // Threads waiting for the read in flight
+} I2C_CoalesceSlot;
+
+typedef struct{
+    const I2C_Transport *Inner;         // Bus backend
+    uint64_t FreshNs;                   // Freshness window, 0: only reads in flight are shared
+    pthread_mutex_t Lock;
+    pthread_cond_t Done;                // Broadcast when a read completes
+    I2C_CoalesceSlot Slots[I2C_COALESCE_SLOTS];
+    // Statistics
+    uint32_t Reads;                     // Register reads asked for
+    uint32_t BusReads;                  // Register reads sent to the backend
+    uint32_t Joined;                    // Reads served by a read in flight
+    uint32_t Fresh;                     // Reads served within the freshness window
+} I2C_Coalesce;
+
+// Initialization, freshness window in ns, and of the transport pointing to it
+void I2C_Coalesce_Init(I2C_Coalesce *Coalesce, const I2C_Transport *Inner, uint64_t FreshNs, I2C_Transport *Transport);
+// Forgetting the results of a device (e.g. after a power cycle)
+void I2C_Coalesce_Invalidate(I2C_Coalesce *Coalesce, uint8_t SlaveAddress);
+// Releasing the mutex and condition variable
+void I2C_Coalesce_Destroy(I2C_Coalesce *Coalesce);
+
+#endif // I2C_COALESCE_H
@@ -0,0 +1,135 @@
+//Include header file
+#include "i2cCounter.h"
+#include <string.h>
+
+static int counterWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    I2C_Counter *Counter = (I2C_Counter *)Context;
+    Counter->Writes++;
+    Counter->Transfers++;
+    Counter->BytesOnWire += Length + 1;
+    if (Counter->Inner == 0) {
+        return I2C_OK;
+    }
+    return Counter->Inner->Write(Counter->Inner->Context,SlaveAddress,Data,Length);
+}
+
+static int counterRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    I2C_Counter *Counter = (I2C_Counter *)Context;
+    Counter->Reads++;
+    Counter->Transfers++;
+    Counter->BytesOnWire += Length + 1;
+    if (Counter->Inner == 0) {
+        memset(Data,0,Length);
+        return I2C_OK;
+    }
+    return Counter->Inner->Read(Counter->Inner->Context,SlaveAddress,Data,Length);
+}
+
+static int counterWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    I2C_Counter *Counter = (I2C_Counter *)Context;
+    if (Counter->Inner != 0 && Counter->Inner->WriteRead == 0) {
+        // The inner transport splits it, count what actually goes out
+        int status = counterWrite(Context,SlaveAddress,WData,WLength);
+        if (status < 0) {
+            return status;
+        }
+        return counterRead(Context,SlaveAddress,RData,RLength);
+    }
+    Counter->WriteReads++;
+    Counter->Transfers++;
+    Counter->BytesOnWire += WLength + RLength + 2;
+    if (Counter->Inner == 0) {
+        memset(RData,0,RLength);
+        return I2C_OK;
+    }
+    return Counter->Inner->WriteRead(Counter->Inner->Context,SlaveAddress,WData,WLength,RData,RLength);
+}
+
+static int counterTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    I2C_Counter *Counter = (I2C_Counter *)Context;
+    if (Counter->Inner != 0 && Counter->Inner->Transfer == 0) {
+        // The inner transport splits it, count what actually goes out
+        for (uint16_t i = 0; i < Count; ++i) {
+            const I2C_Message *message = &Messages[i];
+            int status = (message->Flags & I2C_MSG_READ) ?
+                counterRead(Context,message->SlaveAddress,message->Data,message->Length) :
+                counterWrite(Context,message->SlaveAddress,message->Data,message->Length);
+            if (status < 0) {
+                return status;
+            }
+        }
+        return I2C_OK;
+    }
+    Counter->Combined++;
+    Counter->Transfers++;
+    for (uint16_t i = 0; i < Count; ++i) {
+        Counter->BytesOnWire += Messages[i].Length + 1;
+        if (Counter->Inner == 0 && (Messages[i].Flags & I2C_MSG_READ)) {
+            memset(Messages[i].Data,0,Messages[i].Length);
+        }
+    }
+    if (Counter->Inner == 0) {
+        return I2C_OK;
+    }
+    return Counter->Inner->Transfer(Counter->Inner->Context,Messages,Count);
+}
+
+static int counterQuick(void *Context, uint8_t SlaveAddress){
+    I2C_Counter *Counter = (I2C_Counter *)Context;
+    Counter->Quicks++;
+    Counter->Transfers++;
+    Counter->BytesOnWire += 1;
+    if (Counter->Inner == 0) {
+        return I2C_OK;
+    }
+    return Counter->Inner->Quick(Counter->Inner->Context,SlaveAddress);
+}
+
+static void counterDelay(void *Context, uint32_t Microseconds){
+    I2C_Counter *Counter = (I2C_Counter *)Context;
+    if (Counter->Inner != 0 && Counter->Inner->Delay != 0) {
+        Counter->Inner->Delay(Counter->Inner->Context,Microseconds);
+    }
+}
+
+static int counterFlush(void *Context, uint8_t SlaveAddress){
+    I2C_Counter *Counter = (I2C_Counter *)Context;
+    // The transfers of the flush are counted by the transport below
+    return Counter->Inner->Flush(Counter->Inner->Context,SlaveAddress);
+}
+
+/******************************************
+* @brief: Initializes a counting transport
+* @param Counter: counter context (I2C_Counter *)
+* @param Inner: transport the transfers are forwarded to, NULL to
+*               use it as a mock (const I2C_Transport *)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*        Delays are forwarded but not counted, the mock ignores them.
+*******************************************/
+void I2C_Counter_Init(I2C_Counter *Counter, const I2C_Transport *Inner, I2C_Transport *Transport){
+    memset(Counter,0,sizeof(*Counter));
+    Counter->Inner = Inner;
+    Transport->Write = counterWrite;
+    Transport->Read = counterRead;
+    Transport->WriteRead = counterWriteRead;
+    Transport->Transfer = counterTransfer;
+    Transport->Quick = counterQuick;
+    Transport->Delay = counterDelay;
+    Transport->Flush = (Inner != 0 && Inner->Flush != 0) ? counterFlush : 0;
+    Transport->Context = Counter;
+}
+
+/******************************************
+* @brief: Resets the counters of a counting transport
+* @param Counter: counter context (I2C_Counter *)
+*******************************************/
+void I2C_Counter_Reset(I2C_Counter *Counter){
+    Counter->Writes = 0;
+    Counter->Reads = 0;
+    Counter->WriteReads = 0;
+    Counter->Quicks = 0;
+    Counter->Combined = 0;
+    Counter->Transfers = 0;
+    Counter->BytesOnWire = 0;
+}
@@ -0,0 +1,28 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef I2C_COUNTER_H
+#define I2C_COUNTER_H
+
+// Counting transport. It counts transactions and bytes on the wire and
+// forwards them to an inner transport (e.g. the simulator). Without an
+// inner transport it works as a mock: every transfer is acknowledged and
+// reads return zeros, which measures the pure driver overhead.
+
+typedef struct{
+    const I2C_Transport *Inner;         // Forwarded transport, NULL for the mock
+    uint64_t Writes;                    // Write transactions
+    uint64_t Reads;                     // Read transactions
+    uint64_t WriteReads;                // Write + repeated start read transactions
+    uint64_t Quicks;                    // Quick commands
+    uint64_t Combined;                  // Combined transactions (I2C_Transfer)
+    uint64_t Transfers;                 // All of the above
+    uint64_t BytesOnWire;               // Bytes incl. address bytes
+} I2C_Counter;
+
+// Initialization of the counter and of the transport pointing to it
+void I2C_Counter_Init(I2C_Counter *Counter, const I2C_Transport *Inner, I2C_Transport *Transport);
+// Resetting of the counters
+void I2C_Counter_Reset(I2C_Counter *Counter);
+
+#endif // I2C_COUNTER_H
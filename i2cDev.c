@@ -0,0 +1,115 @@
+//Include header file
+#include "i2cDev.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Maps the errno of a failed ioctl to a transport status code
+static int devError(void){
+    return (errno == ENXIO || errno == EREMOTEIO || errno == EIO) ? I2C_ERR_NACK : I2C_ERR_BUS;
+}
+
+// Issues the messages as one combined transaction
+static int transfer(I2C_DevBus *Bus, struct i2c_msg *Messages, int Count){
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = Messages;
+    data.nmsgs = (uint32_t)Count;
+    if (ioctl(Bus->Fd,I2C_RDWR,&data) < 0) {
+        return devError();
+    }
+    return I2C_OK;
+}
+
+static int devWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    struct i2c_msg message = {SlaveAddress & 0x7F, 0, Length, (uint8_t *)Data};
+    return transfer((I2C_DevBus *)Context,&message,1);
+}
+
+static int devRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    struct i2c_msg message = {SlaveAddress & 0x7F, I2C_M_RD, Length, Data};
+    return transfer((I2C_DevBus *)Context,&message,1);
+}
+
+static int devWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    struct i2c_msg messages[2] = {
+        {SlaveAddress & 0x7F, 0, WLength, (uint8_t *)WData},
+        {SlaveAddress & 0x7F, I2C_M_RD, RLength, RData},
+    };
+    return transfer((I2C_DevBus *)Context,messages,2);
+}
+
+static int devTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    struct i2c_msg messages[I2C_MAX_MESSAGES];
+    for (uint16_t i = 0; i < Count; ++i) {
+        messages[i].addr = Messages[i].SlaveAddress & 0x7F;
+        messages[i].flags = (Messages[i].Flags & I2C_MSG_READ) ? I2C_M_RD : 0;
+        messages[i].len = Messages[i].Length;
+        messages[i].buf = Messages[i].Data;
+    }
+    return transfer((I2C_DevBus *)Context,messages,Count);
+}
+
+static int devQuick(void *Context, uint8_t SlaveAddress){
+    I2C_DevBus *Bus = (I2C_DevBus *)Context;
+    // SMBus quick write, not every adapter takes zero length I2C_RDWR
+    struct i2c_smbus_ioctl_data data;
+    memset(&data,0,sizeof(data));
+    data.read_write = I2C_SMBUS_WRITE;
+    data.size = I2C_SMBUS_QUICK;
+    if (ioctl(Bus->Fd,I2C_SLAVE,(unsigned long)(SlaveAddress & 0x7F)) < 0) {
+        return I2C_ERR_BUS;
+    }
+    if (ioctl(Bus->Fd,I2C_SMBUS,&data) < 0) {
+        return devError();
+    }
+    return I2C_OK;
+}
+
+static void devDelay(void *Context, uint32_t Microseconds){
+    (void)Context;
+    usleep(Microseconds);
+}
+
+/******************************************
+* @brief: Opens an i2c-dev bus and fills its transport
+* @param Bus: bus context to be initialized (I2C_DevBus *)
+* @param BusNumber: number N of /dev/i2c-N (unsigned)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*        Returns 0 or -1 if the device node cannot be opened.
+*******************************************/
+int I2C_Dev_Open(I2C_DevBus *Bus, unsigned BusNumber, I2C_Transport *Transport){
+    char path[32];
+    snprintf(path,sizeof(path),"/dev/i2c-%u",BusNumber);
+    Bus->Bus = BusNumber;
+    Bus->Fd = open(path,O_RDWR);
+    if (Bus->Fd < 0) {
+        fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    Transport->Write = devWrite;
+    Transport->Read = devRead;
+    Transport->WriteRead = devWriteRead;
+    Transport->Transfer = devTransfer;
+    Transport->Quick = devQuick;
+    Transport->Delay = devDelay;
+    Transport->Flush = 0;
+    Transport->Context = Bus;
+    return 0;
+}
+
+/******************************************
+* @brief: Closes the device node of an i2c-dev bus
+* @param Bus: bus context (I2C_DevBus *)
+*******************************************/
+void I2C_Dev_Close(I2C_DevBus *Bus){
+    if (Bus->Fd >= 0) {
+        close(Bus->Fd);
+        Bus->Fd = -1;
+    }
+}
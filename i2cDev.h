@@ -0,0 +1,22 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef I2C_DEV_H
+#define I2C_DEV_H
+
+// Linux i2c-dev backend for the I2C transport (/dev/i2c-N). Transfers use
+// the I2C_RDWR ioctl, so register reads go out as a single transaction
+// with a repeated start. It does not need pigpio nor root rights beyond
+// access to the device node.
+
+typedef struct{
+    unsigned Bus;                       // I2C bus number (e.g. 3 or 5)
+    int Fd;                             // Open /dev/i2c-N, -1 if closed
+} I2C_DevBus;
+
+// Opening of /dev/i2c-BusNumber and filling of the transport, 0 or -1
+int I2C_Dev_Open(I2C_DevBus *Bus, unsigned BusNumber, I2C_Transport *Transport);
+// Closing of the device node
+void I2C_Dev_Close(I2C_DevBus *Bus);
+
+#endif // I2C_DEV_H
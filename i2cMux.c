@@ -0,0 +1,279 @@
+//Include header file
+#include "i2cMux.h"
+#include <stdio.h>
+#include <string.h>
+
+/******************************************
+* @brief: Initializes an upstream bus without muxes
+* @param Bus: mux bus context (I2C_MuxBus *)
+* @param Inner: upstream bus backend (const I2C_Transport *)
+*******************************************/
+void I2C_MuxBus_Init(I2C_MuxBus *Bus, const I2C_Transport *Inner){
+    memset(Bus,0,sizeof(*Bus));
+    Bus->Inner = Inner;
+}
+
+/******************************************
+* @brief: Adds a mux to the upstream bus
+* @param Bus: mux bus context (I2C_MuxBus *)
+* @param I2CAddress: 7 bit address of the mux (uint8_t)
+* @note: Returns the index of the mux or I2C_ERR_BUS if the bus has
+*        I2C_MUX_MAX muxes already. Its control register is unknown
+*        until the first select.
+*******************************************/
+int I2C_MuxBus_AddMux(I2C_MuxBus *Bus, uint8_t I2CAddress){
+    if (Bus->Count == I2C_MUX_MAX) {
+        return I2C_ERR_BUS;
+    }
+    Bus->Addresses[Bus->Count] = I2CAddress & 0x7F;
+    Bus->Known &= (uint8_t)~(1 << Bus->Count);
+    return Bus->Count++;
+}
+
+/******************************************
+* @brief: Forgets the cached control registers
+* @param Bus: mux bus context (I2C_MuxBus *)
+* @note: To be called when the muxes may have changed behind our back
+*        (RESET pin, power cycle, another master). The next select
+*        writes every mux again.
+*******************************************/
+void I2C_MuxBus_Invalidate(I2C_MuxBus *Bus){
+    Bus->Known = 0;
+}
+
+// Writes the control register of a mux unless the cache says it holds
+// the value already
+static int writeControl(I2C_MuxBus *Bus, uint8_t Mux, uint8_t Control){
+    if (((Bus->Known >> Mux) & 1) && Bus->Control[Mux] == Control) {
+        return I2C_OK;
+    }
+    const I2C_Transport *inner = Bus->Inner;
+    int status = inner->Write(inner->Context,Bus->Addresses[Mux],&Control,1);
+    if (status < 0) {
+        // The mux may or may not have taken it
+        Bus->Known &= (uint8_t)~(1 << Mux);
+        Bus->Errors++;
+        fprintf(stderr, "Failed to select channel of I2C mux at address 0x%02X\nERROR CODE:%d\n", Bus->Addresses[Mux], status);
+        return status;
+    }
+    Bus->Control[Mux] = Control;
+    Bus->Known |= (uint8_t)(1 << Mux);
+    Bus->Selects++;
+    return I2C_OK;
+}
+
+// 1 if the channel is open and every other mux closed
+static int isOpen(const I2C_MuxBus *Bus, uint8_t Mux, uint8_t Channel){
+    for (uint8_t i = 0; i < Bus->Count; ++i) {
+        uint8_t control = (i == Mux) ? (uint8_t)(1 << Channel) : 0;
+        if (!((Bus->Known >> i) & 1) || Bus->Control[i] != control) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/******************************************
+* @brief: Opens a channel of a mux and closes every other one
+* @param Bus: mux bus context (I2C_MuxBus *)
+* @param Mux: index of the mux, I2C_MUX_NONE for the upstream bus (uint8_t)
+* @param Channel: channel number, 0 to I2C_MUX_CHANNELS-1 (uint8_t)
+* @note: Only the control registers that differ from the cache are
+*        written, the other muxes first so two channels are never open
+*        together. Nothing goes on the wire if the channel is open.
+*        Returns I2C_OK or the error of the failed write.
+*******************************************/
+int I2C_MuxBus_Select(I2C_MuxBus *Bus, uint8_t Mux, uint8_t Channel){
+    if ((Mux != I2C_MUX_NONE && Mux >= Bus->Count) || Channel >= I2C_MUX_CHANNELS) {
+        return I2C_ERR_BUS;
+    }
+    if (isOpen(Bus,Mux,Channel)) {
+        Bus->Skipped++;
+        return I2C_OK;
+    }
+    for (uint8_t i = 0; i < Bus->Count; ++i) {
+        if (i != Mux) {
+            int status = writeControl(Bus,i,0);
+            if (status < 0) {
+                return status;
+            }
+        }
+    }
+    return (Mux == I2C_MUX_NONE) ? I2C_OK : writeControl(Bus,Mux,(uint8_t)(1 << Channel));
+}
+
+// Transport of a channel: select, then the upstream backend
+
+static int channelSelect(I2C_MuxChannel *Channel){
+    return I2C_MuxBus_Select(Channel->Bus,Channel->Mux,Channel->Channel);
+}
+
+static int muxWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    I2C_MuxChannel *Channel = (I2C_MuxChannel *)Context;
+    const I2C_Transport *inner = Channel->Bus->Inner;
+    int status = channelSelect(Channel);
+    return (status < 0) ? status : inner->Write(inner->Context,SlaveAddress,Data,Length);
+}
+
+static int muxRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    I2C_MuxChannel *Channel = (I2C_MuxChannel *)Context;
+    const I2C_Transport *inner = Channel->Bus->Inner;
+    int status = channelSelect(Channel);
+    return (status < 0) ? status : inner->Read(inner->Context,SlaveAddress,Data,Length);
+}
+
+static int muxWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    I2C_MuxChannel *Channel = (I2C_MuxChannel *)Context;
+    const I2C_Transport *inner = Channel->Bus->Inner;
+    int status = channelSelect(Channel);
+    if (status < 0) {
+        return status;
+    }
+    if (inner->WriteRead == 0) {
+        status = inner->Write(inner->Context,SlaveAddress,WData,WLength);
+        return (status < 0) ? status : inner->Read(inner->Context,SlaveAddress,RData,RLength);
+    }
+    return inner->WriteRead(inner->Context,SlaveAddress,WData,WLength,RData,RLength);
+}
+
+static int muxTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    I2C_MuxChannel *Channel = (I2C_MuxChannel *)Context;
+    const I2C_Transport *inner = Channel->Bus->Inner;
+    int status = channelSelect(Channel);
+    return (status < 0) ? status : inner->Transfer(inner->Context,Messages,Count);
+}
+
+static int muxQuick(void *Context, uint8_t SlaveAddress){
+    I2C_MuxChannel *Channel = (I2C_MuxChannel *)Context;
+    const I2C_Transport *inner = Channel->Bus->Inner;
+    int status = channelSelect(Channel);
+    return (status < 0) ? status : inner->Quick(inner->Context,SlaveAddress);
+}
+
+static void muxDelay(void *Context, uint32_t Microseconds){
+    I2C_MuxChannel *Channel = (I2C_MuxChannel *)Context;
+    const I2C_Transport *inner = Channel->Bus->Inner;
+    if (inner->Delay != 0) {
+        inner->Delay(inner->Context,Microseconds);
+    }
+}
+
+static int muxFlush(void *Context, uint8_t SlaveAddress){
+    I2C_MuxChannel *Channel = (I2C_MuxChannel *)Context;
+    const I2C_Transport *inner = Channel->Bus->Inner;
+    int status = channelSelect(Channel);
+    return (status < 0) ? status : inner->Flush(inner->Context,SlaveAddress);
+}
+
+/******************************************
+* @brief: Initializes a channel and its transport
+* @param Channel: channel context (I2C_MuxChannel *)
+* @param Bus: upstream bus with the mux (I2C_MuxBus *)
+* @param Mux: index of the mux, I2C_MUX_NONE for the upstream bus (uint8_t)
+* @param Number: channel number of the mux (uint8_t)
+* @note: Selecting &Channel->Transport with I2C_SetTransport() makes
+*        every driver call reach the devices of the channel. With
+*        I2C_MUX_NONE it reaches the devices of the upstream bus, with
+*        every mux closed.
+*******************************************/
+void I2C_MuxChannel_Init(I2C_MuxChannel *Channel, I2C_MuxBus *Bus, uint8_t Mux, uint8_t Number){
+    memset(Channel,0,sizeof(*Channel));
+    Channel->Bus = Bus;
+    Channel->Mux = Mux;
+    Channel->Channel = (Mux == I2C_MUX_NONE) ? 0 : Number;
+    Channel->Transport.Write = muxWrite;
+    Channel->Transport.Read = muxRead;
+    Channel->Transport.WriteRead = muxWriteRead;
+    Channel->Transport.Transfer = (Bus->Inner->Transfer != 0) ? muxTransfer : 0;
+    Channel->Transport.Quick = muxQuick;
+    Channel->Transport.Delay = muxDelay;
+    Channel->Transport.Flush = (Bus->Inner->Flush != 0) ? muxFlush : 0;
+    Channel->Transport.Context = Channel;
+}
+
+/******************************************
+* @brief: Initializes an empty scheduler
+* @param Scheduler: scheduler context (I2C_MuxSched *)
+*******************************************/
+void I2C_MuxSched_Init(I2C_MuxSched *Scheduler){
+    memset(Scheduler,0,sizeof(*Scheduler));
+}
+
+/******************************************
+* @brief: Queues a job for a device behind a mux
+* @param Scheduler: scheduler context (I2C_MuxSched *)
+* @param Channel: channel of the device (I2C_MuxChannel *)
+* @param SlaveAddress: 7 bit address of the device (uint8_t)
+* @param Job: called with the address by the run (I2C_MuxJob)
+* @param Context: passed to Job (void *)
+* @note: Runs the queue first if it is full and returns the status of
+*        that run, I2C_OK otherwise.
+*******************************************/
+int I2C_MuxSched_Add(I2C_MuxSched *Scheduler, I2C_MuxChannel *Channel, uint8_t SlaveAddress, I2C_MuxJob Job, void *Context){
+    int status = I2C_OK;
+    if (Scheduler->Count == I2C_MUXSCHED_MAX_JOBS) {
+        status = I2C_MuxSched_Run(Scheduler);
+    }
+    I2C_MuxSched_Job *job = &Scheduler->Jobs[Scheduler->Count++];
+    job->Channel = Channel;
+    job->SlaveAddress = SlaveAddress;
+    job->Job = Job;
+    job->Context = Context;
+    return status;
+}
+
+// Order of the channel groups: the open channel first, then by mux and
+// channel number (the upstream bus last)
+static unsigned rank(const I2C_MuxChannel *Channel){
+    if (isOpen(Channel->Bus,Channel->Mux,Channel->Channel)) {
+        return 0;
+    }
+    return 1 + (unsigned)Channel->Mux * I2C_MUX_CHANNELS + Channel->Channel;
+}
+
+/******************************************
+* @brief: Executes every queued job grouped per channel
+* @param Scheduler: scheduler context (I2C_MuxSched *)
+* @note: The jobs of a channel run together, in the order they were
+*        queued, with the channel transport selected for the calling
+*        thread (I2C_SetThreadTransport). The override the thread had
+*        before is put back afterwards.
+*        The open channel goes first, so a run costs one select per
+*        channel with jobs at most. A failed job does not stop the
+*        others. Returns I2C_OK or the first error.
+*******************************************/
+int I2C_MuxSched_Run(I2C_MuxSched *Scheduler){
+    if (Scheduler->Count == 0) {
+        return I2C_OK;
+    }
+    Scheduler->Runs++;
+    // Stable insertion sort of the job indexes by channel rank
+    uint8_t order[I2C_MUXSCHED_MAX_JOBS];
+    unsigned ranks[I2C_MUXSCHED_MAX_JOBS];
+    for (int i = 0; i < Scheduler->Count; ++i) {
+        unsigned key = rank(Scheduler->Jobs[i].Channel);
+        int j = i;
+        while (j > 0 && ranks[j - 1] > key) {
+            order[j] = order[j - 1];
+            ranks[j] = ranks[j - 1];
+            j--;
+        }
+        order[j] = (uint8_t)i;
+        ranks[j] = key;
+    }
+    const I2C_Transport *previous = I2C_GetThreadTransport();
+    int first = I2C_OK;
+    for (int i = 0; i < Scheduler->Count; ++i) {
+        const I2C_MuxSched_Job *job = &Scheduler->Jobs[order[i]];
+        I2C_SetThreadTransport(&job->Channel->Transport);
+        int status = job->Job(job->Context,job->SlaveAddress);
+        if (status < 0) {
+            Scheduler->Failures++;
+            first = (first < 0) ? first : status;
+        }
+        Scheduler->JobsDone++;
+    }
+    I2C_SetThreadTransport(previous);
+    Scheduler->Count = 0;
+    return first;
+}
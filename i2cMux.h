@@ -0,0 +1,81 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef I2C_MUX_H
+#define I2C_MUX_H
+
+// TCA9548A style I2C multiplexers. The LM51772 has two addresses only, so
+// larger systems put the converters behind muxes: up to I2C_MUX_MAX muxes
+// on an upstream bus, each with I2C_MUX_CHANNELS downstream channels, the
+// control register (one bit per channel) written with a single byte write.
+// A device is addressed by its channel (upstream bus, mux, channel number)
+// and its own address. Every channel has a transport that opens the
+// channel before each transaction; the control register of every mux is
+// cached, so the select write only goes out when another channel is open,
+// and at most one mux is open at a time (the same device address exists
+// on every channel). The scheduler runs queued jobs grouped per channel,
+// the open channel first, so a sweep over many devices costs one select
+// per channel instead of one per access.
+
+#define I2C_MUX_MAX                     8   // Muxes per upstream bus (0x70..0x77)
+#define I2C_MUX_CHANNELS                8   // Channels per mux
+#define I2C_MUX_NONE                    0xFF // Mux of a channel for the upstream bus itself
+#define I2C_MUXSCHED_MAX_JOBS           128
+
+typedef struct{
+    const I2C_Transport *Inner;         // Upstream bus backend
+    uint8_t Addresses[I2C_MUX_MAX];     // 7 bit address per mux
+    uint8_t Count;                      // Muxes added
+    uint8_t Control[I2C_MUX_MAX];       // Last control register written per mux
+    uint8_t Known;                      // Bitmap of the muxes whose Control is valid
+    // Statistics
+    uint32_t Selects;                   // Control register writes
+    uint32_t Skipped;                   // Selects not needed, channel already open
+    uint32_t Errors;                    // Failed control register writes
+} I2C_MuxBus;
+
+typedef struct{
+    I2C_MuxBus *Bus;                    // Upstream bus and its muxes
+    uint8_t Mux;                        // Index of the mux, I2C_MUX_NONE for the upstream bus
+    uint8_t Channel;                    // Channel number of the mux
+    I2C_Transport Transport;            // Opens the channel before every transaction
+} I2C_MuxChannel;
+
+// Job of the scheduler, run with the transport of its channel selected
+typedef int (*I2C_MuxJob)(void *Context, uint8_t SlaveAddress);
+
+typedef struct{
+    I2C_MuxChannel *Channel;
+    uint8_t SlaveAddress;               // 7 bit address of the device on the channel
+    I2C_MuxJob Job;
+    void *Context;                      // Passed to Job
+} I2C_MuxSched_Job;
+
+typedef struct{
+    I2C_MuxSched_Job Jobs[I2C_MUXSCHED_MAX_JOBS];
+    int Count;                          // Queued jobs
+    // Statistics
+    uint32_t Runs;                      // I2C_MuxSched_Run() calls with work
+    uint32_t JobsDone;                  // Jobs executed
+    uint32_t Failures;                  // Jobs that returned an error
+} I2C_MuxSched;
+
+// Initialization of an upstream bus without muxes
+void I2C_MuxBus_Init(I2C_MuxBus *Bus, const I2C_Transport *Inner);
+// Adding a mux, returns its index or I2C_ERR_BUS if there are too many
+int I2C_MuxBus_AddMux(I2C_MuxBus *Bus, uint8_t I2CAddress);
+// Forgetting the cached control registers (e.g. after a mux reset)
+void I2C_MuxBus_Invalidate(I2C_MuxBus *Bus);
+// Opening a channel and closing every other one, skipped if already open
+int I2C_MuxBus_Select(I2C_MuxBus *Bus, uint8_t Mux, uint8_t Channel);
+// Initialization of a channel and of its transport
+void I2C_MuxChannel_Init(I2C_MuxChannel *Channel, I2C_MuxBus *Bus, uint8_t Mux, uint8_t Number);
+
+// Initialization of an empty scheduler
+void I2C_MuxSched_Init(I2C_MuxSched *Scheduler);
+// Queueing a job for a device, runs the queue first if it is full
+int I2C_MuxSched_Add(I2C_MuxSched *Scheduler, I2C_MuxChannel *Channel, uint8_t SlaveAddress, I2C_MuxJob Job, void *Context);
+// Executing every queued job grouped per channel, returns I2C_OK or the first error
+int I2C_MuxSched_Run(I2C_MuxSched *Scheduler);
+
+#endif // I2C_MUX_H
@@ -0,0 +1,276 @@
+//Include header file
+#include "i2cPec.h"
+#include <string.h>
+
+// CRC-8 of every byte value, polynomial 0x07
+static const uint8_t CrcTable[256] = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+    0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+    0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+    0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+    0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+    0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+    0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+    0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+    0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+    0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+    0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+    0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+    0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+    0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+    0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+    0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+static inline int pecMode(const I2C_Pec *Pec, uint8_t SlaveAddress){
+    SlaveAddress &= 0x7F;
+    return (Pec->Devices[SlaveAddress >> 3] >> (SlaveAddress & 7)) & 1;
+}
+
+static inline uint8_t crcByte(uint8_t Crc, uint8_t Byte){
+    return CrcTable[Crc ^ Byte];
+}
+
+// PEC of a read: address bytes and data, with the write part of a
+// write-read (WLength 0 for a plain read)
+static uint8_t readPec(uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, const uint8_t *RData, uint16_t RLength){
+    uint8_t crc = 0;
+    if (WLength > 0) {
+        crc = crcByte(crc,(uint8_t)((SlaveAddress & 0x7F) << 1));
+        crc = I2C_Pec_Crc8(crc,WData,WLength);
+    }
+    crc = crcByte(crc,(uint8_t)(((SlaveAddress & 0x7F) << 1) | 1));
+    return I2C_Pec_Crc8(crc,RData,RLength);
+}
+
+// Counts the outcome of an attempt, returns 1 if it is worth retrying
+static int retryable(I2C_Pec *Pec, int Status, int Attempt){
+    if (Status == I2C_ERR_NACK) {
+        Pec->Nacks++;
+    } else if (Status == I2C_ERR_PEC) {
+        Pec->PecErrors++;
+    } else {
+        return 0;
+    }
+    if (Attempt < Pec->Retries) {
+        Pec->Retried++;
+        return 1;
+    }
+    Pec->Failed++;
+    return 0;
+}
+
+static int pecWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    I2C_Pec *Pec = (I2C_Pec *)Context;
+    const I2C_Transport *inner = Pec->Inner;
+    if (!pecMode(Pec,SlaveAddress) || Length == 0) {
+        return inner->Write(inner->Context,SlaveAddress,Data,Length);
+    }
+    if (Length >= I2C_PEC_MAX_BYTES) {
+        return I2C_ERR_BUS;
+    }
+    uint8_t buffer[I2C_PEC_MAX_BYTES];
+    memcpy(buffer,Data,Length);
+    uint8_t crc = crcByte(0,(uint8_t)((SlaveAddress & 0x7F) << 1));
+    buffer[Length] = I2C_Pec_Crc8(crc,Data,Length);
+    int status;
+    for (int attempt = 0; ; ++attempt) {
+        status = inner->Write(inner->Context,SlaveAddress,buffer,(uint16_t)(Length + 1));
+        if (!retryable(Pec,status,attempt)) {
+            return status;
+        }
+    }
+}
+
+static int pecRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    I2C_Pec *Pec = (I2C_Pec *)Context;
+    const I2C_Transport *inner = Pec->Inner;
+    if (!pecMode(Pec,SlaveAddress) || Length == 0) {
+        return inner->Read(inner->Context,SlaveAddress,Data,Length);
+    }
+    if (Length >= I2C_PEC_MAX_BYTES) {
+        return I2C_ERR_BUS;
+    }
+    uint8_t buffer[I2C_PEC_MAX_BYTES];
+    int status = inner->Read(inner->Context,SlaveAddress,buffer,(uint16_t)(Length + 1));
+    if (status == I2C_OK && readPec(SlaveAddress,0,0,buffer,Length) != buffer[Length]) {
+        status = I2C_ERR_PEC;
+    }
+    if (status == I2C_OK) {
+        memcpy(Data,buffer,Length);
+    }
+    // Not retried, the register pointer has moved on
+    retryable(Pec,status,Pec->Retries);
+    return status;
+}
+
+static int pecWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    I2C_Pec *Pec = (I2C_Pec *)Context;
+    const I2C_Transport *inner = Pec->Inner;
+    if (!pecMode(Pec,SlaveAddress) || RLength == 0) {
+        if (inner->WriteRead == 0) {
+            int status = inner->Write(inner->Context,SlaveAddress,WData,WLength);
+            return (status < 0) ? status : inner->Read(inner->Context,SlaveAddress,RData,RLength);
+        }
+        return inner->WriteRead(inner->Context,SlaveAddress,WData,WLength,RData,RLength);
+    }
+    if (RLength >= I2C_PEC_MAX_BYTES) {
+        return I2C_ERR_BUS;
+    }
+    uint8_t buffer[I2C_PEC_MAX_BYTES];
+    int status;
+    for (int attempt = 0; ; ++attempt) {
+        if (inner->WriteRead != 0) {
+            status = inner->WriteRead(inner->Context,SlaveAddress,WData,WLength,buffer,(uint16_t)(RLength + 1));
+        } else {
+            // Without a repeated start the PEC only covers the read
+            status = inner->Write(inner->Context,SlaveAddress,WData,WLength);
+            if (status == I2C_OK) {
+                status = inner->Read(inner->Context,SlaveAddress,buffer,(uint16_t)(RLength + 1));
+            }
+        }
+        if (status == I2C_OK) {
+            uint8_t expected = (inner->WriteRead != 0) ? readPec(SlaveAddress,WData,WLength,buffer,RLength) :
+                                                         readPec(SlaveAddress,0,0,buffer,RLength);
+            if (expected != buffer[RLength]) {
+                status = I2C_ERR_PEC;
+            }
+        }
+        if (status == I2C_OK) {
+            memcpy(RData,buffer,RLength);
+            return I2C_OK;
+        }
+        if (!retryable(Pec,status,attempt)) {
+            return status;
+        }
+    }
+}
+
+// Combined transaction: every write gets its PEC, except the write of a
+// write-read pair to one device, whose PEC comes with the read
+static int pecTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    I2C_Pec *Pec = (I2C_Pec *)Context;
+    const I2C_Transport *inner = Pec->Inner;
+    I2C_Message messages[I2C_MAX_MESSAGES];
+    uint8_t pool[I2C_PEC_MAX_BYTES];
+    uint16_t used = 0;
+    if (Count > I2C_MAX_MESSAGES) {
+        return I2C_ERR_BUS;
+    }
+    for (uint16_t i = 0; i < Count; ++i) {
+        const I2C_Message *message = &Messages[i];
+        messages[i] = *message;
+        if (!pecMode(Pec,message->SlaveAddress)) {
+            continue;
+        }
+        int read = (message->Flags & I2C_MSG_READ) != 0;
+        int pairedWrite = !read && i + 1 < Count && (Messages[i + 1].Flags & I2C_MSG_READ) &&
+                          (Messages[i + 1].SlaveAddress & 0x7F) == (message->SlaveAddress & 0x7F);
+        if (pairedWrite || message->Length == 0) {
+            continue;
+        }
+        if (used + message->Length + 1 > I2C_PEC_MAX_BYTES) {
+            return I2C_ERR_BUS;
+        }
+        messages[i].Data = &pool[used];
+        messages[i].Length = (uint16_t)(message->Length + 1);
+        if (!read) {
+            memcpy(&pool[used],message->Data,message->Length);
+            uint8_t crc = crcByte(0,(uint8_t)((message->SlaveAddress & 0x7F) << 1));
+            pool[used + message->Length] = I2C_Pec_Crc8(crc,message->Data,message->Length);
+        }
+        used = (uint16_t)(used + message->Length + 1);
+    }
+    int status;
+    for (int attempt = 0; ; ++attempt) {
+        status = inner->Transfer(inner->Context,messages,Count);
+        for (uint16_t i = 0; status == I2C_OK && i < Count; ++i) {
+            const I2C_Message *message = &Messages[i];
+            if (!(message->Flags & I2C_MSG_READ) || messages[i].Data == message->Data) {
+                continue;
+            }
+            const I2C_Message *write = (i > 0 && !(Messages[i - 1].Flags & I2C_MSG_READ) &&
+                                        (Messages[i - 1].SlaveAddress & 0x7F) == (message->SlaveAddress & 0x7F)) ?
+                                       &Messages[i - 1] : 0;
+            uint8_t expected = readPec(message->SlaveAddress,write ? write->Data : 0,write ? write->Length : 0,
+                                       messages[i].Data,message->Length);
+            if (expected != messages[i].Data[message->Length]) {
+                status = I2C_ERR_PEC;
+            } else {
+                memcpy(message->Data,messages[i].Data,message->Length);
+            }
+        }
+        if (!retryable(Pec,status,attempt)) {
+            return status;
+        }
+    }
+}
+
+static int pecQuick(void *Context, uint8_t SlaveAddress){
+    I2C_Pec *Pec = (I2C_Pec *)Context;
+    return Pec->Inner->Quick(Pec->Inner->Context,SlaveAddress);
+}
+
+static void pecDelay(void *Context, uint32_t Microseconds){
+    I2C_Pec *Pec = (I2C_Pec *)Context;
+    if (Pec->Inner->Delay != 0) {
+        Pec->Inner->Delay(Pec->Inner->Context,Microseconds);
+    }
+}
+
+static int pecFlush(void *Context, uint8_t SlaveAddress){
+    I2C_Pec *Pec = (I2C_Pec *)Context;
+    return Pec->Inner->Flush(Pec->Inner->Context,SlaveAddress);
+}
+
+/******************************************
+* @brief: Computes the SMBus PEC (CRC-8) of a block of bytes
+* @param Crc: CRC of the bytes before, 0 at the start (uint8_t)
+* @param Data: bytes (const uint8_t *)
+* @param Length: amount of bytes (uint16_t)
+* @note: Polynomial x^8 + x^2 + x + 1, one table lookup per byte.
+*******************************************/
+uint8_t I2C_Pec_Crc8(uint8_t Crc, const uint8_t *Data, uint16_t Length){
+    for (uint16_t i = 0; i < Length; ++i) {
+        Crc = CrcTable[Crc ^ Data[i]];
+    }
+    return Crc;
+}
+
+/******************************************
+* @brief: Initializes a PEC transport
+* @param Pec: PEC context (I2C_Pec *)
+* @param Inner: bus backend (const I2C_Transport *)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*        No device is in PEC mode until I2C_Pec_Enable(), the devices
+*        have to be put in PEC mode too.
+*******************************************/
+void I2C_Pec_Init(I2C_Pec *Pec, const I2C_Transport *Inner, I2C_Transport *Transport){
+    memset(Pec,0,sizeof(*Pec));
+    Pec->Inner = Inner;
+    Pec->Retries = I2C_PEC_RETRIES;
+    Transport->Write = pecWrite;
+    Transport->Read = pecRead;
+    Transport->WriteRead = pecWriteRead;
+    Transport->Transfer = (Inner->Transfer != 0) ? pecTransfer : 0;
+    Transport->Quick = pecQuick;
+    Transport->Delay = pecDelay;
+    Transport->Flush = (Inner->Flush != 0) ? pecFlush : 0;
+    Transport->Context = Pec;
+}
+
+/******************************************
+* @brief: Turns PEC on or off for a device
+* @param Pec: PEC context (I2C_Pec *)
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param Enable: 1 to turn it on, 0 to turn it off (int)
+*******************************************/
+void I2C_Pec_Enable(I2C_Pec *Pec, uint8_t SlaveAddress, int Enable){
+    SlaveAddress &= 0x7F;
+    if (Enable) {
+        Pec->Devices[SlaveAddress >> 3] |= (uint8_t)(1 << (SlaveAddress & 7));
+    } else {
+        Pec->Devices[SlaveAddress >> 3] &= (uint8_t)~(1 << (SlaveAddress & 7));
+    }
+}
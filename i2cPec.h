@@ -0,0 +1,43 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef I2C_PEC_H
+#define I2C_PEC_H
+
+// SMBus Packet Error Checking, a transport placed between the driver and a
+// bus backend. For the devices put in PEC mode every write gets a CRC-8
+// (polynomial x^8 + x^2 + x + 1, over the address bytes and the data)
+// appended, which the device checks and NACKs if wrong, and every read
+// gets one more byte, the CRC-8 computed by the device, which is checked
+// here. A NACK or a PEC mismatch is retried up to I2C_PEC_RETRIES times, so
+// a noisy line costs a retry instead of the read-back of every write.
+// The CRC is table driven, one lookup per byte.
+// Plain reads continuing at the register pointer (I2C_ReadBlock) are not
+// retried, a second read would continue further. Devices not in PEC mode
+// (EEPROMs, ...) and quick commands go through untouched.
+
+// Status code besides the I2C_* codes of i2cTransport.h
+#define I2C_ERR_PEC                     -9  // PEC of a read wrong after the retries
+
+#define I2C_PEC_RETRIES                 3   // Retries after a NACK or PEC mismatch
+#define I2C_PEC_MAX_BYTES               512 // Bytes of a transfer (all messages) with PEC
+
+typedef struct{
+    const I2C_Transport *Inner;         // Bus backend
+    uint8_t Devices[16];                // Bitmap of the devices in PEC mode
+    uint8_t Retries;                    // Retries per transfer
+    // Statistics
+    uint32_t PecErrors;                 // Reads with a wrong PEC
+    uint32_t Nacks;                     // NACKed transfers (incl. PEC rejected by the device)
+    uint32_t Retried;                   // Retries done
+    uint32_t Failed;                    // Transfers failed after the retries
+} I2C_Pec;
+
+// Initialization, no device in PEC mode, and of the transport pointing to it
+void I2C_Pec_Init(I2C_Pec *Pec, const I2C_Transport *Inner, I2C_Transport *Transport);
+// Turning PEC on/off for a device
+void I2C_Pec_Enable(I2C_Pec *Pec, uint8_t SlaveAddress, int Enable);
+// CRC-8 of SMBus PEC, continuing from Crc (0 at the start)
+uint8_t I2C_Pec_Crc8(uint8_t Crc, const uint8_t *Data, uint16_t Length);
+
+#endif // I2C_PEC_H
@@ -0,0 +1,111 @@
+//Include header file
+#include "i2cPigpio.h"
+#include <pigpio.h>
+#include <unistd.h>
+#include <stdio.h>
+
+// Returns the cached handle for the address, opening it if needed
+static int getHandle(I2C_PigpioBus *Bus, uint8_t SlaveAddress){
+    SlaveAddress &= 0x7F;
+    if (Bus->Handles[SlaveAddress] < 0) {
+        int handle = i2cOpen(Bus->Bus,SlaveAddress,0);
+        if (handle < 0) {
+            fprintf(stderr, "Failed to open I2C device at address 0x%02X\n", SlaveAddress);
+            return handle;
+        }
+        Bus->Handles[SlaveAddress] = handle;
+    }
+    return Bus->Handles[SlaveAddress];
+}
+
+static int pigpioWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    int handle = getHandle((I2C_PigpioBus *)Context,SlaveAddress);
+    if (handle < 0) {
+        return I2C_ERR_BUS;
+    }
+    int status = i2cWriteDevice(handle,(char *)Data,Length);
+    return (status < 0) ? I2C_ERR_NACK : I2C_OK;
+}
+
+static int pigpioRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    int handle = getHandle((I2C_PigpioBus *)Context,SlaveAddress);
+    if (handle < 0) {
+        return I2C_ERR_BUS;
+    }
+    int status = i2cReadDevice(handle,(char *)Data,Length);
+    return (status < 0) ? I2C_ERR_NACK : I2C_OK;
+}
+
+static int pigpioTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    if (Count == 0) {
+        return I2C_OK;
+    }
+    // Any open handle of the bus will do, every segment has its address
+    int handle = getHandle((I2C_PigpioBus *)Context,Messages[0].SlaveAddress);
+    if (handle < 0) {
+        return I2C_ERR_BUS;
+    }
+    pi_i2c_msg_t segments[I2C_MAX_MESSAGES];
+    for (uint16_t i = 0; i < Count; ++i) {
+        segments[i].addr = Messages[i].SlaveAddress & 0x7F;
+        segments[i].flags = (Messages[i].Flags & I2C_MSG_READ) ? 1 : 0;
+        segments[i].len = Messages[i].Length;
+        segments[i].buf = Messages[i].Data;
+    }
+    int status = i2cSegments(handle,segments,Count);
+    return (status == Count) ? I2C_OK : I2C_ERR_NACK;
+}
+
+static int pigpioQuick(void *Context, uint8_t SlaveAddress){
+    int handle = getHandle((I2C_PigpioBus *)Context,SlaveAddress);
+    if (handle < 0) {
+        return I2C_ERR_BUS;
+    }
+    // Send a quick write operation
+    int status = i2cWriteQuick(handle,0);
+    return (status == 0) ? I2C_OK : I2C_ERR_NACK;
+}
+
+static void pigpioDelay(void *Context, uint32_t Microseconds){
+    (void)Context;
+    usleep(Microseconds);
+}
+
+/******************************************
+* @brief: Initializes a pigpio bus context and its transport
+* @param Bus: bus context to be initialized (I2C_PigpioBus *)
+* @param BusNumber: I2C bus number used by pigpio (unsigned)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*        The WriteRead function is left NULL, register reads are then
+*        done as a write of the register address followed by a read,
+*        which is how the test programs have always accessed the bus.
+*        Combined transactions (I2C_Transfer) use i2cSegments().
+*******************************************/
+void I2C_Pigpio_Init(I2C_PigpioBus *Bus, unsigned BusNumber, I2C_Transport *Transport){
+    Bus->Bus = BusNumber;
+    for (int i = 0; i < 128; ++i) {
+        Bus->Handles[i] = -1;
+    }
+    Transport->Write = pigpioWrite;
+    Transport->Read = pigpioRead;
+    Transport->WriteRead = 0;
+    Transport->Transfer = pigpioTransfer;
+    Transport->Quick = pigpioQuick;
+    Transport->Delay = pigpioDelay;
+    Transport->Flush = 0;
+    Transport->Context = Bus;
+}
+
+/******************************************
+* @brief: Closes every handle opened on the bus
+* @param Bus: bus context (I2C_PigpioBus *)
+*******************************************/
+void I2C_Pigpio_Close(I2C_PigpioBus *Bus){
+    for (int i = 0; i < 128; ++i) {
+        if (Bus->Handles[i] >= 0) {
+            i2cClose(Bus->Handles[i]);
+            Bus->Handles[i] = -1;
+        }
+    }
+}
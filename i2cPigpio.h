@@ -0,0 +1,22 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef I2C_PIGPIO_H
+#define I2C_PIGPIO_H
+
+// pigpio backend for the I2C transport. Handles are opened on the first
+// access to each address and kept open until I2C_Pigpio_Close() is called,
+// so no i2cOpen()/i2cClose() pair is paid on every transfer.
+// gpioInitialise() has to be called before using it.
+
+typedef struct{
+    unsigned Bus;                   // I2C bus number (e.g. 3 or 5)
+    int Handles[128];               // Open handle per 7 bit address, -1 if closed
+} I2C_PigpioBus;
+
+// Initialization of the bus context and of the transport pointing to it
+void I2C_Pigpio_Init(I2C_PigpioBus *Bus, unsigned BusNumber, I2C_Transport *Transport);
+// Closing of every handle opened on the bus
+void I2C_Pigpio_Close(I2C_PigpioBus *Bus);
+
+#endif // I2C_PIGPIO_H
@@ -0,0 +1,148 @@
+//Include header file
+#include "i2cRecorder.h"
+#include <string.h>
+
+#define LINE_MAX_BYTES          64      // Bytes shown per direction, then "..."
+
+// Line being built, written at once
+typedef struct{
+    char Text[512];
+    size_t Length;
+} Line;
+
+static void append(Line *Line, const char *Text){
+    size_t n = strlen(Text);
+    if (Line->Length + n < sizeof(Line->Text)) {
+        memcpy(&Line->Text[Line->Length],Text,n + 1);
+        Line->Length += n;
+    }
+}
+
+static void appendBytes(Line *Line, const uint8_t *Data, uint16_t Length){
+    char hex[4];
+    for (uint16_t i = 0; i < Length && i < LINE_MAX_BYTES; ++i) {
+        snprintf(hex,sizeof(hex)," %02X",Data[i]);
+        append(Line,hex);
+    }
+    if (Length > LINE_MAX_BYTES) {
+        append(Line," ...");
+    }
+}
+
+static void begin(I2C_Recorder *Recorder, Line *Line, const char *Op, uint8_t SlaveAddress){
+    char head[64];
+    Line->Length = 0;
+    Line->Text[0] = 0;
+    if (Recorder->Tag != 0) {
+        append(Line,Recorder->Tag);
+        append(Line," ");
+    }
+    snprintf(head,sizeof(head),"%s %02X",Op,SlaveAddress & 0x7F);
+    append(Line,head);
+}
+
+static void finish(I2C_Recorder *Recorder, Line *Line, int Status){
+    char tail[32];
+    if (Status < 0) {
+        snprintf(tail,sizeof(tail)," ERR %d",Status);
+        append(Line,tail);
+    }
+    append(Line,"\n");
+    fputs(Line->Text,Recorder->Stream);
+    Recorder->Lines++;
+}
+
+static int recorderWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    I2C_Recorder *Recorder = (I2C_Recorder *)Context;
+    int status = Recorder->Inner->Write(Recorder->Inner->Context,SlaveAddress,Data,Length);
+    Line line;
+    begin(Recorder,&line,"W",SlaveAddress);
+    append(&line,":");
+    appendBytes(&line,Data,Length);
+    finish(Recorder,&line,status);
+    return status;
+}
+
+static int recorderRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    I2C_Recorder *Recorder = (I2C_Recorder *)Context;
+    int status = Recorder->Inner->Read(Recorder->Inner->Context,SlaveAddress,Data,Length);
+    Line line;
+    begin(Recorder,&line,"R",SlaveAddress);
+    append(&line,": ->");
+    if (status == I2C_OK) {
+        appendBytes(&line,Data,Length);
+    }
+    finish(Recorder,&line,status);
+    return status;
+}
+
+static int recorderWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    I2C_Recorder *Recorder = (I2C_Recorder *)Context;
+    int status = Recorder->Inner->WriteRead(Recorder->Inner->Context,SlaveAddress,WData,WLength,RData,RLength);
+    Line line;
+    begin(Recorder,&line,"WR",SlaveAddress);
+    append(&line,":");
+    appendBytes(&line,WData,WLength);
+    append(&line," ->");
+    if (status == I2C_OK) {
+        appendBytes(&line,RData,RLength);
+    }
+    finish(Recorder,&line,status);
+    return status;
+}
+
+static int recorderQuick(void *Context, uint8_t SlaveAddress){
+    I2C_Recorder *Recorder = (I2C_Recorder *)Context;
+    int status = Recorder->Inner->Quick(Recorder->Inner->Context,SlaveAddress);
+    Line line;
+    begin(Recorder,&line,"Q",SlaveAddress);
+    finish(Recorder,&line,status);
+    return status;
+}
+
+static int recorderFlush(void *Context, uint8_t SlaveAddress){
+    I2C_Recorder *Recorder = (I2C_Recorder *)Context;
+    // The writes of the flush are recorded by a recorder below it
+    return Recorder->Inner->Flush(Recorder->Inner->Context,SlaveAddress);
+}
+
+static void recorderDelay(void *Context, uint32_t Microseconds){
+    I2C_Recorder *Recorder = (I2C_Recorder *)Context;
+    Recorder->Inner->Delay(Recorder->Inner->Context,Microseconds);
+    Line line;
+    char text[32];
+    line.Length = 0;
+    line.Text[0] = 0;
+    if (Recorder->Tag != 0) {
+        append(&line,Recorder->Tag);
+        append(&line," ");
+    }
+    snprintf(text,sizeof(text),"D %u",(unsigned)Microseconds);
+    append(&line,text);
+    finish(Recorder,&line,I2C_OK);
+}
+
+/******************************************
+* @brief: Initializes a recording transport
+* @param Recorder: recorder context (I2C_Recorder *)
+* @param Inner: transport the transfers are forwarded to (const I2C_Transport *)
+* @param Stream: transcript output (FILE *)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*        WriteRead and Delay are only provided if the inner transport
+*        has them, so the transcript shows what actually goes out.
+*******************************************/
+void I2C_Recorder_Init(I2C_Recorder *Recorder, const I2C_Transport *Inner, FILE *Stream, I2C_Transport *Transport){
+    memset(Recorder,0,sizeof(*Recorder));
+    Recorder->Inner = Inner;
+    Recorder->Stream = Stream;
+    Transport->Write = recorderWrite;
+    Transport->Read = recorderRead;
+    Transport->WriteRead = (Inner->WriteRead != 0) ? recorderWriteRead : 0;
+    // Combined transactions are recorded message by message
+    Transport->Transfer = 0;
+    Transport->Quick = recorderQuick;
+    Transport->Delay = (Inner->Delay != 0) ? recorderDelay : 0;
+    Transport->Flush = (Inner->Flush != 0) ? recorderFlush : 0;
+    Transport->Context = Recorder;
+}
@@ -0,0 +1,29 @@
+#include <stdint.h>
+#include <stdio.h>
+#include "i2cTransport.h"
+
+#ifndef I2C_RECORDER_H
+#define I2C_RECORDER_H
+
+// Recording transport. It forwards every transfer to an inner transport
+// and writes one line per transfer to a stream, a transcript that can be
+// kept as a golden file and diffed between runs:
+//   W 6A: 0C FA          write
+//   R 6A: -> 00          read
+//   WR 6A: D0 -> 01      write + repeated start read
+//   Q 6A                 quick command
+//   D 1000               delay in us
+// Failed transfers end with " ERR <status>". Every line is written with
+// one call, so recorders of several threads can share a stream.
+
+typedef struct{
+    const I2C_Transport *Inner;         // Forwarded transport
+    FILE *Stream;                       // Transcript output
+    const char *Tag;                    // Prefix of every line, can be NULL
+    uint64_t Lines;                     // Lines written
+} I2C_Recorder;
+
+// Initialization of the recorder and of the transport pointing to it
+void I2C_Recorder_Init(I2C_Recorder *Recorder, const I2C_Transport *Inner, FILE *Stream, I2C_Transport *Transport);
+
+#endif // I2C_RECORDER_H
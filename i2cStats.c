@@ -0,0 +1,248 @@
+//Include header file
+#include "i2cStats.h"
+#include "i2cTransport.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+// Live counters, same layout as the snapshot but atomic
+typedef struct{
+    _Atomic uint64_t Reads;
+    _Atomic uint64_t Writes;
+    _Atomic uint64_t Nacks;
+    _Atomic uint64_t Errors;
+    _Atomic uint64_t PollRetries;
+} DeviceCounters;
+
+typedef struct{
+    _Atomic uint64_t Reads;
+    _Atomic uint64_t Writes;
+} RegisterCounters;
+
+typedef struct{
+    _Atomic uint64_t Count;
+    _Atomic uint64_t SumNs;
+    _Atomic uint64_t MaxNs;
+    _Atomic uint64_t Buckets[I2C_HIST_BUCKETS];
+} HistogramCounters;
+
+// Every recording thread owns a shard and is its only writer, so the
+// counters are bumped with plain relaxed loads and stores, no atomic
+// read-modify-write. Threads beyond I2C_STATS_SHARDS - 1 share the last
+// shard, which is updated with atomic additions.
+typedef struct{
+    DeviceCounters Devices[128];
+    RegisterCounters Registers[256];
+    HistogramCounters Latency[I2C_OP_COUNT];
+} Shard;
+
+static Shard Shards[I2C_STATS_SHARDS];
+static _Atomic int ShardsTaken = 0;
+static _Thread_local Shard *OwnShard = 0;
+static _Thread_local int OwnShared = 0;
+
+#define LOAD(counter)       atomic_load_explicit(&(counter),memory_order_relaxed)
+#define CLEAR(counter)      atomic_store_explicit(&(counter),0,memory_order_relaxed)
+
+static inline void add(_Atomic uint64_t *Counter, uint64_t Value){
+    if (OwnShared) {
+        atomic_fetch_add_explicit(Counter,Value,memory_order_relaxed);
+    } else {
+        atomic_store_explicit(Counter,atomic_load_explicit(Counter,memory_order_relaxed) + Value,memory_order_relaxed);
+    }
+}
+
+// Shard of the calling thread, claimed on its first record
+static Shard *ownShard(void){
+    if (OwnShard == 0) {
+        int index = atomic_fetch_add_explicit(&ShardsTaken,1,memory_order_relaxed);
+        if (index >= I2C_STATS_SHARDS - 1) {
+            index = I2C_STATS_SHARDS - 1;
+            OwnShared = 1;
+        }
+        OwnShard = &Shards[index];
+    }
+    return OwnShard;
+}
+
+/******************************************
+* @brief: Returns the histogram bucket of a latency
+* @param LatencyNs: latency in ns (uint64_t)
+* @note: Values below 2*I2C_HIST_SUB get their own bucket, above that
+*        the bucket is given by the position of the most significant
+*        bit and the I2C_HIST_SUB_BITS bits that follow it. Latencies
+*        beyond the range land in the last bucket.
+*******************************************/
+int I2C_Stats_Bucket(uint64_t LatencyNs){
+    if (LatencyNs < 2*I2C_HIST_SUB) {
+        return (int)LatencyNs;
+    }
+    int msb = 63 - __builtin_clzll(LatencyNs);
+    if (msb >= I2C_HIST_MAX_BITS) {
+        return I2C_HIST_BUCKETS - 1;
+    }
+    int shift = msb - I2C_HIST_SUB_BITS;
+    return (shift + 1)*I2C_HIST_SUB + (int)((LatencyNs >> shift) & (I2C_HIST_SUB - 1));
+}
+
+/******************************************
+* @brief: Returns the lowest latency falling in a bucket
+* @param Bucket: bucket index (int)
+*******************************************/
+uint64_t I2C_Stats_BucketValue(int Bucket){
+    if (Bucket < 2*I2C_HIST_SUB) {
+        return (uint64_t)Bucket;
+    }
+    int shift = Bucket/I2C_HIST_SUB - 1;
+    return (uint64_t)(I2C_HIST_SUB + Bucket % I2C_HIST_SUB) << shift;
+}
+
+/******************************************
+* @brief: Returns a monotonic time stamp in ns
+*******************************************/
+uint64_t I2C_Stats_Now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/******************************************
+* @brief: Records a bus transfer
+* @param Operation: I2C_OP_WRITE, I2C_OP_READ, I2C_OP_WRITEREAD or
+*                   I2C_OP_QUICK (int)
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param RegAddress: register the transfer starts at or
+*                    I2C_STATS_NO_REG (int)
+* @param Status: status returned by the backend (int)
+* @param LatencyNs: duration of the transfer (uint64_t)
+* @note: Lock-free, the counters are in the shard of the calling
+*        thread. The counters of one transfer are not updated as a
+*        whole, so a snapshot taken meanwhile can be off by one transfer.
+*******************************************/
+void I2C_Stats_Record(int Operation, uint8_t SlaveAddress, int RegAddress, int Status, uint64_t LatencyNs){
+    Shard *shard = ownShard();
+    DeviceCounters *device = &shard->Devices[SlaveAddress & 0x7F];
+    if (Status == I2C_ERR_NACK) {
+        add(&device->Nacks,1);
+    } else if (Status < 0) {
+        add(&device->Errors,1);
+    }
+    if (Operation == I2C_OP_WRITE) {
+        add(&device->Writes,1);
+        if (RegAddress >= 0) {
+            add(&shard->Registers[RegAddress & 0xFF].Writes,1);
+        }
+    } else if (Operation != I2C_OP_QUICK) {
+        add(&device->Reads,1);
+        if (RegAddress >= 0) {
+            add(&shard->Registers[RegAddress & 0xFF].Reads,1);
+        }
+    }
+    HistogramCounters *hist = &shard->Latency[Operation];
+    add(&hist->Count,1);
+    add(&hist->SumNs,LatencyNs);
+    add(&hist->Buckets[I2C_Stats_Bucket(LatencyNs)],1);
+    uint64_t max = LOAD(hist->MaxNs);
+    while (LatencyNs > max &&
+           !atomic_compare_exchange_weak_explicit(&hist->MaxNs,&max,LatencyNs,memory_order_relaxed,memory_order_relaxed)) {
+    }
+}
+
+/******************************************
+* @brief: Records a poll of pollForDevice not acknowledged
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+*******************************************/
+void I2C_Stats_PollRetry(uint8_t SlaveAddress){
+    add(&ownShard()->Devices[SlaveAddress & 0x7F].PollRetries,1);
+}
+
+/******************************************
+* @brief: Copies the current counters
+* @param Snapshot: destination (I2C_StatsSnapshot *)
+* @note: Can be called while other threads record, every counter is
+*        read atomically but not all of them at the same instant.
+*******************************************/
+void I2C_Stats_Snapshot(I2C_StatsSnapshot *Snapshot){
+    memset(Snapshot,0,sizeof(*Snapshot));
+    for (int s = 0; s < I2C_STATS_SHARDS; ++s) {
+        const Shard *shard = &Shards[s];
+        for (int i = 0; i < 128; ++i) {
+            Snapshot->Devices[i].Reads += LOAD(shard->Devices[i].Reads);
+            Snapshot->Devices[i].Writes += LOAD(shard->Devices[i].Writes);
+            Snapshot->Devices[i].Nacks += LOAD(shard->Devices[i].Nacks);
+            Snapshot->Devices[i].Errors += LOAD(shard->Devices[i].Errors);
+            Snapshot->Devices[i].PollRetries += LOAD(shard->Devices[i].PollRetries);
+        }
+        for (int i = 0; i < 256; ++i) {
+            Snapshot->Registers[i].Reads += LOAD(shard->Registers[i].Reads);
+            Snapshot->Registers[i].Writes += LOAD(shard->Registers[i].Writes);
+        }
+        for (int op = 0; op < I2C_OP_COUNT; ++op) {
+            I2C_Histogram *hist = &Snapshot->Latency[op];
+            hist->Count += LOAD(shard->Latency[op].Count);
+            hist->SumNs += LOAD(shard->Latency[op].SumNs);
+            uint64_t max = LOAD(shard->Latency[op].MaxNs);
+            if (max > hist->MaxNs) {
+                hist->MaxNs = max;
+            }
+            for (int b = 0; b < I2C_HIST_BUCKETS; ++b) {
+                hist->Buckets[b] += LOAD(shard->Latency[op].Buckets[b]);
+            }
+        }
+    }
+}
+
+/******************************************
+* @brief: Clears every counter and histogram
+* @note: Meant to be called while no transfer is in progress, a
+*        record done meanwhile by another thread can survive it.
+*******************************************/
+void I2C_Stats_Reset(void){
+    for (int s = 0; s < I2C_STATS_SHARDS; ++s) {
+        Shard *shard = &Shards[s];
+        for (int i = 0; i < 128; ++i) {
+            CLEAR(shard->Devices[i].Reads);
+            CLEAR(shard->Devices[i].Writes);
+            CLEAR(shard->Devices[i].Nacks);
+            CLEAR(shard->Devices[i].Errors);
+            CLEAR(shard->Devices[i].PollRetries);
+        }
+        for (int i = 0; i < 256; ++i) {
+            CLEAR(shard->Registers[i].Reads);
+            CLEAR(shard->Registers[i].Writes);
+        }
+        for (int op = 0; op < I2C_OP_COUNT; ++op) {
+            CLEAR(shard->Latency[op].Count);
+            CLEAR(shard->Latency[op].SumNs);
+            CLEAR(shard->Latency[op].MaxNs);
+            for (int b = 0; b < I2C_HIST_BUCKETS; ++b) {
+                CLEAR(shard->Latency[op].Buckets[b]);
+            }
+        }
+    }
+}
+
+/******************************************
+* @brief: Returns the latency of a percentile of a histogram
+* @param Histogram: snapshot histogram (const I2C_Histogram *)
+* @param Percentile: 0 to 100 (double)
+* @note: Returns the lowest latency of the bucket holding the
+*        percentile, or 0 for an empty histogram.
+*******************************************/
+uint64_t I2C_Stats_Percentile(const I2C_Histogram *Histogram, double Percentile){
+    if (Histogram->Count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(Percentile/100.0*(double)Histogram->Count);
+    if (rank >= Histogram->Count) {
+        rank = Histogram->Count - 1;
+    }
+    uint64_t seen = 0;
+    for (int b = 0; b < I2C_HIST_BUCKETS; ++b) {
+        seen += Histogram->Buckets[b];
+        if (seen > rank) {
+            return I2C_Stats_BucketValue(b);
+        }
+    }
+    return Histogram->MaxNs;
+}
@@ -0,0 +1,80 @@
+#include <stdint.h>
+
+#ifndef I2C_STATS_H
+#define I2C_STATS_H
+
+// Bus transaction accounting of the transport layer. When i2cTransport.c
+// is compiled with I2C_STATS defined, every transfer is counted per device
+// and per register and its latency is added to a histogram of its
+// operation type. Without I2C_STATS nothing is recorded and nothing is
+// added to the transfers.
+// Recording is lock-free: every thread counts in its own shard, so it can
+// be done from several threads at once. The counters are read with a
+// snapshot, which adds up the shards.
+
+// Operation types
+#define I2C_OP_WRITE                    0
+#define I2C_OP_READ                     1
+#define I2C_OP_WRITEREAD                2
+#define I2C_OP_QUICK                    3
+#define I2C_OP_COUNT                    4
+
+// Threads with their own shard, the remaining ones share the last one
+#ifndef I2C_STATS_SHARDS
+#define I2C_STATS_SHARDS                8
+#endif
+
+// Register passed when the transfer does not address one (reads
+// continuing at the register pointer, quick commands)
+#define I2C_STATS_NO_REG                -1
+
+// Log-linear latency histogram: values below 2*I2C_HIST_SUB are exact,
+// above that every power of two is split in I2C_HIST_SUB buckets, which
+// keeps the relative error under 1/I2C_HIST_SUB (12.5%)
+#define I2C_HIST_SUB_BITS               3
+#define I2C_HIST_SUB                    (1 << I2C_HIST_SUB_BITS)
+#define I2C_HIST_MAX_BITS               40      // Up to ~1100 s in ns
+#define I2C_HIST_BUCKETS                ((I2C_HIST_MAX_BITS - I2C_HIST_SUB_BITS + 1) * I2C_HIST_SUB)
+
+typedef struct{
+    uint64_t Reads;                     // Read and write-read transactions
+    uint64_t Writes;                    // Write transactions
+    uint64_t Nacks;                     // Transfers not acknowledged
+    uint64_t Errors;                    // Other failed transfers
+    uint64_t PollRetries;               // Unacknowledged polls of pollForDevice
+} I2C_DeviceStats;
+
+typedef struct{
+    uint64_t Reads;                     // Reads starting at the register
+    uint64_t Writes;                    // Writes starting at the register
+} I2C_RegisterStats;
+
+typedef struct{
+    uint64_t Count;                     // Recorded transfers
+    uint64_t SumNs;                     // Sum of the latencies
+    uint64_t MaxNs;                     // Longest latency
+    uint64_t Buckets[I2C_HIST_BUCKETS]; // Log-linear buckets
+} I2C_Histogram;
+
+typedef struct{
+    I2C_DeviceStats Devices[128];       // Indexed by 7 bit address
+    I2C_RegisterStats Registers[256];   // Indexed by register, all devices
+    I2C_Histogram Latency[I2C_OP_COUNT];// Indexed by operation type
+} I2C_StatsSnapshot;
+
+// Recording, called by the transport
+void I2C_Stats_Record(int Operation, uint8_t SlaveAddress, int RegAddress, int Status, uint64_t LatencyNs);
+void I2C_Stats_PollRetry(uint8_t SlaveAddress);
+// Monotonic time stamp used for the latencies
+uint64_t I2C_Stats_Now(void);
+
+// Reading and clearing
+void I2C_Stats_Snapshot(I2C_StatsSnapshot *Snapshot);
+void I2C_Stats_Reset(void);
+// Latency of the given percentile (0..100) of a histogram, in ns
+uint64_t I2C_Stats_Percentile(const I2C_Histogram *Histogram, double Percentile);
+// Mapping between latencies and buckets
+int I2C_Stats_Bucket(uint64_t LatencyNs);
+uint64_t I2C_Stats_BucketValue(int Bucket);
+
+#endif // I2C_STATS_H
@@ -0,0 +1,208 @@
+//Include header file
+#include "i2cTrace.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct{
+    Trace_Event *Events;                // Allocated when the thread claims it
+    _Atomic uint32_t Count;             // Events published to the exporter
+} TraceBuffer;
+
+static TraceBuffer Buffers[TRACE_MAX_THREADS];
+static _Atomic int BuffersTaken = 0;
+static _Atomic int Enabled = 0;
+static _Atomic uint64_t Dropped = 0;
+static _Thread_local TraceBuffer *OwnBuffer = 0;
+static _Thread_local int OwnBufferFailed = 0;
+static Trace_Clock Clock = 0;
+static void *ClockContext = 0;
+
+// Buffer of the calling thread, claimed on its first event
+static TraceBuffer *ownBuffer(void){
+    if (OwnBuffer == 0 && !OwnBufferFailed) {
+        int index = atomic_fetch_add_explicit(&BuffersTaken,1,memory_order_relaxed);
+        if (index < TRACE_MAX_THREADS) {
+            Buffers[index].Events = malloc(TRACE_BUFFER_EVENTS*sizeof(Trace_Event));
+            OwnBuffer = (Buffers[index].Events != 0) ? &Buffers[index] : 0;
+        }
+        OwnBufferFailed = (OwnBuffer == 0);
+    }
+    return OwnBuffer;
+}
+
+// Slot for a new event, NULL if the event has to be dropped
+static Trace_Event *newEvent(void){
+    if (!atomic_load_explicit(&Enabled,memory_order_relaxed)) {
+        return 0;
+    }
+    TraceBuffer *buffer = ownBuffer();
+    if (buffer == 0 || atomic_load_explicit(&buffer->Count,memory_order_relaxed) >= TRACE_BUFFER_EVENTS) {
+        atomic_fetch_add_explicit(&Dropped,1,memory_order_relaxed);
+        return 0;
+    }
+    return &buffer->Events[atomic_load_explicit(&buffer->Count,memory_order_relaxed)];
+}
+
+// Makes the event just filled visible to the exporter
+static void publish(void){
+    atomic_fetch_add_explicit(&OwnBuffer->Count,1,memory_order_release);
+}
+
+/******************************************
+* @brief: Starts recording events
+*******************************************/
+void Trace_Start(void){
+    atomic_store(&Enabled,1);
+}
+
+/******************************************
+* @brief: Stops recording events, the recorded ones are kept
+*******************************************/
+void Trace_Stop(void){
+    atomic_store(&Enabled,0);
+}
+
+/******************************************
+* @brief: Selects the clock of the time stamps
+* @param NewClock: function returning the time in ns, NULL selects
+*                  CLOCK_MONOTONIC (Trace_Clock)
+* @param Context: passed to NewClock (void *)
+* @note: To be called before starting the recording.
+*******************************************/
+void Trace_SetClock(Trace_Clock NewClock, void *Context){
+    Clock = NewClock;
+    ClockContext = Context;
+}
+
+/******************************************
+* @brief: Returns the current time stamp in ns
+*******************************************/
+uint64_t Trace_Now(void){
+    if (Clock != 0) {
+        return Clock(ClockContext);
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void recordPhase(const char *Name, char Phase){
+    Trace_Event *event = newEvent();
+    if (event == 0) {
+        return;
+    }
+    event->Name = Name;
+    event->TimeNs = Trace_Now();
+    event->DurationNs = 0;
+    event->Phase = Phase;
+    event->SlaveAddress = 0;
+    event->RegAddress = -1;
+    event->Length = 0;
+    event->Status = 0;
+    publish();
+}
+
+/******************************************
+* @brief: Records the beginning of an API call
+* @param Name: function name, must stay valid (const char *)
+*******************************************/
+void Trace_Begin(const char *Name){
+    recordPhase(Name,TRACE_BEGIN);
+}
+
+/******************************************
+* @brief: Records the end of an API call
+* @param Name: function name, must stay valid (const char *)
+*******************************************/
+void Trace_End(const char *Name){
+    recordPhase(Name,TRACE_END);
+}
+
+/******************************************
+* @brief: Records a bus transfer or a delay that already finished
+* @param Name: operation name, must stay valid (const char *)
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param RegAddress: first register or -1 (int)
+* @param Length: bytes transferred, or us for delays (uint16_t)
+* @param Status: status returned by the backend (int)
+* @param StartNs: Trace_Now() taken before the transfer (uint64_t)
+*******************************************/
+void Trace_Transfer(const char *Name, uint8_t SlaveAddress, int RegAddress, uint16_t Length, int Status, uint64_t StartNs){
+    Trace_Event *event = newEvent();
+    if (event == 0) {
+        return;
+    }
+    event->Name = Name;
+    event->TimeNs = StartNs;
+    event->DurationNs = Trace_Now() - StartNs;
+    event->Phase = TRACE_COMPLETE;
+    event->SlaveAddress = SlaveAddress;
+    event->RegAddress = (int16_t)RegAddress;
+    event->Length = Length;
+    event->Status = (int8_t)Status;
+    publish();
+}
+
+/******************************************
+* @brief: Writes every recorded event as Chrome trace JSON
+* @param Stream: output stream (FILE *)
+* @note: Every thread buffer becomes a track (tid). Time stamps are
+*        written in us relative to the first event. Can be called
+*        while other threads record, their newer events are skipped.
+*        Returns the number of events written.
+*******************************************/
+int Trace_WriteJSON(FILE *Stream){
+    int threads = atomic_load(&BuffersTaken);
+    if (threads > TRACE_MAX_THREADS) {
+        threads = TRACE_MAX_THREADS;
+    }
+    // Origin of the time axis
+    uint64_t origin = UINT64_MAX;
+    for (int t = 0; t < threads; ++t) {
+        if (atomic_load_explicit(&Buffers[t].Count,memory_order_acquire) > 0 && Buffers[t].Events[0].TimeNs < origin) {
+            origin = Buffers[t].Events[0].TimeNs;
+        }
+    }
+    int written = 0;
+    fprintf(Stream,"{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    for (int t = 0; t < threads; ++t) {
+        uint32_t count = atomic_load_explicit(&Buffers[t].Count,memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            const Trace_Event *e = &Buffers[t].Events[i];
+            fprintf(Stream,"%s{\"name\": \"%s\", \"ph\": \"%c\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f",
+                    (written != 0) ? ",\n" : "", e->Name, e->Phase, t + 1, (double)(e->TimeNs - origin)/1000.0);
+            if (e->Phase == TRACE_COMPLETE) {
+                fprintf(Stream,", \"dur\": %.3f, \"cat\": \"i2c\", \"args\": {\"addr\": \"0x%02X\", ",
+                        (double)e->DurationNs/1000.0, e->SlaveAddress);
+                if (e->RegAddress >= 0) {
+                    fprintf(Stream,"\"reg\": \"0x%02X\", ",e->RegAddress);
+                }
+                fprintf(Stream,"\"len\": %u, \"status\": %d}}",e->Length,e->Status);
+            } else {
+                fprintf(Stream,", \"cat\": \"api\"}");
+            }
+            written++;
+        }
+    }
+    fprintf(Stream,"\n]}\n");
+    return written;
+}
+
+/******************************************
+* @brief: Empties every buffer
+* @note: Not to be called while other threads record.
+*******************************************/
+void Trace_Clear(void){
+    for (int t = 0; t < TRACE_MAX_THREADS; ++t) {
+        atomic_store(&Buffers[t].Count,0);
+    }
+    atomic_store(&Dropped,0);
+}
+
+/******************************************
+* @brief: Returns the number of events dropped
+*******************************************/
+uint64_t Trace_Dropped(void){
+    return atomic_load(&Dropped);
+}
@@ -0,0 +1,68 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef I2C_TRACE_H
+#define I2C_TRACE_H
+
+// Timeline tracing of the driver. When compiled with LM51772_TRACE defined,
+// every API function of LM51772.c records a begin and an end event, and
+// i2cTransport.c records every bus transfer and delay as a complete event
+// nested in it. Events go to a buffer owned by the calling thread and are
+// exported as Chrome trace JSON, which chrome://tracing and Perfetto load.
+// Without LM51772_TRACE the macros expand to nothing.
+
+#define TRACE_MAX_THREADS               16      // Threads with a buffer
+#define TRACE_BUFFER_EVENTS             65536   // Events per thread
+
+// Event phases, as in the Chrome trace format
+#define TRACE_BEGIN                     'B'
+#define TRACE_END                       'E'
+#define TRACE_COMPLETE                  'X'
+
+typedef struct{
+    const char *Name;                   // Static string, not copied
+    uint64_t TimeNs;                    // Time stamp
+    uint64_t DurationNs;                // Only for TRACE_COMPLETE
+    char Phase;                         // TRACE_BEGIN, TRACE_END or TRACE_COMPLETE
+    uint8_t SlaveAddress;               // Transfers only
+    int16_t RegAddress;                 // Transfers only, -1 if none
+    uint16_t Length;                    // Transfers: bytes, delays: us
+    int8_t Status;                      // Transfers only
+} Trace_Event;
+
+// Clock used for the time stamps, by default CLOCK_MONOTONIC. Simulated
+// buses can provide their virtual clock instead.
+typedef uint64_t (*Trace_Clock)(void *Context);
+
+// Starting and stopping the recording, events are dropped while stopped
+void Trace_Start(void);
+void Trace_Stop(void);
+void Trace_SetClock(Trace_Clock NewClock, void *Context);
+uint64_t Trace_Now(void);
+
+// Recording
+void Trace_Begin(const char *Name);
+void Trace_End(const char *Name);
+void Trace_Transfer(const char *Name, uint8_t SlaveAddress, int RegAddress, uint16_t Length, int Status, uint64_t StartNs);
+
+// Exporting all the buffers as Chrome trace JSON, returns the event count
+int Trace_WriteJSON(FILE *Stream);
+// Emptying all the buffers
+void Trace_Clear(void);
+// Events lost because a buffer was full or there were too many threads
+uint64_t Trace_Dropped(void);
+
+// Scope of an API function: begin event now, end event when the scope is
+// left, whatever the return path
+typedef const char *Trace_Scope;
+static inline void Trace_EndScope(Trace_Scope *Scope){
+    Trace_End(*Scope);
+}
+
+#ifdef LM51772_TRACE
+#define TRACE_API()                     Trace_Scope traceScope __attribute__((cleanup(Trace_EndScope))) = __func__; Trace_Begin(__func__)
+#else
+#define TRACE_API()
+#endif
+
+#endif // I2C_TRACE_H
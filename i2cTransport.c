@@ -0,0 +1,456 @@
+//Include header file
+#include "i2cTransport.h"
+#include <stdio.h>
+
+// Backend currently in use, a thread can override it for itself
+static const I2C_Transport *CurrentTransport = 0;
+static _Thread_local const I2C_Transport *ThreadTransport = 0;
+// Observer of register writes
+static I2C_WriteHook WriteHook = 0;
+
+// Transfer accounting, compiled in with I2C_STATS
+#ifdef I2C_STATS
+#include "i2cStats.h"
+#define STATS_START()                           uint64_t statsStart = I2C_Stats_Now()
+#define STATS_RECORD(op, addr, reg, status)     I2C_Stats_Record(op,addr,reg,status,I2C_Stats_Now() - statsStart)
+#define STATS_RECORD_SHARE(op, addr, reg, status, n) I2C_Stats_Record(op,addr,reg,status,(I2C_Stats_Now() - statsStart)/(n))
+#define STATS_POLL_RETRY(addr)                  I2C_Stats_PollRetry(addr)
+#else
+#define STATS_START()
+#define STATS_RECORD(op, addr, reg, status)
+#define STATS_RECORD_SHARE(op, addr, reg, status, n)
+#define STATS_POLL_RETRY(addr)
+#endif
+
+// Timeline tracing, compiled in with LM51772_TRACE
+#ifdef LM51772_TRACE
+#include "i2cTrace.h"
+#define TRACE_START()                           uint64_t traceStart = Trace_Now()
+#define TRACE_TRANSFER(name, addr, reg, len, status) Trace_Transfer(name,addr,reg,len,status,traceStart)
+#else
+#define TRACE_START()
+#define TRACE_TRANSFER(name, addr, reg, len, status)
+#endif
+
+// Backend of the calling thread
+static inline const I2C_Transport *activeTransport(void){
+    return (ThreadTransport != 0) ? ThreadTransport : CurrentTransport;
+}
+
+// Calls of the backend, the first byte written is the register address
+static int busWrite(uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    const I2C_Transport *transport = activeTransport();
+    STATS_START();
+    TRACE_START();
+    int status = transport->Write(transport->Context,SlaveAddress,Data,Length);
+    STATS_RECORD(I2C_OP_WRITE,SlaveAddress,(Length > 0) ? Data[0] : -1,status);
+    TRACE_TRANSFER("i2c write",SlaveAddress,(Length > 0) ? Data[0] : -1,Length,status);
+    return status;
+}
+
+static int busRead(uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    const I2C_Transport *transport = activeTransport();
+    STATS_START();
+    TRACE_START();
+    int status = transport->Read(transport->Context,SlaveAddress,Data,Length);
+    STATS_RECORD(I2C_OP_READ,SlaveAddress,-1,status);
+    TRACE_TRANSFER("i2c read",SlaveAddress,-1,Length,status);
+    return status;
+}
+
+// Without WriteRead in the backend the register read is a write and a
+// read transaction, recorded as the one write-read it stands for
+static int busWriteRead(uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    const I2C_Transport *transport = activeTransport();
+    STATS_START();
+    TRACE_START();
+    int status;
+    if (transport->WriteRead != 0) {
+        status = transport->WriteRead(transport->Context,SlaveAddress,WData,WLength,RData,RLength);
+    } else {
+        status = transport->Write(transport->Context,SlaveAddress,WData,WLength);
+        if (status >= 0) {
+            status = transport->Read(transport->Context,SlaveAddress,RData,RLength);
+        }
+    }
+    STATS_RECORD(I2C_OP_WRITEREAD,SlaveAddress,(WLength > 0) ? WData[0] : -1,status);
+    TRACE_TRANSFER("i2c write-read",SlaveAddress,(WLength > 0) ? WData[0] : -1,WLength + RLength,status);
+    return status;
+}
+
+// 1 if message Index writes a register address and the next one reads
+// the same device, a register read
+static int registerRead(const I2C_Message *Messages, uint16_t Count, uint16_t Index){
+    const I2C_Message *write = &Messages[Index];
+    return Index + 1 < Count && !(write->Flags & I2C_MSG_READ) && write->Length > 0 &&
+           (Messages[Index + 1].Flags & I2C_MSG_READ) && Messages[Index + 1].SlaveAddress == write->SlaveAddress;
+}
+
+// The messages of a combined transaction are recorded one by one, each
+// with its share of the transaction time, a register read as one
+// write-read
+static int busTransfer(const I2C_Message *Messages, uint16_t Count){
+    const I2C_Transport *transport = activeTransport();
+    STATS_START();
+    TRACE_START();
+    int status = transport->Transfer(transport->Context,Messages,Count);
+#if defined(I2C_STATS) || defined(LM51772_TRACE)
+    uint16_t records = Count;
+    for (uint16_t i = 0; i < Count; ++i) {
+        if (registerRead(Messages,Count,i)) {
+            records--;
+            ++i;
+        }
+    }
+    for (uint16_t i = 0; i < Count; ++i) {
+        const I2C_Message *message = &Messages[i];
+        if (registerRead(Messages,Count,i)) {
+            STATS_RECORD_SHARE(I2C_OP_WRITEREAD,message->SlaveAddress,message->Data[0],status,records);
+            TRACE_TRANSFER("i2c transfer write-read",message->SlaveAddress,message->Data[0],message->Length + Messages[i + 1].Length,status);
+            ++i;
+            continue;
+        }
+        int read = (message->Flags & I2C_MSG_READ) != 0;
+        int reg = (!read && message->Length > 0) ? message->Data[0] : -1;
+        STATS_RECORD_SHARE(read ? I2C_OP_READ : I2C_OP_WRITE,message->SlaveAddress,reg,status,records);
+        TRACE_TRANSFER(read ? "i2c transfer read" : "i2c transfer write",message->SlaveAddress,reg,message->Length,status);
+    }
+#endif
+    return status;
+}
+
+static int busQuick(uint8_t SlaveAddress){
+    const I2C_Transport *transport = activeTransport();
+    STATS_START();
+    TRACE_START();
+    int status = transport->Quick(transport->Context,SlaveAddress);
+    STATS_RECORD(I2C_OP_QUICK,SlaveAddress,-1,status);
+    TRACE_TRANSFER("i2c quick",SlaveAddress,-1,0,status);
+    return status;
+}
+
+/******************************************
+* @brief: Selects the bus backend used by the transport
+* @param Transport: filled backend interface (const I2C_Transport *)
+* @note: The structure is not copied, it has to stay valid while it
+*        is selected. Passing NULL deselects the current backend.
+*******************************************/
+void I2C_SetTransport(const I2C_Transport *Transport){
+    CurrentTransport = Transport;
+}
+
+/******************************************
+* @brief: Returns the bus backend currently in use
+* @note: The override of the calling thread if it has one.
+*******************************************/
+const I2C_Transport *I2C_GetTransport(void){
+    return activeTransport();
+}
+
+/******************************************
+* @brief: Selects a bus backend for the calling thread only
+* @param Transport: filled backend interface (const I2C_Transport *)
+* @note: Overrides the backend selected with I2C_SetTransport() in
+*        this thread, so threads can drive different (e.g. simulated)
+*        buses in parallel. Passing NULL removes the override.
+*******************************************/
+void I2C_SetThreadTransport(const I2C_Transport *Transport){
+    ThreadTransport = Transport;
+}
+
+/******************************************
+* @brief: Returns the bus backend override of the calling thread
+* @note: NULL if the thread uses the backend of I2C_SetTransport().
+*        Used to put back an override after replacing it for a while.
+*******************************************/
+const I2C_Transport *I2C_GetThreadTransport(void){
+    return ThreadTransport;
+}
+
+/******************************************
+* @brief: Writes a block of bytes to a device in one transaction
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param Data: bytes to be sent (const uint8_t *)
+* @param Length: amount of bytes to be sent (uint16_t)
+* @note: Returns I2C_OK or a negative error code.
+*******************************************/
+int I2C_WriteBlock(uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    const I2C_Transport *transport = activeTransport();
+    if (transport == 0) {
+        return I2C_ERR_NO_TRANSPORT;
+    }
+    return busWrite(SlaveAddress,Data,Length);
+}
+
+/******************************************
+* @brief: Reads a block of bytes from a device in one transaction
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param Data: reception buffer (uint8_t *)
+* @param Length: amount of bytes to be read (uint16_t)
+* @note: Returns I2C_OK or a negative error code.
+*******************************************/
+int I2C_ReadBlock(uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    const I2C_Transport *transport = activeTransport();
+    if (transport == 0) {
+        return I2C_ERR_NO_TRANSPORT;
+    }
+    return busRead(SlaveAddress,Data,Length);
+}
+
+/******************************************
+* @brief: Writes a block and reads back a block from a device
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param WData: bytes to be sent, usually the register address (const uint8_t *)
+* @param WLength: amount of bytes to be sent (uint16_t)
+* @param RData: reception buffer (uint8_t *)
+* @param RLength: amount of bytes to be read (uint16_t)
+* @note: Uses a repeated start when the backend supports it, if it
+*        does not, a write transaction followed by a read transaction
+*        is issued instead. Either way it is accounted as one
+*        write-read of the register WData[0].
+*******************************************/
+int I2C_WriteReadBlock(uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    const I2C_Transport *transport = activeTransport();
+    if (transport == 0) {
+        return I2C_ERR_NO_TRANSPORT;
+    }
+    return busWriteRead(SlaveAddress,WData,WLength,RData,RLength);
+}
+
+/******************************************
+* @brief: Issues several messages in one combined transaction
+* @param Messages: messages in bus order (const I2C_Message *)
+* @param Count: amount of messages, up to I2C_MAX_MESSAGES (uint16_t)
+* @note: The messages are separated by repeated starts and nothing
+*        else can get on the bus in between. If the backend has no
+*        Transfer function every message is issued as a transaction of
+*        its own instead (see I2C_HasTransfer()), except a register
+*        write followed by a read of the same device, which goes out
+*        as an I2C_WriteReadBlock(). Stops at the first failed message,
+*        the ones before it have been carried out.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int I2C_Transfer(const I2C_Message *Messages, uint16_t Count){
+    const I2C_Transport *transport = activeTransport();
+    if (transport == 0) {
+        return I2C_ERR_NO_TRANSPORT;
+    }
+    if (Count > I2C_MAX_MESSAGES) {
+        return I2C_ERR_BUS;
+    }
+    if (transport->Transfer != 0) {
+        return busTransfer(Messages,Count);
+    }
+    for (uint16_t i = 0; i < Count; ++i) {
+        const I2C_Message *message = &Messages[i];
+        if (registerRead(Messages,Count,i)) {
+            const I2C_Message *read = &Messages[++i];
+            int status = busWriteRead(message->SlaveAddress,message->Data,message->Length,read->Data,read->Length);
+            if (status < 0) {
+                return status;
+            }
+            continue;
+        }
+        int status = (message->Flags & I2C_MSG_READ) ?
+            busRead(message->SlaveAddress,message->Data,message->Length) :
+            busWrite(message->SlaveAddress,message->Data,message->Length);
+        if (status < 0) {
+            return status;
+        }
+    }
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Tells if I2C_Transfer() is one transaction on the bus
+* @note: Returns 1 if the selected backend has a Transfer function,
+*        0 if not or if there is no backend.
+*******************************************/
+int I2C_HasTransfer(void){
+    const I2C_Transport *transport = activeTransport();
+    return transport != 0 && transport->Transfer != 0;
+}
+
+/******************************************
+* @brief: Sends a PMBus group command
+* @param Writes: command and data of every device (const I2C_GroupWrite *)
+* @param Count: amount of devices, up to I2C_MAX_MESSAGES (uint16_t)
+* @note: One combined transaction (I2C_Transfer) with one write per
+*        device and a single STOP, at which the devices execute their
+*        commands together. Every device may appear only once. Without
+*        combined transactions in the backend the writes are separate
+*        transactions and take effect one after the other.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int I2C_GroupCommand(const I2C_GroupWrite *Writes, uint16_t Count){
+    if (Count > I2C_MAX_MESSAGES) {
+        return I2C_ERR_BUS;
+    }
+    I2C_Message messages[I2C_MAX_MESSAGES];
+    uint8_t frames[I2C_MAX_MESSAGES][I2C_GROUP_MAX_DATA + 1];
+    uint8_t seen[16] = {0};
+    for (uint16_t i = 0; i < Count; ++i) {
+        const I2C_GroupWrite *write = &Writes[i];
+        uint8_t address = write->SlaveAddress & 0x7F;
+        if (write->Length > I2C_GROUP_MAX_DATA || (seen[address >> 3] & (1 << (address & 7)))) {
+            fprintf(stderr, "Invalid group command write to I2C device at address 0x%02X\n", address);
+            return I2C_ERR_BUS;
+        }
+        seen[address >> 3] |= (uint8_t)(1 << (address & 7));
+        frames[i][0] = write->Command;
+        for (uint8_t k = 0; k < write->Length; ++k) {
+            frames[i][k + 1] = write->Data[k];
+        }
+        messages[i].SlaveAddress = address;
+        messages[i].Flags = 0;
+        messages[i].Length = (uint16_t)(write->Length + 1);
+        messages[i].Data = frames[i];
+    }
+    return I2C_Transfer(messages,Count);
+}
+
+/******************************************
+* @brief: Reads consecutive registers in one transaction
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param RegAddress: first register to be read (uint8_t)
+* @param Data: reception buffer (uint8_t *)
+* @param Length: amount of registers to be read (uint16_t)
+* @note: Relies on the register pointer auto-incrementing after
+*        every byte read. Returns I2C_OK or a negative error code.
+*******************************************/
+int I2C_ReadRegBlock(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t *Data, uint16_t Length){
+    return I2C_WriteReadBlock(SlaveAddress,&RegAddress,1,Data,Length);
+}
+
+/******************************************
+* @brief: Installs an observer of the register writes
+* @param Hook: function called after every successful
+*              I2C_WriteRegByte, NULL removes it (I2C_WriteHook)
+*******************************************/
+void I2C_SetWriteHook(I2C_WriteHook Hook){
+    WriteHook = Hook;
+}
+
+/******************************************
+* @brief: Completes the writes held back by the backend
+* @param SlaveAddress: 7 bit I2C address of the device, I2C_FLUSH_ALL
+*                      for every device (uint8_t)
+* @note: Only a write-behind cache holds writes back, with any other
+*        backend there is nothing to do. Returns I2C_OK or a negative
+*        error code.
+*******************************************/
+int I2C_Flush(uint8_t SlaveAddress){
+    const I2C_Transport *transport = activeTransport();
+    if (transport == 0) {
+        return I2C_ERR_NO_TRANSPORT;
+    }
+    if (transport->Flush == 0) {
+        return I2C_OK;
+    }
+    TRACE_START();
+    int status = transport->Flush(transport->Context,SlaveAddress);
+    TRACE_TRANSFER("flush",SlaveAddress,-1,0,status);
+    return status;
+}
+
+/******************************************
+* @brief: Ordering point of the LM51772 driver
+* @param I2CAddress: 7 bit I2C address of the device (uint8_t)
+* @note: Every write done so far reaches the device before this
+*        returns, call it before operations that depend on the
+*        configuration (EnablePowerStage, ...). A write-behind cache
+*        also does it by itself before CONV_EN and status writes.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int LM51772_Barrier(uint8_t I2CAddress){
+    int status = I2C_Flush(I2CAddress);
+    if (status < 0) {
+        fprintf(stderr, "Failed to flush the writes to I2C device at address 0x%02X\nERROR CODE:%d\n", I2CAddress, status);
+    }
+    return status;
+}
+
+/******************************************
+* @brief: Polls a device until it acknowledges its address
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @note: Sends quick write operations every I2C_POLL_DELAY us, up to
+*        I2C_POLL_RETRIES times. Returns 0 when the device is ready
+*        and -1 if it is still busy after the maximum retries.
+*******************************************/
+int pollForDevice(uint8_t SlaveAddress){
+    const I2C_Transport *transport = activeTransport();
+    if (transport == 0) {
+        return -1;
+    }
+    for (int i = 0; i < I2C_POLL_RETRIES; ++i) {
+        if (busQuick(SlaveAddress) == I2C_OK) {
+            return 0; // Device is ready
+        }
+        STATS_POLL_RETRY(SlaveAddress);
+        I2C_DelayUs(I2C_POLL_DELAY);
+    }
+    return -1; // Device is not ready after maximum retries
+}
+
+/******************************************
+* @brief: Waits the given amount of microseconds
+* @param Microseconds: time to wait (uint32_t)
+* @note: The wait is done by the backend, so simulated buses can
+*        advance their virtual clock instead of sleeping.
+*******************************************/
+void I2C_DelayUs(uint32_t Microseconds){
+    const I2C_Transport *transport = activeTransport();
+    if (transport != 0 && transport->Delay != 0) {
+        TRACE_START();
+        transport->Delay(transport->Context,Microseconds);
+        TRACE_TRANSFER("delay",0,-1,(uint16_t)(Microseconds > 0xFFFF ? 0xFFFF : Microseconds),0);
+    }
+}
+
+/******************************************
+* @brief: Writes one register of a device
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param RegAddress: register address (uint8_t)
+* @param ByteData: value to be written (uint8_t)
+* @note: The write hook sees the write only if it succeeded.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int I2C_WriteReg(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData){
+    // We prepare the data buffer
+    uint8_t buff[2];
+    buff[0] = RegAddress;
+    buff[1] = ByteData;
+    // We write the device on said address the given data
+    int status = I2C_WriteBlock(SlaveAddress,buff,2);
+    if (status == I2C_OK && WriteHook != 0) {
+        WriteHook(SlaveAddress,RegAddress,ByteData);
+    }
+    return status;
+}
+
+// We define the writing function required by the LM51772 library
+void I2C_WriteRegByte(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData){
+    int status = I2C_WriteReg(SlaveAddress,RegAddress,ByteData);
+    if (status < 0) {
+        fprintf(stderr, "Failed to write to I2C device at address 0x%02X\nERROR CODE:%d\n", SlaveAddress, status);
+    }
+}
+
+// We define the reading function required by the LM51772 library
+uint8_t I2C_ReadRegByte(uint8_t SlaveAddress, uint8_t RegAddress){
+    // We prepare the reception buffer
+    uint8_t buffer = 0;
+    // Write the register we want to access and read its contents
+    int status = I2C_WriteReadBlock(SlaveAddress,&RegAddress,1,&buffer,1);
+    // If the read operation failed, print error message and return 0
+    if (status < 0) {
+        fprintf(stderr, "Failed to read from register 0x%02X of I2C device at address 0x%02X\nERROR CODE:%d\n", RegAddress, SlaveAddress, status);
+        return 0; // Return 0 to indicate failure
+    }
+    // Return the retrieved value
+    return buffer;
+}
+
+void SoftwareDelay(uint8_t ms){
+    I2C_DelayUs((uint32_t)ms*1000);
+}
@@ -0,0 +1,120 @@
+#include <stdint.h>
+
+#ifndef I2C_TRANSPORT_H
+#define I2C_TRANSPORT_H
+
+// This module provides the external I2C functions required by the LM51772
+// library (I2C_WriteRegByte, I2C_ReadRegByte and SoftwareDelay), plus block
+// transfers and readiness polling, on top of an exchangeable bus backend.
+// A backend (pigpio, simulator, ...) only has to fill an I2C_Transport.
+
+// Status codes returned by the transport functions. Errors are negative
+// numbers, following the pigpio convention.
+#define I2C_OK                          0
+#define I2C_ERR_NACK                    -1  // Device did not acknowledge
+#define I2C_ERR_BUS                     -2  // Any other bus/driver failure
+#define I2C_ERR_NO_TRANSPORT            -3  // No backend has been selected
+#define I2C_ERR_TIMEOUT                 -4  // Device not ready after polling
+
+// Readiness polling parameters used by pollForDevice()
+#define I2C_POLL_DELAY                  100 // Microseconds
+#define I2C_POLL_RETRIES                100
+
+// Largest amount of messages in one combined transaction (the i2c-dev
+// I2C_RDWR limit)
+#define I2C_MAX_MESSAGES                42
+
+// Address given to Flush for every device
+#define I2C_FLUSH_ALL                   0xFF
+
+// Message of a combined transaction
+#define I2C_MSG_READ                    0x01    // Read instead of write
+typedef struct{
+    uint8_t SlaveAddress;               // 7 bit address
+    uint8_t Flags;                      // I2C_MSG_*
+    uint16_t Length;                    // Bytes to be sent/read
+    uint8_t *Data;                      // Data to be sent or reception buffer
+} I2C_Message;
+
+// Write of a PMBus group command: every device gets its own command and
+// data and they all execute it at the STOP
+#define I2C_GROUP_MAX_DATA              4
+typedef struct{
+    uint8_t SlaveAddress;               // 7 bit address, once per group command
+    uint8_t Command;                    // Command code (register address)
+    uint8_t Length;                     // Data bytes, up to I2C_GROUP_MAX_DATA
+    uint8_t Data[I2C_GROUP_MAX_DATA];   // Data following the command code
+} I2C_GroupWrite;
+
+// Bus backend interface
+// Write: sends Length bytes to the device in a single transaction
+// Read: reads Length bytes from the device in a single transaction
+// WriteRead: write followed by a repeated start read, can be NULL in which
+//            case a Write followed by a Read is issued instead
+// Transfer: messages to any devices in one transaction, a repeated start
+//           between them and a single STOP at the end, can be NULL in which
+//           case every message is issued as a transaction of its own
+// Quick: zero length write, used to check if the device acknowledges
+// Delay: waits the given amount of microseconds
+// Flush: completes the writes to a device the transport holds back
+//        (I2C_FLUSH_ALL: every device), NULL if it never holds any
+// All transfer functions return I2C_OK or a negative error code
+typedef struct{
+    int (*Write)(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length);
+    int (*Read)(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length);
+    int (*WriteRead)(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength);
+    int (*Transfer)(void *Context, const I2C_Message *Messages, uint16_t Count);
+    int (*Quick)(void *Context, uint8_t SlaveAddress);
+    void (*Delay)(void *Context, uint32_t Microseconds);
+    int (*Flush)(void *Context, uint8_t SlaveAddress);
+    void *Context;
+} I2C_Transport;
+
+// Observer called after every successful I2C_WriteRegByte
+typedef void (*I2C_WriteHook)(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData);
+
+// Selecting the backend used by every function below
+void I2C_SetTransport(const I2C_Transport *Transport);
+const I2C_Transport *I2C_GetTransport(void);
+// Selecting a backend for the calling thread only, NULL removes it
+void I2C_SetThreadTransport(const I2C_Transport *Transport);
+// Backend of the calling thread only, NULL if it has none
+const I2C_Transport *I2C_GetThreadTransport(void);
+
+// Block transfers
+int I2C_WriteBlock(uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length);
+int I2C_ReadBlock(uint8_t SlaveAddress, uint8_t *Data, uint16_t Length);
+int I2C_WriteReadBlock(uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength);
+// Several messages in one combined transaction if the backend supports it
+int I2C_Transfer(const I2C_Message *Messages, uint16_t Count);
+// 1 if the selected backend issues I2C_Transfer as one transaction
+int I2C_HasTransfer(void);
+// PMBus group command, one combined transaction with a single STOP
+int I2C_GroupCommand(const I2C_GroupWrite *Writes, uint16_t Count);
+
+// Register block read, RegAddress and the following registers
+int I2C_ReadRegBlock(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t *Data, uint16_t Length);
+// Installing a write observer, NULL removes it
+void I2C_SetWriteHook(I2C_WriteHook Hook);
+
+// Completes the writes held back by the backend (write-behind caching)
+int I2C_Flush(uint8_t SlaveAddress);
+// Ordering point before safety-critical LM51772 operations
+// (EnablePowerStage, ...): every held back write of the device reaches it
+int LM51772_Barrier(uint8_t I2CAddress);
+
+// Waits until the device acknowledges its address (e.g. EEPROM write cycle)
+int pollForDevice(uint8_t SlaveAddress);
+// Microsecond delay through the selected backend
+void I2C_DelayUs(uint32_t Microseconds);
+
+// Register write returning the status, I2C_WriteRegByte without the
+// error message
+int I2C_WriteReg(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData);
+
+// External functions required by the LM51772 library
+void I2C_WriteRegByte(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData);
+uint8_t I2C_ReadRegByte(uint8_t SlaveAddress, uint8_t RegAddress);
+void SoftwareDelay(uint8_t ms);
+
+#endif // I2C_TRANSPORT_H
@@ -0,0 +1,260 @@
+//Include header file
+#include "lm51772Cases.h"
+#include "LM51772.h"
+
+// Step constructors, the name is taken from the call
+#define T_WRITE(reg, value)             { STEP_WRITE, "write " #reg, {0}, value, reg, 0xFF, value }
+#define T_CALL(fn, reg, exp)            { STEP_CALL, #fn, {.Call = fn}, 0, reg, 0xFF, exp }
+#define T_CALL_U8(fn, arg, reg, exp)    { STEP_CALL_U8, #fn "(" #arg ")", {.CallU8 = fn}, arg, reg, 0xFF, exp }
+#define T_CALL_U16(fn, arg, reg, exp)   { STEP_CALL_U16, #fn "(" #arg ")", {.CallU16 = fn}, arg, reg, 0xFF, exp }
+#define T_CALL_F(fn, arg, reg, exp)     { STEP_CALL_F, #fn "(" #arg ")", {.CallF = fn}, arg, reg, 0xFF, exp }
+#define T_GET8(fn, mask, exp)           { STEP_GET8, #fn, {.Get8 = fn}, 0, 0, mask, exp }
+#define T_GET16(fn, exp)                { STEP_GET16, #fn, {.Get16 = fn}, 0, 0, 0xFF, exp }
+// Fault flags that are only set by a fault, OFF and BUSY follow the state
+#define LATCHED_FLAGS                   (FLT_OVP|FLT_OCP|FLT_IVP|FLT_TEMPERATURE|FLT_CML|FLT_OTHER)
+
+static const TestStep mfrD0[] = {
+    T_WRITE(MFR_SPECIFIC_D0, 0x00),
+    T_CALL(EnablePowerStage, MFR_SPECIFIC_D0, 0x01),
+    T_CALL(DisablePowerStage, MFR_SPECIFIC_D0, 0x00),
+    T_CALL(uSleep_Enable, MFR_SPECIFIC_D0, 0x02),
+    T_CALL(uSleep_Disable, MFR_SPECIFIC_D0, 0x00),
+    T_CALL(DRSS_Enable, MFR_SPECIFIC_D0, 0x04),
+    T_CALL(DRSS_Disable, MFR_SPECIFIC_D0, 0x00),
+    T_CALL(HiccupProtection_Enable, MFR_SPECIFIC_D0, 0x08),
+    T_CALL(HiccupProtection_Disable, MFR_SPECIFIC_D0, 0x00),
+    T_CALL(CurrentLimiter_Enable, MFR_SPECIFIC_D0, 0x10),
+    T_CALL(CurrentLimiter_Disable, MFR_SPECIFIC_D0, 0x00),
+    T_CALL(Vcc1LDO_Enable, MFR_SPECIFIC_D0, 0x20),
+    T_CALL(Vcc1LDO_Disable, MFR_SPECIFIC_D0, 0x00),
+    T_CALL(NegativeCurrentLimiting_Enable, MFR_SPECIFIC_D0, 0x40),
+    T_CALL(NegativeCurrentLimiting_Disable, MFR_SPECIFIC_D0, 0x00),
+    // Disabling one feature keeps the others
+    T_WRITE(MFR_SPECIFIC_D0, 0xFF),
+    T_CALL(uSleep_Disable, MFR_SPECIFIC_D0, 0xFD),
+    T_CALL(DRSS_Disable, MFR_SPECIFIC_D0, 0xF9),
+    T_CALL(HiccupProtection_Disable, MFR_SPECIFIC_D0, 0xF1),
+    T_CALL(CurrentLimiter_Disable, MFR_SPECIFIC_D0, 0xE1),
+    T_CALL(Vcc1LDO_Disable, MFR_SPECIFIC_D0, 0xC1),
+    T_CALL(NegativeCurrentLimiting_Disable, MFR_SPECIFIC_D0, 0x81),
+    T_CALL(DisablePowerStage, MFR_SPECIFIC_D0, 0x80),
+};
+
+static const TestStep mfrD1[] = {
+    T_WRITE(MFR_SPECIFIC_D1, 0x00),
+    T_CALL(PSM_2PhaseBB_Enable, MFR_SPECIFIC_D1, 0x01),
+    T_CALL(PSM_2PhaseBB_Disable, MFR_SPECIFIC_D1, 0x00),
+    T_CALL(FPWM_2PhaseBB_Enable, MFR_SPECIFIC_D1, 0x02),
+    T_CALL(FPWM_2PhaseBB_Disable, MFR_SPECIFIC_D1, 0x00),
+    T_CALL(ForceBias_Enable, MFR_SPECIFIC_D1, 0x04),
+    T_CALL(ForceBias_Disable, MFR_SPECIFIC_D1, 0x00),
+    T_CALL(DTRK_DirectStartup_Enable, MFR_SPECIFIC_D1, 0x08),
+    T_CALL(DTRK_DirectStartup_Disable, MFR_SPECIFIC_D1, 0x00),
+    T_CALL(nFLT_as_INT_Enable, MFR_SPECIFIC_D1, 0x10),
+    T_CALL(nFLT_as_INT_Disable, MFR_SPECIFIC_D1, 0x00),
+    T_CALL_U8(ThermalWarning_ThresholdConfigure, THW_THRESHOLD_140degC, MFR_SPECIFIC_D1, 0x00),
+    T_CALL_U8(ThermalWarning_ThresholdConfigure, THW_THRESHOLD_125degC, MFR_SPECIFIC_D1, 0x20),
+    T_CALL_U8(ThermalWarning_ThresholdConfigure, THW_THRESHOLD_110degC, MFR_SPECIFIC_D1, 0x40),
+    T_CALL_U8(ThermalWarning_ThresholdConfigure, THW_THRESHOLD_95degC, MFR_SPECIFIC_D1, 0x60),
+    T_CALL(ThermalWarning_Enable, MFR_SPECIFIC_D1, 0xE0),
+    T_CALL(ThermalWarning_Disable, MFR_SPECIFIC_D1, 0x60),
+    T_WRITE(MFR_SPECIFIC_D1, 0xFF),
+    T_CALL_U8(ThermalWarning_ThresholdConfigure, THW_THRESHOLD_110degC, MFR_SPECIFIC_D1, 0xDF),
+};
+
+static const TestStep mfrD2[] = {
+    T_WRITE(MFR_SPECIFIC_D2, 0x00),
+    T_CALL(Discharge_VTH_Enable, MFR_SPECIFIC_D2, 0x01),
+    T_CALL(Discharge_VTH_Disable, MFR_SPECIFIC_D2, 0x00),
+    T_CALL(Discharge_Enable, MFR_SPECIFIC_D2, 0x02),
+    T_CALL(Discharge_Disable, MFR_SPECIFIC_D2, 0x00),
+    T_CALL_U8(Dishcarge_StrengthConfigure, DISCHG_STRENGTH_25mA, MFR_SPECIFIC_D2, 0x00),
+    T_CALL_U8(Dishcarge_StrengthConfigure, DISCHG_STRENGTH_50mA, MFR_SPECIFIC_D2, 0x04),
+    T_CALL_U8(Dishcarge_StrengthConfigure, DISCHG_STRENGTH_75mA, MFR_SPECIFIC_D2, 0x08),
+    T_CALL_U8(DVS_SlewrateConfigure, DVS_SLEW_40mV_us, MFR_SPECIFIC_D2, 0x08),
+    T_CALL_U8(DVS_SlewrateConfigure, DVS_SLEW_20mV_us, MFR_SPECIFIC_D2, 0x18),
+    T_CALL_U8(DVS_SlewrateConfigure, DVS_SLEW_1mV_us, MFR_SPECIFIC_D2, 0x28),
+    T_CALL_U8(DVS_SlewrateConfigure, DVS_SLEW_0_5mV_us, MFR_SPECIFIC_D2, 0x38),
+    T_CALL(DVS_ActiveDownRamp_Enable, MFR_SPECIFIC_D2, 0x78),
+    T_CALL(DVS_ActiveDownRamp_Disable, MFR_SPECIFIC_D2, 0x38),
+};
+
+static const TestStep mfrD3[] = {
+    T_WRITE(MFR_SPECIFIC_D3, 0x00),
+    T_CALL_U16(VDET_FallingThresholdConfigure, 2700, MFR_SPECIFIC_D3, 0x00),
+    T_CALL_U16(VDET_FallingThresholdConfigure, 5000, MFR_SPECIFIC_D3, 0x0B),
+    T_CALL_U16(VDET_FallingThresholdConfigure, 8900, MFR_SPECIFIC_D3, 0x1F),
+    T_WRITE(MFR_SPECIFIC_D3, 0x00),
+    T_CALL(VDET_Enable, MFR_SPECIFIC_D3, 0x20),
+    T_CALL(VDET_Disable, MFR_SPECIFIC_D3, 0x00),
+    T_CALL(IVP_InputVoltageRegulation_Enable, MFR_SPECIFIC_D3, 0x40),
+    T_CALL(IVP_InputVoltageRegulation_Disable, MFR_SPECIFIC_D3, 0x00),
+    T_CALL(IVP_Enable, MFR_SPECIFIC_D3, 0x80),
+    T_CALL(IVP_Disable, MFR_SPECIFIC_D3, 0x00),
+    // The threshold keeps the enable bits, out of range is ignored
+    T_WRITE(MFR_SPECIFIC_D3, 0xFF),
+    T_CALL_U16(VDET_FallingThresholdConfigure, 5000, MFR_SPECIFIC_D3, 0xEB),
+    T_CALL_U16(VDET_FallingThresholdConfigure, 9000, MFR_SPECIFIC_D3, 0xEB),
+};
+
+static const TestStep mfrD4[] = {
+    T_WRITE(MFR_SPECIFIC_D4, 0x00),
+    T_CALL_U16(VDET_RisingThresholdConfigure, 2800, MFR_SPECIFIC_D4, 0x00),
+    T_CALL_U16(VDET_RisingThresholdConfigure, 5000, MFR_SPECIFIC_D4, 0x0B),
+    T_CALL_U16(VDET_RisingThresholdConfigure, 9000, MFR_SPECIFIC_D4, 0x1F),
+    T_CALL_U16(VDET_RisingThresholdConfigure, 9200, MFR_SPECIFIC_D4, 0x1F),
+};
+
+static const TestStep mfrD5[] = {
+    T_WRITE(MFR_SPECIFIC_D5, 0x00),
+    T_CALL_U16(OVP_SecondaryThreshold_Configure, 4000, MFR_SPECIFIC_D5, 0x00),
+    T_CALL_U16(OVP_SecondaryThreshold_Configure, 10000, MFR_SPECIFIC_D5, 0x0C),
+    T_CALL_U16(OVP_SecondaryThreshold_Configure, 23700, MFR_SPECIFIC_D5, 0x1F),
+    T_CALL_U16(OVP_SecondaryThreshold_Configure, 55000, MFR_SPECIFIC_D5, 0x3F),
+};
+
+static const TestStep mfrD6[] = {
+    T_WRITE(MFR_SPECIFIC_D6, 0x00),
+    T_CALL_U8(BB_MinTimeScale_Select, BB_MINTIME_SCALE_0_75x, MFR_SPECIFIC_D6, 0x00),
+    T_CALL_U8(BB_MinTimeScale_Select, BB_MINTIME_SCALE_1x, MFR_SPECIFIC_D6, 0x01),
+    T_CALL_U8(BB_MinTimeScale_Select, BB_MINTIME_SCALE_1_25x, MFR_SPECIFIC_D6, 0x02),
+    T_CALL_U8(BB_MinTimeScale_Select, BB_MINTIME_SCALE_1_5x, MFR_SPECIFIC_D6, 0x03),
+    T_WRITE(MFR_SPECIFIC_D6, 0x00),
+    T_CALL_U8(GDRV_MinDeadTime_Select, GDRV_MINDEADTIME_10ns, MFR_SPECIFIC_D6, 0x00),
+    T_CALL_U8(GDRV_MinDeadTime_Select, GDRV_MINDEADTIME_20ns, MFR_SPECIFIC_D6, 0x04),
+    T_CALL_U8(GDRV_MinDeadTime_Select, GDRV_MINDEADTIME_40ns, MFR_SPECIFIC_D6, 0x08),
+    T_CALL_U8(GDRV_MinDeadTime_Select, GDRV_MINDEADTIME_60ns, MFR_SPECIFIC_D6, 0x0C),
+    T_WRITE(MFR_SPECIFIC_D6, 0x00),
+    T_CALL(GDRV_DeadTimeScaling_Enable, MFR_SPECIFIC_D6, 0x10),
+    T_CALL(GDRV_DeadTimeScaling_Disable, MFR_SPECIFIC_D6, 0x00),
+    T_CALL(GDRV_ForceConstantDeadTime_Enable, MFR_SPECIFIC_D6, 0x20),
+    T_CALL(GDRV_ForceConstantDeadTime_Disable, MFR_SPECIFIC_D6, 0x00),
+    T_CALL_U8(OSC_FreqSyncConfigure, OSC_SYNC_INPUT_RISING, MFR_SPECIFIC_D6, 0x00),
+    T_CALL_U8(OSC_FreqSyncConfigure, OSC_SYNC_INPUT_FALLING, MFR_SPECIFIC_D6, 0x40),
+    T_CALL_U8(OSC_FreqSyncConfigure, OSC_SYNC_OUTPUT_RISING, MFR_SPECIFIC_D6, 0x80),
+    T_CALL_U8(OSC_FreqSyncConfigure, OSC_SYNC_OUTPUT_FALLING, MFR_SPECIFIC_D6, 0xC0),
+};
+
+static const TestStep mfrD7[] = {
+    T_WRITE(MFR_SPECIFIC_D7, 0x00),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_0_125, MFR_SPECIFIC_D7, 0x00),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_0_25, MFR_SPECIFIC_D7, 0x01),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_0_375, MFR_SPECIFIC_D7, 0x02),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_0_5, MFR_SPECIFIC_D7, 0x03),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_0_625, MFR_SPECIFIC_D7, 0x04),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_0_75, MFR_SPECIFIC_D7, 0x05),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_0_875, MFR_SPECIFIC_D7, 0x06),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_1_0, MFR_SPECIFIC_D7, 0x07),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_1_5, MFR_SPECIFIC_D7, 0x08),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_2_0, MFR_SPECIFIC_D7, 0x09),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_2_5, MFR_SPECIFIC_D7, 0x0A),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_3_0, MFR_SPECIFIC_D7, 0x0B),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_3_5, MFR_SPECIFIC_D7, 0x0C),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_4_0, MFR_SPECIFIC_D7, 0x0D),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_4_5, MFR_SPECIFIC_D7, 0x0E),
+    T_CALL_U8(SlopeComp_CorrectionFactor_Select, SLOPECOMP_CORRECTION_5_0, MFR_SPECIFIC_D7, 0x0F),
+    T_CALL_U8(SlopeComp_InductorDerating_Select, INDUC_DERATE_DISABLE, MFR_SPECIFIC_D7, 0x0F),
+    T_CALL_U8(SlopeComp_InductorDerating_Select, INDUC_DERATE_20, MFR_SPECIFIC_D7, 0x1F),
+    T_CALL_U8(SlopeComp_InductorDerating_Select, INDUC_DERATE_30, MFR_SPECIFIC_D7, 0x2F),
+    T_CALL_U8(SlopeComp_InductorDerating_Select, INDUC_DERATE_40, MFR_SPECIFIC_D7, 0x3F),
+};
+
+static const TestStep mfrD8[] = {
+    T_WRITE(MFR_SPECIFIC_D8, 0x00),
+    T_CALL_U8(DRV1_Supply_Configure, DRV1_SUP_OPENDRAIN, MFR_SPECIFIC_D8, 0x00),
+    T_CALL_U8(DRV1_Supply_Configure, DRV1_SUP_VOUT, MFR_SPECIFIC_D8, 0x01),
+    T_CALL_U8(DRV1_Supply_Configure, DRV1_SUP_VBIAS, MFR_SPECIFIC_D8, 0x02),
+    T_CALL_U8(DRV1_Supply_Configure, DRV1_SUP_VCC2, MFR_SPECIFIC_D8, 0x03),
+    T_WRITE(MFR_SPECIFIC_D8, 0x00),
+    T_CALL_U8(DRV1_Sequence_Configure, DRV1_SEQ_PULL_LOW_CONV_ON, MFR_SPECIFIC_D8, 0x04),
+    T_CALL_U8(DRV1_Sequence_Configure, DRV1_SEQ_PULL_LOW_CONV_OFF, MFR_SPECIFIC_D8, 0x00),
+    T_CALL_U8(DRV1_Sequence_Configure, DRV1_SEQ_FORCE_ACTIVE, MFR_SPECIFIC_D8, 0x08),
+    T_CALL_U8(DRV1_Sequence_Configure, DRV1_SEQ_FORCE_OFF, MFR_SPECIFIC_D8, 0x0C),
+    T_WRITE(MFR_SPECIFIC_D8, 0x00),
+    T_CALL_U8(CDC_GainVoltage_Select, CDC_GAIN_0_250V, MFR_SPECIFIC_D8, 0x00),
+    T_CALL_U8(CDC_GainVoltage_Select, CDC_GAIN_0_500V, MFR_SPECIFIC_D8, 0x10),
+    T_CALL_U8(CDC_GainVoltage_Select, CDC_GAIN_1_000V, MFR_SPECIFIC_D8, 0x20),
+    T_CALL_U8(CDC_GainVoltage_Select, CDC_GAIN_2_000V, MFR_SPECIFIC_D8, 0x30),
+    T_CALL(CDC_Enable, MFR_SPECIFIC_D8, 0x70),
+    T_CALL(CDC_Disable, MFR_SPECIFIC_D8, 0x30),
+    T_CALL(LM51772_FB_Divider_Sel20, MFR_SPECIFIC_D8, 0xB0),
+    T_CALL(LM51772_FB_Divider_Sel10, MFR_SPECIFIC_D8, 0x30),
+};
+
+static const TestStep mfrD9[] = {
+    T_WRITE(MFR_SPECIFIC_D9, 0x00),
+    T_CALL_U16(PCM_LowerVoltageWindow_Configure, 0, MFR_SPECIFIC_D9, 0x00),
+    T_CALL_U16(PCM_LowerVoltageWindow_Configure, 387, MFR_SPECIFIC_D9, 0x0F),
+    T_CALL_U16(PCM_LowerVoltageWindow_Configure, 775, MFR_SPECIFIC_D9, 0x1F),
+    T_WRITE(MFR_SPECIFIC_D9, 0x00),
+    T_CALL_F(PCM_LowerVoltageWindow_ConfigureF, 0.0, MFR_SPECIFIC_D9, 0x00),
+    T_CALL_F(PCM_LowerVoltageWindow_ConfigureF, 38.75, MFR_SPECIFIC_D9, 0x0F),
+    T_CALL_F(PCM_LowerVoltageWindow_ConfigureF, 77.5, MFR_SPECIFIC_D9, 0x1F),
+    T_WRITE(MFR_SPECIFIC_D9, 0x00),
+    T_CALL(OCP_ISET_OverILIM_Enable, MFR_SPECIFIC_D9, 0x20),
+    T_CALL(OCP_ISET_OverILIM_Disable, MFR_SPECIFIC_D9, 0x00),
+};
+
+static const TestStep ivpVolt[] = {
+    T_CALL_U16(IVP_VoltageThreshold_Configure, 5000, IVP_VOLTAGE, 0x02),
+    T_CALL_U16(IVP_VoltageThreshold_Configure, 10000, IVP_VOLTAGE, 0x2A),
+    T_CALL_U16(IVP_VoltageThreshold_Configure, 33400, IVP_VOLTAGE, 0xBC),
+    // No code between 23500 mV (0x96) and 24000 mV (0x97), rounded down
+    T_CALL_U16(IVP_VoltageThreshold_Configure, 23500, IVP_VOLTAGE, 0x96),
+    T_CALL_U16(IVP_VoltageThreshold_Configure, 23625, IVP_VOLTAGE, 0x96),
+    T_CALL_U16(IVP_VoltageThreshold_Configure, 23999, IVP_VOLTAGE, 0x96),
+    T_CALL_U16(IVP_VoltageThreshold_Configure, 24000, IVP_VOLTAGE, 0x97),
+};
+
+static const TestStep usbPdControl[] = {
+    T_WRITE(USB_PD_CONTROL_0, 0x00),
+    T_CALL(ForceDischargeEnable, USB_PD_CONTROL_0, 0x02),
+    T_CALL(ForceDischargeDisable, USB_PD_CONTROL_0, 0x00),
+    T_CALL(EnablePowerStage, USB_PD_CONTROL_0, 0x01),
+    T_CALL(DisablePowerStage, USB_PD_CONTROL_0, 0x00),
+};
+
+static const TestStep ilimThreshold[] = {
+    T_CALL_U16(setILIM_THRESHOLD, 5000, ILIM_THRESHOLD, 0x64),
+    T_CALL_U16(setILIM_THRESHOLD, 500, ILIM_THRESHOLD, 0x0A),
+    T_CALL_U16(setILIM_THRESHOLD, 7000, ILIM_THRESHOLD, 0x8C),
+    T_CALL_U16(setILIM_THRESHOLD, 8000, ILIM_THRESHOLD, 0x8C),
+};
+
+static const TestStep outputVoltage[] = {
+    T_CALL_U16(setVOUT1_TARGET, 5000, VOUT_TARGET1_LSB, 0xFA),
+    T_CALL_U16(setVOUT1_TARGET, 5000, VOUT_TARGET1_MSB, 0x00),
+    T_GET16(getVOUT1_TARGET, 250),
+    T_CALL_U16(setVOUT1_TARGET, 20000, VOUT_TARGET1_LSB, 0xE8),
+    T_CALL_U16(setVOUT1_TARGET, 20000, VOUT_TARGET1_MSB, 0x03),
+    T_GET16(getVOUT1_TARGET, 1000),
+};
+
+// Expects no fault active on the board while it runs
+static const TestStep status[] = {
+    { STEP_CALL, "ClearFaults", {.Call = ClearFaults}, 0, STATUS_BYTE, LATCHED_FLAGS, 0x00 },
+    { STEP_CALL_U8, "ClearFaultFlag(FLT_OVP|FLT_IVP|FLT_OCP)", {.CallU8 = ClearFaultFlag}, FLT_OVP|FLT_IVP|FLT_OCP, STATUS_BYTE, FLT_OVP|FLT_IVP|FLT_OCP, 0x00 },
+    T_GET8(get_STATUS_BYTE, LATCHED_FLAGS, 0x00),
+};
+
+#define SUITE(name, steps)              { name, steps, (int)(sizeof(steps)/sizeof(steps[0])) }
+
+const TestSuite LM51772_Suites[] = {
+    SUITE("testMFRD0", mfrD0),
+    SUITE("testMFRD1", mfrD1),
+    SUITE("testMFRD2", mfrD2),
+    SUITE("testMFRD3", mfrD3),
+    SUITE("testMFRD4", mfrD4),
+    SUITE("testMFRD5", mfrD5),
+    SUITE("testMFRD6", mfrD6),
+    SUITE("testMFRD7", mfrD7),
+    SUITE("testMFRD8", mfrD8),
+    SUITE("testMFRD9", mfrD9),
+    SUITE("testIVPVOLT", ivpVolt),
+    SUITE("testUSBPDCNTRL", usbPdControl),
+    SUITE("testILIMThreshold", ilimThreshold),
+    SUITE("testOutputVoltage", outputVoltage),
+    SUITE("testSTATUS", status),
+};
+
+const int LM51772_SuiteCount = (int)(sizeof(LM51772_Suites)/sizeof(LM51772_Suites[0]));
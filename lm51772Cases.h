@@ -0,0 +1,48 @@
+#include <stdint.h>
+
+#ifndef LM51772_CASES_H
+#define LM51772_CASES_H
+
+// Test cases of the LM51772 library as data. Every suite is the sequence
+// of one of the old test programs (testMFRD0.c, testSTATUS.c, ...): each
+// step calls a library function and gives the value the register (or the
+// getter) must have afterwards, so the runner can check it instead of a
+// person reading printf output. Steps of a suite depend on the previous
+// ones, suites are independent of each other.
+
+// Kinds of step
+#define STEP_WRITE                      0   // Writes Arg to Reg (register preset)
+#define STEP_CALL                       1   // Fn.Call(I2CAddress)
+#define STEP_CALL_U8                    2   // Fn.CallU8(I2CAddress, Arg)
+#define STEP_CALL_U16                   3   // Fn.CallU16(I2CAddress, Arg)
+#define STEP_CALL_F                     4   // Fn.CallF(I2CAddress, Arg)
+#define STEP_GET8                       5   // Result of Fn.Get8 is checked, not Reg
+#define STEP_GET16                      6   // Result of Fn.Get16 is checked, not Reg
+
+typedef struct{
+    uint8_t Kind;                       // STEP_*
+    const char *Name;                   // Call as shown in the report
+    union{
+        void (*Call)(uint8_t);
+        void (*CallU8)(uint8_t, uint8_t);
+        void (*CallU16)(uint8_t, uint16_t);
+        void (*CallF)(uint8_t, float);
+        uint8_t (*Get8)(uint8_t);
+        uint16_t (*Get16)(uint8_t);
+    } Fn;
+    double Arg;                         // Argument of the call
+    uint8_t Reg;                        // Register checked after the call
+    uint8_t Mask;                       // Bits compared
+    uint16_t Expected;                  // Register value or getter result
+} TestStep;
+
+typedef struct{
+    const char *Name;                   // Test program it replaces
+    const TestStep *Steps;
+    int Count;
+} TestSuite;
+
+extern const TestSuite LM51772_Suites[];
+extern const int LM51772_SuiteCount;
+
+#endif // LM51772_CASES_H
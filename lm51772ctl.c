@@ -0,0 +1,76 @@
+#include "LM51772.h"
+#include "lm51772dClient.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Command line client of the lm51772d daemon, replacing the one-shot test
+// programs (testOutputVoltageNoPoll, testILIMThresholdnoPoll, ...) in
+// scripts. No pigpio initialization, just one round trip to the daemon.
+//
+// Usage: lm51772ctl [-s socket] [-a address] <command> [value]
+// Commands: setvout <mV>, getvout, setilim <mA>, status, usbpd,
+//           clearfaults, power <0|1>, read <reg>, write <reg> <value>
+
+int main(int argc, char *argv[]){
+    const char *path = 0;
+    uint8_t addr = LM51772_I2CADDR1;
+    int i = 1;
+    for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (strcmp(argv[i],"-s") == 0) {
+            path = argv[i + 1];
+        } else if (strcmp(argv[i],"-a") == 0) {
+            addr = (uint8_t)strtol(argv[i + 1],0,0);
+        }
+    }
+    if (i >= argc) {
+        fprintf(stderr, "Usage: %s [-s socket] [-a address] <command> [value]\n", argv[0]);
+        return 1;
+    }
+    const char *cmd = argv[i];
+    uint16_t arg = (i + 1 < argc) ? (uint16_t)strtol(argv[i + 1],0,0) : 0;
+    uint16_t arg2 = (i + 2 < argc) ? (uint16_t)strtol(argv[i + 2],0,0) : 0;
+
+    LM51772D_Client client;
+    if (Client_Open(&client,path) < 0) {
+        fprintf(stderr, "Cannot connect to lm51772d\n");
+        return 1;
+    }
+    uint16_t result = 0;
+    int status;
+    if (strcmp(cmd,"setvout") == 0) {
+        status = Client_Request(&client,LM51772D_OP_SET_VOUT,addr,arg,0);
+    } else if (strcmp(cmd,"getvout") == 0) {
+        status = Client_Request(&client,LM51772D_OP_GET_VOUT,addr,0,&result);
+    } else if (strcmp(cmd,"setilim") == 0) {
+        status = Client_Request(&client,LM51772D_OP_SET_ILIM,addr,arg,0);
+    } else if (strcmp(cmd,"status") == 0) {
+        status = Client_Request(&client,LM51772D_OP_GET_STATUS,addr,0,&result);
+    } else if (strcmp(cmd,"usbpd") == 0) {
+        status = Client_Request(&client,LM51772D_OP_GET_USBPD_STATUS,addr,0,&result);
+    } else if (strcmp(cmd,"clearfaults") == 0) {
+        status = Client_Request(&client,LM51772D_OP_CLEAR_FAULTS,addr,0,0);
+    } else if (strcmp(cmd,"power") == 0) {
+        status = Client_Request(&client,LM51772D_OP_POWER_STAGE,addr,arg,0);
+    } else if (strcmp(cmd,"read") == 0) {
+        status = Client_Request(&client,LM51772D_OP_READ_REG,addr,arg,&result);
+    } else if (strcmp(cmd,"write") == 0) {
+        status = Client_Request(&client,LM51772D_OP_WRITE_REG,addr,(uint16_t)((arg << 8) | (arg2 & 0xFF)),0);
+    } else {
+        fprintf(stderr, "Unknown command %s\n", cmd);
+        Client_Close(&client);
+        return 1;
+    }
+    Client_Close(&client);
+    if (status != LM51772D_OK) {
+        fprintf(stderr, "%s failed, status %d\n", cmd, status);
+        return 1;
+    }
+    if (strcmp(cmd,"getvout") == 0) {
+        printf("%u\n", result);
+    } else if (strcmp(cmd,"status") == 0 || strcmp(cmd,"usbpd") == 0 || strcmp(cmd,"read") == 0) {
+        printf("0x%02X\n", result);
+    }
+    return 0;
+}
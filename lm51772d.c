@@ -0,0 +1,89 @@
+#include "LM51772.h"
+#include "lm51772dServer.h"
+#include "regCache.h"
+#include "i2cPigpio.h"
+#include "busLock.h"
+#include "i2cTransport.h"
+#include <pigpio.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Resident daemon owning the I2C bus. pigpio is initialized once, the
+// device handles stay open and the configuration registers are kept in a
+// shadow cache, so a request costs only its own transfers instead of the
+// startup of a whole process. Transactions take the lock of the bus
+// (busLock.h), so other tools can still use it in between.
+// The socket is only open to the members of the lm51772d group, register
+// writes and the power stage only to the user running the daemon.
+//
+// Usage: lm51772d [-b bus] [-s socket]
+
+#define I2C_BUS 3
+
+static volatile sig_atomic_t Running = 1;
+
+static void stop(int Signal){
+    (void)Signal;
+    Running = 0;
+}
+
+int main(int argc, char *argv[]){
+    unsigned busNumber = I2C_BUS;
+    const char *path = LM51772D_SOCKET_PATH;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i],"-b") == 0 && i + 1 < argc) {
+            busNumber = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i],"-s") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-b bus] [-s socket]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (gpioInitialise() < 0) {
+        fprintf(stderr, "pigpio initialisation failed\n");
+        return 1;
+    }
+    // pigpio installs its own handlers, ours have to come after it
+    signal(SIGINT,stop);
+    signal(SIGTERM,stop);
+
+    static I2C_PigpioBus bus;
+    static BusLock lock;
+    static I2C_Locked locked;
+    static RegCache cache;
+    I2C_Transport pigpioTransport, lockedTransport, cacheTransport;
+    if (BusLock_OpenBus(&lock,busNumber) < 0) {
+        gpioTerminate();
+        return 1;
+    }
+    I2C_Pigpio_Init(&bus,busNumber,&pigpioTransport);
+    BusLock_InitTransport(&locked,&lock,&pigpioTransport,&lockedTransport);
+    RegCache_Init(&cache,&lockedTransport,&cacheTransport);
+    I2C_SetTransport(&cacheTransport);
+
+    LM51772D_Server server;
+    if (Daemon_Open(&server,path,&cache) < 0) {
+        I2C_Pigpio_Close(&bus);
+        gpioTerminate();
+        return 1;
+    }
+    printf("lm51772d serving bus %u on %s\n", busNumber, path);
+    while (Running) {
+        if (Daemon_Poll(&server,500) < 0) {
+            perror("poll");
+            break;
+        }
+    }
+    printf("lm51772d stopping: %u requests, %u connections, cache hits %u misses %u\n",
+           server.Requests, server.Connections, cache.Hits, cache.Misses);
+    Daemon_Close(&server);
+    I2C_Pigpio_Close(&bus);
+    BusLock_Close(&lock);
+    gpioTerminate();
+    return 0;
+}
@@ -0,0 +1,99 @@
+//Include header file
+#include "lm51772dClient.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/******************************************
+* @brief: Connects to the daemon
+* @param Client: client context (LM51772D_Client *)
+* @param Path: socket path, NULL for LM51772D_SOCKET_PATH (const char *)
+* @note: Returns 0 or -1.
+*******************************************/
+int Client_Open(LM51772D_Client *Client, const char *Path){
+    Client->Seq = 0;
+    if (Path == 0) {
+        Path = LM51772D_SOCKET_PATH;
+    }
+    struct sockaddr_un addr;
+    memset(&addr,0,sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(Path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    strcpy(addr.sun_path,Path);
+    Client->Fd = socket(AF_UNIX,SOCK_SEQPACKET,0);
+    if (Client->Fd < 0) {
+        return -1;
+    }
+    if (connect(Client->Fd,(struct sockaddr *)&addr,sizeof(addr)) < 0) {
+        close(Client->Fd);
+        Client->Fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************
+* @brief: Closes the connection to the daemon
+* @param Client: client context (LM51772D_Client *)
+*******************************************/
+void Client_Close(LM51772D_Client *Client){
+    if (Client->Fd >= 0) {
+        close(Client->Fd);
+        Client->Fd = -1;
+    }
+}
+
+/******************************************
+* @brief: Sends a request and waits for its response
+* @param Client: client context (LM51772D_Client *)
+* @param Op: LM51772D_OP_* operation (uint8_t)
+* @param I2CAddress: 7 bit address of the device (uint8_t)
+* @param Value: argument of the operation (uint16_t)
+* @param Result: value of the response, can be NULL (uint16_t *)
+* @note: Returns the status of the response.
+*******************************************/
+int Client_Request(LM51772D_Client *Client, uint8_t Op, uint8_t I2CAddress, uint16_t Value, uint16_t *Result){
+    LM51772D_Request request = {Client->Seq++, Op, I2CAddress, Value, 0};
+    LM51772D_Response response;
+    if (send(Client->Fd,&request,sizeof(request),MSG_NOSIGNAL) != sizeof(request)) {
+        return LM51772D_ERR_PROTOCOL;
+    }
+    if (recv(Client->Fd,&response,sizeof(response),0) != sizeof(response) || response.Seq != request.Seq) {
+        return LM51772D_ERR_PROTOCOL;
+    }
+    if (Result != 0) {
+        *Result = response.Value;
+    }
+    return response.Status;
+}
+
+int Client_SetVout(LM51772D_Client *Client, uint8_t I2CAddress, uint16_t VoutmV){
+    return Client_Request(Client,LM51772D_OP_SET_VOUT,I2CAddress,VoutmV,0);
+}
+
+int Client_GetVout(LM51772D_Client *Client, uint8_t I2CAddress, uint16_t *VoutmV){
+    return Client_Request(Client,LM51772D_OP_GET_VOUT,I2CAddress,0,VoutmV);
+}
+
+int Client_SetIlim(LM51772D_Client *Client, uint8_t I2CAddress, uint16_t ILIMmAmps){
+    return Client_Request(Client,LM51772D_OP_SET_ILIM,I2CAddress,ILIMmAmps,0);
+}
+
+int Client_GetStatus(LM51772D_Client *Client, uint8_t I2CAddress, uint8_t *Status){
+    uint16_t value = 0;
+    int status = Client_Request(Client,LM51772D_OP_GET_STATUS,I2CAddress,0,&value);
+    *Status = (uint8_t)value;
+    return status;
+}
+
+int Client_ClearFaults(LM51772D_Client *Client, uint8_t I2CAddress){
+    return Client_Request(Client,LM51772D_OP_CLEAR_FAULTS,I2CAddress,0,0);
+}
+
+int Client_PowerStage(LM51772D_Client *Client, uint8_t I2CAddress, int Enable){
+    return Client_Request(Client,LM51772D_OP_POWER_STAGE,I2CAddress,Enable ? 1 : 0,0);
+}
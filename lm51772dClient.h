@@ -0,0 +1,31 @@
+#include <stdint.h>
+#include "lm51772dProtocol.h"
+
+#ifndef LM51772D_CLIENT_H
+#define LM51772D_CLIENT_H
+
+// Client library of the lm51772d daemon. A connection is opened once and
+// reused, every call is one request/response round trip on it.
+// Calls return LM51772D_OK, an LM51772D_ERR_* status of the daemon, or
+// LM51772D_ERR_PROTOCOL if the connection failed.
+
+typedef struct{
+    int Fd;                             // Connected socket
+    uint16_t Seq;                       // Sequence number of the next request
+} LM51772D_Client;
+
+// Connecting to the daemon, NULL Path uses LM51772D_SOCKET_PATH
+int Client_Open(LM51772D_Client *Client, const char *Path);
+void Client_Close(LM51772D_Client *Client);
+// Generic request, Result can be NULL
+int Client_Request(LM51772D_Client *Client, uint8_t Op, uint8_t I2CAddress, uint16_t Value, uint16_t *Result);
+
+// Wrappers of the operations
+int Client_SetVout(LM51772D_Client *Client, uint8_t I2CAddress, uint16_t VoutmV);
+int Client_GetVout(LM51772D_Client *Client, uint8_t I2CAddress, uint16_t *VoutmV);
+int Client_SetIlim(LM51772D_Client *Client, uint8_t I2CAddress, uint16_t ILIMmAmps);
+int Client_GetStatus(LM51772D_Client *Client, uint8_t I2CAddress, uint8_t *Status);
+int Client_ClearFaults(LM51772D_Client *Client, uint8_t I2CAddress);
+int Client_PowerStage(LM51772D_Client *Client, uint8_t I2CAddress, int Enable);
+
+#endif // LM51772D_CLIENT_H
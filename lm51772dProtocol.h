@@ -0,0 +1,57 @@
+#include <stdint.h>
+
+#ifndef LM51772D_PROTOCOL_H
+#define LM51772D_PROTOCOL_H
+
+// Protocol of the lm51772d daemon. Clients connect to a Unix domain
+// socket of type SOCK_SEQPACKET and send fixed size 8 byte requests, the
+// daemon answers every request with an 8 byte response carrying the same
+// sequence number. Both ends are on the same host, so the fields are in
+// host byte order.
+// The socket lives in a directory of its own and only the members of
+// LM51772D_GROUP can connect to it. Raw register writes and switching the
+// power stage are further limited to clients running as the user of the
+// daemon (SO_PEERCRED).
+
+#define LM51772D_SOCKET_DIR             "/run/lm51772d"
+#define LM51772D_SOCKET_PATH            LM51772D_SOCKET_DIR "/lm51772d.sock"
+#define LM51772D_GROUP                  "lm51772d"
+#define LM51772D_MAX_CLIENTS            32
+
+// Operations, Value is the argument of the request / result of the response
+#define LM51772D_OP_PING                0x00    // Value echoed
+#define LM51772D_OP_SET_VOUT            0x01    // Value: VOUT in mV, VOUT_MIN_MV to VOUT_MAX_MV
+#define LM51772D_OP_GET_VOUT            0x02    // Result: VOUT in mV
+#define LM51772D_OP_SET_ILIM            0x03    // Value: current limit in mA
+#define LM51772D_OP_GET_STATUS          0x04    // Result: STATUS_BYTE
+#define LM51772D_OP_GET_USBPD_STATUS    0x05    // Result: USB_PD_STATUS_0
+#define LM51772D_OP_CLEAR_FAULTS        0x06
+#define LM51772D_OP_POWER_STAGE         0x07    // Value: 1 enables, 0 disables
+#define LM51772D_OP_READ_REG            0x08    // Value: register, result: its value
+#define LM51772D_OP_WRITE_REG           0x09    // Value: register << 8 | value
+
+// Response status
+#define LM51772D_OK                     0
+#define LM51772D_ERR_OP                 -1      // Unknown operation
+#define LM51772D_ERR_ARG                -2      // Argument out of range
+#define LM51772D_ERR_BUS                -3      // Transfer failed
+#define LM51772D_ERR_PROTOCOL           -4      // Malformed request
+#define LM51772D_ERR_PERM               -5      // Client not allowed to do it
+
+typedef struct __attribute__((packed)){
+    uint16_t Seq;                       // Chosen by the client, echoed back
+    uint8_t Op;                         // LM51772D_OP_*
+    uint8_t I2CAddress;                 // 7 bit address of the device
+    uint16_t Value;                     // Argument
+    uint16_t Reserved;                  // Zero
+} LM51772D_Request;
+
+typedef struct __attribute__((packed)){
+    uint16_t Seq;                       // Sequence number of the request
+    uint8_t Op;                         // Operation of the request
+    int8_t Status;                      // LM51772D_OK or LM51772D_ERR_*
+    uint16_t Value;                     // Result
+    uint16_t Reserved;                  // Zero
+} LM51772D_Response;
+
+#endif // LM51772D_PROTOCOL_H
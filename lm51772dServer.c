@@ -0,0 +1,288 @@
+//Include header file
+#define _GNU_SOURCE     // struct ucred of SO_PEERCRED
+#include "lm51772dServer.h"
+#include "LM51772.h"
+#include "i2cTransport.h"
+#include <errno.h>
+#include <grp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Access mode of the socket directory and of the socket, for the daemon
+// user and LM51772D_GROUP
+#define DAEMON_DIR_MODE                 0750
+#define DAEMON_SOCKET_MODE              0660
+
+// Creates the directory of the socket, owned by LM51772D_GROUP (Gid, -1
+// if it does not exist), an existing one is kept as it is
+static int makeSocketDir(const char *Path, gid_t Gid){
+    char dir[108];
+    strcpy(dir,Path);
+    char *slash = strrchr(dir,'/');
+    if (slash == 0 || slash == dir) {
+        return 0;
+    }
+    *slash = 0;
+    if (mkdir(dir,DAEMON_DIR_MODE) < 0) {
+        if (errno == EEXIST) {
+            return 0;
+        }
+        perror(dir);
+        return -1;
+    }
+    if (chown(dir,(uid_t)-1,Gid) < 0 || chmod(dir,DAEMON_DIR_MODE) < 0) {
+        perror(dir);
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************
+* @brief: Creates the listening socket of the daemon
+* @param Server: server context (LM51772D_Server *)
+* @param Path: socket path, NULL for LM51772D_SOCKET_PATH (const char *)
+* @param Cache: register cache of the selected transport, used to
+*               detect bus errors, can be NULL (RegCache *)
+* @note: The directory of the socket is created with mode 0750 if it
+*        does not exist. The socket gets mode 0660 and the group
+*        LM51772D_GROUP, it is bound with a umask that keeps everyone
+*        else out until then (fchmod() on a socket does not reach its
+*        file). Without the group only the user of the daemon can
+*        connect. ControlUid is set to the user of the daemon.
+*        A stale socket file left by a previous run is removed.
+*        Returns 0 or -1.
+*******************************************/
+int Daemon_Open(LM51772D_Server *Server, const char *Path, RegCache *Cache){
+    memset(Server,0,sizeof(*Server));
+    for (int i = 0; i < LM51772D_MAX_CLIENTS; ++i) {
+        Server->Clients[i] = -1;
+    }
+    Server->Cache = Cache;
+    Server->ControlUid = geteuid();
+    if (Path == 0) {
+        Path = LM51772D_SOCKET_PATH;
+    }
+    struct sockaddr_un addr;
+    memset(&addr,0,sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(Path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", Path);
+        return -1;
+    }
+    strcpy(addr.sun_path,Path);
+    strcpy(Server->Path,Path);
+    struct group *group = getgrnam(LM51772D_GROUP);
+    gid_t gid = (group != 0) ? group->gr_gid : (gid_t)-1;
+    if (group == 0) {
+        fprintf(stderr, "Group %s not found, only the daemon user can connect to %s\n", LM51772D_GROUP, Path);
+    }
+    if (makeSocketDir(Path,gid) < 0) {
+        return -1;
+    }
+    Server->ListenFd = socket(AF_UNIX,SOCK_SEQPACKET,0);
+    if (Server->ListenFd < 0) {
+        perror("socket");
+        return -1;
+    }
+    unlink(Path);
+    mode_t mask = umask(0777 & ~DAEMON_SOCKET_MODE);
+    int bound = bind(Server->ListenFd,(struct sockaddr *)&addr,sizeof(addr));
+    umask(mask);
+    if (bound < 0 || chown(Path,(uid_t)-1,gid) < 0 || chmod(Path,DAEMON_SOCKET_MODE) < 0 ||
+        listen(Server->ListenFd,LM51772D_MAX_CLIENTS) < 0) {
+        perror(Path);
+        close(Server->ListenFd);
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************
+* @brief: Executes one request
+* @param Server: server context (LM51772D_Server *)
+* @param Request: request received (const LM51772D_Request *)
+* @param Response: response to be sent (LM51772D_Response *)
+* @note: The driver functions do not report bus errors, they are
+*        detected through the error counter of the register cache.
+*******************************************/
+void Daemon_Execute(LM51772D_Server *Server, const LM51772D_Request *Request, LM51772D_Response *Response){
+    const uint8_t addr = Request->I2CAddress & 0x7F;
+    const uint16_t value = Request->Value;
+    uint32_t errors = (Server->Cache != 0) ? Server->Cache->Errors : 0;
+    Response->Seq = Request->Seq;
+    Response->Op = Request->Op;
+    Response->Status = LM51772D_OK;
+    Response->Value = 0;
+    Response->Reserved = 0;
+    switch (Request->Op) {
+        case LM51772D_OP_PING:
+            Response->Value = value;
+            return; // No bus access
+        case LM51772D_OP_SET_VOUT:
+            if (value < VOUT_MIN_MV || value > VOUT_MAX_MV) {
+                Response->Status = LM51772D_ERR_ARG;
+                return;
+            }
+            setVOUT1_TARGET(addr,value);
+            break;
+        case LM51772D_OP_GET_VOUT:
+            Response->Value = (uint16_t)(getVOUT1_TARGET(addr)*VOUT_MV_PER_CODE);
+            break;
+        case LM51772D_OP_SET_ILIM:
+            if (value < ILIM_MIN_MA || value > ILIM_MAX_MA) {
+                Response->Status = LM51772D_ERR_ARG;
+                return;
+            }
+            setILIM_THRESHOLD(addr,value);
+            break;
+        case LM51772D_OP_GET_STATUS:
+            Response->Value = I2C_ReadRegByte(addr,STATUS_BYTE);
+            break;
+        case LM51772D_OP_GET_USBPD_STATUS:
+            Response->Value = get_USBPD_STATUS(addr);
+            break;
+        case LM51772D_OP_CLEAR_FAULTS:
+            ClearFaults(addr);
+            break;
+        case LM51772D_OP_POWER_STAGE:
+            if (value) {
+                EnablePowerStage(addr);
+            } else {
+                DisablePowerStage(addr);
+            }
+            break;
+        case LM51772D_OP_READ_REG: {
+            uint8_t data = 0;
+            if (value > 0xFF || I2C_ReadRegBlock(addr,(uint8_t)value,&data,1) < 0) {
+                Response->Status = (value > 0xFF) ? LM51772D_ERR_ARG : LM51772D_ERR_BUS;
+                return;
+            }
+            Response->Value = data;
+            return;
+        }
+        case LM51772D_OP_WRITE_REG: {
+            uint8_t buff[2] = {(uint8_t)(value >> 8), (uint8_t)(value & 0xFF)};
+            if (I2C_WriteBlock(addr,buff,2) < 0) {
+                Response->Status = LM51772D_ERR_BUS;
+            }
+            return;
+        }
+        default:
+            Response->Status = LM51772D_ERR_OP;
+            return;
+    }
+    if (Server->Cache != 0 && Server->Cache->Errors != errors) {
+        Response->Status = LM51772D_ERR_BUS;
+    }
+}
+
+// Operations reserved to ControlUid: raw register writes and the power
+// stage
+static int controlOp(uint8_t Op){
+    return Op == LM51772D_OP_WRITE_REG || Op == LM51772D_OP_POWER_STAGE;
+}
+
+// Serves one readable client, returns -1 if it has to be closed
+static int serveClient(LM51772D_Server *Server, int Slot){
+    int fd = Server->Clients[Slot];
+    LM51772D_Request request;
+    LM51772D_Response response;
+    ssize_t received = recv(fd,&request,sizeof(request),0);
+    if (received <= 0) {
+        return -1; // Closed or failed
+    }
+    if (received != sizeof(request)) {
+        memset(&response,0,sizeof(response));
+        response.Status = LM51772D_ERR_PROTOCOL;
+    } else if (controlOp(request.Op) && Server->ClientUids[Slot] != Server->ControlUid) {
+        memset(&response,0,sizeof(response));
+        response.Seq = request.Seq;
+        response.Op = request.Op;
+        response.Status = LM51772D_ERR_PERM;
+    } else {
+        Daemon_Execute(Server,&request,&response);
+    }
+    Server->Requests++;
+    if (send(fd,&response,sizeof(response),MSG_NOSIGNAL) != sizeof(response)) {
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************
+* @brief: Serves pending connections and requests
+* @param Server: server context (LM51772D_Server *)
+* @param TimeoutMs: maximum wait for activity, -1 waits forever (int)
+* @note: Returns the number of requests served, or -1 if poll()
+*        failed for another reason than a signal.
+*******************************************/
+int Daemon_Poll(LM51772D_Server *Server, int TimeoutMs){
+    struct pollfd fds[LM51772D_MAX_CLIENTS + 1];
+    int slots[LM51772D_MAX_CLIENTS + 1];
+    int count = 0;
+    fds[count].fd = Server->ListenFd;
+    fds[count].events = POLLIN;
+    slots[count++] = -1;
+    for (int i = 0; i < LM51772D_MAX_CLIENTS; ++i) {
+        if (Server->Clients[i] >= 0) {
+            fds[count].fd = Server->Clients[i];
+            fds[count].events = POLLIN;
+            slots[count++] = i;
+        }
+    }
+    int ready = poll(fds,count,TimeoutMs);
+    if (ready < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+    uint32_t before = Server->Requests;
+    for (int i = 1; i < count; ++i) {
+        if (fds[i].revents == 0) {
+            continue;
+        }
+        if ((fds[i].revents & POLLIN) == 0 || serveClient(Server,slots[i]) < 0) {
+            close(fds[i].fd);
+            Server->Clients[slots[i]] = -1;
+        }
+    }
+    if (fds[0].revents & POLLIN) {
+        int fd = accept(Server->ListenFd,0,0);
+        if (fd >= 0) {
+            int slot = -1;
+            for (int i = 0; i < LM51772D_MAX_CLIENTS && slot < 0; ++i) {
+                if (Server->Clients[i] < 0) {
+                    slot = i;
+                }
+            }
+            struct ucred cred;
+            socklen_t length = sizeof(cred);
+            if (slot < 0 || getsockopt(fd,SOL_SOCKET,SO_PEERCRED,&cred,&length) < 0) {
+                close(fd); // Too many clients or unknown peer
+            } else {
+                Server->Clients[slot] = fd;
+                Server->ClientUids[slot] = cred.uid;
+                Server->Connections++;
+            }
+        }
+    }
+    return (int)(Server->Requests - before);
+}
+
+/******************************************
+* @brief: Closes every connection and removes the socket
+* @param Server: server context (LM51772D_Server *)
+*******************************************/
+void Daemon_Close(LM51772D_Server *Server){
+    for (int i = 0; i < LM51772D_MAX_CLIENTS; ++i) {
+        if (Server->Clients[i] >= 0) {
+            close(Server->Clients[i]);
+            Server->Clients[i] = -1;
+        }
+    }
+    close(Server->ListenFd);
+    unlink(Server->Path);
+}
@@ -0,0 +1,35 @@
+#include <stdint.h>
+#include "lm51772dProtocol.h"
+#include "regCache.h"
+#include <sys/types.h>
+
+#ifndef LM51772D_SERVER_H
+#define LM51772D_SERVER_H
+
+// Request handling of the lm51772d daemon, independent of the bus backend.
+// The daemon selects a transport (usually a RegCache over pigpio), opens
+// the socket and calls Daemon_Poll() in a loop. Everything runs in the
+// thread calling Daemon_Poll(), so the driver is never entered twice.
+
+typedef struct{
+    int ListenFd;                       // Listening socket
+    int Clients[LM51772D_MAX_CLIENTS];  // Connected clients, -1 if free
+    uid_t ClientUids[LM51772D_MAX_CLIENTS]; // User of every client (SO_PEERCRED)
+    uid_t ControlUid;                   // User allowed to write registers and switch the power stage
+    RegCache *Cache;                    // Cache of the selected transport, can be NULL
+    char Path[108];                     // Socket path, removed on close
+    // Statistics
+    uint32_t Requests;                  // Requests served
+    uint32_t Connections;               // Clients accepted
+} LM51772D_Server;
+
+// Creating the socket and its directory, returns 0 or -1
+int Daemon_Open(LM51772D_Server *Server, const char *Path, RegCache *Cache);
+// Serving the pending connections and requests, waits up to TimeoutMs
+int Daemon_Poll(LM51772D_Server *Server, int TimeoutMs);
+// Closing every connection and removing the socket
+void Daemon_Close(LM51772D_Server *Server);
+// Executing one request on the selected transport
+void Daemon_Execute(LM51772D_Server *Server, const LM51772D_Request *Request, LM51772D_Response *Response);
+
+#endif // LM51772D_SERVER_H
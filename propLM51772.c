@@ -0,0 +1,558 @@
+#include "LM51772.h"
+#include "LM51772Regs.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Differential property tester of the LM51772 setters and getters. Every
+// sequence starts from random register contents, applies random calls
+// with random arguments to the driver (on a simulated device) and to a
+// reference model, and compares the final register state (the bits of
+// the fields, reserved bits may differ). The model is independent of
+// LM51772.c: field positions and widths come from the field descriptor
+// table of LM51772Regs.c and the encodings are written from the
+// datasheet. Getters are checked against the model on the fly.
+// A failing sequence is shrunk (calls removed while it still fails) and
+// printed with the seed and its index, so it can be replayed with -s/-r.
+//
+// Usage: propLM51772 [-n sequences] [-j threads] [-s seed] [-r sequence]
+
+#define DEFAULT_SEQUENCES       200000
+#define MAX_CALLS               16
+#define MAX_THREADS             16
+#define MAX_TARGETS             2
+
+// Kinds of operation
+#define OP_SET                  0   // Sets every bit of the targets
+#define OP_CLEAR                1   // Clears every bit of the targets
+#define OP_ENUM                 2   // Argument is the field value in position
+#define OP_NUMBER               3   // Argument encoded by Encode, ignored out of range
+#define OP_NUMBER_F             4   // As OP_NUMBER, argument passed as float Arg/ArgScale
+#define OP_GET8                 5   // Result compared with the targets
+#define OP_GET16                6
+
+typedef struct{
+    uint8_t Reg;
+    const char *Field;                  // Field name in LM51772_Fields, NULL for the whole register
+} Target;
+
+typedef struct{
+    const char *Name;
+    uint8_t Kind;
+    union{
+        void (*Call)(uint8_t);
+        void (*CallU8)(uint8_t, uint8_t);
+        void (*CallU16)(uint8_t, uint16_t);
+        void (*CallF)(uint8_t, float);
+        uint8_t (*Get8)(uint8_t);
+        uint16_t (*Get16)(uint8_t);
+    } Fn;
+    Target Targets[MAX_TARGETS];        // A number is split over them, low bits first
+    const uint8_t *Values;              // OP_ENUM arguments
+    int ValueCount;
+    int32_t Min, Max;                   // OP_NUMBER range accepted by the datasheet
+    int32_t (*Encode)(int32_t Arg);     // OP_NUMBER register code of the argument
+    int32_t ArgScale;                   // OP_NUMBER_F divisor of the argument
+} Operation;
+
+// Datasheet encodings
+static int32_t encodeIlim(int32_t mA){ return mA*R_SENSE/500; }
+static int32_t encodeVout(int32_t mV){ return mV/VOUT_MV_PER_CODE; }
+static int32_t encodeVdetFall(int32_t mV){ return (mV - 2700)/200; }
+static int32_t encodeVdetRise(int32_t mV){ return (mV - 2800)/200; }
+static int32_t encodeOvp2(int32_t mV){ return (mV < 16000) ? (mV - 4000)/500 : 24 + (mV - 16000)/1000; }
+static int32_t encodePcm(int32_t mV){ return mV/25; }
+static int32_t encodePcmTenths(int32_t TenthsmV){ return TenthsmV/250; }
+// IVP_VOLTAGE code table of the datasheet: codes 0-150 from 4750 mV in
+// 125 mV steps, codes 151-255 from 24000 mV in 250 mV steps. The right
+// code is the highest one whose threshold does not exceed the request.
+static int32_t decodeIvp(int32_t Code){ return (Code <= 150) ? 4750 + Code*125 : 24000 + (Code - 151)*250; }
+static int32_t encodeIvp(int32_t mV){
+    int32_t code = 0;
+    while (code < 255 && decodeIvp(code + 1) <= mV) {
+        code++;
+    }
+    return code;
+}
+
+static const uint8_t thwValues[] = {THW_THRESHOLD_140degC, THW_THRESHOLD_125degC, THW_THRESHOLD_110degC, THW_THRESHOLD_95degC};
+static const uint8_t strengthValues[] = {DISCHG_STRENGTH_25mA, DISCHG_STRENGTH_50mA, DISCHG_STRENGTH_75mA};
+static const uint8_t slewValues[] = {DVS_SLEW_40mV_us, DVS_SLEW_20mV_us, DVS_SLEW_1mV_us, DVS_SLEW_0_5mV_us};
+static const uint8_t scaleValues[] = {BB_MINTIME_SCALE_0_75x, BB_MINTIME_SCALE_1x, BB_MINTIME_SCALE_1_25x, BB_MINTIME_SCALE_1_5x};
+static const uint8_t deadTimeValues[] = {GDRV_MINDEADTIME_10ns, GDRV_MINDEADTIME_20ns, GDRV_MINDEADTIME_40ns, GDRV_MINDEADTIME_60ns};
+static const uint8_t syncValues[] = {OSC_SYNC_INPUT_RISING, OSC_SYNC_INPUT_FALLING, OSC_SYNC_OUTPUT_RISING, OSC_SYNC_OUTPUT_FALLING};
+static const uint8_t slopeValues[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
+static const uint8_t derateValues[] = {INDUC_DERATE_DISABLE, INDUC_DERATE_20, INDUC_DERATE_30, INDUC_DERATE_40};
+static const uint8_t drvSupplyValues[] = {DRV1_SUP_OPENDRAIN, DRV1_SUP_VOUT, DRV1_SUP_VBIAS, DRV1_SUP_VCC2};
+static const uint8_t drvSequenceValues[] = {DRV1_SEQ_PULL_LOW_CONV_OFF, DRV1_SEQ_PULL_LOW_CONV_ON, DRV1_SEQ_FORCE_ACTIVE, DRV1_SEQ_FORCE_OFF};
+static const uint8_t cdcValues[] = {CDC_GAIN_0_250V, CDC_GAIN_0_500V, CDC_GAIN_1_000V, CDC_GAIN_2_000V};
+
+#define FLAG(kind, fn, reg, field)      { #fn, kind, {.Call = fn}, {{reg, field}}, 0, 0, 0, 0, 0, 0 }
+#define SET(fn, reg, field)             FLAG(OP_SET, fn, reg, field)
+#define CLEAR(fn, reg, field)           FLAG(OP_CLEAR, fn, reg, field)
+#define ENUM(fn, reg, field, values)    { #fn, OP_ENUM, {.CallU8 = fn}, {{reg, field}}, values, (int)sizeof(values), 0, 0, 0, 0 }
+#define NUMBER(fn, reg, field, lo, hi, encode) \
+                                        { #fn, OP_NUMBER, {.CallU16 = fn}, {{reg, field}}, 0, 0, lo, hi, encode, 0 }
+
+static const Operation operations[] = {
+    NUMBER(setILIM_THRESHOLD, ILIM_THRESHOLD, "ILIM_THRESHOLD", 500, 7000, encodeIlim),
+    { "setVOUT1_TARGET", OP_NUMBER, {.CallU16 = setVOUT1_TARGET},
+      {{VOUT_TARGET1_LSB, "VOUT_TARGET1_LSB"}, {VOUT_TARGET1_MSB, "VOUT_TARGET1_MSB"}}, 0, 0, 0, 65535, encodeVout, 0 },
+    { "getVOUT1_TARGET", OP_GET16, {.Get16 = getVOUT1_TARGET},
+      {{VOUT_TARGET1_LSB, "VOUT_TARGET1_LSB"}, {VOUT_TARGET1_MSB, "VOUT_TARGET1_MSB"}}, 0, 0, 0, 0, 0, 0 },
+    { "EnablePowerStage", OP_SET, {.Call = EnablePowerStage},
+      {{USB_PD_CONTROL_0, "CONV_EN"}, {MFR_SPECIFIC_D0, "CONV_EN"}}, 0, 0, 0, 0, 0, 0 },
+    { "DisablePowerStage", OP_CLEAR, {.Call = DisablePowerStage},
+      {{USB_PD_CONTROL_0, "CONV_EN"}, {MFR_SPECIFIC_D0, "CONV_EN"}}, 0, 0, 0, 0, 0, 0 },
+    SET(ForceDischargeEnable, USB_PD_CONTROL_0, "FORCE_DISCHG"),
+    CLEAR(ForceDischargeDisable, USB_PD_CONTROL_0, "FORCE_DISCHG"),
+    { "get_USBPD_STATUS", OP_GET8, {.Get8 = get_USBPD_STATUS}, {{USB_PD_STATUS_0, 0}}, 0, 0, 0, 0, 0, 0 },
+    { "get_STATUS_BYTE", OP_GET8, {.Get8 = get_STATUS_BYTE}, {{STATUS_BYTE, 0}}, 0, 0, 0, 0, 0, 0 },
+    SET(uSleep_Enable, MFR_SPECIFIC_D0, "USLEEP_EN"),
+    CLEAR(uSleep_Disable, MFR_SPECIFIC_D0, "USLEEP_EN"),
+    SET(DRSS_Enable, MFR_SPECIFIC_D0, "DRSS_EN"),
+    CLEAR(DRSS_Disable, MFR_SPECIFIC_D0, "DRSS_EN"),
+    SET(HiccupProtection_Enable, MFR_SPECIFIC_D0, "HICCUP_EN"),
+    CLEAR(HiccupProtection_Disable, MFR_SPECIFIC_D0, "HICCUP_EN"),
+    SET(CurrentLimiter_Enable, MFR_SPECIFIC_D0, "IMON_LIMITER_EN"),
+    CLEAR(CurrentLimiter_Disable, MFR_SPECIFIC_D0, "IMON_LIMITER_EN"),
+    SET(Vcc1LDO_Enable, MFR_SPECIFIC_D0, "EN_VCC1"),
+    CLEAR(Vcc1LDO_Disable, MFR_SPECIFIC_D0, "EN_VCC1"),
+    SET(NegativeCurrentLimiting_Enable, MFR_SPECIFIC_D0, "EN_NEG_CL_LIMIT"),
+    CLEAR(NegativeCurrentLimiting_Disable, MFR_SPECIFIC_D0, "EN_NEG_CL_LIMIT"),
+    SET(PSM_2PhaseBB_Enable, MFR_SPECIFIC_D1, "EN_BB_2P_PSM"),
+    CLEAR(PSM_2PhaseBB_Disable, MFR_SPECIFIC_D1, "EN_BB_2P_PSM"),
+    SET(FPWM_2PhaseBB_Enable, MFR_SPECIFIC_D1, "EN_BB_2P_FPWM"),
+    CLEAR(FPWM_2PhaseBB_Disable, MFR_SPECIFIC_D1, "EN_BB_2P_FPWM"),
+    SET(ForceBias_Enable, MFR_SPECIFIC_D1, "FORCE_BIASPIN"),
+    CLEAR(ForceBias_Disable, MFR_SPECIFIC_D1, "FORCE_BIASPIN"),
+    SET(DTRK_DirectStartup_Enable, MFR_SPECIFIC_D1, "EN_DTRK_STARTOVER"),
+    CLEAR(DTRK_DirectStartup_Disable, MFR_SPECIFIC_D1, "EN_DTRK_STARTOVER"),
+    SET(nFLT_as_INT_Enable, MFR_SPECIFIC_D1, "EN_NINT"),
+    CLEAR(nFLT_as_INT_Disable, MFR_SPECIFIC_D1, "EN_NINT"),
+    ENUM(ThermalWarning_ThresholdConfigure, MFR_SPECIFIC_D1, "THW_THRESHOLD", thwValues),
+    SET(ThermalWarning_Enable, MFR_SPECIFIC_D1, "EN_THER_WARN"),
+    CLEAR(ThermalWarning_Disable, MFR_SPECIFIC_D1, "EN_THER_WARN"),
+    SET(Discharge_VTH_Enable, MFR_SPECIFIC_D2, "DISCHARGE_CONFIG0"),
+    CLEAR(Discharge_VTH_Disable, MFR_SPECIFIC_D2, "DISCHARGE_CONFIG0"),
+    SET(Discharge_Enable, MFR_SPECIFIC_D2, "DISCHARGE_CONFIG1"),
+    CLEAR(Discharge_Disable, MFR_SPECIFIC_D2, "DISCHARGE_CONFIG1"),
+    ENUM(Dishcarge_StrengthConfigure, MFR_SPECIFIC_D2, "DISCHG_STRENGTH", strengthValues),
+    ENUM(DVS_SlewrateConfigure, MFR_SPECIFIC_D2, "DVS_SLEW_RAMP", slewValues),
+    SET(DVS_ActiveDownRamp_Enable, MFR_SPECIFIC_D2, "EN_ACTIVE_DVS"),
+    CLEAR(DVS_ActiveDownRamp_Disable, MFR_SPECIFIC_D2, "EN_ACTIVE_DVS"),
+    NUMBER(VDET_FallingThresholdConfigure, MFR_SPECIFIC_D3, "VDET_FALL", 2700, 8900, encodeVdetFall),
+    SET(VDET_Enable, MFR_SPECIFIC_D3, "VDET_EN"),
+    CLEAR(VDET_Disable, MFR_SPECIFIC_D3, "VDET_EN"),
+    SET(IVP_InputVoltageRegulation_Enable, MFR_SPECIFIC_D3, "SEL_IVR"),
+    CLEAR(IVP_InputVoltageRegulation_Disable, MFR_SPECIFIC_D3, "SEL_IVR"),
+    SET(IVP_Enable, MFR_SPECIFIC_D3, "EN_IVP"),
+    CLEAR(IVP_Disable, MFR_SPECIFIC_D3, "EN_IVP"),
+    NUMBER(VDET_RisingThresholdConfigure, MFR_SPECIFIC_D4, "VDET_RISE", 2800, 9000, encodeVdetRise),
+    NUMBER(OVP_SecondaryThreshold_Configure, MFR_SPECIFIC_D5, "V_OVP2", 4000, 55000, encodeOvp2),
+    ENUM(BB_MinTimeScale_Select, MFR_SPECIFIC_D6, "BB_MINTIME_SCALE", scaleValues),
+    ENUM(GDRV_MinDeadTime_Select, MFR_SPECIFIC_D6, "GDRV_MIN_DEADTIME", deadTimeValues),
+    SET(GDRV_DeadTimeScaling_Enable, MFR_SPECIFIC_D6, "SEL_SCALE_DT"),
+    CLEAR(GDRV_DeadTimeScaling_Disable, MFR_SPECIFIC_D6, "SEL_SCALE_DT"),
+    SET(GDRV_ForceConstantDeadTime_Enable, MFR_SPECIFIC_D6, "EN_CONTS_TDEAD"),
+    CLEAR(GDRV_ForceConstantDeadTime_Disable, MFR_SPECIFIC_D6, "EN_CONTS_TDEAD"),
+    ENUM(OSC_FreqSyncConfigure, MFR_SPECIFIC_D6, "OSC_SYNC", syncValues),
+    ENUM(SlopeComp_CorrectionFactor_Select, MFR_SPECIFIC_D7, "SLOPECOMP_CORRECTION", slopeValues),
+    ENUM(SlopeComp_InductorDerating_Select, MFR_SPECIFIC_D7, "INDUC_DERATE", derateValues),
+    ENUM(DRV1_Supply_Configure, MFR_SPECIFIC_D8, "DRV1_SUPPLY", drvSupplyValues),
+    ENUM(DRV1_Sequence_Configure, MFR_SPECIFIC_D8, "DRV1_SEQUENCE", drvSequenceValues),
+    ENUM(CDC_GainVoltage_Select, MFR_SPECIFIC_D8, "CDC_GAIN", cdcValues),
+    SET(CDC_Enable, MFR_SPECIFIC_D8, "EN_CDC"),
+    CLEAR(CDC_Disable, MFR_SPECIFIC_D8, "EN_CDC"),
+    SET(LM51772_FB_Divider_Sel20, MFR_SPECIFIC_D8, "SEL_FB_DIV20"),
+    CLEAR(LM51772_FB_Divider_Sel10, MFR_SPECIFIC_D8, "SEL_FB_DIV20"),
+    NUMBER(PCM_LowerVoltageWindow_Configure, MFR_SPECIFIC_D9, "PCM_WINDOW_LOW", 0, 775, encodePcm),
+    { "PCM_LowerVoltageWindow_ConfigureF", OP_NUMBER_F, {.CallF = PCM_LowerVoltageWindow_ConfigureF},
+      {{MFR_SPECIFIC_D9, "PCM_WINDOW_LOW"}}, 0, 0, 0, 7750, encodePcmTenths, 100 },
+    SET(OCP_ISET_OverILIM_Enable, MFR_SPECIFIC_D9, "SEL_ISET_PIN"),
+    CLEAR(OCP_ISET_OverILIM_Disable, MFR_SPECIFIC_D9, "SEL_ISET_PIN"),
+    NUMBER(IVP_VoltageThreshold_Configure, IVP_VOLTAGE, "IVP_VOLTAGE", 4750, 50000, encodeIvp),
+};
+#define OPERATION_COUNT         (int)(sizeof(operations)/sizeof(operations[0]))
+
+// Masks of the targets, resolved from the field table once
+static uint8_t targetMask[OPERATION_COUNT][MAX_TARGETS];
+// Bits of every register covered by a field, reserved bits are not compared
+static uint8_t definedMask[256];
+
+typedef struct{
+    uint8_t Op;
+    int32_t Arg;
+} Call;
+
+typedef struct{
+    uint8_t Initial[256];               // Random register contents
+    Call Calls[MAX_CALLS];
+    int Count;
+} Sequence;
+
+typedef struct{
+    uint64_t Rng;                       // Seed of the run
+    SimI2CBus Bus;
+    SimLM51772 Device;
+    I2C_Transport Transport;
+    uint64_t Sequences;
+    uint64_t Calls;
+} Worker;
+
+static uint64_t sequencesWanted = DEFAULT_SEQUENCES;
+static atomic_ullong sequencesTaken = 0;
+static atomic_int failed = 0;
+static pthread_mutex_t reportLock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t xorshift(uint64_t *State){
+    uint64_t x = *State;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *State = x;
+}
+
+static int lowestBit(uint8_t Mask){
+    int shift = 0;
+    while (((Mask >> shift) & 1) == 0) {
+        shift++;
+    }
+    return shift;
+}
+
+static int bitCount(uint8_t Mask){
+    int count = 0;
+    for (; Mask != 0; Mask &= (uint8_t)(Mask - 1)) {
+        count++;
+    }
+    return count;
+}
+
+static int resolveMasks(void){
+    for (int f = 0; f < LM51772_FieldCount; ++f) {
+        definedMask[LM51772_Fields[f].Reg] |= LM51772_Fields[f].Mask;
+    }
+    for (int i = 0; i < OPERATION_COUNT; ++i) {
+        for (int t = 0; t < MAX_TARGETS; ++t) {
+            const Target *target = &operations[i].Targets[t];
+            if (t > 0 && target->Reg == 0 && target->Field == 0) {
+                continue;
+            }
+            if (target->Field == 0) {
+                targetMask[i][t] = 0xFF;
+                continue;
+            }
+            for (int f = 0; f < LM51772_FieldCount; ++f) {
+                if (LM51772_Fields[f].Reg == target->Reg && strcmp(LM51772_Fields[f].Name,target->Field) == 0) {
+                    targetMask[i][t] = LM51772_Fields[f].Mask;
+                }
+            }
+            if (targetMask[i][t] == 0) {
+                fprintf(stderr, "%s: field %s not in the field table\n", operations[i].Name, target->Field);
+                return -1;
+            }
+        }
+    }
+    // The model itself: every accepted argument must fit the fields
+    for (int i = 0; i < OPERATION_COUNT; ++i) {
+        const Operation *op = &operations[i];
+        if (op->Kind != OP_NUMBER && op->Kind != OP_NUMBER_F) {
+            continue;
+        }
+        int bits = 0;
+        for (int t = 0; t < MAX_TARGETS && targetMask[i][t] != 0; ++t) {
+            bits += bitCount(targetMask[i][t]);
+        }
+        if (op->Encode(op->Min) < 0 || op->Encode(op->Max) >= (1 << bits)) {
+            fprintf(stderr, "%s: range %d..%d does not fit %d bits\n", op->Name, (int)op->Min, (int)op->Max, bits);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Model: writes a code spread over the targets, low bits first
+static void modelStore(uint8_t *Regs, int Op, uint32_t Code){
+    for (int t = 0; t < MAX_TARGETS && targetMask[Op][t] != 0; ++t) {
+        uint8_t mask = targetMask[Op][t];
+        uint8_t reg = operations[Op].Targets[t].Reg;
+        Regs[reg] = (uint8_t)((Regs[reg] & ~mask) | ((Code << lowestBit(mask)) & mask));
+        Code >>= bitCount(mask);
+    }
+}
+
+// Model: reads a code spread over the targets
+static uint32_t modelLoad(const uint8_t *Regs, int Op){
+    uint32_t code = 0;
+    int bits = 0;
+    for (int t = 0; t < MAX_TARGETS && targetMask[Op][t] != 0; ++t) {
+        uint8_t mask = targetMask[Op][t];
+        code |= (uint32_t)((Regs[operations[Op].Targets[t].Reg] & mask) >> lowestBit(mask)) << bits;
+        bits += bitCount(mask);
+    }
+    return code;
+}
+
+// Model of one call, returns the value a getter must return
+static uint32_t modelApply(uint8_t *Regs, const Call *Call){
+    const Operation *op = &operations[Call->Op];
+    switch (op->Kind) {
+        case OP_SET:
+        case OP_CLEAR:
+            for (int t = 0; t < MAX_TARGETS && targetMask[Call->Op][t] != 0; ++t) {
+                uint8_t reg = op->Targets[t].Reg;
+                Regs[reg] = (op->Kind == OP_SET) ? (Regs[reg] | targetMask[Call->Op][t]) : (Regs[reg] & ~targetMask[Call->Op][t]);
+            }
+            break;
+        case OP_ENUM:
+            modelStore(Regs,Call->Op,(uint32_t)Call->Arg >> lowestBit(targetMask[Call->Op][0]));
+            break;
+        case OP_NUMBER:
+        case OP_NUMBER_F:
+            if (Call->Arg >= op->Min && Call->Arg <= op->Max) {
+                modelStore(Regs,Call->Op,(uint32_t)op->Encode(Call->Arg));
+            }
+            break;
+        default:
+            return modelLoad(Regs,Call->Op);
+    }
+    return 0;
+}
+
+// Driver call, returns the getter result
+static uint32_t driverApply(uint8_t I2CAddress, const Call *Call){
+    const Operation *op = &operations[Call->Op];
+    switch (op->Kind) {
+        case OP_SET:
+        case OP_CLEAR:
+            op->Fn.Call(I2CAddress);
+            break;
+        case OP_ENUM:
+            op->Fn.CallU8(I2CAddress,(uint8_t)Call->Arg);
+            break;
+        case OP_NUMBER:
+            op->Fn.CallU16(I2CAddress,(uint16_t)Call->Arg);
+            break;
+        case OP_NUMBER_F:
+            op->Fn.CallF(I2CAddress,(float)Call->Arg/(float)op->ArgScale);
+            break;
+        case OP_GET8:
+            return op->Fn.Get8(I2CAddress);
+        case OP_GET16:
+            return op->Fn.Get16(I2CAddress);
+        default:
+            break;
+    }
+    return 0;
+}
+
+static void randomCall(uint64_t *Rng, Call *Call){
+    Call->Op = (uint8_t)(xorshift(Rng) % OPERATION_COUNT);
+    const Operation *op = &operations[Call->Op];
+    Call->Arg = 0;
+    if (op->Kind == OP_ENUM) {
+        Call->Arg = op->Values[xorshift(Rng) % (uint64_t)op->ValueCount];
+    } else if (op->Kind == OP_NUMBER || op->Kind == OP_NUMBER_F) {
+        // Range plus an eighth on each side, to cover the rejection
+        int32_t margin = (op->Max - op->Min)/8;
+        int32_t lo = (op->Min - margin < 0) ? 0 : op->Min - margin;
+        int32_t hi = (op->Max + margin > 65535) ? 65535 : op->Max + margin;
+        Call->Arg = lo + (int32_t)(xorshift(Rng) % (uint64_t)(hi - lo + 1));
+    }
+}
+
+// Runs a sequence on the simulated device and on the model. Returns -1
+// if they agree, else the index of the failing call (Count for the final
+// register state), with the register or getter values in Expected/Actual.
+static int runSequence(Worker *Worker, const Sequence *Sequence, uint8_t *Reg, uint32_t *Expected, uint32_t *Actual){
+    uint8_t model[256];
+    memcpy(model,Sequence->Initial,sizeof(model));
+    memcpy(Worker->Device.Regs,Sequence->Initial,sizeof(model));
+    uint8_t address = Worker->Device.I2CAddress;
+    for (int i = 0; i < Sequence->Count; ++i) {
+        const Call *call = &Sequence->Calls[i];
+        uint32_t expected = modelApply(model,call);
+        uint32_t actual = driverApply(address,call);
+        Worker->Calls++;
+        if (actual != expected) {
+            *Reg = operations[call->Op].Targets[0].Reg;
+            *Expected = expected;
+            *Actual = actual;
+            return i;
+        }
+    }
+    for (uint8_t r = 0; r < LM51772_RegisterCount; ++r) {
+        const LM51772_RegisterDesc *desc = &LM51772_Registers[r];
+        uint8_t mask = definedMask[desc->Reg];
+        if ((desc->Flags & REG_RW) && ((model[desc->Reg] ^ Worker->Device.Regs[desc->Reg]) & mask) != 0) {
+            *Reg = desc->Reg;
+            *Expected = model[desc->Reg];
+            *Actual = Worker->Device.Regs[desc->Reg];
+            return Sequence->Count;
+        }
+    }
+    return -1;
+}
+
+static void printCall(const Call *Call){
+    const Operation *op = &operations[Call->Op];
+    if (op->Kind == OP_ENUM) {
+        fprintf(stderr, "    %s(0x%02X)\n", op->Name, (unsigned)Call->Arg);
+    } else if (op->Kind == OP_NUMBER) {
+        fprintf(stderr, "    %s(%d)\n", op->Name, (int)Call->Arg);
+    } else if (op->Kind == OP_NUMBER_F) {
+        fprintf(stderr, "    %s(%g)\n", op->Name, (double)Call->Arg/op->ArgScale);
+    } else {
+        fprintf(stderr, "    %s()\n", op->Name);
+    }
+}
+
+// Removes calls while the sequence keeps failing, then reports it
+static void shrinkAndReport(Worker *Worker, Sequence *Sequence, uint64_t Index){
+    uint8_t reg;
+    uint32_t expected, actual;
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int i = 0; i < Sequence->Count && Sequence->Count > 1; ++i) {
+            Call removed = Sequence->Calls[i];
+            memmove(&Sequence->Calls[i],&Sequence->Calls[i + 1],(size_t)(Sequence->Count - i - 1)*sizeof(Call));
+            Sequence->Count--;
+            if (runSequence(Worker,Sequence,&reg,&expected,&actual) >= 0) {
+                changed = 1;
+                i--;
+            } else {
+                memmove(&Sequence->Calls[i + 1],&Sequence->Calls[i],(size_t)(Sequence->Count - i)*sizeof(Call));
+                Sequence->Calls[i] = removed;
+                Sequence->Count++;
+            }
+        }
+    }
+    int at = runSequence(Worker,Sequence,&reg,&expected,&actual);
+    pthread_mutex_lock(&reportLock);
+    fprintf(stderr, "Mismatch, replay with -s 0x%llX -r %llu (shrunk to %d calls):\n",
+            (unsigned long long)Worker->Rng, (unsigned long long)Index, Sequence->Count);
+    for (int i = 0; i < Sequence->Count; ++i) {
+        printCall(&Sequence->Calls[i]);
+    }
+    if (at < Sequence->Count) {
+        fprintf(stderr, "  %s returned 0x%X, the model expects 0x%X (%s = 0x%02X before)\n",
+                operations[Sequence->Calls[at].Op].Name, actual, expected, LM51772_RegisterName(reg),
+                Sequence->Initial[reg]);
+    } else {
+        fprintf(stderr, "  %s is 0x%02X, the model expects 0x%02X (0x%02X before)\n", LM51772_RegisterName(reg),
+                actual, expected, Sequence->Initial[reg]);
+    }
+    pthread_mutex_unlock(&reportLock);
+}
+
+static void *worker(void *Arg){
+    Worker *worker = (Worker *)Arg;
+    SimBus_Init(&worker->Bus,&worker->Transport);
+    SimLM51772_Init(&worker->Device,LM51772_I2CADDR1);
+    SimBus_Attach(&worker->Bus,&worker->Device);
+    I2C_SetThreadTransport(&worker->Transport);
+    Sequence sequence;
+    while (!atomic_load_explicit(&failed,memory_order_relaxed)) {
+        uint64_t index = atomic_fetch_add(&sequencesTaken,1);
+        if (index >= sequencesWanted) {
+            break;
+        }
+        // Every sequence has its own generator, so any of them can be replayed
+        uint64_t rng = worker->Rng + (index + 1)*0x9E3779B97F4A7C15ull;
+        rng = rng ? rng : 1;
+        for (int i = 0; i < 256; i += 8) {
+            uint64_t r = xorshift(&rng);
+            memcpy(&sequence.Initial[i],&r,8);
+        }
+        sequence.Count = 1 + (int)(xorshift(&rng) % MAX_CALLS);
+        for (int i = 0; i < sequence.Count; ++i) {
+            randomCall(&rng,&sequence.Calls[i]);
+        }
+        uint8_t reg;
+        uint32_t expected, actual;
+        worker->Sequences++;
+        if (runSequence(worker,&sequence,&reg,&expected,&actual) >= 0) {
+            if (atomic_exchange(&failed,1) == 0) {
+                shrinkAndReport(worker,&sequence,index);
+            }
+            break;
+        }
+    }
+    I2C_SetThreadTransport(0);
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    int threads = 1;
+    uint64_t seed = 0x5EED;
+    long replay = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i],"-n") == 0 && i + 1 < argc) {
+            sequencesWanted = strtoull(argv[++i],0,0);
+        } else if (strcmp(argv[i],"-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i],0,0);
+        } else if (strcmp(argv[i],"-r") == 0 && i + 1 < argc) {
+            replay = atol(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [-n sequences] [-j threads] [-s seed] [-r sequence]\n", argv[0]);
+            return 2;
+        }
+    }
+    threads = (threads < 1) ? 1 : (threads > MAX_THREADS) ? MAX_THREADS : threads;
+    if (resolveMasks() < 0) {
+        return 2;
+    }
+    if (replay >= 0) {
+        // Only the given sequence
+        atomic_store(&sequencesTaken,(unsigned long long)replay);
+        sequencesWanted = (uint64_t)replay + 1;
+        threads = 1;
+    }
+    // The library prints while configuring
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null",O_WRONLY);
+    if (saved < 0 || devnull < 0) {
+        fprintf(stderr, "Cannot redirect the standard output\n");
+        return 2;
+    }
+    dup2(devnull,STDOUT_FILENO);
+    close(devnull);
+
+    static Worker workers[MAX_THREADS];
+    pthread_t ids[MAX_THREADS];
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    for (int i = 0; i < threads; ++i) {
+        workers[i].Rng = seed;
+        pthread_create(&ids[i],0,worker,&workers[i]);
+    }
+    uint64_t sequences = 0, calls = 0;
+    for (int i = 0; i < threads; ++i) {
+        pthread_join(ids[i],0);
+        sequences += workers[i].Sequences;
+        calls += workers[i].Calls;
+    }
+    clock_gettime(CLOCK_MONOTONIC,&t1);
+    double seconds = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec)/1e9;
+
+    fflush(stdout);
+    dup2(saved,STDOUT_FILENO);
+    close(saved);
+    printf("%llu sequences, %llu calls, %d operations, %.2f s: %.2e sequences/min, %s\n",
+           (unsigned long long)sequences, (unsigned long long)calls, OPERATION_COUNT, seconds,
+           sequences/seconds*60.0, atomic_load(&failed) ? "MISMATCH" : "no mismatch");
+    return atomic_load(&failed) ? 1 : 0;
+}
@@ -0,0 +1,501 @@
+//Include header file
+#include "regCache.h"
+#include "LM51772.h"
+#include "LM51772Regs.h"
+#include <string.h>
+
+// Largest run of clean registers a flush rewrites to join two block
+// writes, cheaper than the address and register bytes of a new one
+#define REGCACHE_FLUSH_GAP              2
+
+// Largest run of registers not asked for a snapshot reads to join two
+// block reads
+#define REGCACHE_SNAPSHOT_GAP           2
+
+static int cacheable(const RegCache *Cache, uint8_t Reg){
+    return Cache->TtlMs[Reg] == REGCACHE_STATIC;
+}
+
+// Registers whose writes can wait in write-behind mode: static
+// registers, apart from the ones holding CONV_EN
+static int deferrable(const RegCache *Cache, uint8_t Reg){
+    return cacheable(Cache,Reg) && Reg != USB_PD_CONTROL_0 && Reg != MFR_SPECIFIC_D0;
+}
+
+static int isValid(const RegCache *Cache, uint8_t SlaveAddress, uint8_t Reg){
+    return RegShadow_IsValid(&Cache->Shadow[SlaveAddress],Reg);
+}
+
+static int isDirty(const RegCache *Cache, uint8_t SlaveAddress, uint8_t Reg){
+    return (Cache->Dirty[SlaveAddress][Reg >> 3] >> (Reg & 0x07)) & 0x01;
+}
+
+static int isSampled(const RegCache *Cache, uint8_t SlaveAddress, uint8_t Reg){
+    return (Cache->Sampled[SlaveAddress][Reg >> 3] >> (Reg & 0x07)) & 0x01;
+}
+
+static int hasDirty(const RegCache *Cache, uint8_t SlaveAddress){
+    return (Cache->DirtyDevices[SlaveAddress >> 3] >> (SlaveAddress & 0x07)) & 0x01;
+}
+
+static void store(RegCache *Cache, uint8_t SlaveAddress, uint8_t Reg, uint8_t Value){
+    if (cacheable(Cache,Reg)) {
+        RegShadow_Store(&Cache->Shadow[SlaveAddress],Reg,Value);
+    }
+}
+
+// Keeps the value of a register written in write-behind mode
+static void defer(RegCache *Cache, uint8_t SlaveAddress, uint8_t Reg, uint8_t Value){
+    RegShadow_Store(&Cache->Shadow[SlaveAddress],Reg,Value);
+    Cache->Dirty[SlaveAddress][Reg >> 3] |= (uint8_t)(1 << (Reg & 0x07));
+    Cache->DirtyDevices[SlaveAddress >> 3] |= (uint8_t)(1 << (SlaveAddress & 0x07));
+}
+
+// A failed transfer forgets what was read from the device, the dirty
+// registers are kept since they still have to be written
+static int failed(RegCache *Cache, uint8_t SlaveAddress, int Status){
+    if (Status < 0) {
+        Cache->Errors++;
+        memcpy(Cache->Shadow[SlaveAddress].Valid,Cache->Dirty[SlaveAddress],sizeof(Cache->Dirty[0]));
+        memset(Cache->Sampled[SlaveAddress],0,sizeof(Cache->Sampled[0]));
+    }
+    return Status;
+}
+
+// Writes the dirty registers of a device, a block write per run of
+// registers. The registers of a failed write stay dirty.
+static int flushDevice(RegCache *Cache, uint8_t SlaveAddress){
+    uint8_t buff[257];
+    int result = I2C_OK;
+    int reg = 0;
+    while (reg < 256) {
+        if (!isDirty(Cache,SlaveAddress,(uint8_t)reg)) {
+            reg++;
+            continue;
+        }
+        // Run from the first dirty register up to the last one that is
+        // at most REGCACHE_FLUSH_GAP known clean registers away
+        int first = reg;
+        int last = reg;
+        int next = reg + 1;
+        while (next < 256 && next - last - 1 <= REGCACHE_FLUSH_GAP) {
+            if (isDirty(Cache,SlaveAddress,(uint8_t)next)) {
+                last = next;
+            } else if (!isValid(Cache,SlaveAddress,(uint8_t)next) || !deferrable(Cache,(uint8_t)next)) {
+                break;
+            }
+            next++;
+        }
+        uint16_t length = (uint16_t)(last - first + 1);
+        buff[0] = (uint8_t)first;
+        memcpy(&buff[1],&Cache->Shadow[SlaveAddress].Values[first],length);
+        int status = Cache->Inner->Write(Cache->Inner->Context,SlaveAddress,buff,(uint16_t)(length + 1));
+        Cache->Flushes++;
+        if (failed(Cache,SlaveAddress,status) < 0) {
+            result = status;
+        } else {
+            for (int i = first; i <= last; ++i) {
+                Cache->Dirty[SlaveAddress][i >> 3] &= (uint8_t)~(1 << (i & 0x07));
+            }
+        }
+        reg = last + 1;
+    }
+    if (result == I2C_OK) {
+        Cache->DirtyDevices[SlaveAddress >> 3] &= (uint8_t)~(1 << (SlaveAddress & 0x07));
+    }
+    return result;
+}
+
+static int innerWriteRead(RegCache *Cache, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    if (Cache->Inner->WriteRead != 0) {
+        return Cache->Inner->WriteRead(Cache->Inner->Context,SlaveAddress,WData,WLength,RData,RLength);
+    }
+    int status = Cache->Inner->Write(Cache->Inner->Context,SlaveAddress,WData,WLength);
+    return (status < 0) ? status : Cache->Inner->Read(Cache->Inner->Context,SlaveAddress,RData,RLength);
+}
+
+static int cacheWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    RegCache *Cache = (RegCache *)Context;
+    SlaveAddress &= 0x7F;
+    if (Cache->WriteBehind && Length > 1 && Data[0] + Length - 1 <= 256) {
+        int later = 1;
+        for (uint16_t i = 1; i < Length && later; ++i) {
+            later = deferrable(Cache,(uint8_t)(Data[0] + i - 1));
+        }
+        if (later) {
+            for (uint16_t i = 1; i < Length; ++i) {
+                defer(Cache,SlaveAddress,(uint8_t)(Data[0] + i - 1),Data[i]);
+            }
+            Cache->Deferred++;
+            return I2C_OK;
+        }
+    }
+    // Barrier: what was written before reaches the device first
+    if (hasDirty(Cache,SlaveAddress)) {
+        int status = flushDevice(Cache,SlaveAddress);
+        if (status < 0) {
+            return status;
+        }
+    }
+    int status = Cache->Inner->Write(Cache->Inner->Context,SlaveAddress,Data,Length);
+    if (failed(Cache,SlaveAddress,status) < 0) {
+        return status;
+    }
+    // Register address followed by the values, auto-incrementing. The
+    // next snapshot reads back what the device made of the other ones.
+    for (uint16_t i = 1; i < Length; ++i) {
+        uint8_t reg = (uint8_t)(Data[0] + i - 1);
+        store(Cache,SlaveAddress,reg,Data[i]);
+        Cache->Sampled[SlaveAddress][reg >> 3] &= (uint8_t)~(1 << (reg & 0x07));
+    }
+    return status;
+}
+
+static int cacheRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    RegCache *Cache = (RegCache *)Context;
+    // The register pointer is unknown here, nothing can be cached
+    return failed(Cache,SlaveAddress & 0x7F,Cache->Inner->Read(Cache->Inner->Context,SlaveAddress,Data,Length));
+}
+
+static int cacheWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    RegCache *Cache = (RegCache *)Context;
+    SlaveAddress &= 0x7F;
+    if (WLength == 1 && RLength > 0 && WData[0] + RLength <= 256) {
+        uint8_t reg = WData[0];
+        int hit = 1;
+        for (uint16_t i = 0; i < RLength && hit; ++i) {
+            hit = isValid(Cache,SlaveAddress,(uint8_t)(reg + i));
+        }
+        if (hit) {
+            memcpy(RData,&Cache->Shadow[SlaveAddress].Values[reg],RLength);
+            Cache->Hits++;
+            return I2C_OK;
+        }
+    }
+    // A write of more than the register address is written in order
+    if (WLength > 1 && hasDirty(Cache,SlaveAddress)) {
+        int status = flushDevice(Cache,SlaveAddress);
+        if (status < 0) {
+            return status;
+        }
+    }
+    Cache->Misses++;
+    int status = innerWriteRead(Cache,SlaveAddress,WData,WLength,RData,RLength);
+    if (failed(Cache,SlaveAddress,status) < 0) {
+        return status;
+    }
+    if (WLength == 1) {
+        for (uint16_t i = 0; i < RLength && WData[0] + i < 256; ++i) {
+            uint8_t reg = (uint8_t)(WData[0] + i);
+            // The device does not have the dirty values yet
+            if (isDirty(Cache,SlaveAddress,reg)) {
+                RData[i] = Cache->Shadow[SlaveAddress].Values[reg];
+            } else {
+                store(Cache,SlaveAddress,reg,RData[i]);
+            }
+        }
+    }
+    return status;
+}
+
+static int cacheQuick(void *Context, uint8_t SlaveAddress){
+    RegCache *Cache = (RegCache *)Context;
+    return failed(Cache,SlaveAddress & 0x7F,Cache->Inner->Quick(Cache->Inner->Context,SlaveAddress));
+}
+
+static void cacheDelay(void *Context, uint32_t Microseconds){
+    RegCache *Cache = (RegCache *)Context;
+    if (Cache->Inner->Delay != 0) {
+        Cache->Inner->Delay(Cache->Inner->Context,Microseconds);
+    }
+}
+
+static int cacheFlush(void *Context, uint8_t SlaveAddress){
+    return RegCache_Flush((RegCache *)Context,SlaveAddress);
+}
+
+/******************************************
+* @brief: Returns the default freshness policy of a register
+* @param Map: register map of the chip (const ChipMap *)
+* @param Reg: register address (uint8_t)
+* @note: Registers whose value only changes when written are
+*        REGCACHE_STATIC, the others are REGCACHE_LIVE.
+*******************************************/
+uint32_t RegCache_DefaultPolicy(const ChipMap *Map, uint8_t Reg){
+    const Chip_RegisterDesc *desc = Chip_FindRegister(Map,Reg);
+    if (desc != 0 && (desc->Flags & REG_RW) && !(desc->Flags & REG_VOLATILE)) {
+        return REGCACHE_STATIC;
+    }
+    return REGCACHE_LIVE;
+}
+
+/******************************************
+* @brief: Initializes an empty register cache
+* @param Cache: cache context (RegCache *)
+* @param Inner: bus backend the misses and writes go to (const I2C_Transport *)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*        Writes reach the bus right away (write-through) until
+*        write-behind is switched on with RegCache_SetWriteBehind().
+*******************************************/
+void RegCache_Init(RegCache *Cache, const I2C_Transport *Inner, I2C_Transport *Transport){
+    memset(Cache,0,sizeof(*Cache));
+    Cache->Inner = Inner;
+    for (int reg = 0; reg < 256; ++reg) {
+        Cache->TtlMs[reg] = RegCache_DefaultPolicy(&LM51772_Map,(uint8_t)reg);
+    }
+    Transport->Write = cacheWrite;
+    Transport->Read = cacheRead;
+    Transport->WriteRead = cacheWriteRead;
+    // Messages of combined transactions go through cacheWrite/cacheRead
+    Transport->Transfer = 0;
+    Transport->Quick = cacheQuick;
+    Transport->Delay = cacheDelay;
+    Transport->Flush = cacheFlush;
+    Transport->Context = Cache;
+}
+
+/******************************************
+* @brief: Forgets the cached registers of a device
+* @param Cache: cache context (RegCache *)
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @note: Dirty registers are dropped as well, flush them first if
+*        they still have to reach the device.
+*******************************************/
+void RegCache_Invalidate(RegCache *Cache, uint8_t SlaveAddress){
+    SlaveAddress &= 0x7F;
+    RegShadow_Clear(&Cache->Shadow[SlaveAddress]);
+    memset(Cache->Sampled[SlaveAddress],0,sizeof(Cache->Sampled[0]));
+    memset(Cache->Dirty[SlaveAddress],0,sizeof(Cache->Dirty[0]));
+    Cache->DirtyDevices[SlaveAddress >> 3] &= (uint8_t)~(1 << (SlaveAddress & 0x07));
+}
+
+/******************************************
+* @brief: Forgets the cached registers of every device
+* @param Cache: cache context (RegCache *)
+*******************************************/
+void RegCache_InvalidateAll(RegCache *Cache){
+    for (int address = 0; address < 128; ++address) {
+        RegShadow_Clear(&Cache->Shadow[address]);
+    }
+    memset(Cache->Sampled,0,sizeof(Cache->Sampled));
+    memset(Cache->Dirty,0,sizeof(Cache->Dirty));
+    memset(Cache->DirtyDevices,0,sizeof(Cache->DirtyDevices));
+    Cache->Pending = 0;
+}
+
+/******************************************
+* @brief: Switches write-behind on or off
+* @param Cache: cache context (RegCache *)
+* @param Enable: 1 to keep configuration writes in the shadow, 0 for
+*                write-through (uint8_t)
+* @param DeadlineUs: longest time dirty registers wait, counted from
+*                    the first RegCache_Poll() seeing them, 0 flushes
+*                    them at every poll (uint32_t)
+* @note: Switching it off flushes every device first. Returns I2C_OK
+*        or the error of the flush.
+*******************************************/
+int RegCache_SetWriteBehind(RegCache *Cache, uint8_t Enable, uint32_t DeadlineUs){
+    int status = I2C_OK;
+    if (!Enable) {
+        status = RegCache_Flush(Cache,I2C_FLUSH_ALL);
+    }
+    Cache->WriteBehind = Enable ? 1 : 0;
+    Cache->DeadlineUs = DeadlineUs;
+    return status;
+}
+
+/******************************************
+* @brief: Flushes the dirty registers once their deadline has passed
+* @param Cache: cache context (RegCache *)
+* @param NowUs: current time in microseconds, any monotonic clock (uint64_t)
+* @note: Meant to be called periodically by the control loop, the
+*        cache has no clock of its own. Returns I2C_OK or the error of
+*        the flush, the registers then stay dirty for the next poll.
+*******************************************/
+int RegCache_Poll(RegCache *Cache, uint64_t NowUs){
+    int dirty = 0;
+    for (int i = 0; i < 16 && !dirty; ++i) {
+        dirty = Cache->DirtyDevices[i] != 0;
+    }
+    if (!dirty) {
+        Cache->Pending = 0;
+        return I2C_OK;
+    }
+    if (!Cache->Pending) {
+        Cache->Pending = 1;
+        Cache->PendingSinceUs = NowUs;
+    }
+    if (NowUs - Cache->PendingSinceUs < Cache->DeadlineUs) {
+        return I2C_OK;
+    }
+    int status = RegCache_Flush(Cache,I2C_FLUSH_ALL);
+    if (status == I2C_OK) {
+        Cache->Pending = 0;
+    }
+    return status;
+}
+
+/******************************************
+* @brief: Writes the dirty registers to the devices now
+* @param Cache: cache context (RegCache *)
+* @param SlaveAddress: 7 bit I2C address of the device, I2C_FLUSH_ALL
+*                      for every device (uint8_t)
+* @note: Every register gets its last written value, a run of
+*        neighbouring registers goes out as one block write in
+*        ascending register order. Returns I2C_OK or the first error,
+*        the registers of a failed write stay dirty.
+*******************************************/
+int RegCache_Flush(RegCache *Cache, uint8_t SlaveAddress){
+    if (SlaveAddress != I2C_FLUSH_ALL) {
+        SlaveAddress &= 0x7F;
+        return hasDirty(Cache,SlaveAddress) ? flushDevice(Cache,SlaveAddress) : I2C_OK;
+    }
+    int result = I2C_OK;
+    for (uint8_t address = 0; address < 0x80; ++address) {
+        if (hasDirty(Cache,address)) {
+            int status = flushDevice(Cache,address);
+            result = (result == I2C_OK) ? status : result;
+        }
+    }
+    return result;
+}
+
+/******************************************
+* @brief: Sets the freshness policy of a register
+* @param Cache: cache context (RegCache *)
+* @param Reg: register address (uint8_t)
+* @param TtlMs: REGCACHE_STATIC, REGCACHE_LIVE or the time in ms a
+*               value read by a snapshot stays fresh (uint32_t)
+* @note: The policy holds for every device of the cache. Only static
+*        registers serve plain reads and take write-behind writes, a
+*        register leaving the static policy is forgotten. A TTL takes
+*        one of the REGCACHE_TTL_SLOTS slots of snapshot times until
+*        the register gets another policy. Returns I2C_OK, or
+*        REGCACHE_ERR_SLOTS with the policy unchanged if every slot is
+*        taken.
+*******************************************/
+int RegCache_SetPolicy(RegCache *Cache, uint8_t Reg, uint32_t TtlMs){
+    int slot = 0;
+    if (TtlMs != REGCACHE_STATIC && TtlMs != REGCACHE_LIVE) {
+        slot = Cache->TtlSlot[Reg];
+        if (slot == 0) {
+            uint8_t used[REGCACHE_TTL_SLOTS];
+            memset(used,0,sizeof(used));
+            for (int reg = 0; reg < 256; ++reg) {
+                if (Cache->TtlSlot[reg] != 0) {
+                    used[Cache->TtlSlot[reg] - 1] = 1;
+                }
+            }
+            while (slot < REGCACHE_TTL_SLOTS && used[slot]) {
+                slot++;
+            }
+            if (slot == REGCACHE_TTL_SLOTS) {
+                return REGCACHE_ERR_SLOTS;
+            }
+            slot++;
+        }
+    }
+    if (TtlMs != REGCACHE_STATIC && Cache->TtlMs[Reg] == REGCACHE_STATIC) {
+        RegCache_Flush(Cache,I2C_FLUSH_ALL);
+        for (int address = 0; address < 128; ++address) {
+            RegShadow_Forget(&Cache->Shadow[address],Reg);
+        }
+    }
+    // Samples taken under the old policy do not count
+    for (int address = 0; address < 128; ++address) {
+        Cache->Sampled[address][Reg >> 3] &= (uint8_t)~(1 << (Reg & 0x07));
+    }
+    Cache->TtlSlot[Reg] = (uint8_t)slot;
+    Cache->TtlMs[Reg] = TtlMs;
+    return I2C_OK;
+}
+
+// Registers a snapshot has to read: live ones, unknown static ones and
+// TTL ones that expired. Dirty registers are served from the shadow.
+static int expired(const RegCache *Cache, uint8_t SlaveAddress, uint8_t Reg, uint32_t NowMs){
+    uint32_t ttl = Cache->TtlMs[Reg];
+    if (isDirty(Cache,SlaveAddress,Reg)) {
+        return 0;
+    }
+    if (ttl == REGCACHE_STATIC) {
+        return !isValid(Cache,SlaveAddress,Reg);
+    }
+    return ttl == REGCACHE_LIVE || !isSampled(Cache,SlaveAddress,Reg) ||
+           (uint32_t)(NowMs - Cache->ReadMs[SlaveAddress][Cache->TtlSlot[Reg] - 1]) >= ttl;
+}
+
+/******************************************
+* @brief: Reads a set of registers of a device, as fresh as their policy
+* @param Cache: cache context (RegCache *)
+* @param SlaveAddress: 7 bit I2C address of the device (uint8_t)
+* @param Regs: register addresses, any order (const uint8_t *)
+* @param Count: number of registers (uint16_t)
+* @param NowUs: current time in microseconds, any monotonic clock (uint64_t)
+* @param Values: destination, Values[i] for Regs[i] (uint8_t *)
+* @note: Only the registers whose cached value expired go to the bus,
+*        a run of neighbouring ones as one block read that may also
+*        cover up to REGCACHE_SNAPSHOT_GAP readable registers in
+*        between. Returns I2C_OK or the first error, Values is not
+*        complete then.
+*******************************************/
+int RegCache_Snapshot(RegCache *Cache, uint8_t SlaveAddress, const uint8_t *Regs, uint16_t Count, uint64_t NowUs, uint8_t *Values){
+    SlaveAddress &= 0x7F;
+    uint32_t nowMs = (uint32_t)(NowUs/1000u);
+    uint8_t wanted[32];
+    memset(wanted,0,sizeof(wanted));
+    for (uint16_t i = 0; i < Count; ++i) {
+        if (expired(Cache,SlaveAddress,Regs[i],nowMs)) {
+            wanted[Regs[i] >> 3] |= (uint8_t)(1 << (Regs[i] & 0x07));
+        } else {
+            Cache->Fresh++;
+        }
+    }
+    int reg = 0;
+    while (reg < 256) {
+        if (!((wanted[reg >> 3] >> (reg & 0x07)) & 0x01)) {
+            reg++;
+            continue;
+        }
+        // Run up to the last wanted register at most
+        // REGCACHE_SNAPSHOT_GAP readable registers away
+        int first = reg;
+        int last = reg;
+        int next = reg + 1;
+        while (next < 256 && next - last - 1 <= REGCACHE_SNAPSHOT_GAP) {
+            if ((wanted[next >> 3] >> (next & 0x07)) & 0x01) {
+                last = next;
+            } else if (!Chip_Readable(&LM51772_Map,(uint8_t)next)) {
+                break;
+            }
+            next++;
+        }
+        uint8_t address = (uint8_t)first;
+        uint8_t data[256];
+        uint16_t length = (uint16_t)(last - first + 1);
+        int status = innerWriteRead(Cache,SlaveAddress,&address,1,data,length);
+        Cache->BlockReads++;
+        if (failed(Cache,SlaveAddress,status) < 0) {
+            return status;
+        }
+        for (int i = first; i <= last; ++i) {
+            if (isDirty(Cache,SlaveAddress,(uint8_t)i)) {
+                continue;
+            }
+            if (cacheable(Cache,(uint8_t)i)) {
+                RegShadow_Store(&Cache->Shadow[SlaveAddress],(uint8_t)i,data[i - first]);
+            } else {
+                Cache->Shadow[SlaveAddress].Values[i] = data[i - first];
+                Cache->Sampled[SlaveAddress][i >> 3] |= (uint8_t)(1 << (i & 0x07));
+                if (Cache->TtlSlot[i] != 0) {
+                    Cache->ReadMs[SlaveAddress][Cache->TtlSlot[i] - 1] = nowMs;
+                }
+            }
+        }
+        reg = last + 1;
+    }
+    for (uint16_t i = 0; i < Count; ++i) {
+        Values[i] = Cache->Shadow[SlaveAddress].Values[Regs[i]];
+    }
+    return I2C_OK;
+}
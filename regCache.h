@@ -0,0 +1,120 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+#include "chipMap.h"
+
+#ifndef REG_CACHE_H
+#define REG_CACHE_H
+
+// Register shadow cache, a transport placed between the driver and a bus
+// backend. Register writes are recorded in a shadow copy per device and
+// register reads are served from it when every register asked for is
+// known, so read-modify-write functions of the driver cost one transfer
+// instead of two once the cache is warm.
+// Every register has a freshness policy. Static registers only change
+// when written: by default the plain configuration registers (REG_RW and
+// not REG_VOLATILE in LM51772Regs.h), the only ones cached for plain
+// reads. Live registers (by default the status registers) always go to
+// the bus. A TTL policy lets RegCache_Snapshot() reuse a value read up to
+// that many ms ago. A snapshot of a set of registers only reads the
+// expired ones, neighbouring registers in one block read, so steady
+// state telemetry only costs the registers that actually change.
+// A failed transfer drops everything cached for that device, since it may
+// have been reset or power cycled, apart from the dirty registers.
+// Hits do not move the register pointer of the device, so plain reads
+// continuing at the pointer (I2C_ReadBlock) must not follow cached reads.
+// In write-behind mode writes of configuration registers only update the
+// shadow and mark the registers dirty, repeated writes of a register
+// collapse into one. RegCache_Poll() (cadence or deadline) and
+// RegCache_Flush() send the final value of every dirty register, runs of
+// neighbouring registers as one block write. Writes of the registers
+// holding CONV_EN (USB_PD_CONTROL_0, MFR_SPECIFIC_D0) and of status and
+// command registers are barriers: the dirty registers of the device go
+// out first, so EnablePowerStage() always finds the device configured.
+// LM51772_Barrier() (I2C_Flush()) forces the same at any other point.
+
+// The shadow of a device (RegShadow) and the default policies are also
+// used by the register engine (regEngine.h).
+
+// Freshness policies, any other value is a TTL in ms
+#define REGCACHE_LIVE                   0           // Read every time
+#define REGCACHE_STATIC                 0xFFFFFFFF  // Only changes when written
+
+// Registers that can have a TTL policy at the same time, each one takes a
+// slot of snapshot times (4 bytes per device)
+#ifndef REGCACHE_TTL_SLOTS
+#define REGCACHE_TTL_SLOTS              8
+#endif
+
+// Status code besides the I2C_* codes of i2cTransport.h
+#define REGCACHE_ERR_SLOTS              -10 // Every TTL slot is taken
+
+// Shadow of the registers of one device
+typedef struct{
+    uint8_t Values[256];                // Last known register values
+    uint8_t Valid[32];                  // Bitmap of the known registers
+} RegShadow;
+
+static inline int RegShadow_IsValid(const RegShadow *Shadow, uint8_t Reg){
+    return (Shadow->Valid[Reg >> 3] >> (Reg & 0x07)) & 0x01;
+}
+
+static inline void RegShadow_Store(RegShadow *Shadow, uint8_t Reg, uint8_t Value){
+    Shadow->Values[Reg] = Value;
+    Shadow->Valid[Reg >> 3] |= (uint8_t)(1 << (Reg & 0x07));
+}
+
+static inline void RegShadow_Forget(RegShadow *Shadow, uint8_t Reg){
+    Shadow->Valid[Reg >> 3] &= (uint8_t)~(1 << (Reg & 0x07));
+}
+
+static inline void RegShadow_Clear(RegShadow *Shadow){
+    for (int i = 0; i < 32; ++i) {
+        Shadow->Valid[i] = 0;
+    }
+}
+
+typedef struct{
+    const I2C_Transport *Inner;         // Bus backend
+    RegShadow Shadow[128];              // Shadow registers per device
+    uint8_t Sampled[128][32];           // Bitmap of the TTL/live registers read by a snapshot
+    uint32_t ReadMs[128][REGCACHE_TTL_SLOTS]; // Snapshot time of the sampled TTL registers, per slot
+    uint32_t TtlMs[256];                // Freshness policy per register, REGCACHE_STATIC/LIVE or ms
+    uint8_t TtlSlot[256];               // Slot + 1 of the TTL registers, 0 for the others
+    uint8_t Dirty[128][32];             // Bitmap of the registers not written to the device yet
+    uint8_t DirtyDevices[16];           // Bitmap of the devices with dirty registers
+    // Write-behind
+    uint8_t WriteBehind;                // 0: write-through
+    uint8_t Pending;                    // PendingSinceUs is set
+    uint32_t DeadlineUs;                // Longest time dirty registers wait for RegCache_Poll()
+    uint64_t PendingSinceUs;            // Poll time the dirty registers were first seen
+    // Statistics
+    uint32_t Hits;                      // Reads served from the shadow
+    uint32_t Misses;                    // Reads sent to the bus
+    uint32_t Errors;                    // Failed transfers
+    uint32_t Deferred;                  // Register writes kept in the shadow
+    uint32_t Flushes;                   // Block writes sent by flushes
+    uint32_t BlockReads;                // Block reads sent by snapshots
+    uint32_t Fresh;                     // Snapshot registers served from the shadow
+} RegCache;
+
+// Default policy of a register of a chip: static for the configuration
+// registers (REG_RW and not REG_VOLATILE), live for the others
+uint32_t RegCache_DefaultPolicy(const ChipMap *Map, uint8_t Reg);
+// Initialization of an empty cache and of the transport pointing to it
+void RegCache_Init(RegCache *Cache, const I2C_Transport *Inner, I2C_Transport *Transport);
+// Forgetting the registers of a device (e.g. after a power cycle)
+void RegCache_Invalidate(RegCache *Cache, uint8_t SlaveAddress);
+// Forgetting every device
+void RegCache_InvalidateAll(RegCache *Cache);
+// Switching write-behind on or off, dirty registers wait up to DeadlineUs
+int RegCache_SetWriteBehind(RegCache *Cache, uint8_t Enable, uint32_t DeadlineUs);
+// Flushing dirty registers whose deadline has passed, NowUs from the caller
+int RegCache_Poll(RegCache *Cache, uint64_t NowUs);
+// Writing the dirty registers of a device now (I2C_FLUSH_ALL: every device)
+int RegCache_Flush(RegCache *Cache, uint8_t SlaveAddress);
+// Setting the freshness policy of a register (REGCACHE_STATIC/LIVE, TTL ms)
+int RegCache_SetPolicy(RegCache *Cache, uint8_t Reg, uint32_t TtlMs);
+// Reading the expired registers of a set and returning all of their values
+int RegCache_Snapshot(RegCache *Cache, uint8_t SlaveAddress, const uint8_t *Regs, uint16_t Count, uint64_t NowUs, uint8_t *Values);
+
+#endif // REG_CACHE_H
@@ -0,0 +1,410 @@
+//Include header file
+#include "regEngine.h"
+#include "i2cTransport.h"
+#include <string.h>
+
+static inline int isSet(const uint8_t *Bitmap, uint8_t Reg){
+    return (Bitmap[Reg >> 3] >> (Reg & 7)) & 1;
+}
+
+static inline void setBit(uint8_t *Bitmap, uint8_t Reg){
+    Bitmap[Reg >> 3] |= (uint8_t)(1 << (Reg & 7));
+}
+
+static inline int isKnown(const RegEngine_Device *Device, uint8_t Reg){
+    return isSet(Device->Cacheable,Reg) && RegShadow_IsValid(&Device->Shadow,Reg);
+}
+
+static int fieldShift(uint8_t Mask){
+    int shift = 0;
+    while (shift < 7 && ((Mask >> shift) & 1) == 0) {
+        shift++;
+    }
+    return shift;
+}
+
+static uint8_t pulseMask(const RegEngine_Device *Device, uint8_t Reg){
+    const Chip_RegisterDesc *desc = Chip_FindRegister(Device->Map,Reg);
+    return (desc != 0) ? desc->PulseMask : 0;
+}
+
+// A register a block write may include without being asked for: its value
+// is known and writing it again changes nothing
+static int rewritable(const RegEngine_Device *Device, uint8_t Reg){
+    return isKnown(Device,Reg) && (Device->Shadow.Values[Reg] & pulseMask(Device,Reg)) == 0;
+}
+
+/******************************************
+* @brief: Initializes a device of the register engine
+* @param Device: device context (RegEngine_Device *)
+* @param Map: register map of the chip (const ChipMap *)
+* @param I2CAddress: 7 bit address of the device (uint8_t)
+* @note: The shadow starts empty, the first access of every register
+*        goes to the bus (or use RegEngine_Prefetch()).
+*******************************************/
+void RegEngine_Init(RegEngine_Device *Device, const ChipMap *Map, uint8_t I2CAddress){
+    memset(Device,0,sizeof(*Device));
+    Device->Map = Map;
+    Device->I2CAddress = I2CAddress;
+    for (uint8_t i = 0; i < Map->RegisterCount; ++i) {
+        uint8_t reg = Map->Registers[i].Reg;
+        if (RegCache_DefaultPolicy(Map,reg) == REGCACHE_STATIC) {
+            setBit(Device->Cacheable,reg);
+        }
+    }
+}
+
+/******************************************
+* @brief: Forgets every register of a device
+* @param Device: device context (RegEngine_Device *)
+* @note: Called on every failed transfer, since the device may have
+*        been reset.
+*******************************************/
+void RegEngine_Invalidate(RegEngine_Device *Device){
+    RegShadow_Clear(&Device->Shadow);
+}
+
+/******************************************
+* @brief: Looks up a field of the device register map
+* @param Device: device context (const RegEngine_Device *)
+* @param Reg: register address (uint8_t)
+* @param Name: field name (const char *)
+* @note: Returns NULL if there is no such field.
+*******************************************/
+const Chip_FieldDesc *RegEngine_Field(const RegEngine_Device *Device, uint8_t Reg, const char *Name){
+    return Chip_FindField(Device->Map,Reg,Name);
+}
+
+/******************************************
+* @brief: Reads consecutive registers
+* @param Device: device context (RegEngine_Device *)
+* @param Reg: first register address (uint8_t)
+* @param Values: read values (uint8_t *)
+* @param Count: number of registers (uint8_t)
+* @note: Served from the shadow if every register is known, otherwise
+*        one block read, whose configuration registers are kept.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int RegEngine_ReadRegs(RegEngine_Device *Device, uint8_t Reg, uint8_t *Values, uint8_t Count){
+    if ((unsigned)Reg + Count > 256) {
+        return REG_ERR_ACCESS;
+    }
+    int known = 1;
+    for (unsigned i = 0; i < Count && known; ++i) {
+        known = isKnown(Device,(uint8_t)(Reg + i));
+    }
+    if (known) {
+        memcpy(Values,&Device->Shadow.Values[Reg],Count);
+        Device->Hits += Count;
+        return I2C_OK;
+    }
+    Device->Transfers++;
+    int status = I2C_ReadRegBlock(Device->I2CAddress,Reg,Values,Count);
+    if (status < 0) {
+        Device->Errors++;
+        RegEngine_Invalidate(Device);
+        return status;
+    }
+    for (unsigned i = 0; i < Count; ++i) {
+        uint8_t reg = (uint8_t)(Reg + i);
+        if (isSet(Device->Cacheable,reg)) {
+            RegShadow_Store(&Device->Shadow,reg,Values[i]);
+        }
+    }
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Writes consecutive registers in one block write
+* @param Device: device context (RegEngine_Device *)
+* @param Reg: first register address (uint8_t)
+* @param Values: values to be written (const uint8_t *)
+* @param Count: number of registers (uint8_t)
+* @note: Always goes to the bus. Returns I2C_OK or a negative error
+*        code.
+*******************************************/
+int RegEngine_WriteRegs(RegEngine_Device *Device, uint8_t Reg, const uint8_t *Values, uint8_t Count){
+    if ((unsigned)Reg + Count > 256) {
+        return REG_ERR_ACCESS;
+    }
+    uint8_t buffer[257];
+    buffer[0] = Reg;
+    memcpy(&buffer[1],Values,Count);
+    Device->Transfers++;
+    int status = I2C_WriteBlock(Device->I2CAddress,buffer,(uint16_t)(Count + 1));
+    if (status < 0) {
+        Device->Errors++;
+        RegEngine_Invalidate(Device);
+        return status;
+    }
+    for (unsigned i = 0; i < Count; ++i) {
+        uint8_t reg = (uint8_t)(Reg + i);
+        if (isSet(Device->Cacheable,reg)) {
+            RegShadow_Store(&Device->Shadow,reg,Values[i] & (uint8_t)~pulseMask(Device,reg));
+        }
+    }
+    return I2C_OK;
+}
+
+// Reads the registers Regs[0..Count-1] (sorted) into Values with as few
+// block reads as possible, a block may span up to REGENGINE_MAX_GAP
+// readable registers that were not asked for
+static int readSorted(RegEngine_Device *Device, const uint8_t *Regs, uint8_t *Values, int Count){
+    uint8_t block[256];
+    int i = 0;
+    while (i < Count) {
+        int j = i;
+        while (j + 1 < Count) {
+            int gap = Regs[j + 1] - Regs[j] - 1;
+            int ok = gap <= REGENGINE_MAX_GAP;
+            for (int g = 1; ok && g <= gap; ++g) {
+                ok = Chip_Readable(Device->Map,(uint8_t)(Regs[j] + g));
+            }
+            if (!ok) {
+                break;
+            }
+            j++;
+        }
+        uint8_t first = Regs[i];
+        int status = RegEngine_ReadRegs(Device,first,block,(uint8_t)(Regs[j] - first + 1));
+        if (status < 0) {
+            return status;
+        }
+        for (int k = i; k <= j; ++k) {
+            Values[k] = block[Regs[k] - first];
+        }
+        i = j + 1;
+    }
+    return I2C_OK;
+}
+
+// Registers touched by a batch of fields, sorted by address
+typedef struct{
+    int Count;
+    uint8_t Reg[REGENGINE_MAX_BATCH];
+    uint8_t Mask[REGENGINE_MAX_BATCH];  // Bits of the fields in the batch
+    uint8_t Bits[REGENGINE_MAX_BATCH];  // Their new values
+} Batch;
+
+static int addField(Batch *Batch, const Chip_FieldDesc *Field, uint8_t Value){
+    int i = 0;
+    while (i < Batch->Count && Batch->Reg[i] < Field->Reg) {
+        i++;
+    }
+    if (i == Batch->Count || Batch->Reg[i] != Field->Reg) {
+        memmove(&Batch->Reg[i + 1],&Batch->Reg[i],(size_t)(Batch->Count - i));
+        memmove(&Batch->Mask[i + 1],&Batch->Mask[i],(size_t)(Batch->Count - i));
+        memmove(&Batch->Bits[i + 1],&Batch->Bits[i],(size_t)(Batch->Count - i));
+        Batch->Reg[i] = Field->Reg;
+        Batch->Mask[i] = 0;
+        Batch->Bits[i] = 0;
+        Batch->Count++;
+    }
+    uint8_t bits = (uint8_t)(Value << fieldShift(Field->Mask));
+    Batch->Mask[i] |= Field->Mask;
+    Batch->Bits[i] = (uint8_t)((Batch->Bits[i] & ~Field->Mask) | (bits & Field->Mask));
+    return i;
+}
+
+/******************************************
+* @brief: Writes a batch of fields
+* @param Device: device context (RegEngine_Device *)
+* @param Values: fields and their values (const RegEngine_FieldValue *)
+* @param Count: number of fields, up to REGENGINE_MAX_BATCH (int)
+* @note: Fields are applied in order, so a later value of the same
+*        field wins. Fields of the same register are merged into one
+*        register write; configuration registers are read first only
+*        if unknown and only partially written, W1C and command
+*        registers get the field bits alone. Unchanged registers are
+*        not written and neighbouring ones go out in one block write.
+*        Nothing is written if a value does not fit its field
+*        (REG_ERR_FIELD) or a register is read only (REG_ERR_ACCESS).
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int RegEngine_WriteFields(RegEngine_Device *Device, const RegEngine_FieldValue *Values, int Count){
+    if (Count > REGENGINE_MAX_BATCH) {
+        return REG_ERR_BATCH;
+    }
+    Batch batch;
+    batch.Count = 0;
+    for (int i = 0; i < Count; ++i) {
+        const Chip_FieldDesc *field = Values[i].Field;
+        if ((Values[i].Value & ~(field->Mask >> fieldShift(field->Mask))) != 0) {
+            return REG_ERR_FIELD;
+        }
+        const Chip_RegisterDesc *desc = Chip_FindRegister(Device->Map,field->Reg);
+        if (desc == 0 || (desc->Flags & REG_RO)) {
+            return REG_ERR_ACCESS;
+        }
+        addField(&batch,field,Values[i].Value);
+    }
+
+    // Current values of the partially written registers that are unknown
+    uint8_t value[REGENGINE_MAX_BATCH];
+    uint8_t missing[REGENGINE_MAX_BATCH], old[REGENGINE_MAX_BATCH];
+    int index[REGENGINE_MAX_BATCH];
+    int missingCount = 0;
+    for (int i = 0; i < batch.Count; ++i) {
+        uint8_t reg = batch.Reg[i];
+        const Chip_RegisterDesc *desc = Chip_FindRegister(Device->Map,reg);
+        value[i] = 0;
+        if (!(desc->Flags & REG_RW) || batch.Mask[i] == 0xFF) {
+            continue;
+        }
+        if (isKnown(Device,reg)) {
+            value[i] = Device->Shadow.Values[reg];
+        } else {
+            index[missingCount] = i;
+            missing[missingCount++] = reg;
+        }
+    }
+    int status = (missingCount > 0) ? readSorted(Device,missing,old,missingCount) : I2C_OK;
+    if (status < 0) {
+        return status;
+    }
+    for (int k = 0; k < missingCount; ++k) {
+        value[index[k]] = old[k];
+    }
+
+    // New values, registers left as they are drop out
+    uint8_t changed[REGENGINE_MAX_BATCH];
+    for (int i = 0; i < batch.Count; ++i) {
+        uint8_t reg = batch.Reg[i];
+        value[i] = (uint8_t)((value[i] & ~batch.Mask[i]) | batch.Bits[i]);
+        changed[i] = !(isKnown(Device,reg) && Device->Shadow.Values[reg] == value[i] && (value[i] & pulseMask(Device,reg)) == 0);
+        if (!changed[i]) {
+            Device->Skipped++;
+        }
+    }
+
+    // Block writes over neighbouring changed registers
+    uint8_t block[256];
+    int i = 0;
+    while (i < batch.Count) {
+        if (!changed[i]) {
+            i++;
+            continue;
+        }
+        int last = i;
+        for (int j = i + 1; j < batch.Count; ++j) {
+            if (!changed[j]) {
+                continue;
+            }
+            int gap = batch.Reg[j] - batch.Reg[last] - 1;
+            int ok = gap <= REGENGINE_MAX_GAP;
+            for (int g = 1; ok && g <= gap; ++g) {
+                ok = rewritable(Device,(uint8_t)(batch.Reg[last] + g));
+            }
+            if (!ok) {
+                break;
+            }
+            last = j;
+        }
+        uint8_t first = batch.Reg[i];
+        uint8_t length = (uint8_t)(batch.Reg[last] - first + 1);
+        for (unsigned k = 0; k < length; ++k) {
+            block[k] = Device->Shadow.Values[first + k];
+        }
+        for (int k = i; k <= last; ++k) {
+            block[batch.Reg[k] - first] = value[k];
+        }
+        status = RegEngine_WriteRegs(Device,first,block,length);
+        if (status < 0) {
+            return status;
+        }
+        i = last + 1;
+    }
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Reads a batch of fields
+* @param Device: device context (RegEngine_Device *)
+* @param Values: fields, their Value is filled in (RegEngine_FieldValue *)
+* @param Count: number of fields, up to REGENGINE_MAX_BATCH (int)
+* @note: Known configuration registers come from the shadow, the others
+*        are read with one block read per run of neighbouring
+*        registers. Returns I2C_OK or a negative error code.
+*******************************************/
+int RegEngine_ReadFields(RegEngine_Device *Device, RegEngine_FieldValue *Values, int Count){
+    if (Count > REGENGINE_MAX_BATCH) {
+        return REG_ERR_BATCH;
+    }
+    Batch batch;
+    batch.Count = 0;
+    for (int i = 0; i < Count; ++i) {
+        const Chip_RegisterDesc *desc = Chip_FindRegister(Device->Map,Values[i].Field->Reg);
+        if (desc == 0 || (desc->Flags & REG_CMD)) {
+            return REG_ERR_ACCESS;
+        }
+        addField(&batch,Values[i].Field,0);
+    }
+    uint8_t value[256];
+    uint8_t missing[REGENGINE_MAX_BATCH], read[REGENGINE_MAX_BATCH];
+    int missingCount = 0;
+    for (int i = 0; i < batch.Count; ++i) {
+        uint8_t reg = batch.Reg[i];
+        if (isKnown(Device,reg)) {
+            value[reg] = Device->Shadow.Values[reg];
+            Device->Hits++;
+        } else {
+            missing[missingCount++] = reg;
+        }
+    }
+    int status = (missingCount > 0) ? readSorted(Device,missing,read,missingCount) : I2C_OK;
+    if (status < 0) {
+        return status;
+    }
+    for (int k = 0; k < missingCount; ++k) {
+        value[missing[k]] = read[k];
+    }
+    for (int i = 0; i < Count; ++i) {
+        const Chip_FieldDesc *field = Values[i].Field;
+        Values[i].Value = (uint8_t)((value[field->Reg] & field->Mask) >> fieldShift(field->Mask));
+    }
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Writes one field
+* @param Device: device context (RegEngine_Device *)
+* @param Field: field of the chip map (const Chip_FieldDesc *)
+* @param Value: field value, right aligned (uint8_t)
+* @note: See RegEngine_WriteFields().
+*******************************************/
+int RegEngine_WriteField(RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t Value){
+    RegEngine_FieldValue value = {Field, Value};
+    return RegEngine_WriteFields(Device,&value,1);
+}
+
+/******************************************
+* @brief: Reads one field
+* @param Device: device context (RegEngine_Device *)
+* @param Field: field of the chip map (const Chip_FieldDesc *)
+* @param Value: field value, right aligned (uint8_t *)
+* @note: See RegEngine_ReadFields().
+*******************************************/
+int RegEngine_ReadField(RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t *Value){
+    RegEngine_FieldValue value = {Field, 0};
+    int status = RegEngine_ReadFields(Device,&value,1);
+    *Value = value.Value;
+    return status;
+}
+
+/******************************************
+* @brief: Loads every configuration register into the shadow
+* @param Device: device context (RegEngine_Device *)
+* @note: One block read per run of neighbouring registers of the map.
+*        Returns I2C_OK or a negative error code.
+*******************************************/
+int RegEngine_Prefetch(RegEngine_Device *Device){
+    uint8_t regs[256], values[256];
+    int count = 0;
+    for (uint8_t i = 0; i < Device->Map->RegisterCount; ++i) {
+        uint8_t reg = Device->Map->Registers[i].Reg;
+        if (isSet(Device->Cacheable,reg) && !RegShadow_IsValid(&Device->Shadow,reg)) {
+            regs[count++] = reg;
+        }
+    }
+    return readSorted(Device,regs,values,count);
+}
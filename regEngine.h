@@ -0,0 +1,69 @@
+#include <stdint.h>
+#include "chipMap.h"
+#include "regCache.h"
+
+#ifndef REG_ENGINE_H
+#define REG_ENGINE_H
+
+// Chip independent register engine. A device is a register map (chipMap.h)
+// at an I2C address; the engine reads and writes its registers and fields
+// through the selected transport (i2cTransport.h) and keeps a shadow of the
+// registers the default policy of the register cache makes static
+// (RegShadow and RegCache_DefaultPolicy of regCache.h), so that:
+//   - field writes are read-modify-writes without the read once the
+//     register is known, and registers left unchanged are not written,
+//   - the field values of a batch are merged per register and neighbouring
+//     registers go out in one block write (one read for the unknown ones),
+//   - reads of several fields become one block read per run of registers.
+// Bits listed in the PulseMask of a register (GO bits) are never kept in
+// the shadow, so writing them again always reaches the device.
+// Chip drivers on top of it only convert units to field values (see
+// LM51772Units.h and MPQ4210Units.h). A device must not be used by two
+// threads at once.
+
+// Status codes besides the I2C_* codes of i2cTransport.h
+#define REG_ERR_FIELD                   -5  // Value does not fit the field
+#define REG_ERR_ACCESS                  -6  // Register is not writable/readable
+#define REG_ERR_BATCH                   -7  // More fields than REGENGINE_MAX_BATCH
+
+#define REGENGINE_MAX_BATCH             32  // Fields per RegEngine_WriteFields/ReadFields
+#define REGENGINE_MAX_GAP               2   // Known registers a block write/read may span
+
+typedef struct{
+    const ChipMap *Map;                 // Register map of the chip
+    uint8_t I2CAddress;                 // 7 bit address
+    RegShadow Shadow;                   // Last known register values
+    uint8_t Cacheable[32];              // Bitmap of the static registers, kept in the shadow
+    // Statistics
+    uint32_t Transfers;                 // Transfers issued
+    uint32_t Hits;                      // Registers read from the shadow
+    uint32_t Skipped;                   // Registers not written, value unchanged
+    uint32_t Errors;                    // Failed transfers
+} RegEngine_Device;
+
+typedef struct{
+    const Chip_FieldDesc *Field;        // Field of the chip map
+    uint8_t Value;                      // Field value, right aligned
+} RegEngine_FieldValue;
+
+// Initialization of a device with an empty shadow
+void RegEngine_Init(RegEngine_Device *Device, const ChipMap *Map, uint8_t I2CAddress);
+// Forgetting every register (e.g. after a power cycle)
+void RegEngine_Invalidate(RegEngine_Device *Device);
+// Looking up a field of the device map, NULL if there is none
+const Chip_FieldDesc *RegEngine_Field(const RegEngine_Device *Device, uint8_t Reg, const char *Name);
+// Reading Count registers from Reg on, one block read unless all are known
+int RegEngine_ReadRegs(RegEngine_Device *Device, uint8_t Reg, uint8_t *Values, uint8_t Count);
+// Writing Count registers from Reg on in one block write
+int RegEngine_WriteRegs(RegEngine_Device *Device, uint8_t Reg, const uint8_t *Values, uint8_t Count);
+// Loading every configuration register into the shadow with block reads
+int RegEngine_Prefetch(RegEngine_Device *Device);
+// Writing a batch of fields, applied in order
+int RegEngine_WriteFields(RegEngine_Device *Device, const RegEngine_FieldValue *Values, int Count);
+// Reading a batch of fields into their Value
+int RegEngine_ReadFields(RegEngine_Device *Device, RegEngine_FieldValue *Values, int Count);
+// Single field access
+int RegEngine_WriteField(RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t Value);
+int RegEngine_ReadField(RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t *Value);
+
+#endif // REG_ENGINE_H
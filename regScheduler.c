@@ -0,0 +1,112 @@
+//Include header file
+#include "regScheduler.h"
+#include "i2cTransport.h"
+#include <string.h>
+
+/******************************************
+* @brief: Initializes an empty scheduler
+* @param Scheduler: scheduler context (RegScheduler *)
+*******************************************/
+void RegSched_Init(RegScheduler *Scheduler){
+    memset(Scheduler,0,sizeof(*Scheduler));
+}
+
+static int enqueue(RegScheduler *Scheduler, RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t Value, uint8_t *Result){
+    int status = I2C_OK;
+    if (Scheduler->Count == REGSCHED_MAX_JOBS) {
+        status = RegSched_Run(Scheduler);
+    }
+    RegSched_Job *job = &Scheduler->Jobs[Scheduler->Count++];
+    job->Device = Device;
+    job->Field = Field;
+    job->Value = Value;
+    job->Result = Result;
+    return status;
+}
+
+/******************************************
+* @brief: Queues a field write
+* @param Scheduler: scheduler context (RegScheduler *)
+* @param Device: device of the register engine (RegEngine_Device *)
+* @param Field: field of the device map (const Chip_FieldDesc *)
+* @param Value: field value, right aligned (uint8_t)
+* @note: Runs the queue first if it is full and returns the status of
+*        that run, I2C_OK otherwise.
+*******************************************/
+int RegSched_Write(RegScheduler *Scheduler, RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t Value){
+    return enqueue(Scheduler,Device,Field,Value,0);
+}
+
+/******************************************
+* @brief: Queues a field read
+* @param Scheduler: scheduler context (RegScheduler *)
+* @param Device: device of the register engine (RegEngine_Device *)
+* @param Field: field of the device map (const Chip_FieldDesc *)
+* @param Result: where the run stores the value (uint8_t *)
+* @note: As RegSched_Write().
+*******************************************/
+int RegSched_Read(RegScheduler *Scheduler, RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t *Result){
+    return enqueue(Scheduler,Device,Field,0,Result);
+}
+
+// Executes the jobs of one device, writes then reads, in
+// batches of REGENGINE_MAX_BATCH fields
+static int runDevice(RegScheduler *Scheduler, RegEngine_Device *Device){
+    RegEngine_FieldValue values[REGENGINE_MAX_BATCH];
+    uint8_t *results[REGENGINE_MAX_BATCH];
+    int first = I2C_OK;
+    for (int reads = 0; reads <= 1; ++reads) {
+        int count = 0;
+        for (int i = 0; i <= Scheduler->Count; ++i) {
+            const RegSched_Job *job = (i < Scheduler->Count) ? &Scheduler->Jobs[i] : 0;
+            int take = job != 0 && job->Device == Device && (job->Result != 0) == reads;
+            if (take) {
+                values[count].Field = job->Field;
+                values[count].Value = job->Value;
+                results[count++] = job->Result;
+            }
+            if (count == REGENGINE_MAX_BATCH || (job == 0 && count > 0)) {
+                int status = reads ? RegEngine_ReadFields(Device,values,count) : RegEngine_WriteFields(Device,values,count);
+                if (status < 0) {
+                    Scheduler->Failures++;
+                    first = (first < 0) ? first : status;
+                } else if (reads) {
+                    for (int k = 0; k < count; ++k) {
+                        *results[k] = values[k].Value;
+                    }
+                }
+                Scheduler->JobsDone += (uint32_t)count;
+                count = 0;
+            }
+        }
+    }
+    return first;
+}
+
+/******************************************
+* @brief: Executes every queued job
+* @param Scheduler: scheduler context (RegScheduler *)
+* @note: Devices are served in the order of their first job. A failed
+*        batch leaves its read results untouched and does not stop the
+*        other devices. Returns I2C_OK or the first error.
+*******************************************/
+int RegSched_Run(RegScheduler *Scheduler){
+    if (Scheduler->Count == 0) {
+        return I2C_OK;
+    }
+    Scheduler->Runs++;
+    int first = I2C_OK;
+    for (int i = 0; i < Scheduler->Count; ++i) {
+        RegEngine_Device *device = Scheduler->Jobs[i].Device;
+        int seen = 0;
+        for (int j = 0; j < i && !seen; ++j) {
+            seen = Scheduler->Jobs[j].Device == device;
+        }
+        if (!seen) {
+            int status = runDevice(Scheduler,device);
+            first = (first < 0) ? first : status;
+        }
+    }
+    Scheduler->Count = 0;
+    return first;
+}
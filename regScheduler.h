@@ -0,0 +1,42 @@
+#include <stdint.h>
+#include "regEngine.h"
+
+#ifndef REG_SCHEDULER_H
+#define REG_SCHEDULER_H
+
+// Bus scheduler shared by every device of the register engine, whatever
+// the chip. Field reads and writes are queued and executed together by
+// RegSched_Run(): per device, all queued writes become one
+// RegEngine_WriteFields() batch and all queued reads one
+// RegEngine_ReadFields() batch, so a profile touching many fields of a
+// mixed LM51772/MPQ4210 bus costs a few block transfers per device.
+// Reads return the value after every write queued in the same run.
+
+#define REGSCHED_MAX_JOBS               128
+
+typedef struct{
+    RegEngine_Device *Device;
+    const Chip_FieldDesc *Field;
+    uint8_t Value;                      // Value to be written
+    uint8_t *Result;                    // Read destination, NULL for a write
+} RegSched_Job;
+
+typedef struct{
+    RegSched_Job Jobs[REGSCHED_MAX_JOBS];
+    int Count;                          // Queued jobs
+    // Statistics
+    uint32_t Runs;                      // RegSched_Run() calls with work
+    uint32_t JobsDone;                  // Jobs executed
+    uint32_t Failures;                  // Device batches that failed
+} RegScheduler;
+
+// Initialization of an empty scheduler
+void RegSched_Init(RegScheduler *Scheduler);
+// Queueing a field write, runs the queue first if it is full
+int RegSched_Write(RegScheduler *Scheduler, RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t Value);
+// Queueing a field read, the value is stored in Result by the run
+int RegSched_Read(RegScheduler *Scheduler, RegEngine_Device *Device, const Chip_FieldDesc *Field, uint8_t *Result);
+// Executing every queued job, returns I2C_OK or the first error
+int RegSched_Run(RegScheduler *Scheduler);
+
+#endif // REG_SCHEDULER_H
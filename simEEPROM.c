@@ -0,0 +1,133 @@
+//Include header file
+#include "simEEPROM.h"
+#include <string.h>
+
+// Accounts the bus time of a transaction of Length bytes plus the address
+// byte, each byte takes 9 bit times and start/stop take one each
+static void accountTransfer(SimEEPROM *Sim, uint16_t Length){
+    Sim->NowNs += (uint64_t)((Length + 1) * 9 + 2) * SIM_I2C_BIT_TIME_NS;
+    Sim->BytesOnWire += Length + 1;
+}
+
+// Returns 1 if the device acknowledges its address at the current time
+static int addressAcked(SimEEPROM *Sim, uint8_t SlaveAddress){
+    if (SlaveAddress != Sim->I2CAddress || Sim->NowNs < Sim->BusyUntilNs) {
+        // Only the address byte goes on the wire
+        accountTransfer(Sim,0);
+        Sim->Nacks++;
+        return 0;
+    }
+    return 1;
+}
+
+static int simWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    SimEEPROM *Sim = (SimEEPROM *)Context;
+    if (!addressAcked(Sim,SlaveAddress)) {
+        return I2C_ERR_NACK;
+    }
+    accountTransfer(Sim,Length);
+    Sim->Transfers++;
+    if (Length < 2) {
+        // Address only partially sent, nothing changes
+        return I2C_OK;
+    }
+    Sim->AddressPointer = (uint16_t)(((Data[0] << 8) | Data[1]) % EEPROM_SIZE);
+    if (Length == 2) {
+        // Dummy write used to set the address pointer for a read
+        return I2C_OK;
+    }
+    // Page write: the column address rolls over inside the page
+    uint16_t pageBase = Sim->AddressPointer - (Sim->AddressPointer % EEPROM_PAGE_SIZE);
+    uint16_t column = Sim->AddressPointer % EEPROM_PAGE_SIZE;
+    uint16_t count = Length - 2;
+    if (Sim->TearAfter >= 0 && count > Sim->TearAfter) {
+        count = (uint16_t)Sim->TearAfter;
+    }
+    Sim->TearAfter = -1;
+    for (uint16_t i = 0; i < count; ++i) {
+        Sim->Memory[pageBase + column] = Data[2 + i];
+        column = (column + 1) % EEPROM_PAGE_SIZE;
+    }
+    Sim->AddressPointer = pageBase + column;
+    // The device goes deaf while the write cycle is in progress
+    Sim->BusyUntilNs = Sim->NowNs + Sim->WriteCycleNs;
+    Sim->WriteCycles++;
+    return I2C_OK;
+}
+
+static int simRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    SimEEPROM *Sim = (SimEEPROM *)Context;
+    if (!addressAcked(Sim,SlaveAddress)) {
+        return I2C_ERR_NACK;
+    }
+    accountTransfer(Sim,Length);
+    Sim->Transfers++;
+    // Sequential read, the address counter rolls over at the end of memory
+    for (uint16_t i = 0; i < Length; ++i) {
+        Data[i] = Sim->Memory[Sim->AddressPointer];
+        Sim->AddressPointer = (Sim->AddressPointer + 1) % EEPROM_SIZE;
+    }
+    return I2C_OK;
+}
+
+static int simQuick(void *Context, uint8_t SlaveAddress){
+    SimEEPROM *Sim = (SimEEPROM *)Context;
+    if (!addressAcked(Sim,SlaveAddress)) {
+        return I2C_ERR_NACK;
+    }
+    accountTransfer(Sim,0);
+    Sim->Transfers++;
+    return I2C_OK;
+}
+
+static void simDelay(void *Context, uint32_t Microseconds){
+    SimEEPROM *Sim = (SimEEPROM *)Context;
+    Sim->NowNs += (uint64_t)Microseconds * 1000;
+}
+
+/******************************************
+* @brief: Initializes a simulated EEPROM and its transport
+* @param Sim: simulated device (SimEEPROM *)
+* @param I2CAddress: 7 bit address the device answers to (uint8_t)
+* @param Transport: transport to be filled (I2C_Transport *)
+* @note: The memory starts erased (0xFF) and the write cycle lasts
+*        EEPROM_WRITE_CYCLE us. The transport still has to be selected
+*        with I2C_SetTransport().
+*******************************************/
+void SimEEPROM_Init(SimEEPROM *Sim, uint8_t I2CAddress, I2C_Transport *Transport){
+    memset(Sim,0,sizeof(*Sim));
+    memset(Sim->Memory,0xFF,sizeof(Sim->Memory));
+    Sim->I2CAddress = I2CAddress;
+    Sim->WriteCycleNs = (uint32_t)EEPROM_WRITE_CYCLE * 1000;
+    Sim->TearAfter = -1;
+    Transport->Write = simWrite;
+    Transport->Read = simRead;
+    Transport->WriteRead = 0;
+    Transport->Transfer = 0;
+    Transport->Quick = simQuick;
+    Transport->Delay = simDelay;
+    Transport->Flush = 0;
+    Transport->Context = Sim;
+}
+
+/******************************************
+* @brief: Resets the statistic counters of the simulated EEPROM
+* @param Sim: simulated device (SimEEPROM *)
+*******************************************/
+void SimEEPROM_ResetStats(SimEEPROM *Sim){
+    Sim->Transfers = 0;
+    Sim->Nacks = 0;
+    Sim->WriteCycles = 0;
+    Sim->BytesOnWire = 0;
+}
+
+/******************************************
+* @brief: Tears the next page write of the simulated EEPROM
+* @param Sim: simulated device (SimEEPROM *)
+* @param BytesKept: data bytes programmed before the power loss (int32_t)
+* @note: The following write only programs BytesKept bytes, the rest
+*        of the page keeps its previous contents. Pass -1 to cancel.
+*******************************************/
+void SimEEPROM_TearNextWrite(SimEEPROM *Sim, int32_t BytesKept){
+    Sim->TearAfter = BytesKept;
+}
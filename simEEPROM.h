@@ -0,0 +1,40 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+#include "EEPROM24Cxx.h"
+
+#ifndef SIM_EEPROM_H
+#define SIM_EEPROM_H
+
+// Simulated 24Cxx EEPROM behind an I2C transport. It models the page
+// roll-over, the sequential read address counter and the write cycle
+// during which the device does not acknowledge its address. Time is
+// virtual: every transfer advances the clock by its bus time and delays
+// advance it instead of sleeping, so benchmarks run instantly.
+
+// Bus timing used to account the transfers (100 kHz standard mode)
+#define SIM_I2C_BIT_TIME_NS             10000
+
+typedef struct{
+    uint8_t I2CAddress;                 // 7 bit address of the device
+    uint8_t Memory[EEPROM_SIZE];        // Memory contents
+    uint16_t AddressPointer;            // Internal address counter
+    uint64_t NowNs;                     // Virtual clock
+    uint64_t BusyUntilNs;               // End of the current write cycle
+    uint32_t WriteCycleNs;              // Duration of a write cycle
+    int32_t TearAfter;                  // Bytes kept by the next write, -1 if disabled
+    // Statistics
+    uint32_t Transfers;                 // Acknowledged transactions
+    uint32_t Nacks;                     // Not acknowledged transactions
+    uint32_t WriteCycles;               // Write cycles started
+    uint32_t BytesOnWire;               // Bytes sent/received incl. address byte
+} SimEEPROM;
+
+// Initialization of the simulated device (erased to 0xFF) and its transport
+void SimEEPROM_Init(SimEEPROM *Sim, uint8_t I2CAddress, I2C_Transport *Transport);
+// Resetting of the statistic counters
+void SimEEPROM_ResetStats(SimEEPROM *Sim);
+// Interrupting the next write after the given amount of data bytes, the
+// rest of the page keeps its old contents (models a power loss)
+void SimEEPROM_TearNextWrite(SimEEPROM *Sim, int32_t BytesKept);
+
+#endif // SIM_EEPROM_H
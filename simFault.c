@@ -0,0 +1,257 @@
+//Include header file
+#include "simFault.h"
+#include "LM51772.h"
+#include <string.h>
+
+/******************************************
+* @brief: Returns the next number of a xorshift64* generator
+* @param State: generator state, must not be 0 (uint64_t *)
+*******************************************/
+uint64_t SimFault_Rand(uint64_t *State){
+    uint64_t x = *State;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *State = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+// Uniform number in [0, Range), Range > 0
+static uint64_t randBelow(SimFault_Device *Device, uint64_t Range){
+    return SimFault_Rand(&Device->Rng) % Range;
+}
+
+// True with a probability of Ppm per million
+static int randChance(SimFault_Device *Device, uint32_t Ppm){
+    return Ppm != 0 && randBelow(Device,1000000) < Ppm;
+}
+
+// One of the flags set in Flags, picked at random
+static uint8_t randFlag(SimFault_Device *Device, uint8_t Flags){
+    int count = 0;
+    for (int i = 0; i < 8; ++i) {
+        count += (Flags >> i) & 1;
+    }
+    int pick = (int)randBelow(Device,(uint64_t)count);
+    for (int i = 0; i < 8; ++i) {
+        if (((Flags >> i) & 1) && pick-- == 0) {
+            return (uint8_t)(1u << i);
+        }
+    }
+    return 0;
+}
+
+static void planNextStatus(SimFault *Fault, SimFault_Device *Device, uint64_t FromNs){
+    if (Fault->Random.StatusMeanGapMs == 0) {
+        Device->NextStatusNs = UINT64_MAX;
+        return;
+    }
+    // Uniform gap with the requested mean
+    Device->NextStatusNs = FromNs + randBelow(Device,(uint64_t)Fault->Random.StatusMeanGapMs*2000000) + 1;
+}
+
+// Starts a status fault, replacing the one being applied
+static void startStatus(SimFault *Fault, SimLM51772 *Sim, SimFault_Device *Device, uint8_t Bits, uint64_t StartNs, uint32_t DurationUs, uint8_t Latched){
+    if (Device->StatusBits != 0 && !Device->StatusLatched) {
+        Sim->Regs[STATUS_BYTE] &= (uint8_t)~Device->StatusBits;
+    }
+    Device->StatusBits = Bits;
+    Device->StatusLatched = Latched;
+    Device->StatusEndNs = StartNs + (uint64_t)DurationUs*1000;
+    SimLM51772_RaiseFault(Sim,Bits);
+    Fault->Injected[SIM_FAULT_STATUS]++;
+}
+
+// Brings the status faults of a device up to the bus time
+static void updateStatus(SimFault *Fault, SimLM51772 *Sim, SimFault_Device *Device, uint64_t NowNs){
+    const SimFault_Random *random = &Fault->Random;
+    while (Device->NextStatusNs <= NowNs) {
+        uint8_t flags = (random->StatusFlags != 0) ? random->StatusFlags : SIM_FAULT_STATUS_FLAGS;
+        uint32_t duration = 1 + (uint32_t)randBelow(Device,(random->StatusMaxUs != 0) ? random->StatusMaxUs : 1);
+        startStatus(Fault,Sim,Device,randFlag(Device,flags),Device->NextStatusNs,duration,random->Latched);
+        planNextStatus(Fault,Device,Device->NextStatusNs);
+        if (Device->StatusEndNs <= NowNs && !Device->StatusLatched) {
+            // Came and went between two accesses
+            Sim->Regs[STATUS_BYTE] &= (uint8_t)~Device->StatusBits;
+            Device->StatusBits = 0;
+        }
+    }
+    if (Device->StatusBits == 0) {
+        return;
+    }
+    if (NowNs >= Device->StatusEndNs) {
+        // Condition gone, latched flags stay until the host clears them
+        if (!Device->StatusLatched) {
+            Sim->Regs[STATUS_BYTE] &= (uint8_t)~Device->StatusBits;
+        }
+        Device->StatusBits = 0;
+    } else {
+        // Condition still present, the flags set again if cleared
+        SimLM51772_RaiseFault(Sim,Device->StatusBits);
+    }
+}
+
+// Applies the scripted events due at the bus time
+static void advanceScript(SimFault *Fault, uint64_t NowNs){
+    while (Fault->ScriptNext < Fault->ScriptCount && Fault->Script[Fault->ScriptNext].TimeNs <= NowNs) {
+        const SimFault_Event *event = &Fault->Script[Fault->ScriptNext++];
+        uint8_t address = event->I2CAddress & 0x7F;
+        SimLM51772 *sim = Fault->Bus->Devices[address];
+        SimFault_Device *device = &Fault->Devices[address];
+        if (sim == 0) {
+            continue;
+        }
+        switch (event->Kind) {
+            case SIM_FAULT_STATUS:
+                startStatus(Fault,sim,device,event->Bits,event->TimeNs,event->DurationUs,event->Latched);
+                break;
+            case SIM_FAULT_NACK:
+                device->NackLeft = event->Count;
+                break;
+            case SIM_FAULT_CORRUPT:
+                device->CorruptLeft = event->Count;
+                device->CorruptBits = event->Bits;
+                break;
+            case SIM_FAULT_STRETCH:
+                device->StretchLeft = event->Count;
+                device->StretchUs = event->DurationUs;
+                break;
+            case SIM_FAULT_CORRUPT_WRITE:
+                device->WriteCorruptLeft = event->Count;
+                device->WriteCorruptBits = event->Bits;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static int faultHook(void *Context, SimI2CBus *Bus, SimLM51772 *Sim, int Phase, uint8_t *Data, uint16_t Length){
+    SimFault *Fault = (SimFault *)Context;
+    SimFault_Device *device = &Fault->Devices[Sim->I2CAddress & 0x7F];
+    const SimFault_Random *random = &Fault->Random;
+    if (Phase == SIM_PHASE_READ || Phase == SIM_PHASE_WRITE) {
+        int write = (Phase == SIM_PHASE_WRITE);
+        uint16_t *left = write ? &device->WriteCorruptLeft : &device->CorruptLeft;
+        int corrupt = 0;
+        uint8_t bits = 0;
+        if (*left > 0) {
+            (*left)--;
+            corrupt = 1;
+            bits = write ? device->WriteCorruptBits : device->CorruptBits;
+        } else {
+            corrupt = randChance(device,write ? random->WriteCorruptPpm : random->CorruptPpm);
+        }
+        if (corrupt && bits == 0) {
+            // One random bit flipped
+            bits = (uint8_t)(1u << randBelow(device,8));
+        }
+        if (bits != 0 && Length > 0) {
+            Data[randBelow(device,Length)] ^= bits;
+            Fault->Injected[write ? SIM_FAULT_CORRUPT_WRITE : SIM_FAULT_CORRUPT]++;
+        }
+        return I2C_OK;
+    }
+    advanceScript(Fault,Bus->NowNs);
+    updateStatus(Fault,Sim,device,Bus->NowNs);
+    // Clock stretching by the device delays the whole transfer
+    uint32_t stretchUs = 0;
+    if (device->StretchLeft > 0) {
+        device->StretchLeft--;
+        stretchUs = device->StretchUs;
+    } else if (randChance(device,random->StretchPpm)) {
+        stretchUs = 1 + (uint32_t)randBelow(device,(random->StretchMaxUs != 0) ? random->StretchMaxUs : 1);
+    }
+    if (stretchUs != 0) {
+        Bus->NowNs += (uint64_t)stretchUs*1000;
+        Fault->Injected[SIM_FAULT_STRETCH]++;
+    }
+    if (device->NackLeft > 0) {
+        device->NackLeft--;
+        Fault->Injected[SIM_FAULT_NACK]++;
+        return I2C_ERR_NACK;
+    }
+    if (randChance(device,random->NackPpm)) {
+        Fault->Injected[SIM_FAULT_NACK]++;
+        return I2C_ERR_NACK;
+    }
+    return I2C_OK;
+}
+
+/******************************************
+* @brief: Initializes a fault injector and hooks it to a bus
+* @param Fault: injector (SimFault *)
+* @param Bus: simulated bus, devices may be attached later (SimI2CBus *)
+* @param Seed: seed of the per device generators (uint64_t)
+* @note: No fault is injected until SimFault_Schedule() or
+*        SimFault_SetRandom() is called. The same seed, script and
+*        traffic give the same faults.
+*******************************************/
+void SimFault_Init(SimFault *Fault, SimI2CBus *Bus, uint64_t Seed){
+    memset(Fault,0,sizeof(*Fault));
+    Fault->Bus = Bus;
+    Fault->Seed = Seed;
+    for (int i = 0; i < 128; ++i) {
+        // splitmix64 of the seed and the address, never 0
+        uint64_t z = Seed + (uint64_t)(i + 1)*0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+        z ^= z >> 31;
+        Fault->Devices[i].Rng = (z != 0) ? z : 1;
+        Fault->Devices[i].NextStatusNs = UINT64_MAX;
+    }
+    SimBus_SetFaultHook(Bus,faultHook,Fault);
+}
+
+/******************************************
+* @brief: Sets the scripted fault events
+* @param Fault: injector (SimFault *)
+* @param Events: events sorted by TimeNs, kept by reference (const SimFault_Event *)
+* @param Count: number of events (int)
+* @note: Events are applied when the bus clock reaches them, on the
+*        next transfer or SimFault_Advance().
+*******************************************/
+void SimFault_Schedule(SimFault *Fault, const SimFault_Event *Events, int Count){
+    Fault->Script = Events;
+    Fault->ScriptCount = Count;
+    Fault->ScriptNext = 0;
+}
+
+/******************************************
+* @brief: Sets the rates of the random faults
+* @param Fault: injector (SimFault *)
+* @param Random: rates, copied (const SimFault_Random *)
+* @note: The first random status fault of every device is planned
+*        from the current bus time.
+*******************************************/
+void SimFault_SetRandom(SimFault *Fault, const SimFault_Random *Random){
+    Fault->Random = *Random;
+    for (int i = 0; i < 128; ++i) {
+        planNextStatus(Fault,&Fault->Devices[i],Fault->Bus->NowNs);
+    }
+}
+
+/******************************************
+* @brief: Applies every fault due at the current bus time
+* @param Fault: injector (SimFault *)
+* @note: Only needed to look at the registers directly, transfers
+*        bring the addressed device up to date by themselves.
+*******************************************/
+void SimFault_Advance(SimFault *Fault){
+    uint64_t now = Fault->Bus->NowNs;
+    advanceScript(Fault,now);
+    for (int i = 0; i < 128; ++i) {
+        if (Fault->Bus->Devices[i] != 0) {
+            updateStatus(Fault,Fault->Bus->Devices[i],&Fault->Devices[i],now);
+        }
+    }
+}
+
+/******************************************
+* @brief: Removes the injector from its bus
+* @param Fault: injector (SimFault *)
+* @note: Flags already raised in STATUS_BYTE stay.
+*******************************************/
+void SimFault_Detach(SimFault *Fault){
+    SimBus_SetFaultHook(Fault->Bus,0,0);
+}
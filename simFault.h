@@ -0,0 +1,93 @@
+#include <stdint.h>
+#include "simLM51772.h"
+
+#ifndef SIM_FAULT_H
+#define SIM_FAULT_H
+
+// Fault injector for a simulated LM51772 bus. It hooks the bus and, on the
+// bus clock, applies scripted events (a sorted table given by the caller)
+// and random faults: STATUS_BYTE flags raised for a while (OVP, OCP, IVP,
+// thermal, CML), NACKed transfers, corrupted read or write data and
+// stretched SCL.
+// Faults of a device are only evaluated when it is addressed, so the cost
+// per transfer does not depend on the number of devices and one process
+// can soak thousands of devices (one injector per bus of up to 127).
+// Every device has its own RNG derived from the seed and its address, the
+// faults it sees do not depend on the traffic to the other devices.
+
+// Kinds of fault
+#define SIM_FAULT_STATUS                0   // Raises Bits in STATUS_BYTE for DurationUs
+#define SIM_FAULT_NACK                  1   // NACKs the next Count transfers
+#define SIM_FAULT_CORRUPT               2   // XORs Bits into the next Count reads
+#define SIM_FAULT_STRETCH               3   // Stretches the next Count transfers by DurationUs
+#define SIM_FAULT_CORRUPT_WRITE         4   // XORs Bits into the next Count writes
+#define SIM_FAULT_KINDS                 5
+
+// STATUS_BYTE flags raised by random status faults
+#define SIM_FAULT_STATUS_FLAGS          (FLT_OVP|FLT_OCP|FLT_IVP|FLT_TEMPERATURE|FLT_CML)
+
+typedef struct{
+    uint64_t TimeNs;                    // Bus time at which it is applied
+    uint8_t I2CAddress;                 // Target device
+    uint8_t Kind;                       // SIM_FAULT_*
+    uint8_t Bits;                       // Flags raised or bits flipped
+    uint8_t Latched;                    // Status flags stay after DurationUs until cleared
+    uint16_t Count;                     // Transfers affected by NACK/CORRUPT/STRETCH/CORRUPT_WRITE
+    uint32_t DurationUs;                // Status fault length or stretch per transfer
+} SimFault_Event;
+
+typedef struct{
+    // Random faults, rates per million transfers to the device
+    uint32_t NackPpm;
+    uint32_t CorruptPpm;
+    uint32_t WriteCorruptPpm;
+    uint32_t StretchPpm;
+    uint32_t StretchMaxUs;              // Stretch is uniform in [1, StretchMaxUs]
+    // Random status faults, mean time between them per device (0 none)
+    uint32_t StatusMeanGapMs;
+    uint32_t StatusMaxUs;               // Duration is uniform in [1, StatusMaxUs]
+    uint8_t StatusFlags;                // Flags to pick from, 0 for SIM_FAULT_STATUS_FLAGS
+    uint8_t Latched;                    // Random status faults stay until cleared
+} SimFault_Random;
+
+typedef struct{
+    uint64_t Rng;                       // xorshift64* state
+    uint64_t NextStatusNs;              // Start of the next random status fault
+    uint64_t StatusEndNs;               // End of the status fault being applied
+    uint8_t StatusBits;                 // Flags of the status fault being applied
+    uint8_t StatusLatched;
+    uint8_t CorruptBits;
+    uint8_t WriteCorruptBits;
+    uint16_t WriteCorruptLeft;          // Scripted writes still to corrupt
+    uint16_t NackLeft;                  // Scripted transfers still to NACK
+    uint16_t CorruptLeft;               // Scripted reads still to corrupt
+    uint16_t StretchLeft;               // Scripted transfers still to stretch
+    uint32_t StretchUs;
+} SimFault_Device;
+
+typedef struct{
+    SimI2CBus *Bus;
+    uint64_t Seed;
+    const SimFault_Event *Script;       // Sorted by TimeNs, can be NULL
+    int ScriptCount;
+    int ScriptNext;                     // First event not applied yet
+    SimFault_Random Random;
+    SimFault_Device Devices[128];
+    // Statistics
+    uint32_t Injected[SIM_FAULT_KINDS]; // Faults applied per kind
+} SimFault;
+
+// Initialization with the seed, hooking the bus
+void SimFault_Init(SimFault *Fault, SimI2CBus *Bus, uint64_t Seed);
+// Setting the scripted events, sorted by time
+void SimFault_Schedule(SimFault *Fault, const SimFault_Event *Events, int Count);
+// Setting the random fault rates
+void SimFault_SetRandom(SimFault *Fault, const SimFault_Random *Random);
+// Applying the events due at the current bus time, without a transfer
+void SimFault_Advance(SimFault *Fault);
+// Removing the hook from the bus
+void SimFault_Detach(SimFault *Fault);
+// Next number of the xorshift64* generator
+uint64_t SimFault_Rand(uint64_t *State);
+
+#endif // SIM_FAULT_H
@@ -0,0 +1,477 @@
+//Include header file
+#include "simLM51772.h"
+#include "LM51772.h"
+#include "i2cPec.h"
+#include <string.h>
+
+// Longest write the fault hook can corrupt
+#define SIM_WIRE_BYTES                  260
+
+// Accounts the bus time of a transaction of Length bytes plus the address
+// byte, each byte takes 9 bit times and start/stop take one each
+static void accountTransfer(SimI2CBus *Bus, uint16_t Length){
+    Bus->NowNs += (uint64_t)((Length + 1) * 9 + 2) * Bus->BitTimeNs;
+    Bus->BytesOnWire += Length + 1;
+}
+
+// Accounts a further message of a combined transaction: a repeated start
+// instead of START/STOP
+static void accountMessage(SimI2CBus *Bus, uint16_t Length){
+    Bus->NowNs += (uint64_t)((Length + 1) * 9 + 1) * Bus->BitTimeNs;
+    Bus->BytesOnWire += Length + 1;
+}
+
+// Host time between two transactions (driver call, scheduling)
+static void startTransaction(SimI2CBus *Bus){
+    Bus->NowNs += Bus->HostGapNs;
+}
+
+// Returns the device answering to the address on an open mux channel,
+// NULL if none. Devices answering on two open channels are counted as a
+// conflict, the first one is taken.
+static SimLM51772 *behindMux(SimI2CBus *Bus, uint8_t SlaveAddress){
+    SimLM51772 *device = 0;
+    for (int m = 0; m < SIM_MAX_MUXES; ++m) {
+        const SimTCA9548A *mux = Bus->Muxes[m];
+        for (int c = 0; mux != 0 && c < SIM_MUX_CHANNELS; ++c) {
+            SimLM51772 *found = ((mux->Device.Regs[0] >> c) & 1) && mux->Channels[c] != 0 ?
+                                mux->Channels[c]->Devices[SlaveAddress & 0x7F] : 0;
+            if (found != 0 && device != 0) {
+                Bus->Conflicts++;
+            } else if (found != 0) {
+                device = found;
+            }
+        }
+    }
+    return device;
+}
+
+// Returns the device answering to the address, NULL (and a NACK) if none
+// or if the fault hook makes it NACK
+static SimLM51772 *selectDevice(SimI2CBus *Bus, uint8_t SlaveAddress){
+    SimLM51772 *device = Bus->Devices[SlaveAddress & 0x7F];
+    if (device == 0) {
+        device = behindMux(Bus,SlaveAddress);
+    }
+    if (device != 0 && Bus->FaultHook != 0 &&
+        Bus->FaultHook(Bus->FaultContext,Bus,device,SIM_PHASE_ADDRESS,0,0) == I2C_ERR_NACK) {
+        device = 0;
+    }
+    if (device == 0) {
+        // Only the address byte goes on the wire
+        accountTransfer(Bus,0);
+        Bus->Nacks++;
+    }
+    return device;
+}
+
+// Register write semantics of the LM51772
+static void writeRegister(SimI2CBus *Bus, SimLM51772 *Device, uint8_t Reg, uint8_t Value){
+    Device->RegWrites++;
+    Device->LastWriteNs = Bus->NowNs;
+    if (Device->Plain) {
+        Device->Regs[Reg] = Value;
+        return;
+    }
+    switch (Reg) {
+        case CLEAR_FAULTS:
+            // Clears every latched fault flag, BUSY and OFF reflect state
+            Device->Regs[STATUS_BYTE] &= (FLT_BUSY|FLT_OFF);
+            Device->Alert = 0;
+            break;
+        case STATUS_BYTE:
+            // Fault flags are cleared by writing 1 to them
+            Device->Regs[STATUS_BYTE] &= (uint8_t)~(Value & ~(FLT_BUSY|FLT_OFF));
+            if ((Device->Regs[STATUS_BYTE] & ~(FLT_BUSY|FLT_OFF)) == 0) {
+                Device->Alert = 0;
+            }
+            break;
+        case USB_PD_STATUS_0:
+            // Read only
+            break;
+        case VOUT_TARGET1_LSB:
+        case VOUT_TARGET1_MSB:
+            Device->Regs[Reg] = Value;
+            Device->VoutUpdateNs = Bus->NowNs;
+            break;
+        default:
+            Device->Regs[Reg] = Value;
+            break;
+    }
+}
+
+// Write data as the device gets it. The fault hook can corrupt it on the
+// wire (in a copy, Wire). A device in PEC mode checks and strips the PEC
+// byte, unless the PEC comes with the read that follows (CheckPec 0); on a
+// mismatch it NACKs the PEC byte, drops the write and raises FLT_CML.
+// Returns the amount of bytes to apply or a negative error code.
+static int receiveWrite(SimI2CBus *Bus, SimLM51772 *Device, const uint8_t **Data, uint16_t Length, uint8_t *Wire, int CheckPec){
+    if (Bus->FaultHook != 0 && Length > 0 && Length <= SIM_WIRE_BYTES) {
+        memcpy(Wire,*Data,Length);
+        Bus->FaultHook(Bus->FaultContext,Bus,Device,SIM_PHASE_WRITE,Wire,Length);
+        *Data = Wire;
+    }
+    if (!Device->Pec || !CheckPec || Length == 0) {
+        return Length;
+    }
+    uint8_t address = (uint8_t)(Device->I2CAddress << 1);
+    uint8_t crc = I2C_Pec_Crc8(I2C_Pec_Crc8(0,&address,1),*Data,(uint16_t)(Length - 1));
+    if (Length < 2 || crc != (*Data)[Length - 1]) {
+        Bus->PecErrors++;
+        SimLM51772_RaiseFault(Device,FLT_CML);
+        return I2C_ERR_NACK;
+    }
+    return Length - 1;
+}
+
+// Applies a write: the first byte sets the register pointer, the rest
+// auto-increment
+static void applyWrite(SimI2CBus *Bus, SimLM51772 *Device, const uint8_t *Data, uint16_t Length){
+    if (Length == 0) {
+        return;
+    }
+    if (Device->Mux) {
+        // Every byte is written to the control register
+        Device->Regs[0] = Data[Length - 1];
+        Device->RegWrites += Length;
+        Device->LastWriteNs = Bus->NowNs;
+        return;
+    }
+    Device->Pointer = Data[0];
+    for (uint16_t i = 1; i < Length; ++i) {
+        writeRegister(Bus,Device,Device->Pointer,Data[i]);
+        Device->Pointer++;
+    }
+}
+
+// Read data sent by the device from the register pointer on. In PEC mode
+// the last byte is the PEC, continuing from Crc (the write part of a
+// write-read). The fault hook can corrupt what the master gets.
+static void sendRead(SimI2CBus *Bus, SimLM51772 *Device, uint8_t *Data, uint16_t Length, uint8_t Crc){
+    uint16_t count = (Device->Pec && Length > 0) ? (uint16_t)(Length - 1) : Length;
+    for (uint16_t i = 0; i < count; ++i) {
+        Data[i] = Device->Regs[Device->Mux ? 0 : Device->Pointer];
+        Device->RegReads++;
+        Device->Pointer++;
+    }
+    if (count < Length) {
+        uint8_t address = (uint8_t)((Device->I2CAddress << 1) | 1);
+        Data[count] = I2C_Pec_Crc8(I2C_Pec_Crc8(Crc,&address,1),Data,count);
+    }
+    if (Bus->FaultHook != 0 && Length > 0) {
+        Bus->FaultHook(Bus->FaultContext,Bus,Device,SIM_PHASE_READ,Data,Length);
+    }
+}
+
+// PEC of the write part of a write-read
+static uint8_t writePec(const SimLM51772 *Device, const uint8_t *Data, uint16_t Length){
+    uint8_t address = (uint8_t)(Device->I2CAddress << 1);
+    return I2C_Pec_Crc8(I2C_Pec_Crc8(0,&address,1),Data,Length);
+}
+
+static int simWrite(void *Context, uint8_t SlaveAddress, const uint8_t *Data, uint16_t Length){
+    SimI2CBus *Bus = (SimI2CBus *)Context;
+    startTransaction(Bus);
+    SimLM51772 *device = selectDevice(Bus,SlaveAddress);
+    if (device == 0) {
+        return I2C_ERR_NACK;
+    }
+    accountTransfer(Bus,Length);
+    uint8_t wire[SIM_WIRE_BYTES];
+    int count = receiveWrite(Bus,device,&Data,Length,wire,1);
+    if (count < 0) {
+        return count;
+    }
+    Bus->Transfers++;
+    applyWrite(Bus,device,Data,(uint16_t)count);
+    return I2C_OK;
+}
+
+// Read from the Alert Response Address. Every alerting device sends its
+// address, the wired-AND bus lets the lowest one win the arbitration
+static int alertResponse(SimI2CBus *Bus, uint8_t *Data, uint16_t Length){
+    SimLM51772 *winner = 0;
+    for (int i = 0; i < 128 && winner == 0; ++i) {
+        SimLM51772 *device = Bus->Devices[i];
+        if (device != 0 && device->Alert) {
+            winner = device;
+        }
+    }
+    if (winner == 0) {
+        accountTransfer(Bus,0);
+        Bus->Nacks++;
+        return I2C_ERR_NACK;
+    }
+    accountTransfer(Bus,Length);
+    Bus->Transfers++;
+    for (uint16_t i = 0; i < Length; ++i) {
+        Data[i] = (i == 0) ? (uint8_t)(winner->I2CAddress << 1) : 0xFF;
+    }
+    winner->Alert = 0;
+    return I2C_OK;
+}
+
+static int simRead(void *Context, uint8_t SlaveAddress, uint8_t *Data, uint16_t Length){
+    SimI2CBus *Bus = (SimI2CBus *)Context;
+    startTransaction(Bus);
+    if ((SlaveAddress & 0x7F) == SIM_SMBUS_ARA && Bus->Devices[SIM_SMBUS_ARA] == 0) {
+        return alertResponse(Bus,Data,Length);
+    }
+    SimLM51772 *device = selectDevice(Bus,SlaveAddress);
+    if (device == 0) {
+        return I2C_ERR_NACK;
+    }
+    accountTransfer(Bus,Length);
+    Bus->Transfers++;
+    sendRead(Bus,device,Data,Length,0);
+    return I2C_OK;
+}
+
+static int simWriteRead(void *Context, uint8_t SlaveAddress, const uint8_t *WData, uint16_t WLength, uint8_t *RData, uint16_t RLength){
+    SimI2CBus *Bus = (SimI2CBus *)Context;
+    startTransaction(Bus);
+    SimLM51772 *device = selectDevice(Bus,SlaveAddress);
+    if (device == 0) {
+        return I2C_ERR_NACK;
+    }
+    // Repeated start: one transaction with two address bytes
+    accountTransfer(Bus,WLength + RLength + 1);
+    Bus->NowNs += Bus->BitTimeNs;
+    Bus->Transfers++;
+    uint8_t wire[SIM_WIRE_BYTES];
+    int count = receiveWrite(Bus,device,&WData,WLength,wire,0);
+    applyWrite(Bus,device,WData,(uint16_t)count);
+    sendRead(Bus,device,RData,RLength,(WLength > 0) ? writePec(device,WData,WLength) : 0);
+    return I2C_OK;
+}
+
+static int simTransfer(void *Context, const I2C_Message *Messages, uint16_t Count){
+    SimI2CBus *Bus = (SimI2CBus *)Context;
+    if (Count > I2C_MAX_MESSAGES) {
+        return I2C_ERR_BUS;
+    }
+    startTransaction(Bus);
+    // Writes to group command devices, executed at the STOP
+    SimLM51772 *deferred[I2C_MAX_MESSAGES];
+    const uint8_t *deferredData[I2C_MAX_MESSAGES];
+    uint16_t deferredLength[I2C_MAX_MESSAGES];
+    uint8_t wire[I2C_MAX_MESSAGES][SIM_WIRE_BYTES];
+    int deferredCount = 0;
+    int status = I2C_OK;
+    uint8_t crc = 0;
+    // START and STOP are accounted with the first message, every further
+    // message takes a repeated start
+    for (uint16_t m = 0; m < Count; ++m) {
+        const I2C_Message *message = &Messages[m];
+        SimLM51772 *device = selectDevice(Bus,message->SlaveAddress);
+        if (device == 0) {
+            // The master aborts with a STOP
+            status = I2C_ERR_NACK;
+            break;
+        }
+        if (m == 0) {
+            accountTransfer(Bus,message->Length);
+        } else {
+            accountMessage(Bus,message->Length);
+        }
+        if (message->Flags & I2C_MSG_READ) {
+            sendRead(Bus,device,message->Data,message->Length,crc);
+            crc = 0;
+            continue;
+        }
+        // The PEC of a write followed by a read of the same device comes
+        // with the read
+        int paired = m + 1 < Count && (Messages[m + 1].Flags & I2C_MSG_READ) &&
+                     (Messages[m + 1].SlaveAddress & 0x7F) == (message->SlaveAddress & 0x7F);
+        const uint8_t *data = message->Data;
+        int count = receiveWrite(Bus,device,&data,message->Length,wire[m],!paired);
+        if (count < 0) {
+            status = count;
+            break;
+        }
+        crc = (paired && message->Length > 0) ? writePec(device,data,message->Length) : 0;
+        if (device->GroupCommand) {
+            deferred[deferredCount] = device;
+            deferredData[deferredCount] = data;
+            deferredLength[deferredCount++] = (uint16_t)count;
+        } else {
+            applyWrite(Bus,device,data,(uint16_t)count);
+        }
+    }
+    // STOP: every device that received its command executes it
+    for (int i = 0; i < deferredCount; ++i) {
+        applyWrite(Bus,deferred[i],deferredData[i],deferredLength[i]);
+    }
+    if (status == I2C_OK) {
+        Bus->Transfers++;
+    }
+    return status;
+}
+
+static int simQuick(void *Context, uint8_t SlaveAddress){
+    SimI2CBus *Bus = (SimI2CBus *)Context;
+    startTransaction(Bus);
+    if (selectDevice(Bus,SlaveAddress) == 0) {
+        return I2C_ERR_NACK;
+    }
+    accountTransfer(Bus,0);
+    Bus->Transfers++;
+    return I2C_OK;
+}
+
+static void simDelay(void *Context, uint32_t Microseconds){
+    SimI2CBus *Bus = (SimI2CBus *)Context;
+    Bus->NowNs += (uint64_t)Microseconds * 1000;
+}
+
+/******************************************
+* @brief: Initializes a simulated LM51772
+* @param Device: simulated device (SimLM51772 *)
+* @param I2CAddress: 7 bit address the device answers to (uint8_t)
+* @note: Every register starts at 0x00 except STATUS_BYTE, which
+*        reports the output as OFF until the power stage is enabled.
+*******************************************/
+void SimLM51772_Init(SimLM51772 *Device, uint8_t I2CAddress){
+    memset(Device,0,sizeof(*Device));
+    Device->I2CAddress = I2CAddress;
+    Device->Regs[STATUS_BYTE] = FLT_OFF;
+}
+
+/******************************************
+* @brief: Raises fault flags of a simulated LM51772
+* @param Device: simulated device (SimLM51772 *)
+* @param Flags: FLT_* flags set in STATUS_BYTE (uint8_t)
+* @note: Asserts SMBALERT# if a flag was not set yet.
+*******************************************/
+void SimLM51772_RaiseFault(SimLM51772 *Device, uint8_t Flags){
+    if ((Device->Regs[STATUS_BYTE] & Flags) != Flags) {
+        Device->Alert = 1;
+    }
+    Device->Regs[STATUS_BYTE] |= Flags;
+}
+
+/******************************************
+* @brief: Initializes a simulated plain register file device
+* @param Device: simulated device (SimLM51772 *)
+* @param I2CAddress: 7 bit address the device answers to (uint8_t)
+* @note: For chips other than the LM51772 sharing the bus: every
+*        register starts at 0x00 and keeps what is written to it.
+*******************************************/
+void SimRegFile_Init(SimLM51772 *Device, uint8_t I2CAddress){
+    memset(Device,0,sizeof(*Device));
+    Device->I2CAddress = I2CAddress;
+    Device->Plain = 1;
+}
+
+/******************************************
+* @brief: Initializes a simulated TCA9548A I2C mux
+* @param Mux: simulated mux (SimTCA9548A *)
+* @param I2CAddress: 7 bit address the mux answers to (uint8_t)
+* @note: Every channel starts closed and without a bus, the devices
+*        behind a channel are attached to a bus initialized with
+*        SimBus_Init(Bus,NULL) and set in Mux->Channels.
+*******************************************/
+void SimTCA9548A_Init(SimTCA9548A *Mux, uint8_t I2CAddress){
+    memset(Mux,0,sizeof(*Mux));
+    Mux->Device.I2CAddress = I2CAddress;
+    Mux->Device.Mux = 1;
+}
+
+/******************************************
+* @brief: Initializes an empty simulated bus and its transport
+* @param Bus: simulated bus (SimI2CBus *)
+* @param Transport: transport to be filled, NULL for a mux channel (I2C_Transport *)
+* @note: The transport still has to be selected with I2C_SetTransport().
+*******************************************/
+void SimBus_Init(SimI2CBus *Bus, I2C_Transport *Transport){
+    memset(Bus,0,sizeof(*Bus));
+    Bus->BitTimeNs = SIM_I2C_BIT_TIME_NS;
+    if (Transport == 0) {
+        return;
+    }
+    Transport->Write = simWrite;
+    Transport->Read = simRead;
+    Transport->WriteRead = simWriteRead;
+    Transport->Transfer = simTransfer;
+    Transport->Quick = simQuick;
+    Transport->Delay = simDelay;
+    Transport->Flush = 0;
+    Transport->Context = Bus;
+}
+
+/******************************************
+* @brief: Attaches a simulated device to the bus
+* @param Bus: simulated bus (SimI2CBus *)
+* @param Device: initialized device (SimLM51772 *)
+*******************************************/
+void SimBus_Attach(SimI2CBus *Bus, SimLM51772 *Device){
+    Bus->Devices[Device->I2CAddress & 0x7F] = Device;
+}
+
+/******************************************
+* @brief: Attaches a simulated mux to the bus
+* @param Bus: simulated bus (SimI2CBus *)
+* @param Mux: initialized mux (SimTCA9548A *)
+* @note: At most SIM_MAX_MUXES muxes per bus, further ones are ignored.
+*******************************************/
+void SimBus_AttachMux(SimI2CBus *Bus, SimTCA9548A *Mux){
+    for (int m = 0; m < SIM_MAX_MUXES; ++m) {
+        if (Bus->Muxes[m] == 0) {
+            Bus->Muxes[m] = Mux;
+            SimBus_Attach(Bus,&Mux->Device);
+            return;
+        }
+    }
+}
+
+/******************************************
+* @brief: Returns the state of the shared SMBALERT# line
+* @param Bus: simulated bus (const SimI2CBus *)
+* @note: 1 (asserted) while any attached device pulls it.
+*******************************************/
+int SimBus_AlertLine(const SimI2CBus *Bus){
+    for (int i = 0; i < 128; ++i) {
+        if (Bus->Devices[i] != 0 && Bus->Devices[i]->Alert) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/******************************************
+* @brief: Installs the fault hook of the bus
+* @param Bus: simulated bus (SimI2CBus *)
+* @param Hook: fault hook, NULL removes it (SimBus_FaultHook)
+* @param Context: passed to the hook (void *)
+* @note: The hook is called before every addressed device ACKs and
+*        after every read, see simFault.h for the injector using it.
+*******************************************/
+void SimBus_SetFaultHook(SimI2CBus *Bus, SimBus_FaultHook Hook, void *Context){
+    Bus->FaultHook = Hook;
+    Bus->FaultContext = Context;
+}
+
+/******************************************
+* @brief: Resets the bus and device statistic counters
+* @param Bus: simulated bus (SimI2CBus *)
+*******************************************/
+void SimBus_ResetStats(SimI2CBus *Bus){
+    Bus->Transfers = 0;
+    Bus->Nacks = 0;
+    Bus->BytesOnWire = 0;
+    Bus->PecErrors = 0;
+    Bus->Conflicts = 0;
+    for (int i = 0; i < 128; ++i) {
+        if (Bus->Devices[i] != 0) {
+            Bus->Devices[i]->RegReads = 0;
+            Bus->Devices[i]->RegWrites = 0;
+        }
+    }
+    for (int m = 0; m < SIM_MAX_MUXES; ++m) {
+        for (int c = 0; Bus->Muxes[m] != 0 && c < SIM_MUX_CHANNELS; ++c) {
+            if (Bus->Muxes[m]->Channels[c] != 0) {
+                SimBus_ResetStats(Bus->Muxes[m]->Channels[c]);
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include "i2cTransport.h"
+
+#ifndef SIM_LM51772_H
+#define SIM_LM51772_H
+
+// Simulated I2C bus with LM51772 devices attached. Every device is a 256
+// byte register file with the register pointer/auto-increment behaviour of
+// the real part, write-1-to-clear STATUS_BYTE flags and CLEAR_FAULTS.
+// Other chips (MPQ4210, ...) can share the bus as plain register files.
+// Time is virtual: every transfer advances the bus clock by its bus time
+// (plus HostGapNs for the driver call that issues it) and delays advance
+// it instead of sleeping. Combined transactions (I2C_Transfer) are one
+// transaction with repeated starts between the messages; devices with
+// GroupCommand set hold their writes until the STOP, like PMBus devices
+// do for a group command.
+// TCA9548A muxes (SimTCA9548A) sit on the bus like a device; the devices
+// of their open channels answer on the bus as if attached to it, their
+// transfers are accounted on it.
+
+// Bus timing used to account the transfers (100 kHz standard mode)
+#ifndef SIM_I2C_BIT_TIME_NS
+#define SIM_I2C_BIT_TIME_NS             10000
+#endif
+
+typedef struct{
+    uint8_t I2CAddress;                 // 7 bit address of the device
+    uint8_t Regs[256];                  // Register file
+    uint8_t Pointer;                    // Register pointer set by the last write
+    uint8_t Plain;                      // Plain register file, no LM51772 semantics
+    uint8_t Alert;                      // Pulling SMBALERT# low, until it wins an ARA
+                                        // read or gets CLEAR_FAULTS
+    uint8_t Pec;                        // SMBus PEC mode: checks the PEC of writes,
+                                        // sends one after reads
+    uint8_t GroupCommand;               // Writes of a combined transaction take effect
+                                        // at its STOP (PMBus group command)
+    uint8_t Mux;                        // TCA9548A control register semantics
+    uint64_t VoutUpdateNs;              // Bus time of the last VOUT_TARGET1 write
+    uint64_t LastWriteNs;               // Bus time of the last register write
+    // Statistics
+    uint32_t RegReads;                  // Registers read
+    uint32_t RegWrites;                 // Registers written
+} SimLM51772;
+
+// SMBus Alert Response Address: a read from it returns the address (<< 1)
+// of the alerting device with the lowest address, which wins the
+// arbitration and releases SMBALERT#
+#define SIM_SMBUS_ARA                   0x0C
+
+// Phases in which the fault hook of the bus is called
+#define SIM_PHASE_ADDRESS               0   // Before the device ACKs its address
+#define SIM_PHASE_READ                  1   // After the device returned read data
+#define SIM_PHASE_WRITE                 2   // Before the device takes write data
+
+typedef struct SimI2CBus SimI2CBus;
+
+// Muxes per bus and channels per mux
+#define SIM_MAX_MUXES                   8
+#define SIM_MUX_CHANNELS                8
+
+// TCA9548A: a single byte write sets the control register (one bit per
+// open channel), a read returns it. A channel is a bus holding the devices
+// behind it, only its device table is used.
+typedef struct{
+    SimLM51772 Device;                  // Address of the mux, control register in Regs[0]
+    SimI2CBus *Channels[SIM_MUX_CHANNELS];  // Downstream buses, NULL if unused
+} SimTCA9548A;
+
+// Fault hook: in SIM_PHASE_ADDRESS it can return I2C_ERR_NACK to make the
+// device NACK, in SIM_PHASE_READ and SIM_PHASE_WRITE it can modify Data. It can also advance
+// the bus clock to stretch SCL.
+typedef int (*SimBus_FaultHook)(void *Context, SimI2CBus *Bus, SimLM51772 *Device, int Phase, uint8_t *Data, uint16_t Length);
+
+struct SimI2CBus{
+    SimLM51772 *Devices[128];           // Attached device per 7 bit address
+    uint64_t NowNs;                     // Virtual bus clock
+    uint32_t BitTimeNs;                 // Duration of one SCL period
+    uint32_t HostGapNs;                 // Host time before every transaction, 0 by default
+    SimBus_FaultHook FaultHook;         // Can be NULL
+    void *FaultContext;                 // Passed to the fault hook
+    SimTCA9548A *Muxes[SIM_MAX_MUXES];  // Attached muxes
+    // Statistics
+    uint32_t Transfers;                 // Acknowledged transactions
+    uint32_t Nacks;                     // Not acknowledged transactions
+    uint32_t BytesOnWire;               // Bytes sent/received incl. address bytes
+    uint32_t PecErrors;                 // Writes rejected for a wrong PEC
+    uint32_t Conflicts;                 // Transactions answered by devices of two open channels
+};
+
+// Initialization of a device with its power-on register values
+void SimLM51772_Init(SimLM51772 *Device, uint8_t I2CAddress);
+// Initialization of a plain register file device (all registers 0x00)
+void SimRegFile_Init(SimLM51772 *Device, uint8_t I2CAddress);
+// Initialization of a mux with every channel closed
+void SimTCA9548A_Init(SimTCA9548A *Mux, uint8_t I2CAddress);
+// Initialization of an empty bus and the transport pointing to it
+// (Transport NULL for a mux channel)
+void SimBus_Init(SimI2CBus *Bus, I2C_Transport *Transport);
+// Attaching a device to the bus at its address
+void SimBus_Attach(SimI2CBus *Bus, SimLM51772 *Device);
+// Attaching a mux to the bus, its channels are set in Mux->Channels
+void SimBus_AttachMux(SimI2CBus *Bus, SimTCA9548A *Mux);
+// Raising STATUS_BYTE flags and asserting SMBALERT#
+void SimLM51772_RaiseFault(SimLM51772 *Device, uint8_t Flags);
+// State of the shared SMBALERT# line, 1 while any device pulls it
+int SimBus_AlertLine(const SimI2CBus *Bus);
+// Installing the fault hook, NULL removes it
+void SimBus_SetFaultHook(SimI2CBus *Bus, SimBus_FaultHook Hook, void *Context);
+// Resetting of the bus and device statistics
+void SimBus_ResetStats(SimI2CBus *Bus);
+
+#endif // SIM_LM51772_H
@@ -0,0 +1,236 @@
+#include "LM51772.h"
+#include "simFault.h"
+#include "simLM51772.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Soak test of a fault handler against thousands of simulated LM51772 in
+// one process. Devices are spread over buses of DEVICES_PER_BUS, every bus
+// with its own fault injector: random status faults (latched, the handler
+// has to clear them), NACKs, corrupted reads and clock stretching, plus a
+// script with an OVP storm on every device and bursts of each fault kind.
+// The handler services the devices of a bus in turn until the bus clock
+// reaches the soak time. The first bus is run again with the same seed to
+// check the run is reproducible.
+//
+// Usage: soakFaults [-n devices] [-t seconds] [-s seed]
+
+#define DEVICES_PER_BUS         100
+#define FIRST_ADDRESS           0x10
+#define READ_RETRIES            3
+#define RETRY_DELAY_US          100
+
+typedef struct{
+    uint64_t Services;                  // Devices serviced
+    uint64_t FaultsSeen;                // Services that found fault flags
+    uint64_t Cleared;                   // Faults cleared and read back clean
+    uint64_t Retries;                   // Transfers retried after a NACK
+    uint64_t Unreachable;               // Services given up after the retries
+    uint64_t Disagreements;             // Reads that needed a third vote
+    uint64_t Transfers;
+    uint64_t Injected[SIM_FAULT_KINDS];
+} SoakResult;
+
+static SimFault_Event script[DEVICES_PER_BUS + 3];
+static int scriptCount;
+
+static void buildScript(void){
+    // OVP storm on every device at 1 s
+    for (int i = 0; i < DEVICES_PER_BUS; ++i) {
+        SimFault_Event *e = &script[scriptCount++];
+        memset(e,0,sizeof(*e));
+        e->TimeNs = 1000000000ull;
+        e->I2CAddress = (uint8_t)(FIRST_ADDRESS + i);
+        e->Kind = SIM_FAULT_STATUS;
+        e->Bits = FLT_OVP;
+        e->Latched = 1;
+        e->DurationUs = 5000;
+    }
+    const SimFault_Event bursts[3] = {
+        {2000000000ull, FIRST_ADDRESS, SIM_FAULT_NACK, 0, 0, 5, 0},
+        {3000000000ull, FIRST_ADDRESS + 1, SIM_FAULT_CORRUPT, FLT_OVP, 0, 3, 0},
+        {4000000000ull, FIRST_ADDRESS + 2, SIM_FAULT_STRETCH, 0, 0, 10, 2000},
+    };
+    memcpy(&script[scriptCount],bursts,sizeof(bursts));
+    scriptCount += 3;
+}
+
+// Register read retried on NACK, I2C_OK or the last error
+static int readReg(uint8_t I2CAddress, uint8_t Reg, uint8_t *Value, SoakResult *Result){
+    int status = I2C_ERR_NACK;
+    for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+        if (attempt > 0) {
+            Result->Retries++;
+            I2C_DelayUs(RETRY_DELAY_US);
+        }
+        status = I2C_WriteReadBlock(I2CAddress,&Reg,1,Value,1);
+        if (status == I2C_OK) {
+            break;
+        }
+    }
+    return status;
+}
+
+// STATUS_BYTE read twice, a third read decides when they differ
+static int readStatus(uint8_t I2CAddress, uint8_t *Status, SoakResult *Result){
+    uint8_t a, b, c;
+    if (readReg(I2CAddress,STATUS_BYTE,&a,Result) < 0 || readReg(I2CAddress,STATUS_BYTE,&b,Result) < 0) {
+        return -1;
+    }
+    if (a != b) {
+        Result->Disagreements++;
+        if (readReg(I2CAddress,STATUS_BYTE,&c,Result) < 0) {
+            return -1;
+        }
+        // Bitwise majority
+        a = (uint8_t)((a & b) | (a & c) | (b & c));
+    }
+    *Status = a;
+    return 0;
+}
+
+// The handler under test
+static void service(uint8_t I2CAddress, SoakResult *Result){
+    uint8_t status;
+    Result->Services++;
+    if (readStatus(I2CAddress,&status,Result) < 0) {
+        Result->Unreachable++;
+        return;
+    }
+    if ((status & SIM_FAULT_STATUS_FLAGS) == 0) {
+        return;
+    }
+    Result->FaultsSeen++;
+    const uint8_t clear[2] = {CLEAR_FAULTS, 0x00};
+    for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+        if (I2C_WriteBlock(I2CAddress,clear,2) == I2C_OK) {
+            break;
+        }
+        Result->Retries++;
+    }
+    if (readStatus(I2CAddress,&status,Result) == 0 && (status & SIM_FAULT_STATUS_FLAGS) == 0) {
+        Result->Cleared++;
+    }
+}
+
+static void soakBus(int Devices, uint64_t Seed, uint64_t DurationNs, SoakResult *Result){
+    static SimI2CBus bus;
+    static SimLM51772 sims[DEVICES_PER_BUS];
+    static SimFault fault;
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    for (int i = 0; i < Devices; ++i) {
+        SimLM51772_Init(&sims[i],(uint8_t)(FIRST_ADDRESS + i));
+        sims[i].Regs[STATUS_BYTE] = 0;
+        SimBus_Attach(&bus,&sims[i]);
+    }
+    I2C_SetTransport(&transport);
+    SimFault_Init(&fault,&bus,Seed);
+    SimFault_Schedule(&fault,script,scriptCount);
+    SimFault_Random random;
+    memset(&random,0,sizeof(random));
+    random.NackPpm = 2000;
+    random.CorruptPpm = 1000;
+    random.StretchPpm = 5000;
+    random.StretchMaxUs = 500;
+    random.StatusMeanGapMs = 2000;
+    random.StatusMaxUs = 20000;
+    random.Latched = 1;
+    SimFault_SetRandom(&fault,&random);
+
+    while (bus.NowNs < DurationNs) {
+        for (int i = 0; i < Devices; ++i) {
+            service((uint8_t)(FIRST_ADDRESS + i),Result);
+        }
+    }
+    Result->Transfers += bus.Transfers + bus.Nacks;
+    for (int k = 0; k < SIM_FAULT_KINDS; ++k) {
+        Result->Injected[k] += fault.Injected[k];
+    }
+}
+
+static uint64_t digest(const SoakResult *Result){
+    // FNV-1a over the counters
+    const uint8_t *p = (const uint8_t *)Result;
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < sizeof(*Result); ++i) {
+        h = (h ^ p[i])*0x100000001B3ull;
+    }
+    return h;
+}
+
+int main(int argc, char *argv[]){
+    int devices = 4096;
+    double seconds = 10.0;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i],"-n") == 0 && i + 1 < argc) {
+            devices = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"-t") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i],"-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i],0,0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n devices] [-t seconds] [-s seed]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (devices <= 0 || seconds <= 0) {
+        fprintf(stderr, "Invalid device count or soak time\n");
+        return 1;
+    }
+    buildScript();
+    uint64_t durationNs = (uint64_t)(seconds*1e9);
+    int buses = (devices + DEVICES_PER_BUS - 1)/DEVICES_PER_BUS;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    SoakResult total, first;
+    memset(&total,0,sizeof(total));
+    memset(&first,0,sizeof(first));
+    for (int b = 0; b < buses; ++b) {
+        int count = devices - b*DEVICES_PER_BUS;
+        count = (count > DEVICES_PER_BUS) ? DEVICES_PER_BUS : count;
+        SoakResult result;
+        memset(&result,0,sizeof(result));
+        soakBus(count,seed + (uint64_t)b,durationNs,&result);
+        if (b == 0) {
+            first = result;
+        }
+        total.Services += result.Services;
+        total.FaultsSeen += result.FaultsSeen;
+        total.Cleared += result.Cleared;
+        total.Retries += result.Retries;
+        total.Unreachable += result.Unreachable;
+        total.Disagreements += result.Disagreements;
+        total.Transfers += result.Transfers;
+        for (int k = 0; k < SIM_FAULT_KINDS; ++k) {
+            total.Injected[k] += result.Injected[k];
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC,&t1);
+    double wall = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec)/1e9;
+
+    // Same seed again must give the same counters
+    SoakResult again;
+    memset(&again,0,sizeof(again));
+    soakBus((devices < DEVICES_PER_BUS) ? devices : DEVICES_PER_BUS,seed,durationNs,&again);
+    int reproducible = digest(&first) == digest(&again);
+
+    printf("Devices %d on %d buses, %.1f s of bus time each, seed %llu\n", devices, buses, seconds,
+           (unsigned long long)seed);
+    printf("Injected: status %llu, nack %llu, corrupt %llu, stretch %llu\n",
+           (unsigned long long)total.Injected[SIM_FAULT_STATUS], (unsigned long long)total.Injected[SIM_FAULT_NACK],
+           (unsigned long long)total.Injected[SIM_FAULT_CORRUPT], (unsigned long long)total.Injected[SIM_FAULT_STRETCH]);
+    printf("Handler: %llu services, %llu faults seen, %llu cleared, %llu retries, %llu unreachable, %llu disagreements\n",
+           (unsigned long long)total.Services, (unsigned long long)total.FaultsSeen, (unsigned long long)total.Cleared,
+           (unsigned long long)total.Retries, (unsigned long long)total.Unreachable, (unsigned long long)total.Disagreements);
+    printf("%llu transfers in %.2f s, %.2e transfers/s\n", (unsigned long long)total.Transfers, wall,
+           total.Transfers/wall);
+    printf("Reproducible: %s (digest %016llx)\n", reproducible ? "yes" : "NO", (unsigned long long)digest(&first));
+    return reproducible ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+//Include header file
+#include "statusBoard.h"
+#include "LM51772.h"
+#include "i2cTransport.h"
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// Attempts of a reader before giving up on a slot being written
+#define READ_RETRIES                    1000
+
+// One device, in its own cache line. The values are packed in 64 bit
+// words so they can be stored and loaded atomically, which keeps the
+// seqlock free of data races.
+typedef struct{
+    _Atomic uint32_t Seq;               // Odd while being written
+    uint32_t Reserved;
+    _Atomic uint64_t Values;            // Address, valid, status, USB PD status, code, mV
+    _Atomic uint64_t TimestampNs;
+    _Atomic uint64_t Polls;
+} __attribute__((aligned(64))) BoardSlot;
+
+struct StatusBoard_Region{
+    uint32_t Magic;
+    uint32_t Version;
+    _Atomic uint32_t DeviceCount;       // Slots in use
+    uint32_t PublisherPid;
+    BoardSlot Slots[STATUS_BOARD_MAX_DEVICES];
+};
+
+static uint64_t pack(const StatusBoard_Entry *Entry){
+    return (uint64_t)Entry->I2CAddress | (uint64_t)Entry->Valid << 8 | (uint64_t)Entry->Status << 16 |
+           (uint64_t)Entry->UsbPdStatus << 24 | (uint64_t)Entry->VoutCode << 32 | (uint64_t)Entry->VoutmV << 48;
+}
+
+static void unpack(uint64_t Values, StatusBoard_Entry *Entry){
+    Entry->I2CAddress = (uint8_t)Values;
+    Entry->Valid = (uint8_t)(Values >> 8);
+    Entry->Status = (uint8_t)(Values >> 16);
+    Entry->UsbPdStatus = (uint8_t)(Values >> 24);
+    Entry->VoutCode = (uint16_t)(Values >> 32);
+    Entry->VoutmV = (uint16_t)(Values >> 48);
+}
+
+static int mapRegion(StatusBoard *Board, const char *Name, int Writable){
+    if (Name == 0) {
+        Name = STATUS_BOARD_NAME;
+    }
+    snprintf(Board->Name,sizeof(Board->Name),"%s",Name);
+    Board->Writable = Writable;
+    int fd = shm_open(Name,Writable ? (O_CREAT | O_RDWR) : O_RDONLY,0644);
+    if (fd < 0) {
+        perror(Name);
+        return -1;
+    }
+    if (Writable && ftruncate(fd,sizeof(StatusBoard_Region)) < 0) {
+        perror("ftruncate");
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(0,sizeof(StatusBoard_Region),Writable ? (PROT_READ | PROT_WRITE) : PROT_READ,MAP_SHARED,fd,0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    Board->Region = (StatusBoard_Region *)map;
+    return 0;
+}
+
+/******************************************
+* @brief: Creates the shared memory region of the publisher
+* @param Board: board context (StatusBoard *)
+* @param Name: shared memory object name, NULL for
+*              STATUS_BOARD_NAME (const char *)
+* @note: Every slot starts empty. Returns 0 or -1.
+*******************************************/
+int StatusBoard_Create(StatusBoard *Board, const char *Name){
+    if (mapRegion(Board,Name,1) < 0) {
+        return -1;
+    }
+    StatusBoard_Region *region = Board->Region;
+    memset(region,0,sizeof(*region));
+    region->Version = STATUS_BOARD_VERSION;
+    region->PublisherPid = (uint32_t)getpid();
+    // The magic number goes last, readers check it
+    atomic_thread_fence(memory_order_release);
+    region->Magic = STATUS_BOARD_MAGIC;
+    return 0;
+}
+
+/******************************************
+* @brief: Publishes the snapshot of a device
+* @param Board: board created with StatusBoard_Create (StatusBoard *)
+* @param Index: slot of the device (int)
+* @param Entry: snapshot, Polls is ignored (const StatusBoard_Entry *)
+* @note: Only one thread may publish. Never blocks, the readers
+*        retry if they overlapped with the update.
+*******************************************/
+void StatusBoard_Publish(StatusBoard *Board, int Index, const StatusBoard_Entry *Entry){
+    if (Index < 0 || Index >= STATUS_BOARD_MAX_DEVICES) {
+        return;
+    }
+    BoardSlot *slot = &Board->Region->Slots[Index];
+    uint32_t seq = atomic_load_explicit(&slot->Seq,memory_order_relaxed);
+    atomic_store_explicit(&slot->Seq,seq + 1,memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->Values,pack(Entry),memory_order_relaxed);
+    atomic_store_explicit(&slot->TimestampNs,Entry->TimestampNs,memory_order_relaxed);
+    atomic_store_explicit(&slot->Polls,atomic_load_explicit(&slot->Polls,memory_order_relaxed) + 1,memory_order_relaxed);
+    atomic_store_explicit(&slot->Seq,seq + 2,memory_order_release);
+    if ((uint32_t)Index >= atomic_load_explicit(&Board->Region->DeviceCount,memory_order_relaxed)) {
+        atomic_store_explicit(&Board->Region->DeviceCount,(uint32_t)Index + 1,memory_order_release);
+    }
+}
+
+/******************************************
+* @brief: Polls every device once and publishes it
+* @param Board: board created with StatusBoard_Create (StatusBoard *)
+* @param I2CAddresses: device addresses, slot i for address i (const uint8_t *)
+* @param Count: number of devices (int)
+* @note: Costs 4 register reads per device on the selected transport.
+*        A device that does not answer is published as not valid.
+*        Returns the number of devices that answered.
+*******************************************/
+int StatusBoard_Poll(StatusBoard *Board, const uint8_t *I2CAddresses, int Count){
+    int answered = 0;
+    for (int i = 0; i < Count && i < STATUS_BOARD_MAX_DEVICES; ++i) {
+        StatusBoard_Entry entry;
+        uint8_t regs[1];
+        memset(&entry,0,sizeof(entry));
+        entry.I2CAddress = I2CAddresses[i];
+        if (I2C_ReadRegBlock(I2CAddresses[i],STATUS_BYTE,regs,1) == I2C_OK) {
+            entry.Valid = 1;
+            entry.Status = regs[0];
+            entry.UsbPdStatus = get_USBPD_STATUS(I2CAddresses[i]);
+            entry.VoutCode = getVOUT1_TARGET(I2CAddresses[i]);
+            entry.VoutmV = (uint16_t)(entry.VoutCode*VOUT_MV_PER_CODE);
+            answered++;
+        }
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC,&ts);
+        entry.TimestampNs = (uint64_t)ts.tv_sec*1000000000ull + (uint64_t)ts.tv_nsec;
+        StatusBoard_Publish(Board,i,&entry);
+    }
+    return answered;
+}
+
+/******************************************
+* @brief: Unmaps and removes the region of the publisher
+* @param Board: board created with StatusBoard_Create (StatusBoard *)
+*******************************************/
+void StatusBoard_Destroy(StatusBoard *Board){
+    munmap(Board->Region,sizeof(StatusBoard_Region));
+    shm_unlink(Board->Name);
+    Board->Region = 0;
+}
+
+/******************************************
+* @brief: Maps the region of a publisher read-only
+* @param Board: board context (StatusBoard *)
+* @param Name: shared memory object name, NULL for
+*              STATUS_BOARD_NAME (const char *)
+* @note: Returns 0, or -1 if there is no publisher or its region
+*        has another version.
+*******************************************/
+int StatusBoard_Open(StatusBoard *Board, const char *Name){
+    if (mapRegion(Board,Name,0) < 0) {
+        return -1;
+    }
+    if (Board->Region->Magic != STATUS_BOARD_MAGIC || Board->Region->Version != STATUS_BOARD_VERSION) {
+        fprintf(stderr, "%s is not a status board of version %d\n", Board->Name, STATUS_BOARD_VERSION);
+        StatusBoard_Close(Board);
+        return -1;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return 0;
+}
+
+/******************************************
+* @brief: Reads the latest snapshot of a device
+* @param Board: opened or created board (const StatusBoard *)
+* @param Index: slot of the device (int)
+* @param Entry: destination (StatusBoard_Entry *)
+* @note: No system call and no lock, retries while the publisher
+*        writes the slot. Returns 0 for a valid snapshot, 1 if the
+*        device did not answer or was never polled, and -1 if the
+*        slot stayed busy for READ_RETRIES attempts or Index is wrong.
+*******************************************/
+int StatusBoard_Read(const StatusBoard *Board, int Index, StatusBoard_Entry *Entry){
+    if (Index < 0 || Index >= STATUS_BOARD_MAX_DEVICES) {
+        return -1;
+    }
+    BoardSlot *slot = &Board->Region->Slots[Index];
+    for (int i = 0; i < READ_RETRIES; ++i) {
+        uint32_t before = atomic_load_explicit(&slot->Seq,memory_order_acquire);
+        if (before & 0x01) {
+            continue; // Being written
+        }
+        uint64_t values = atomic_load_explicit(&slot->Values,memory_order_relaxed);
+        uint64_t timestamp = atomic_load_explicit(&slot->TimestampNs,memory_order_relaxed);
+        uint64_t polls = atomic_load_explicit(&slot->Polls,memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->Seq,memory_order_relaxed) != before) {
+            continue; // Overlapped with an update
+        }
+        unpack(values,Entry);
+        Entry->TimestampNs = timestamp;
+        Entry->Polls = (uint32_t)polls;
+        return Entry->Valid ? 0 : 1;
+    }
+    return -1;
+}
+
+/******************************************
+* @brief: Returns the number of slots published so far
+* @param Board: opened or created board (const StatusBoard *)
+*******************************************/
+int StatusBoard_DeviceCount(const StatusBoard *Board){
+    return (int)atomic_load_explicit(&Board->Region->DeviceCount,memory_order_acquire);
+}
+
+/******************************************
+* @brief: Unmaps the region of a reader
+* @param Board: board opened with StatusBoard_Open (StatusBoard *)
+*******************************************/
+void StatusBoard_Close(StatusBoard *Board){
+    munmap(Board->Region,sizeof(StatusBoard_Region));
+    Board->Region = 0;
+}
@@ -0,0 +1,54 @@
+#include <stdint.h>
+
+#ifndef STATUS_BOARD_H
+#define STATUS_BOARD_H
+
+// Shared-memory status board. One publisher owns the bus, polls the
+// STATUS_BYTE, USB_PD_STATUS_0 and VOUT target of every device and writes
+// them to a POSIX shared memory region. Any number of local readers
+// (dashboard, logger, watchdog) map the region read-only and get the
+// latest values without bus traffic and without system calls.
+// Every device slot is protected by a seqlock: the publisher makes the
+// sequence odd while it writes, readers retry when they saw an odd or
+// changing sequence, so they never block the publisher.
+
+#define STATUS_BOARD_NAME               "/lm51772-status"
+#define STATUS_BOARD_MAGIC              0x4C4D5342      // "LMSB"
+#define STATUS_BOARD_VERSION            1
+#define STATUS_BOARD_MAX_DEVICES        8
+
+// Snapshot of a device, as seen by the readers
+typedef struct{
+    uint8_t I2CAddress;                 // 7 bit address of the device
+    uint8_t Valid;                      // 0 until the first poll answered
+    uint8_t Status;                     // STATUS_BYTE
+    uint8_t UsbPdStatus;                // USB_PD_STATUS_0
+    uint16_t VoutCode;                  // VOUT_TARGET1 register code
+    uint16_t VoutmV;                    // VOUT target in mV
+    uint64_t TimestampNs;               // CLOCK_MONOTONIC time of the poll
+    uint32_t Polls;                     // Polls published for the device
+} StatusBoard_Entry;
+
+typedef struct StatusBoard_Region StatusBoard_Region;
+
+typedef struct{
+    StatusBoard_Region *Region;         // Mapped region
+    int Writable;                       // 1 for the publisher
+    char Name[64];                      // Shared memory object name
+} StatusBoard;
+
+// Publisher side: creating the region and publishing
+int StatusBoard_Create(StatusBoard *Board, const char *Name);
+void StatusBoard_Publish(StatusBoard *Board, int Index, const StatusBoard_Entry *Entry);
+// Polling the devices on the selected transport and publishing them
+int StatusBoard_Poll(StatusBoard *Board, const uint8_t *I2CAddresses, int Count);
+// Removing the region, readers keep their mapping until they close it
+void StatusBoard_Destroy(StatusBoard *Board);
+
+// Reader side: mapping the region read-only and reading a slot
+int StatusBoard_Open(StatusBoard *Board, const char *Name);
+int StatusBoard_Read(const StatusBoard *Board, int Index, StatusBoard_Entry *Entry);
+int StatusBoard_DeviceCount(const StatusBoard *Board);
+void StatusBoard_Close(StatusBoard *Board);
+
+#endif // STATUS_BOARD_H
@@ -0,0 +1,91 @@
+#include "LM51772.h"
+#include "statusBoard.h"
+#include "i2cPigpio.h"
+#include "busLock.h"
+#include "i2cTransport.h"
+#include <pigpio.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Status board publisher. Polls every LM51772 once per period and
+// publishes the results in shared memory for local readers. Transactions
+// take the lock of the bus (busLock.h), other tools can share it.
+//
+// Usage: statusPublisher [-b bus] [-p period_ms] [address ...]
+
+#define I2C_BUS 3
+#define POLL_PERIOD_MS 100
+
+static volatile sig_atomic_t Running = 1;
+
+static void stop(int Signal){
+    (void)Signal;
+    Running = 0;
+}
+
+int main(int argc, char *argv[]){
+    unsigned busNumber = I2C_BUS;
+    int periodMs = POLL_PERIOD_MS;
+    uint8_t addresses[STATUS_BOARD_MAX_DEVICES];
+    int count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i],"-b") == 0 && i + 1 < argc) {
+            busNumber = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i],"-p") == 0 && i + 1 < argc) {
+            periodMs = atoi(argv[++i]);
+        } else if (count < STATUS_BOARD_MAX_DEVICES) {
+            addresses[count++] = (uint8_t)strtol(argv[i],0,0);
+        }
+    }
+    if (count == 0) {
+        addresses[count++] = LM51772_I2CADDR1;
+    }
+    if (periodMs <= 0) {
+        periodMs = POLL_PERIOD_MS;
+    }
+
+    if (gpioInitialise() < 0) {
+        fprintf(stderr, "pigpio initialisation failed\n");
+        return 1;
+    }
+    signal(SIGINT,stop);
+    signal(SIGTERM,stop);
+    static I2C_PigpioBus bus;
+    static BusLock lock;
+    static I2C_Locked locked;
+    I2C_Transport pigpioTransport, transport;
+    if (BusLock_OpenBus(&lock,busNumber) < 0) {
+        gpioTerminate();
+        return 1;
+    }
+    I2C_Pigpio_Init(&bus,busNumber,&pigpioTransport);
+    BusLock_InitTransport(&locked,&lock,&pigpioTransport,&transport);
+    I2C_SetTransport(&transport);
+
+    StatusBoard board;
+    if (StatusBoard_Create(&board,0) < 0) {
+        gpioTerminate();
+        return 1;
+    }
+    // Polls on an absolute schedule
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC,&next);
+    while (Running) {
+        StatusBoard_Poll(&board,addresses,count);
+        next.tv_nsec += (long)periodMs*1000000L;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&next,0);
+    }
+    StatusBoard_Destroy(&board);
+    I2C_Pigpio_Close(&bus);
+    BusLock_Close(&lock);
+    gpioTerminate();
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "LM51772.h"
+#include "DVSSweep.h"
+#include "i2cTransport.h"
+#include "i2cPigpio.h"
+#include "busLock.h"
+#include <pigpio.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Timed version of sweepVoltages: the code schedule is precomputed and
+// steps are paced on the monotonic clock instead of usleep(). Every
+// transaction takes the lock of the bus (busLock.h).
+
+#define I2C_BUS 5
+#define MAX_STEPS 4096
+
+static DVS_SweepStep steps[MAX_STEPS];
+
+static void printStep(uint32_t Index, const DVS_SweepStep *Step, void *Context){
+    (void)Context;
+    printf("Step %u: output voltage set to %u mV, register value: 0x%02X%02X\n", Index, Step->VoutmV, Step->MSB, Step->LSB);
+}
+
+int main(int argc, char *argv[]){
+    // Check if the correct number of arguments is provided
+    if (argc < 5 || argc > 6) {
+        fprintf(stderr, "Usage: %s <I2CAddress> <StartmV> <StopmV> <Period_us> [StepmV]\n", argv[0]);
+        fprintf(stderr, "       StepmV = 0 or omitted picks the step from the DVS slew rate\n");
+        return 1;
+    }
+
+    // Parse input arguments
+    uint8_t I2CAddress = (uint8_t)strtol(argv[1], NULL, 0);
+    uint16_t StartmV = (uint16_t)strtol(argv[2], NULL, 0);
+    uint16_t StopmV = (uint16_t)strtol(argv[3], NULL, 0);
+    uint32_t Period_us = (uint32_t)strtol(argv[4], NULL, 0);
+    uint16_t StepmV = (argc == 6) ? (uint16_t)strtol(argv[5], NULL, 0) : 0;
+
+    // Initialize the pigpio library
+    if (gpioInitialise() < 0) {
+        fprintf(stderr, "pigpio initialization failed\n");
+        return 1;
+    }
+    I2C_PigpioBus bus;
+    BusLock lock;
+    I2C_Locked locked;
+    I2C_Transport pigpioTransport, transport;
+    if (BusLock_OpenBus(&lock,I2C_BUS) < 0) {
+        gpioTerminate();
+        return 1;
+    }
+    I2C_Pigpio_Init(&bus,I2C_BUS,&pigpioTransport);
+    BusLock_InitTransport(&locked,&lock,&pigpioTransport,&transport);
+    I2C_SetTransport(&transport);
+
+    // Use the slew rate configured on the device
+    uint8_t Slewrate = I2C_ReadRegByte(I2CAddress,MFR_SPECIFIC_D2) & 0x30;
+    DVS_SweepSchedule schedule;
+    if (DVS_Sweep_Plan(&schedule,steps,MAX_STEPS,StartmV,StopmV,StepmV,Slewrate,Period_us) != 0) {
+        fprintf(stderr, "Sweep needs more than %d steps\n", MAX_STEPS);
+        I2C_Pigpio_Close(&bus);
+        BusLock_Close(&lock);
+        gpioTerminate();
+        return 1;
+    }
+    printf("Sweeping %u mV -> %u mV in %u steps of %u mV every %u us (slew %u uV/us)\n",
+           StartmV, StopmV, schedule.Count, schedule.StepmV, schedule.Period_us, DVS_SlewRate_uVus(Slewrate));
+
+    DVS_SweepReport report;
+    if (DVS_Sweep_Run(I2CAddress,&schedule,&report,printStep,0) < 0) {
+        fprintf(stderr, "Sweep stopped after %u of %u steps\n", report.Steps, schedule.Count);
+    }
+    printf("Steps: %u, transfers: %u\n", report.Steps, report.Transfers);
+    printf("Release lateness: min %.1f us, max %.1f us, mean %.1f us, jitter (std) %.1f us\n",
+           report.MinLate_ns/1e3, report.MaxLate_ns/1e3, report.MeanLate_ns/1e3, report.StdLate_ns/1e3);
+
+    // Do not delete
+    I2C_Pigpio_Close(&bus);
+    BusLock_Close(&lock);
+    gpioTerminate();
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "LM51772.h"
+#include "busLock.h"
 #include <pigpio.h>
 #include <stdint.h>
 #include <unistd.h>
@@ -10,6 +11,9 @@
 #define POLL_DELAY 100 // Microseconds
 #define POLL_RETRIES 100
 
+// Lock of the bus shared with the other tools, taken per transaction
+static BusLock busLock;
+
 // Function to poll for device readiness
 int pollForDevice(uint8_t SlaveAddress) {
     int handle;
@@ -49,7 +53,9 @@ void I2C_WriteRegByte(uint8_t SlaveAddress, uint8_t RegAddress, uint8_t ByteData
     buff[1] = ByteData;
 
     // We write the device on said address the given data
+    BusLock_Acquire(&busLock);
     int status = i2cWriteDevice(handle,buff,2);
+    BusLock_Release(&busLock);
     // Close the I2C device
     i2cClose(handle);
 
@@ -73,7 +79,9 @@ uint8_t I2C_ReadRegByte(uint8_t SlaveAddress, uint8_t RegAddress){
         return 0;
     }
     // Read data byte from device's register
+    BusLock_Acquire(&busLock);
     int status = i2cReadByteData(handle,RegAddress);
+    BusLock_Release(&busLock);
     // Close the I2C device
     i2cClose(handle);
 
@@ -119,16 +127,23 @@ int main(int argc, char *argv[]){
         fprintf(stderr, "pigpio initialization failed\n");
         return 1;
     }
+    if (BusLock_OpenBus(&busLock,I2C_BUS) < 0) {
+        gpioTerminate();
+        return 1;
+    }
 
     // Calculate the value to be loaded
     uint16_t Vref = getOutputVoltageTarget(divValue, Vout);
     printf("\nLoading 0x%X into the VOUT_TARGET1 registers-->...\n",Vref);
-    // Set reference voltage
+    // Set reference voltage, both register writes without another tool in between
+    BusLock_Acquire(&busLock);
     setVOUT1_TARGET(I2CAddress, Vref);
+    BusLock_Release(&busLock);
     // // Read loaded value to verify that the function works
     // uint16_t VoutReal = getVOUT1_TARGET(I2CAddress);
     // printf("\nValue of 0x%X currently loaded to VOUT_TARGET1 registers\n",VoutReal);
     // Do not delete
+    BusLock_Close(&busLock);
     gpioTerminate();
     return 0;;
 }
@@ -0,0 +1,266 @@
+#include "LM51772.h"
+#include "lm51772Cases.h"
+#include "simLM51772.h"
+#include "i2cDev.h"
+#include "i2cRecorder.h"
+#include "i2cTransport.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Runs the table-driven LM51772 suites of lm51772Cases.c, replacing the
+// test programs that printed register values to be checked by eye. Each
+// step result is compared with the table, the exit status is 1 if any
+// step mismatches (or a transfer fails) and 0 otherwise.
+// Transports:
+//   sim       every suite on its own simulated device, suites run in
+//             parallel threads, each with a thread-local transport
+//   recorder  as sim, plus a transcript of every transfer (see i2cRecorder.h)
+//   i2c-dev   the real device on /dev/i2c-N, suites run one after another
+//
+// Usage: testRunner [-t sim|recorder|i2c-dev] [-b bus] [-a address]
+//                   [-j jobs] [-o transcript] [-s suite] [-v]
+
+#define I2C_BUS                 3
+#define MAX_JOBS                16
+#define REPORT_BYTES            8192
+
+typedef struct{
+    int Failures;                       // Mismatching steps
+    int Steps;                          // Steps run
+    char Report[REPORT_BYTES];          // Lines printed after the run
+    size_t Length;
+} SuiteResult;
+
+static const char *transportName = "sim";
+static uint8_t address = LM51772_I2CADDR1;
+static const char *onlySuite = 0;
+static int verbose = 0;
+static FILE *transcript = 0;
+static const I2C_Transport *hardware = 0;   // i2c-dev transport, NULL in simulation
+static SuiteResult results[64];
+static atomic_int nextSuite = 0;
+
+// Appends a line to the report of a suite
+static void report(SuiteResult *Result, const char *Format, ...){
+    va_list args;
+    va_start(args,Format);
+    int n = vsnprintf(&Result->Report[Result->Length],sizeof(Result->Report) - Result->Length,Format,args);
+    va_end(args);
+    if (n > 0) {
+        Result->Length += (size_t)n;
+        if (Result->Length >= sizeof(Result->Report)) {
+            Result->Length = sizeof(Result->Report) - 1;
+        }
+    }
+}
+
+// Runs one step, returns 1 if it mismatches
+static int runStep(const TestStep *Step, uint8_t I2CAddress, uint16_t *Actual){
+    uint16_t value = 0;
+    switch (Step->Kind) {
+        case STEP_WRITE:
+            I2C_WriteRegByte(I2CAddress,Step->Reg,(uint8_t)Step->Arg);
+            break;
+        case STEP_CALL:
+            Step->Fn.Call(I2CAddress);
+            break;
+        case STEP_CALL_U8:
+            Step->Fn.CallU8(I2CAddress,(uint8_t)Step->Arg);
+            break;
+        case STEP_CALL_U16:
+            Step->Fn.CallU16(I2CAddress,(uint16_t)Step->Arg);
+            break;
+        case STEP_CALL_F:
+            Step->Fn.CallF(I2CAddress,(float)Step->Arg);
+            break;
+        case STEP_GET8:
+            value = Step->Fn.Get8(I2CAddress);
+            break;
+        case STEP_GET16:
+            value = Step->Fn.Get16(I2CAddress);
+            break;
+        default:
+            return 1;
+    }
+    if (Step->Kind != STEP_GET8 && Step->Kind != STEP_GET16) {
+        uint8_t reg;
+        if (I2C_ReadRegBlock(I2CAddress,Step->Reg,&reg,1) < 0) {
+            *Actual = 0xFFFF;
+            return 1;
+        }
+        value = reg;
+    }
+    *Actual = value;
+    if (Step->Kind == STEP_GET16) {
+        return value != Step->Expected;
+    }
+    return (value & Step->Mask) != (Step->Expected & Step->Mask);
+}
+
+static void runSuite(int Index){
+    const TestSuite *suite = &LM51772_Suites[Index];
+    SuiteResult *result = &results[Index];
+    for (int i = 0; i < suite->Count; ++i) {
+        const TestStep *step = &suite->Steps[i];
+        uint16_t actual;
+        int failed = runStep(step,address,&actual);
+        result->Steps++;
+        if (failed) {
+            result->Failures++;
+            if (actual == 0xFFFF) {
+                report(result,"FAIL %s #%d %s: transfer failed\n",suite->Name,i,step->Name);
+            } else {
+                report(result,"FAIL %s #%d %s: expected 0x%02X got 0x%02X (mask 0x%02X)\n",suite->Name,i,
+                       step->Name,step->Expected,actual,step->Mask);
+            }
+        } else if (verbose) {
+            report(result,"ok   %s #%d %s = 0x%02X\n",suite->Name,i,step->Name,actual);
+        }
+    }
+}
+
+// Worker: takes suites until none is left, each on a fresh device
+static void *worker(void *Arg){
+    (void)Arg;
+    static _Thread_local SimI2CBus bus;
+    static _Thread_local SimLM51772 device;
+    I2C_Transport sim, recorded;
+    I2C_Recorder recorder;
+    for (;;) {
+        int index = atomic_fetch_add(&nextSuite,1);
+        if (index >= LM51772_SuiteCount) {
+            break;
+        }
+        if (onlySuite != 0 && strcmp(onlySuite,LM51772_Suites[index].Name) != 0) {
+            continue;
+        }
+        if (hardware != 0) {
+            I2C_SetThreadTransport(hardware);
+        } else {
+            SimBus_Init(&bus,&sim);
+            SimLM51772_Init(&device,address);
+            SimBus_Attach(&bus,&device);
+            I2C_SetThreadTransport(&sim);
+        }
+        if (transcript != 0) {
+            I2C_Recorder_Init(&recorder,I2C_GetTransport(),transcript,&recorded);
+            recorder.Tag = LM51772_Suites[index].Name;
+            I2C_SetThreadTransport(&recorded);
+        }
+        runSuite(index);
+        I2C_SetThreadTransport(0);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    unsigned busNumber = I2C_BUS;
+    int jobs = 0;
+    const char *transcriptPath = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i],"-t") == 0 && i + 1 < argc) {
+            transportName = argv[++i];
+        } else if (strcmp(argv[i],"-b") == 0 && i + 1 < argc) {
+            busNumber = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i],"-a") == 0 && i + 1 < argc) {
+            address = (uint8_t)strtol(argv[++i],0,0);
+        } else if (strcmp(argv[i],"-j") == 0 && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i],"-o") == 0 && i + 1 < argc) {
+            transcriptPath = argv[++i];
+        } else if (strcmp(argv[i],"-s") == 0 && i + 1 < argc) {
+            onlySuite = argv[++i];
+        } else if (strcmp(argv[i],"-v") == 0) {
+            verbose = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [-t sim|recorder|i2c-dev] [-b bus] [-a address] [-j jobs] [-o transcript] [-s suite] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((size_t)LM51772_SuiteCount > sizeof(results)/sizeof(results[0])) {
+        fprintf(stderr, "Too many suites\n");
+        return 2;
+    }
+
+    // The library prints while configuring, the report goes to the real stdout
+    fflush(stdout);
+    FILE *out = fdopen(dup(STDOUT_FILENO),"w");
+    int devnull = open("/dev/null",O_WRONLY);
+    if (out == 0 || devnull < 0) {
+        fprintf(stderr, "Cannot redirect the standard output\n");
+        return 2;
+    }
+    dup2(devnull,STDOUT_FILENO);
+    close(devnull);
+
+    static I2C_DevBus dev;
+    I2C_Transport devTransport;
+    if (strcmp(transportName,"i2c-dev") == 0) {
+        if (I2C_Dev_Open(&dev,busNumber,&devTransport) < 0) {
+            return 2;
+        }
+        hardware = &devTransport;
+        jobs = 1; // One real device, the suites share it
+    } else if (strcmp(transportName,"recorder") == 0) {
+        if (transcriptPath == 0) {
+            transcript = out;
+        }
+    } else if (strcmp(transportName,"sim") != 0) {
+        fprintf(stderr, "Unknown transport %s\n", transportName);
+        return 2;
+    }
+    if (transcriptPath != 0) {
+        transcript = fopen(transcriptPath,"w");
+        if (transcript == 0) {
+            fprintf(stderr, "Cannot open %s\n", transcriptPath);
+            return 2;
+        }
+    }
+    if (jobs <= 0) {
+        jobs = (LM51772_SuiteCount < MAX_JOBS) ? LM51772_SuiteCount : MAX_JOBS;
+    }
+    jobs = (jobs > MAX_JOBS) ? MAX_JOBS : jobs;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    pthread_t threads[MAX_JOBS];
+    for (int i = 0; i < jobs; ++i) {
+        pthread_create(&threads[i],0,worker,0);
+    }
+    for (int i = 0; i < jobs; ++i) {
+        pthread_join(threads[i],0);
+    }
+    clock_gettime(CLOCK_MONOTONIC,&t1);
+    double ms = (double)(t1.tv_sec - t0.tv_sec)*1e3 + (double)(t1.tv_nsec - t0.tv_nsec)/1e6;
+
+    // Report in suite order, whatever the order they ran in
+    int steps = 0, failures = 0, suites = 0, failedSuites = 0;
+    for (int i = 0; i < LM51772_SuiteCount; ++i) {
+        if (results[i].Steps == 0) {
+            continue;
+        }
+        fputs(results[i].Report,out);
+        suites++;
+        steps += results[i].Steps;
+        failures += results[i].Failures;
+        failedSuites += results[i].Failures != 0;
+    }
+    fprintf(out,"%d suites, %d steps, %d failed steps in %d suites, %.2f ms on %s with %d jobs\n", suites, steps,
+            failures, failedSuites, ms, transportName, jobs);
+    if (transcript != 0 && transcript != out) {
+        fclose(transcript);
+    }
+    if (hardware != 0) {
+        I2C_Dev_Close(&dev);
+    }
+    fclose(out);
+    return (failures != 0 || suites == 0) ? 1 : 0;
+}
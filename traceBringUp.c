@@ -0,0 +1,61 @@
+#include "LM51772.h"
+#include "simLM51772.h"
+#include "i2cTrace.h"
+#include "i2cTransport.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Records a board bring-up on a simulated LM51772 and writes it as Chrome
+// trace JSON, to be opened in Perfetto (ui.perfetto.dev) or
+// chrome://tracing. The time stamps come from the virtual clock of the
+// simulated bus, so the timeline shows bus time and delays, not CPU time.
+// LM51772.c and i2cTransport.c have to be compiled with -DLM51772_TRACE.
+//
+// Usage: traceBringUp [output.json]
+
+static uint64_t simClock(void *Context){
+    return ((SimI2CBus *)Context)->NowNs;
+}
+
+int main(int argc, char *argv[]){
+    const char *path = (argc > 1) ? argv[1] : "trace.json";
+    static SimI2CBus bus;
+    static SimLM51772 device;
+    I2C_Transport transport;
+    SimBus_Init(&bus,&transport);
+    SimLM51772_Init(&device,LM51772_I2CADDR1);
+    SimBus_Attach(&bus,&device);
+    I2C_SetTransport(&transport);
+
+    Trace_SetClock(simClock,&bus);
+    Trace_Start();
+    const uint8_t addr = LM51772_I2CADDR1;
+    ClearFaults(addr);
+    DisablePowerStage(addr);
+    setILIM_THRESHOLD(addr,5000);
+    setVOUT1_TARGET(addr,5000);
+    HiccupProtection_Enable(addr);
+    CurrentLimiter_Enable(addr);
+    ThermalWarning_ThresholdConfigure(addr,THW_THRESHOLD_110degC);
+    ThermalWarning_Enable(addr);
+    DVS_SlewrateConfigure(addr,DVS_SLEW_1mV_us);
+    IVP_VoltageThreshold_Configure(addr,12000);
+    IVP_Enable(addr);
+    OVP_SecondaryThreshold_Configure(addr,20000);
+    EnablePowerStage(addr);
+    SoftwareDelay(10);
+    get_USBPD_STATUS(addr);
+    getVOUT1_TARGET(addr);
+    Trace_Stop();
+
+    FILE *f = fopen(path,"w");
+    if (f == 0) {
+        fprintf(stderr,"Cannot open %s\n",path);
+        return 1;
+    }
+    int events = Trace_WriteJSON(f);
+    fclose(f);
+    printf("%d events written to %s (%llu dropped), bus time %.3f ms\n", events, path,
+           (unsigned long long)Trace_Dropped(), (double)bus.NowNs/1e6);
+    return 0;
+}